@@ -2,6 +2,7 @@
 const common = require('../common.js');
 const fs = require('fs');
 const path = require('path');
+const { Searcher } = require('buffer');
 
 const searchStrings = [
   '@',
@@ -24,7 +25,7 @@ const searchStrings = [
 const bench = common.createBenchmark(main, {
   search: searchStrings,
   encoding: ['undefined', 'utf8', 'ucs2', 'binary'],
-  type: ['buffer', 'string'],
+  type: ['buffer', 'string', 'searcher'],
   n: [100000]
 });
 
@@ -45,6 +46,16 @@ function main({ n, search, encoding, type }) {
     search = Buffer.from(Buffer.from(search).toString(), encoding);
   }
 
+  if (type === 'searcher') {
+    const searcher = new Searcher(search, encoding);
+    bench.start();
+    for (var j = 0; j < n; j++) {
+      searcher.indexOf(aliceBuffer);
+    }
+    bench.end(n);
+    return;
+  }
+
   bench.start();
   for (var i = 0; i < n; i++) {
     aliceBuffer.indexOf(search, 0, encoding);
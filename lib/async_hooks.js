@@ -28,13 +28,18 @@ const {
   emitAfter,
   emitDestroy,
   initHooksExist,
+  enableContextFrames,
+  getContextFrame,
+  setContextFrame,
+  enterContextFrame,
+  exitContextFrame,
 } = internal_async_hooks;
 
 // Get symbols
 const {
   async_id_symbol, trigger_async_id_symbol,
   init_symbol, before_symbol, after_symbol, destroy_symbol,
-  promise_resolve_symbol
+  promise_resolve_symbol, context_frame_symbol
 } = internal_async_hooks.symbols;
 
 // Get constants
@@ -150,6 +155,7 @@ class AsyncResource {
     const asyncId = newAsyncId();
     this[async_id_symbol] = asyncId;
     this[trigger_async_id_symbol] = triggerAsyncId;
+    this[context_frame_symbol] = getContextFrame();
 
     // This prop name (destroyed) has to be synchronized with C++
     const destroyed = { destroyed: false };
@@ -167,9 +173,11 @@ class AsyncResource {
   runInAsyncScope(fn, thisArg, ...args) {
     const asyncId = this[async_id_symbol];
     emitBefore(asyncId, this[trigger_async_id_symbol]);
+    const previousFrame = enterContextFrame(this);
     try {
       return Reflect.apply(fn, thisArg, args);
     } finally {
+      exitContextFrame(previousFrame);
       emitAfter(asyncId);
     }
   }
@@ -190,6 +198,46 @@ class AsyncResource {
 }
 
 
+// The stores of all instances are kept in an immutable Map, the async context
+// frame, which async resources capture when they are created and restore when
+// they call back. That is done natively for resources that are created in
+// C++, so that, unlike with hooks, no JS runs for them.
+class AsyncLocalStorage {
+  run(store, callback, ...args) {
+    enableContextFrames();
+    const previous = getContextFrame();
+    const frame = new Map(previous);
+    frame.set(this, store);
+    setContextFrame(frame);
+    try {
+      return Reflect.apply(callback, null, args);
+    } finally {
+      setContextFrame(previous);
+    }
+  }
+
+  exit(callback, ...args) {
+    const previous = getContextFrame();
+    if (previous === undefined || !previous.has(this))
+      return Reflect.apply(callback, null, args);
+    const frame = new Map(previous);
+    frame.delete(this);
+    setContextFrame(frame.size > 0 ? frame : undefined);
+    try {
+      return Reflect.apply(callback, null, args);
+    } finally {
+      setContextFrame(previous);
+    }
+  }
+
+  getStore() {
+    const frame = getContextFrame();
+    if (frame !== undefined)
+      return frame.get(this);
+  }
+}
+
+
 // Placing all exports down here because the exported classes won't export
 // otherwise.
 module.exports = {
@@ -199,4 +247,5 @@ module.exports = {
   triggerAsyncId,
   // Embedder API
   AsyncResource,
+  AsyncLocalStorage,
 };
@@ -24,6 +24,7 @@
 const { Math, Object } = primordials;
 
 const {
+  BufferSearch,
   byteLengthUtf8,
   copy: _copy,
   compare: _compare,
@@ -33,6 +34,7 @@ const {
   indexOfBuffer,
   indexOfNumber,
   indexOfString,
+  isUtf8: _isUtf8,
   swap16: _swap16,
   swap32: _swap32,
   swap64: _swap64,
@@ -737,11 +739,8 @@ Buffer.prototype.compare = function compare(target,
 // - byteOffset - an index into `buffer`; will be clamped to an int32
 // - encoding - an optional encoding, relevant if val is a string
 // - dir - true for indexOf, false for lastIndexOf
-function bidirectionalIndexOf(buffer, val, byteOffset, encoding, dir) {
-  if (typeof byteOffset === 'string') {
-    encoding = byteOffset;
-    byteOffset = undefined;
-  } else if (byteOffset > 0x7fffffff) {
+function toIndexOfOffset(buffer, byteOffset, dir) {
+  if (byteOffset > 0x7fffffff) {
     byteOffset = 0x7fffffff;
   } else if (byteOffset < -0x80000000) {
     byteOffset = -0x80000000;
@@ -752,6 +751,15 @@ function bidirectionalIndexOf(buffer, val, byteOffset, encoding, dir) {
   if (Number.isNaN(byteOffset)) {
     byteOffset = dir ? 0 : buffer.length;
   }
+  return byteOffset;
+}
+
+function bidirectionalIndexOf(buffer, val, byteOffset, encoding, dir) {
+  if (typeof byteOffset === 'string') {
+    encoding = byteOffset;
+    byteOffset = undefined;
+  }
+  byteOffset = toIndexOfOffset(buffer, byteOffset, dir);
   dir = !!dir;  // Cast to bool.
 
   if (typeof val === 'string') {
@@ -1083,9 +1091,60 @@ if (internalBinding('config').hasIntl) {
   };
 }
 
+const kHandle = Symbol('kHandle');
+
+// Searches for a fixed needle, reusing the search tables that
+// Buffer#indexOf() would otherwise rebuild on every call.
+class Searcher {
+  constructor(needle, encoding) {
+    if (typeof needle === 'string') {
+      needle = Buffer.from(needle, encoding);
+    } else if (!isUint8Array(needle)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'needle', ['string', 'Buffer', 'Uint8Array'], needle
+      );
+    }
+    const ucs2 = encoding !== undefined &&
+                 normalizeEncoding(encoding) === 'utf16le';
+    this[kHandle] = new BufferSearch(needle, ucs2);
+    this.length = needle.length;
+  }
+
+  indexOf(buffer, byteOffset) {
+    return searcherIndexOf(this, buffer, byteOffset, true);
+  }
+
+  lastIndexOf(buffer, byteOffset) {
+    return searcherIndexOf(this, buffer, byteOffset, false);
+  }
+
+  includes(buffer, byteOffset) {
+    return this.indexOf(buffer, byteOffset) !== -1;
+  }
+}
+
+function searcherIndexOf(searcher, buffer, byteOffset, dir) {
+  if (!isUint8Array(buffer)) {
+    throw new ERR_INVALID_ARG_TYPE('buffer', ['Buffer', 'Uint8Array'], buffer);
+  }
+  byteOffset = toIndexOfOffset(buffer, byteOffset, dir);
+  return searcher[kHandle].indexOf(buffer, byteOffset, dir);
+}
+
+function isUtf8(input) {
+  if (!isArrayBufferView(input) && !isAnyArrayBuffer(input)) {
+    throw new ERR_INVALID_ARG_TYPE('input',
+                                   ['ArrayBuffer', 'Buffer', 'TypedArray'],
+                                   input);
+  }
+  return _isUtf8(input);
+}
+
 module.exports = {
   Buffer,
   SlowBuffer,
+  isUtf8,
+  Searcher,
   transcode,
   // Legacy
   kMaxLength,
@@ -35,6 +35,7 @@ const {
 } = require('internal/net');
 const {
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
   ERR_MISSING_ARGS,
   ERR_SOCKET_ALREADY_BOUND,
   ERR_SOCKET_BAD_BUFFER_SIZE,
@@ -90,6 +91,7 @@ function Socket(type, listener) {
   var lookup;
   let recvBufferSize;
   let sendBufferSize;
+  let recvBatch = false;
 
   let options;
   if (type !== null && typeof type === 'object') {
@@ -98,6 +100,7 @@ function Socket(type, listener) {
     lookup = options.lookup;
     recvBufferSize = options.recvBufferSize;
     sendBufferSize = options.sendBufferSize;
+    recvBatch = !!options.recvBatch;
   }
 
   const handle = newHandle(type, lookup);
@@ -118,7 +121,8 @@ function Socket(type, listener) {
     reuseAddr: options && options.reuseAddr, // Use UV_UDP_REUSEADDR if true.
     ipv6Only: options && options.ipv6Only,
     recvBufferSize,
-    sendBufferSize
+    sendBufferSize,
+    recvBatch
   };
 }
 Object.setPrototypeOf(Socket.prototype, EventEmitter.prototype);
@@ -133,9 +137,9 @@ function createSocket(type, listener) {
 function startListening(socket) {
   const state = socket[kStateSymbol];
 
-  state.handle.onmessage = onMessage;
+  state.handle.onmessage = state.recvBatch ? onMessages : onMessage;
   // Todo: handle errors
-  state.handle.recvStart();
+  state.handle.recvStart(state.recvBatch);
   state.receiving = true;
   state.bindState = BIND_STATE_BOUND;
 
@@ -156,6 +160,7 @@ function replaceHandle(self, newHandle) {
   newHandle.lookup = oldHandle.lookup;
   newHandle.bind = oldHandle.bind;
   newHandle.send = oldHandle.send;
+  newHandle.sendBatch = oldHandle.sendBatch;
   newHandle[owner_symbol] = self;
 
   // Replace the existing handle by the handle we got from master.
@@ -670,6 +675,159 @@ function doSend(ex, self, ip, list, address, port, callback) {
   }
 }
 
+// sendBatch(messages[, callback]), where each message is an object with a
+// `msg` and, for connectionless sockets, a `port` and an optional `address`.
+Socket.prototype.sendBatch = function(messages, callback) {
+  if (!Array.isArray(messages))
+    throw new ERR_INVALID_ARG_TYPE('messages', 'Array', messages);
+  if (callback !== undefined && typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
+  const state = this[kStateSymbol];
+  const connected = state.connectState === CONNECT_STATE_CONNECTED;
+  const list = new Array(messages.length);
+  const ports = connected ? undefined : new Array(messages.length);
+  const addresses = connected ? undefined : new Array(messages.length);
+
+  for (var i = 0; i < messages.length; i++) {
+    const message = messages[i];
+    if (message === null || typeof message !== 'object') {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}]`, 'Object', message);
+    }
+    const { msg, port, address } = message;
+    if (typeof msg === 'string') {
+      list[i] = Buffer.from(msg);
+    } else if (isUint8Array(msg)) {
+      list[i] = msg;
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}].msg`,
+                                     ['Buffer', 'Uint8Array', 'string'], msg);
+    }
+
+    if (connected) {
+      if (port !== undefined || address !== undefined)
+        throw new ERR_SOCKET_DGRAM_IS_CONNECTED();
+      continue;
+    }
+    ports[i] = validatePort(port);
+    if (address && typeof address !== 'string') {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}].address`,
+                                     ['string', 'falsy'], address);
+    }
+    addresses[i] = address || undefined;
+  }
+
+  healthCheck(this);
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this,
+            lookupBatch.bind(null, this, list, ports, addresses, callback));
+    return;
+  }
+
+  lookupBatch(this, list, ports, addresses, callback);
+};
+
+// Resolves every distinct address of the batch once.
+function lookupBatch(self, list, ports, addresses, callback) {
+  const state = self[kStateSymbol];
+  const send = (ex, ips) => {
+    defaultTriggerAsyncIdScope(
+      self[async_id_symbol],
+      doSendBatch,
+      ex, self, list, ports, addresses, ips, callback
+    );
+  };
+
+  if (ports === undefined || list.length === 0) {
+    send(null, undefined);
+    return;
+  }
+
+  const indices = new Map();
+  for (var i = 0; i < addresses.length; i++) {
+    const forAddress = indices.get(addresses[i]);
+    if (forAddress === undefined)
+      indices.set(addresses[i], [i]);
+    else
+      forAddress.push(i);
+  }
+
+  const ips = new Array(list.length);
+  let remaining = indices.size;
+  let error = null;
+  for (const [address, forAddress] of indices) {
+    state.handle.lookup(address, (ex, ip) => {
+      if (ex) {
+        if (error === null)
+          error = ex;
+      } else {
+        for (var i = 0; i < forAddress.length; i++)
+          ips[forAddress[i]] = ip;
+      }
+      if (--remaining === 0)
+        send(error, ips);
+    });
+  }
+}
+
+function doSendBatch(ex, self, list, ports, addresses, ips, callback) {
+  const state = self[kStateSymbol];
+
+  if (ex) {
+    if (typeof callback === 'function') {
+      process.nextTick(callback, ex);
+      return;
+    }
+
+    process.nextTick(() => self.emit('error', ex));
+    return;
+  } else if (!state.handle) {
+    return;
+  }
+
+  // As many datagrams as possible are sent right away with a single system
+  // call. The rest are sent like with send(), which queues them until the
+  // socket is writable and reports their errors.
+  const sent = ports === undefined ?
+    state.handle.sendBatch(list, list.length) :
+    state.handle.sendBatch(list, list.length, ports, ips);
+
+  let pending = list.length - sent + 1;
+  let error = null;
+  const done = (err) => {
+    if (err && error === null)
+      error = err;
+    if (--pending === 0 && callback)
+      callback(error);
+  };
+
+  for (var i = sent; i < list.length; i++) {
+    const req = new SendWrap();
+    req.list = [list[i]];  // Keep reference alive.
+    if (ports !== undefined) {
+      req.address = addresses[i];
+      req.port = ports[i];
+    }
+    req.callback = done;
+    req.oncomplete = afterSend;
+
+    let err;
+    if (ports !== undefined)
+      err = state.handle.send(req, req.list, 1, ports[i], ips[i], true);
+    else
+      err = state.handle.send(req, req.list, 1, true);
+
+    if (err)
+      process.nextTick(done, exceptionWithHostPort(err, 'send', req.address,
+                                                   req.port));
+  }
+  process.nextTick(done, null);
+}
+
 function afterSend(err, sent) {
   if (err) {
     err = exceptionWithHostPort(err, 'send', this.address, this.port);
@@ -841,6 +999,17 @@ function stopReceiving(socket) {
 }
 
 
+function onMessages(nread, handle, bufs, rinfos) {
+  const self = handle[owner_symbol];
+  if (nread < 0) {
+    return self.emit('error', errnoException(nread, 'recvmsg'));
+  }
+  for (var i = 0; i < bufs.length; i++)
+    rinfos[i].size = bufs[i].length;
+  self.emit('messages', bufs, rinfos);
+}
+
+
 function onMessage(nread, handle, buf, rinfo) {
   const self = handle[owner_symbol];
   if (nread < 0) {
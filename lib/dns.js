@@ -277,9 +277,23 @@ function defaultResolverSetServers(servers) {
     bindDefaultResolver(promises, promises.Resolver.prototype);
 }
 
+const cacheStatsArray = new Float64Array(4);
+
+function getCacheStats() {
+  cares.getCacheStats(cacheStatsArray);
+  return {
+    hits: cacheStatsArray[0],
+    misses: cacheStatsArray[1],
+    coalesced: cacheStatsArray[2],
+    entries: cacheStatsArray[3]
+  };
+}
+
+
 module.exports = {
   lookup,
   lookupService,
+  getCacheStats,
 
   Resolver,
   setServers: defaultResolverSetServers,
@@ -55,7 +55,15 @@ const {
   uvException
 } = require('internal/errors');
 
-const { FSReqCallback, statValues } = binding;
+const {
+  CopyTreeJob,
+  FSReqCallback,
+  kCopyTreeFiles,
+  kCopyTreeDirectories,
+  kCopyTreeSymlinks,
+  kCopyTreeBytes,
+  statValues
+} = binding;
 const { toPathIfFileURL } = require('internal/url');
 const internalUtil = require('internal/util');
 const {
@@ -1731,6 +1739,56 @@ function copyFileSync(src, dest, flags) {
   handleErrorFromBinding(ctx);
 }
 
+// Copies a whole directory tree. The tree walk and the file copies all run
+// on the threadpool, with at most `concurrency` threads working on the same
+// tree at any time.
+function copyTree(src, dest, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
+  const {
+    flags = 0,
+    concurrency = 4
+  } = options || {};
+  callback = makeCallback(callback);
+
+  src = getValidatedPath(src, 'src');
+  dest = getValidatedPath(dest, 'dest');
+  validateInt32(flags, 'flags');
+  validateInt32(concurrency, 'concurrency', 1, 128);
+
+  // Copying a directory into itself would never end.
+  const relative = pathModule.relative(pathModule.resolve(`${src}`),
+                                       pathModule.resolve(`${dest}`));
+  if (relative === '' ||
+      (relative.split(pathModule.sep)[0] !== '..' &&
+       !pathModule.isAbsolute(relative))) {
+    throw new ERR_INVALID_ARG_VALUE('dest', dest,
+                                    'must not be src or inside of src');
+  }
+
+  const job = new CopyTreeJob(pathModule.toNamespacedPath(src),
+                              pathModule.toNamespacedPath(dest),
+                              flags,
+                              concurrency);
+  job.oncomplete = callback;
+  job.start();
+
+  return {
+    progress() {
+      job.readProgress();
+      const fields = job.progress;
+      return {
+        files: fields[kCopyTreeFiles],
+        directories: fields[kCopyTreeDirectories],
+        symlinks: fields[kCopyTreeSymlinks],
+        bytes: fields[kCopyTreeBytes]
+      };
+    }
+  };
+}
+
 function lazyLoadStreams() {
   if (!ReadStream) {
     ({ ReadStream, WriteStream } = require('internal/fs/streams'));
@@ -1762,6 +1820,7 @@ module.exports = fs = {
   closeSync,
   copyFile,
   copyFileSync,
+  copyTree,
   createReadStream,
   createWriteStream,
   exists,
@@ -42,6 +42,16 @@ const { async_hook_fields, async_id_fields, owner_symbol } = async_wrap;
 const { pushAsyncIds: pushAsyncIds_, popAsyncIds: popAsyncIds_ } = async_wrap;
 // For performance reasons, only track Promises when a hook is enabled.
 const { enablePromiseHook, disablePromiseHook } = async_wrap;
+// The async context frame holds the stores of AsyncLocalStorage instances. It
+// is kept in Environment::AsyncHooks::context_frame_, so that AsyncWrap
+// instances capture and restore it without calling into JS. Resources that
+// are created in JS only capture it once AsyncLocalStorage has been used.
+const {
+  enableContextFrames: enableContextFrames_,
+  getContextFrame: getContextFrame_,
+  setContextFrame
+} = async_wrap;
+let contextFramesEnabled = false;
 // Properties in active_hooks are used to keep track of the set of hooks being
 // executed in case another hook is enabled/disabled. The new set of hooks is
 // then restored once the active set of hooks is finished executing.
@@ -86,6 +96,7 @@ const before_symbol = Symbol('before');
 const after_symbol = Symbol('after');
 const destroy_symbol = Symbol('destroy');
 const promise_resolve_symbol = Symbol('promiseResolve');
+const context_frame_symbol = Symbol('contextFrame');
 const emitBeforeNative = emitHookFactory(before_symbol, 'emitBeforeNative');
 const emitAfterNative = emitHookFactory(after_symbol, 'emitAfterNative');
 const emitDestroyNative = emitHookFactory(destroy_symbol, 'emitDestroyNative');
@@ -382,6 +393,44 @@ function clearAsyncIdStack() {
   async_id_fields[kExecutionAsyncId] = 0;
   async_id_fields[kTriggerAsyncId] = 0;
   async_hook_fields[kStackLength] = 0;
+  clearContextFrame();
+}
+
+
+function enableContextFrames() {
+  if (contextFramesEnabled)
+    return;
+  contextFramesEnabled = true;
+  enableContextFrames_();
+}
+
+
+// Returns the frame for a resource to capture when it is created.
+function getContextFrame() {
+  return contextFramesEnabled ? getContextFrame_() : undefined;
+}
+
+
+// Makes the frame that `resource` captured the current one, and returns the
+// frame to pass to exitContextFrame() when the resource's callback is done.
+function enterContextFrame(resource) {
+  if (!contextFramesEnabled)
+    return undefined;
+  const previous = getContextFrame_();
+  setContextFrame(resource[context_frame_symbol]);
+  return previous;
+}
+
+
+function exitContextFrame(previous) {
+  if (contextFramesEnabled)
+    setContextFrame(previous);
+}
+
+
+function clearContextFrame() {
+  if (contextFramesEnabled)
+    setContextFrame(undefined);
 }
 
 
@@ -439,7 +488,7 @@ module.exports = {
   symbols: {
     async_id_symbol, trigger_async_id_symbol,
     init_symbol, before_symbol, after_symbol, destroy_symbol,
-    promise_resolve_symbol, owner_symbol
+    promise_resolve_symbol, owner_symbol, context_frame_symbol
   },
   constants: {
     kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve
@@ -449,6 +498,12 @@ module.exports = {
   clearDefaultTriggerAsyncId,
   clearAsyncIdStack,
   hasAsyncIdStack,
+  enableContextFrames,
+  getContextFrame,
+  setContextFrame,
+  enterContextFrame,
+  exitContextFrame,
+  clearContextFrame,
   // Internal Embedder API
   newAsyncId,
   getOrSetAsyncId,
@@ -0,0 +1,28 @@
+'use strict';
+
+// Runs the application in a snapshot file written by
+// `node_mksnapshot --blob --entry <script>`. The application has already
+// been initialized when the snapshot was taken, in a context without any
+// Node.js APIs. The deserialize callbacks it registered can re-open handles
+// and re-read the environment before its main function runs.
+
+const {
+  prepareMainThreadExecution
+} = require('internal/bootstrap/pre_execution');
+
+prepareMainThreadExecution(false);
+
+const { createRequire } = require('internal/modules/cjs/loader').Module;
+const { resolve } = require('path');
+const { startupSnapshotState: state } = internalBinding('v8');
+
+markBootstrapComplete();
+
+const context = {
+  process,
+  require: createRequire(resolve(state.filename))
+};
+const { callbacks, main } = state;
+for (let i = 0; i < callbacks.length; i++)
+  callbacks[i](context);
+main(context);
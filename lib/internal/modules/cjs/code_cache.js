@@ -0,0 +1,200 @@
+'use strict';
+
+// An on-disk cache of the code that V8 compiles for CommonJS modules, enabled
+// with --experimental-code-cache-dir. There is one file per module, named
+// after the hash of its path. The file is only used when the hash of the
+// source, the path and V8's cached data version match, and is replaced
+// otherwise. Once the files take up more than
+// --experimental-code-cache-max-size bytes, the least recently written ones
+// are removed. Errors are never reported to the application; the module is
+// compiled from scratch instead.
+//
+// Layout of a cache file:
+//
+//   uint32 kMagic
+//   uint32 cachedDataVersionTag()
+//   8 bytes hashSource(content)
+//   uint32 byte length of the path, followed by the path in UTF-8
+//   the cached data of the module wrapper
+
+const { Buffer } = require('buffer');
+const fs = require('fs');
+const path = require('path');
+const { getOptionValue } = require('internal/options');
+const {
+  createCodeCacheForFunction,
+  hashSource
+} = internalBinding('contextify');
+const debug = require('internal/util/debuglog').debuglog('codecache');
+
+const kMagic = 0x4e434331;  // 'NCC1'
+const kFixedHeaderSize = 20;
+// Cached data larger than this is not written, to keep a few huge bundles
+// from filling up the cache directory.
+const kMaxCachedDataSize = 64 * 1024 * 1024;
+// Evicting files brings the size of the cache down to this fraction of the
+// maximum, so that the directory is not scanned again on every write.
+const kEvictionRatio = 0.75;
+
+let cacheDir;
+let versionTag;
+let maxCacheSize;
+// The total size of the cache files as far as this thread knows, or undefined
+// until the directory has been scanned.
+let cacheSize;
+
+function getCacheDir() {
+  if (cacheDir === undefined) {
+    const dir = getOptionValue('--experimental-code-cache-dir');
+    cacheDir = dir ? path.resolve(dir) : null;
+    if (cacheDir !== null) {
+      versionTag = internalBinding('v8').cachedDataVersionTag();
+      maxCacheSize = getOptionValue('--experimental-code-cache-max-size');
+    }
+  }
+  return cacheDir;
+}
+
+// Returns undefined if the cache is disabled. Otherwise, returns an entry
+// whose `cachedData` is the cached data for this content of the module, or
+// undefined if there is none.
+function getCodeCacheEntry(filename, content) {
+  const dir = getCacheDir();
+  if (dir === null)
+    return undefined;
+
+  const entry = {
+    filename,
+    cachePath: path.join(dir, `${hashSource(filename)}.cache`),
+    sourceHash: Buffer.from(hashSource(content), 'hex'),
+    cachedData: undefined,
+    // The size of the cache file that is replaced when the cache is updated.
+    cacheFileSize: 0
+  };
+
+  let file;
+  try {
+    file = fs.readFileSync(entry.cachePath);
+  } catch {
+    return entry;
+  }
+  entry.cacheFileSize = file.length;
+  if (file.length < kFixedHeaderSize ||
+      file.readUInt32LE(0) !== kMagic ||
+      file.readUInt32LE(4) !== versionTag ||
+      !file.slice(8, 16).equals(entry.sourceHash)) {
+    debug('stale cache for %s', filename);
+    return entry;
+  }
+  const filenameLength = file.readUInt32LE(16);
+  const dataStart = kFixedHeaderSize + filenameLength;
+  if (file.length <= dataStart ||
+      file.toString('utf8', kFixedHeaderSize, dataStart) !== filename) {
+    debug('stale cache for %s', filename);
+    return entry;
+  }
+  entry.cachedData = file.slice(dataStart);
+  return entry;
+}
+
+// Writes the code cache of `fn`, the compiled wrapper of the module, after it
+// has run for the first time so that the functions it called are included.
+// The file is renamed into place, so that concurrent processes never read a
+// partially written cache.
+function maybeUpdateCodeCache(entry, fn) {
+  if (entry.cachedData !== undefined && !fn.cachedDataRejected)
+    return;
+  if (entry.cachedData !== undefined)
+    debug('cache rejected for %s', entry.filename);
+
+  const data = createCodeCacheForFunction(fn);
+  if (data === undefined || data.length > kMaxCachedDataSize)
+    return;
+  const filenameLength = Buffer.byteLength(entry.filename);
+  const size = kFixedHeaderSize + filenameLength + data.length;
+  if (size > maxCacheSize)
+    return;
+  const header = Buffer.allocUnsafe(kFixedHeaderSize + filenameLength);
+  header.writeUInt32LE(kMagic, 0);
+  header.writeUInt32LE(versionTag, 4);
+  entry.sourceHash.copy(header, 8);
+  header.writeUInt32LE(filenameLength, 16);
+  header.write(entry.filename, kFixedHeaderSize);
+
+  const { threadId } = internalBinding('worker');
+  const tmpPath = `${entry.cachePath}.${process.pid}.${threadId}.tmp`;
+  try {
+    fs.mkdirSync(cacheDir, { recursive: true });
+    const fd = fs.openSync(tmpPath, 'w');
+    try {
+      fs.writeSync(fd, header);
+      fs.writeSync(fd, data);
+    } finally {
+      fs.closeSync(fd);
+    }
+    fs.renameSync(tmpPath, entry.cachePath);
+    debug('wrote cache for %s', entry.filename);
+  } catch (err) {
+    debug('cannot write cache for %s: %s', entry.filename, err.message);
+    try {
+      fs.unlinkSync(tmpPath);
+    } catch {}
+    return;
+  }
+
+  if (cacheSize !== undefined)
+    cacheSize += size - entry.cacheFileSize;
+  if (cacheSize === undefined || cacheSize > maxCacheSize)
+    evictCacheFiles(entry.cachePath);
+}
+
+// Scans the cache directory and, if the files in it take up more than the
+// maximum size, removes the least recently written ones other than `keep`.
+// Other processes may write to the directory at the same time, so the size
+// is only an estimate until the next scan.
+function evictCacheFiles(keep) {
+  let names;
+  try {
+    names = fs.readdirSync(cacheDir);
+  } catch (err) {
+    debug('cannot scan %s: %s', cacheDir, err.message);
+    return;
+  }
+  const files = [];
+  cacheSize = 0;
+  for (const name of names) {
+    if (!name.endsWith('.cache'))
+      continue;
+    const file = path.join(cacheDir, name);
+    try {
+      const { size, mtimeMs } = fs.statSync(file);
+      files.push({ file, size, mtimeMs });
+      cacheSize += size;
+    } catch {
+      // Removed by another process since the directory was read.
+    }
+  }
+  if (cacheSize <= maxCacheSize)
+    return;
+
+  files.sort((a, b) => a.mtimeMs - b.mtimeMs);
+  for (const { file, size } of files) {
+    if (cacheSize <= maxCacheSize * kEvictionRatio)
+      break;
+    if (file === keep)
+      continue;
+    try {
+      fs.unlinkSync(file);
+      debug('evicted %s', file);
+    } catch (err) {
+      debug('cannot evict %s: %s', file, err.message);
+    }
+    // Count the file as gone even if another process has removed it first.
+    cacheSize -= size;
+  }
+}
+
+module.exports = {
+  getCodeCacheEntry,
+  maybeUpdateCodeCache
+};
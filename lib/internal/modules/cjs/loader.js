@@ -49,6 +49,9 @@ const manifest = getOptionValue('--experimental-policy') ?
   require('internal/process/policy').manifest :
   null;
 const { compileFunction } = internalBinding('contextify');
+const codeCache = getOptionValue('--experimental-code-cache-dir') ?
+  require('internal/modules/cjs/code_cache') :
+  null;
 
 const {
   ERR_INVALID_ARG_VALUE,
@@ -689,7 +692,7 @@ Module.prototype.require = function(id) {
 var resolvedArgv;
 let hasPausedEntry = false;
 
-function wrapSafe(filename, content) {
+function wrapSafe(filename, content, codeCacheEntry) {
   if (patched) {
     const wrapper = Module.wrap(content);
     return vm.runInThisContext(wrapper, {
@@ -708,7 +711,7 @@ function wrapSafe(filename, content) {
     filename,
     0,
     0,
-    undefined,
+    codeCacheEntry !== undefined ? codeCacheEntry.cachedData : undefined,
     false,
     undefined,
     [],
@@ -744,7 +747,9 @@ Module.prototype._compile = function(content, filename) {
     manifest.assertIntegrity(moduleURL, content);
   }
 
-  const compiledWrapper = wrapSafe(filename, content);
+  const codeCacheEntry = codeCache !== null && !patched ?
+    codeCache.getCodeCacheEntry(filename, content) : undefined;
+  const compiledWrapper = wrapSafe(filename, content, codeCacheEntry);
 
   var inspectorWrapper = null;
   if (getOptionValue('--inspect-brk') && process._eval == null) {
@@ -778,6 +783,8 @@ Module.prototype._compile = function(content, filename) {
                                   filename, dirname);
   }
   if (requireDepth === 0) statCache = null;
+  if (codeCacheEntry !== undefined)
+    codeCache.maybeUpdateCodeCache(codeCacheEntry, compiledWrapper);
   return result;
 };
 
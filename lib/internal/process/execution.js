@@ -15,6 +15,7 @@ const {
   executionAsyncId,
   clearDefaultTriggerAsyncId,
   clearAsyncIdStack,
+  clearContextFrame,
   hasAsyncIdStack,
   afterHooksExist,
   emitAfter
@@ -179,6 +180,8 @@ function createFatalException() {
       do {
         emitAfter(executionAsyncId());
       } while (hasAsyncIdStack());
+      // The frames of the callbacks that threw are not restored either.
+      clearContextFrame();
     // Or completely empty the id stack.
     } else {
       clearAsyncIdStack();
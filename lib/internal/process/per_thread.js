@@ -137,14 +137,15 @@ function wrapProcessMethods(binding) {
     return hrBigintValues[0];
   }
 
-  const memValues = new Float64Array(4);
+  const memValues = new Float64Array(5);
   function memoryUsage() {
     _memoryUsage(memValues);
     return {
       rss: memValues[0],
       heapTotal: memValues[1],
       heapUsed: memValues[2],
-      external: memValues[3]
+      external: memValues[3],
+      hugePageBuffers: memValues[4]
     };
   }
 
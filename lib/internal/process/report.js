@@ -28,6 +28,9 @@ const report = {
 
     return nr.getReport(err.stack);
   },
+  writeHeapProfile() {
+    return nr.writeHeapProfile();
+  },
   get directory() {
     return nr.getDirectory();
   },
@@ -29,7 +29,10 @@ const {
   emitBefore,
   emitAfter,
   emitDestroy,
-  symbols: { async_id_symbol, trigger_async_id_symbol }
+  getContextFrame,
+  enterContextFrame,
+  exitContextFrame,
+  symbols: { async_id_symbol, trigger_async_id_symbol, context_frame_symbol }
 } = require('internal/async_hooks');
 const {
   ERR_INVALID_CALLBACK,
@@ -65,6 +68,7 @@ function processTicksAndRejections() {
     while (tock = queue.shift()) {
       const asyncId = tock[async_id_symbol];
       emitBefore(asyncId, tock[trigger_async_id_symbol]);
+      const previousFrame = enterContextFrame(tock);
       // emitDestroy() places the async_id_symbol into an asynchronous queue
       // that calls the destroy callback in the future. It's called before
       // calling tock.callback so destroy will be called even if the callback
@@ -83,6 +87,7 @@ function processTicksAndRejections() {
       else
         callback(...tock.args);
 
+      exitContextFrame(previousFrame);
       emitAfter(asyncId);
     }
     setHasTickScheduled(false);
@@ -99,6 +104,7 @@ class TickObject {
     const asyncId = newAsyncId();
     this[async_id_symbol] = asyncId;
     this[trigger_async_id_symbol] = triggerAsyncId;
+    this[context_frame_symbol] = getContextFrame();
 
     if (initHooksExist()) {
       emitInit(asyncId,
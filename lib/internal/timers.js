@@ -65,20 +65,22 @@
 // after the first one encountered that does not yet need to timeout will also
 // always be due to timeout at a later time.
 //
-// Less-than constant time operations are thus contained in two places:
-// The PriorityQueue — an efficient binary heap implementation that does all
-// operations in worst-case O(log n) time — which manages the order of expiring
-// Timeout lists and the object map lookup of a specific list by the duration of
-// timers within (or creation of a new list). However, these operations combined
-// have shown to be trivial in comparison to other timers architectures.
+// The order in which the lists expire is managed by a hierarchical timer wheel
+// in C++ (see src/timer_wheel.h), which also schedules and cancels lists in
+// constant time. Lists are added to and removed from the wheel by writing
+// commands to the shared `timerInfo` array, which the wheel applies before
+// timers are run, so doing so does not call into C++. The lists that expire are
+// passed back through the same array in batches, in order of their expiry.
 
 const { Math, Object } = primordials;
 
 const {
   scheduleTimer,
+  flushTimerCommands,
   toggleTimerRef,
   getLibuvNow,
-  immediateInfo
+  immediateInfo,
+  timerInfo
 } = internalBinding('timers');
 
 const {
@@ -86,11 +88,15 @@ const {
   newAsyncId,
   initHooksExist,
   destroyHooksExist,
+  getContextFrame,
+  enterContextFrame,
+  exitContextFrame,
   // The needed emit*() functions.
   emitInit,
   emitBefore,
   emitAfter,
-  emitDestroy
+  emitDestroy,
+  symbols: { context_frame_symbol }
 } = require('internal/async_hooks');
 
 // Symbols for storing async id state.
@@ -104,7 +110,6 @@ const {
 const { validateNumber } = require('internal/validators');
 
 const L = require('internal/linkedlist');
-const PriorityQueue = require('internal/priority_queue');
 
 const { inspect } = require('internal/util/inspect');
 const debug = require('internal/util/debuglog').debuglog('timer');
@@ -114,23 +119,30 @@ const kCount = 0;
 const kRefCount = 1;
 const kHasOutstanding = 2;
 
+// *Must* match Environment::TimerInfo::Fields in src/env.h.
+const kNextExpiry = 0;
+const kExpiredCount = 1;
+const kExpiredCursor = 2;
+const kCommandCount = 3;
+const kExpiredStart = 4;
+const kMaxExpired = 1024;
+const kCommandsStart = kExpiredStart + kMaxExpired;
+const kMaxCommands = 1024;
+
 // Timeout values > TIMEOUT_MAX are set to 1.
 const TIMEOUT_MAX = 2 ** 31 - 1;
 
-let timerListId = Number.MIN_SAFE_INTEGER;
-
 const kRefed = Symbol('refed');
 
 // Create a single linked list instance only once at startup
 const immediateQueue = new ImmediateList();
 
-let nextExpiry = Infinity;
 let refCount = 0;
 
-// This is a priority queue with a custom sorting function that first compares
-// the expiry times of two lists and if they're the same then compares their
-// individual IDs to determine which list was created first.
-const timerListQueue = new PriorityQueue(compareTimersLists, setPosition);
+// Timer lists by the id under which they are kept in the timer wheel. The ids
+// of deleted lists are reused, so that they stay small.
+const timerListsById = [];
+const freeTimerListIds = [];
 
 // Object map containing linked lists of timers, keyed and sorted by their
 // duration in milliseconds.
@@ -143,6 +155,7 @@ function initAsyncResource(resource, type) {
   const asyncId = resource[async_id_symbol] = newAsyncId();
   const triggerAsyncId =
     resource[trigger_async_id_symbol] = getDefaultTriggerAsyncId();
+  resource[context_frame_symbol] = getContextFrame();
   if (initHooksExist())
     emitInit(asyncId, type, triggerAsyncId, resource);
 }
@@ -222,9 +235,10 @@ function TimersList(expiry, msecs) {
   this._idleNext = this; // Create the list with the linkedlist properties to
   this._idlePrev = this; // Prevent any unnecessary hidden class changes.
   this.expiry = expiry;
-  this.id = timerListId++;
+  this.id = freeTimerListIds.length > 0 ?
+    freeTimerListIds.pop() : timerListsById.length;
   this.msecs = msecs;
-  this.priorityQueuePosition = null;
+  timerListsById[this.id] = this;
 }
 
 // Make sure the linked list only shows the minimal necessary information.
@@ -318,11 +332,11 @@ function insert(item, refed, start) {
     debug('no %d list was found in insert, creating a new one', msecs);
     const expiry = start + msecs;
     timerListMap[msecs] = list = new TimersList(expiry, msecs);
-    timerListQueue.insert(list);
+    scheduleTimerList(list);
 
-    if (nextExpiry > expiry) {
+    if (timerInfo[kNextExpiry] > expiry) {
       scheduleTimer(msecs);
-      nextExpiry = expiry;
+      timerInfo[kNextExpiry] = expiry;
     }
   }
 
@@ -372,19 +386,29 @@ function getTimerDuration(msecs, name) {
   return msecs;
 }
 
-function compareTimersLists(a, b) {
-  const expiryDiff = a.expiry - b.expiry;
-  if (expiryDiff === 0) {
-    if (a.id < b.id)
-      return -1;
-    if (a.id > b.id)
-      return 1;
+function writeTimerCommand(id, expiry) {
+  let count = timerInfo[kCommandCount];
+  if (count === kMaxCommands) {
+    flushTimerCommands();
+    count = 0;
   }
-  return expiryDiff;
+  timerInfo[kCommandsStart + 2 * count] = id;
+  timerInfo[kCommandsStart + 2 * count + 1] = expiry;
+  timerInfo[kCommandCount] = count + 1;
+}
+
+// Adds the list to the timer wheel, or moves it to its new expiry. Lists with
+// the same expiry expire in the order in which they were scheduled.
+function scheduleTimerList(list) {
+  writeTimerCommand(list.id, list.expiry);
 }
 
-function setPosition(node, pos) {
-  node.priorityQueuePosition = pos;
+// Removes the list from the object map and from the timer wheel.
+function deleteTimerList(list) {
+  delete timerListMap[list.msecs];
+  writeTimerCommand(list.id, -1);
+  timerListsById[list.id] = undefined;
+  freeTimerListIds.push(list.id);
 }
 
 function getTimerCallbacks(runNextTicks) {
@@ -432,6 +456,7 @@ function getTimerCallbacks(runNextTicks) {
 
       const asyncId = immediate[async_id_symbol];
       emitBefore(asyncId, immediate[trigger_async_id_symbol]);
+      const previousFrame = enterContextFrame(immediate);
 
       try {
         const argv = immediate._argv;
@@ -448,6 +473,7 @@ function getTimerCallbacks(runNextTicks) {
         outstandingQueue.head = immediate = immediate._idleNext;
       }
 
+      exitContextFrame(previousFrame);
       emitAfter(asyncId);
     }
 
@@ -459,22 +485,25 @@ function getTimerCallbacks(runNextTicks) {
 
   function processTimers(now) {
     debug('process timer lists %d', now);
-    nextExpiry = Infinity;
 
-    let list;
+    // The cursor is only advanced once a list has been processed, so that if
+    // a timer throws, the next call continues with the same list.
+    let cursor;
     let ranAtLeastOneList = false;
-    while (list = timerListQueue.peek()) {
-      if (list.expiry > now) {
-        nextExpiry = list.expiry;
-        return refCount > 0 ? nextExpiry : -nextExpiry;
+    while ((cursor = timerInfo[kExpiredCursor]) < timerInfo[kExpiredCount]) {
+      const list = timerListsById[timerInfo[kExpiredStart + cursor]];
+      // The list may have been deleted, or its id reused by a new list, since
+      // it expired.
+      if (list !== undefined && list.expiry <= now) {
+        if (ranAtLeastOneList)
+          runNextTicks();
+        else
+          ranAtLeastOneList = true;
+        listOnTimeout(list, now);
       }
-      if (ranAtLeastOneList)
-        runNextTicks();
-      else
-        ranAtLeastOneList = true;
-      listOnTimeout(list, now);
+      timerInfo[kExpiredCursor] = cursor + 1;
     }
-    return 0;
+    return refCount > 0 ? 1 : -1;
   }
 
   function listOnTimeout(list, now) {
@@ -491,8 +520,7 @@ function getTimerCallbacks(runNextTicks) {
       // This happens if there are more timers scheduled for later in the list.
       if (diff < msecs) {
         list.expiry = Math.max(timer._idleStart + msecs, now + 1);
-        list.id = timerListId++;
-        timerListQueue.percolateDown(1);
+        scheduleTimerList(list);
         debug('%d list wait because diff is %d', msecs, diff);
         return;
       }
@@ -520,6 +548,7 @@ function getTimerCallbacks(runNextTicks) {
       }
 
       emitBefore(asyncId, timer[trigger_async_id_symbol]);
+      const previousFrame = enterContextFrame(timer);
 
       let start;
       if (timer._repeat)
@@ -549,22 +578,21 @@ function getTimerCallbacks(runNextTicks) {
         }
       }
 
+      exitContextFrame(previousFrame);
       emitAfter(asyncId);
     }
 
     // If `L.peek(list)` returned nothing, the list was either empty or we have
     // called all of the timer timeouts.
     // As such, we can remove the list from the object map and
-    // the PriorityQueue.
+    // the timer wheel.
     debug('%d list empty', msecs);
 
     // The current list may have been removed and recreated since the reference
     // to `list` was created. Make sure they're the same instance of the list
     // before destroying.
-    if (list === timerListMap[msecs]) {
-      delete timerListMap[msecs];
-      timerListQueue.shift();
-    }
+    if (list === timerListMap[msecs])
+      deleteTimerList(list);
   }
 
   return {
@@ -593,7 +621,7 @@ module.exports = {
   active,
   unrefActive,
   timerListMap,
-  timerListQueue,
+  deleteTimerList,
   decRefCount,
   incRefCount
 };
@@ -0,0 +1,156 @@
+'use strict';
+
+/* global SharedArrayBuffer */
+
+const { Date, Number, Symbol } = primordials;
+
+const {
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+  ERR_OUT_OF_RANGE
+} = require('internal/errors').codes;
+const {
+  isAnyArrayBuffer,
+  isArrayBufferView,
+  isSharedArrayBuffer
+} = require('internal/util/types');
+const { validateNumber } = require('internal/validators');
+const {
+  kHeaderSize,
+  kMinCapacity,
+  kMaxCapacity,
+  kReadersWaitingIndex,
+  kReadSignalIndex,
+  kWritersWaitingIndex,
+  kWriteSignalIndex,
+  read,
+  write
+} = internalBinding('ring_channel');
+
+const kBuffer = Symbol('kBuffer');
+const kState = Symbol('kState');
+
+function isValidCapacity(capacity) {
+  return Number.isInteger(capacity) &&
+         capacity >= kMinCapacity &&
+         capacity <= kMaxCapacity &&
+         (capacity & (capacity - 1)) === 0;
+}
+
+function validateTimeout(timeout) {
+  validateNumber(timeout, 'timeout');
+  if (!(timeout >= 0))
+    throw new ERR_OUT_OF_RANGE('timeout', '>= 0', timeout);
+}
+
+// Wakes up the threads that are blocked in waitFor() on the other side of
+// the channel, if there are any.
+function wake(state, waitingIndex, signalIndex) {
+  if (Atomics.load(state, waitingIndex) !== 0) {
+    Atomics.add(state, signalIndex, 1);
+    Atomics.notify(state, signalIndex);
+  }
+}
+
+// Calls `attempt` until it returns something other than undefined, and
+// blocks on the signal word in between. Announcing the waiter before the
+// last attempt ensures that the other side either sees it and notifies us,
+// or made its change before our attempt.
+function waitFor(state, waitingIndex, signalIndex, timeout, attempt) {
+  const deadline = timeout === Infinity ? Infinity : Date.now() + timeout;
+  for (;;) {
+    const signal = Atomics.load(state, signalIndex);
+    Atomics.add(state, waitingIndex, 1);
+    try {
+      const result = attempt();
+      if (result !== undefined)
+        return result;
+      const remaining = deadline - Date.now();
+      if (remaining <= 0)
+        return undefined;
+      Atomics.wait(state, signalIndex, signal, remaining);
+    } finally {
+      Atomics.sub(state, waitingIndex, 1);
+    }
+  }
+}
+
+class RingChannel {
+  constructor(bufferOrCapacity) {
+    let buffer;
+    if (typeof bufferOrCapacity === 'number') {
+      if (!isValidCapacity(bufferOrCapacity)) {
+        throw new ERR_OUT_OF_RANGE(
+          'capacity',
+          `a power of two >= ${kMinCapacity} and <= ${kMaxCapacity}`,
+          bufferOrCapacity);
+      }
+      buffer = new SharedArrayBuffer(kHeaderSize + bufferOrCapacity);
+    } else if (isSharedArrayBuffer(bufferOrCapacity)) {
+      buffer = bufferOrCapacity;
+      if (!isValidCapacity(buffer.byteLength - kHeaderSize)) {
+        throw new ERR_INVALID_ARG_VALUE(
+          'buffer', buffer, 'is not the buffer of a RingChannel');
+      }
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(
+        'bufferOrCapacity', ['SharedArrayBuffer', 'number'], bufferOrCapacity);
+    }
+    this[kBuffer] = buffer;
+    this[kState] = new Int32Array(buffer, 0, kHeaderSize / 4);
+  }
+
+  get buffer() {
+    return this[kBuffer];
+  }
+
+  get capacity() {
+    return this[kBuffer].byteLength - kHeaderSize;
+  }
+
+  tryWrite(data) {
+    if (typeof data !== 'string') {
+      if (isAnyArrayBuffer(data)) {
+        data = new Uint8Array(data);
+      } else if (!isArrayBufferView(data)) {
+        throw new ERR_INVALID_ARG_TYPE(
+          'data', ['string', 'Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+          data);
+      }
+    }
+    if (!write(this[kBuffer], data))
+      return false;
+    wake(this[kState], kReadersWaitingIndex, kReadSignalIndex);
+    return true;
+  }
+
+  write(data, timeout = Infinity) {
+    validateTimeout(timeout);
+    if (this.tryWrite(data))
+      return true;
+    const attempt = () => {
+      if (this.tryWrite(data))
+        return true;
+    };
+    return waitFor(this[kState], kWritersWaitingIndex, kWriteSignalIndex,
+                   timeout, attempt) === true;
+  }
+
+  tryRead() {
+    const value = read(this[kBuffer]);
+    if (value !== undefined)
+      wake(this[kState], kWritersWaitingIndex, kWriteSignalIndex);
+    return value;
+  }
+
+  read(timeout = Infinity) {
+    validateTimeout(timeout);
+    const value = this.tryRead();
+    if (value !== undefined)
+      return value;
+    return waitFor(this[kState], kReadersWaitingIndex, kReadSignalIndex,
+                   timeout, () => this.tryRead());
+  }
+}
+
+module.exports = { RingChannel };
@@ -88,6 +88,7 @@ const {
 } = require('internal/errors');
 const { validateInt32, validateString } = require('internal/validators');
 const kLastWriteQueueSize = Symbol('lastWriteQueueSize');
+const kTCPListenOptions = Symbol('kTCPListenOptions');
 const {
   DTRACE_NET_SERVER_CONNECTION,
   DTRACE_NET_STREAM_END
@@ -1161,12 +1162,13 @@ function createServerHandle(address, port, addressType, fd, flags) {
       if (err) {
         handle.close();
         // Fallback to ipv4
-        return createServerHandle(DEFAULT_IPV4_ADDR, port);
+        return createServerHandle(DEFAULT_IPV4_ADDR, port, 4, undefined,
+                                  flags & TCPConstants.REUSEPORT);
       }
     } else if (addressType === 6) {
       err = handle.bind6(address, port, flags);
     } else {
-      err = handle.bind(address, port);
+      err = handle.bind(address, port, flags);
     }
   }
 
@@ -1207,6 +1209,14 @@ function setupListenHandle(address, port, addressType, backlog, fd, flags) {
     if (rval === null)
       rval = createServerHandle(address, port, addressType, fd, flags);
 
+    if (typeof rval !== 'number' && this[kTCPListenOptions] !== undefined) {
+      const err = setTCPListenOptions(rval, this[kTCPListenOptions]);
+      if (err) {
+        rval.close();
+        rval = err;
+      }
+    }
+
     if (typeof rval === 'number') {
       var error = uvExceptionWithHostPort(rval, 'listen', address, port);
       process.nextTick(emitErrorNT, this, error);
@@ -1215,14 +1225,17 @@ function setupListenHandle(address, port, addressType, backlog, fd, flags) {
     this._handle = rval;
   }
 
+  const acceptBatch = this._handle instanceof TCP &&
+                      this[kTCPListenOptions] !== undefined ?
+    this[kTCPListenOptions].acceptBatch : undefined;
   this[async_id_symbol] = getNewAsyncId(this._handle);
-  this._handle.onconnection = onconnection;
+  this._handle.onconnection = acceptBatch ? onconnections : onconnection;
   this._handle[owner_symbol] = this;
 
   // Use a backlog of 512 entries. We pass 511 to the listen() call because
   // the kernel does: backlogsize = roundup_pow_of_two(backlogsize + 1);
   // which will thus give us a backlog of 512 entries.
-  const err = this._handle.listen(backlog || 511);
+  const err = this._handle.listen(backlog || 511, acceptBatch);
 
   if (err) {
     var ex = uvExceptionWithHostPort(err, 'listen', address, port);
@@ -1251,6 +1264,19 @@ function setupListenHandle(address, port, addressType, backlog, fd, flags) {
 
 Server.prototype._listen2 = setupListenHandle;  // legacy alias
 
+// Applies the socket options of a newly bound TCP listener. Returns an error
+// code if one of them cannot be set.
+function setTCPListenOptions(handle, options) {
+  let err = 0;
+  if (options.reusePortGroupSize !== undefined)
+    err = handle.setReusePortGroupSize(options.reusePortGroupSize);
+  if (!err && options.deferAccept !== undefined)
+    err = handle.setDeferAccept(options.deferAccept);
+  if (!err && options.fastOpen !== undefined)
+    err = handle.setFastOpen(options.fastOpen);
+  return err;
+}
+
 function emitErrorNT(self, err) {
   self.emit('error', err);
 }
@@ -1308,6 +1334,7 @@ function listenInCluster(server, address, port, addressType,
 Server.prototype.listen = function(...args) {
   const normalized = normalizeArgs(args);
   var options = normalized[0];
+  this[kTCPListenOptions] = undefined;
   const cb = normalized[1];
 
   if (this._handle) {
@@ -1355,14 +1382,41 @@ Server.prototype.listen = function(...args) {
       throw new ERR_SOCKET_BAD_PORT(options.port);
     }
     backlog = options.backlog || backlogFromArgs;
+    // Every listener of a SO_REUSEPORT group has its own handle, so they
+    // are never shared through the cluster master.
+    const reusePort = options.reusePort === true;
+    const exclusive = options.exclusive || reusePort;
+    const reusePortFlags = reusePort ? TCPConstants.REUSEPORT : 0;
+    if (options.reusePortGroupSize !== undefined) {
+      if (!reusePort) {
+        throw new ERR_INVALID_ARG_VALUE('options.reusePortGroupSize',
+                                        options.reusePortGroupSize,
+                                        'requires options.reusePort');
+      }
+      validateInt32(options.reusePortGroupSize,
+                    'options.reusePortGroupSize', 1);
+    }
+    if (options.acceptBatch !== undefined)
+      validateInt32(options.acceptBatch, 'options.acceptBatch', 0);
+    if (options.deferAccept !== undefined)
+      validateInt32(options.deferAccept, 'options.deferAccept', 0);
+    if (options.fastOpen !== undefined)
+      validateInt32(options.fastOpen, 'options.fastOpen', 0);
+    this[kTCPListenOptions] = {
+      reusePortGroupSize: options.reusePortGroupSize,
+      acceptBatch: options.acceptBatch,
+      deferAccept: options.deferAccept,
+      fastOpen: options.fastOpen
+    };
     // start TCP server listening on host:port
     if (options.host) {
       lookupAndListen(this, options.port | 0, options.host, backlog,
-                      options.exclusive, flags);
+                      exclusive, flags | reusePortFlags);
     } else { // Undefined host, listens on unspecified address
       // Default addressType 4 will be used to search for master server
       listenInCluster(this, null, options.port | 0, 4,
-                      backlog, undefined, options.exclusive);
+                      backlog, undefined, exclusive,
+                      reusePortFlags || undefined);
     }
     return this;
   }
@@ -1474,6 +1528,18 @@ function onconnection(err, clientHandle) {
 }
 
 
+// Called instead of onconnection() by listeners with the acceptBatch option,
+// with all the connections that were accepted in one go.
+function onconnections(err, clientHandles) {
+  if (err) {
+    onconnection.call(this, err);
+    return;
+  }
+  for (var i = 0; i < clientHandles.length; i++)
+    onconnection.call(this, null, clientHandles[i]);
+}
+
+
 Server.prototype.getConnections = function(cb) {
   const self = this;
 
@@ -4,6 +4,7 @@ const { Object } = primordials;
 
 const {
   ELDHistogram: _ELDHistogram,
+  EventLoopMonitor: _EventLoopMonitor,
   PerformanceEntry,
   mark: _mark,
   clearMark: _clearMark,
@@ -31,7 +32,15 @@ const {
   NODE_PERFORMANCE_MILESTONE_LOOP_START,
   NODE_PERFORMANCE_MILESTONE_LOOP_EXIT,
   NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE,
-  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT
+  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT,
+
+  NODE_PERFORMANCE_LOOP_METRIC_IDLE,
+  NODE_PERFORMANCE_LOOP_METRIC_ACTIVE,
+  NODE_PERFORMANCE_LOOP_METRIC_TIMERS,
+  NODE_PERFORMANCE_LOOP_METRIC_POLL,
+  NODE_PERFORMANCE_LOOP_METRIC_CHECK,
+  NODE_PERFORMANCE_LOOP_METRIC_CLOSE,
+  NODE_PERFORMANCE_LOOP_METRIC_INVALID
 } = constants;
 
 const { AsyncResource } = require('async_hooks');
@@ -50,6 +59,8 @@ const {
 const { setImmediate } = require('timers');
 const kHandle = Symbol('handle');
 const kMap = Symbol('map');
+const kMetrics = Symbol('metrics');
+const kCallbackHistogram = Symbol('callback-histogram');
 const kCallback = Symbol('callback');
 const kTypes = Symbol('types');
 const kEntries = Symbol('entries');
@@ -548,17 +559,12 @@ function sortedInsert(list, entry) {
   list.splice(location, 0, entry);
 }
 
-class ELDHistogram {
+class Histogram {
   constructor(handle) {
     this[kHandle] = handle;
     this[kMap] = new Map();
   }
 
-  reset() { this[kHandle].reset(); }
-  enable() { return this[kHandle].enable(); }
-  disable() { return this[kHandle].disable(); }
-
-  get exceeds() { return this[kHandle].exceeds(); }
   get min() { return this[kHandle].min(); }
   get max() { return this[kHandle].max(); }
   get mean() { return this[kHandle].mean(); }
@@ -585,12 +591,79 @@ class ELDHistogram {
       max: this.max,
       mean: this.mean,
       stddev: this.stddev,
-      percentiles: this.percentiles,
-      exceeds: this.exceeds
+      percentiles: this.percentiles
+    };
+  }
+}
+
+class ELDHistogram extends Histogram {
+  reset() { this[kHandle].reset(); }
+  enable() { return this[kHandle].enable(); }
+  disable() { return this[kHandle].disable(); }
+
+  get exceeds() { return this[kHandle].exceeds(); }
+
+  [kInspect]() {
+    const inspected = super[kInspect]();
+    inspected.exceeds = this.exceeds;
+    return inspected;
+  }
+}
+
+class EventLoopUtilizationMonitor {
+  constructor(handle) {
+    this[kHandle] = handle;
+    this[kMetrics] = new Float64Array(NODE_PERFORMANCE_LOOP_METRIC_INVALID);
+    this[kCallbackHistogram] = new Histogram(handle);
+  }
+
+  reset() { this[kHandle].reset(); }
+  enable() { return this[kHandle].enable(); }
+  disable() { return this[kHandle].disable(); }
+
+  get idle() {
+    return getLoopMetrics(this)[NODE_PERFORMANCE_LOOP_METRIC_IDLE];
+  }
+  get active() {
+    return getLoopMetrics(this)[NODE_PERFORMANCE_LOOP_METRIC_ACTIVE];
+  }
+  get utilization() {
+    const metrics = getLoopMetrics(this);
+    const idle = metrics[NODE_PERFORMANCE_LOOP_METRIC_IDLE];
+    const active = metrics[NODE_PERFORMANCE_LOOP_METRIC_ACTIVE];
+    return idle + active > 0 ? active / (idle + active) : 0;
+  }
+  get phases() {
+    const metrics = getLoopMetrics(this);
+    return {
+      timers: metrics[NODE_PERFORMANCE_LOOP_METRIC_TIMERS],
+      poll: metrics[NODE_PERFORMANCE_LOOP_METRIC_POLL],
+      check: metrics[NODE_PERFORMANCE_LOOP_METRIC_CHECK],
+      close: metrics[NODE_PERFORMANCE_LOOP_METRIC_CLOSE]
+    };
+  }
+  get callbacks() { return this[kCallbackHistogram]; }
+
+  [kInspect]() {
+    return {
+      idle: this.idle,
+      active: this.active,
+      utilization: this.utilization,
+      phases: this.phases,
+      callbacks: this.callbacks
     };
   }
 }
 
+// Returns the metrics of the monitor, in milliseconds.
+function getLoopMetrics(monitor) {
+  const metrics = monitor[kMetrics];
+  monitor[kHandle].metrics(metrics);
+  for (let i = 0; i < metrics.length; i++)
+    metrics[i] /= 1e6;
+  return metrics;
+}
+
 function monitorEventLoopDelay(options = {}) {
   if (typeof options !== 'object' || options === null) {
     throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
@@ -606,10 +679,15 @@ function monitorEventLoopDelay(options = {}) {
   return new ELDHistogram(new _ELDHistogram(resolution));
 }
 
+function monitorEventLoopUtilization() {
+  return new EventLoopUtilizationMonitor(new _EventLoopMonitor());
+}
+
 module.exports = {
   performance,
   PerformanceObserver,
-  monitorEventLoopDelay
+  monitorEventLoopDelay,
+  monitorEventLoopUtilization
 };
 
 Object.defineProperty(module.exports, 'constants', {
@@ -40,7 +40,7 @@ const {
   initAsyncResource,
   getTimerDuration,
   timerListMap,
-  timerListQueue,
+  deleteTimerList,
   immediateQueue,
   active,
   unrefActive
@@ -81,8 +81,7 @@ function unenroll(item) {
     const list = timerListMap[msecs];
     if (list !== undefined && L.isEmpty(list)) {
       debug('unenroll: list empty');
-      timerListQueue.removeAt(list.priorityQueuePosition);
-      delete timerListMap[list.msecs];
+      deleteTimerList(list);
     }
 
     decRefCount();
@@ -14,12 +14,20 @@ const {
   receiveMessageOnPort
 } = require('internal/worker/io');
 
+let RingChannel;
+
 module.exports = {
   isMainThread,
   MessagePort,
   MessageChannel,
   moveMessagePortToContext,
   receiveMessageOnPort,
+  get RingChannel() {
+    // Loaded lazily so that workers that do not use it don't pay for it.
+    if (RingChannel === undefined)
+      ({ RingChannel } = require('internal/worker/ring_channel'));
+    return RingChannel;
+  },
   threadId,
   SHARE_ENV,
   Worker,
@@ -145,8 +145,10 @@
       'lib/internal/main/prof_process.js',
       'lib/internal/main/repl.js',
       'lib/internal/main/run_main_module.js',
+      'lib/internal/main/run_snapshot_main.js',
       'lib/internal/main/run_third_party_main.js',
       'lib/internal/main/worker_thread.js',
+      'lib/internal/modules/cjs/code_cache.js',
       'lib/internal/modules/cjs/helpers.js',
       'lib/internal/modules/cjs/loader.js',
       'lib/internal/modules/esm/loader.js',
@@ -202,6 +204,7 @@
       'lib/internal/vm/source_text_module.js',
       'lib/internal/worker.js',
       'lib/internal/worker/io.js',
+      'lib/internal/worker/ring_channel.js',
       'lib/internal/streams/lazy_transform.js',
       'lib/internal/streams/async_iterator.js',
       'lib/internal/streams/buffer_list.js',
@@ -527,6 +530,7 @@
         'src/node_constants.cc',
         'src/node_contextify.cc',
         'src/node_credentials.cc',
+        'src/node_dns_cache.cc',
         'src/node_domain.cc',
         'src/node_env_var.cc',
         'src/node_errors.cc',
@@ -534,6 +538,7 @@
         'src/node_http_parser_llhttp.cc',
         'src/node_http_parser_traditional.cc',
         'src/node_http2.cc',
+        'src/node_huge_page_pool.cc',
         'src/node_i18n.cc',
         'src/node_main_instance.cc',
         'src/node_messaging.cc',
@@ -545,10 +550,13 @@
         'src/node_perf.cc',
         'src/node_platform.cc',
         'src/node_postmortem_metadata.cc',
+        'src/node_pprof.cc',
         'src/node_process_events.cc',
         'src/node_process_methods.cc',
         'src/node_process_object.cc',
+        'src/node_ring_channel.cc',
         'src/node_serdes.cc',
+        'src/node_size_class_pool.cc',
         'src/node_stat_watcher.cc',
         'src/node_symbols.cc',
         'src/node_task_queue.cc',
@@ -564,6 +572,7 @@
         'src/process_wrap.cc',
         'src/sharedarraybuffer_metadata.cc',
         'src/signal_wrap.cc',
+        'src/simd_codecs.cc',
         'src/spawn_sync.cc',
         'src/stream_base.cc',
         'src/stream_pipe.cc',
@@ -571,10 +580,13 @@
         'src/string_bytes.cc',
         'src/string_decoder.cc',
         'src/tcp_wrap.cc',
+        'src/threadpoolwork.cc',
+        'src/timer_wheel.cc',
         'src/timers.cc',
         'src/tracing/agent.cc',
         'src/tracing/node_trace_buffer.cc',
         'src/tracing/node_trace_writer.cc',
+        'src/tracing/perfetto_trace_writer.cc',
         'src/tracing/trace_event.cc',
         'src/tracing/traced_value.cc',
         'src/tty_wrap.cc',
@@ -609,11 +621,13 @@
         'src/node_constants.h',
         'src/node_context_data.h',
         'src/node_contextify.h',
+        'src/node_dns_cache.h',
         'src/node_errors.h',
         'src/node_file.h',
         'src/node_http_parser_impl.h',
         'src/node_http2.h',
         'src/node_http2_state.h',
+        'src/node_huge_page_pool.h',
         'src/node_i18n.h',
         'src/node_internals.h',
         'src/node_main_instance.h',
@@ -628,10 +642,13 @@
         'src/node_options-inl.h',
         'src/node_perf.h',
         'src/node_perf_common.h',
+        'src/node_perf_loop.h',
         'src/node_platform.h',
+        'src/node_pprof.h',
         'src/node_process.h',
         'src/node_revert.h',
         'src/node_root_certs.h',
+        'src/node_size_class_pool.h',
         'src/node_stat_watcher.h',
         'src/node_union_bytes.h',
         'src/node_url.h',
@@ -643,6 +660,7 @@
         'src/req_wrap.h',
         'src/req_wrap-inl.h',
         'src/sharedarraybuffer_metadata.h',
+        'src/simd_codecs.h',
         'src/spawn_sync.h',
         'src/stream_base.h',
         'src/stream_base-inl.h',
@@ -653,9 +671,11 @@
         'src/string_decoder-inl.h',
         'src/string_search.h',
         'src/tcp_wrap.h',
+        'src/timer_wheel.h',
         'src/tracing/agent.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
+        'src/tracing/perfetto_trace_writer.h',
         'src/tracing/trace_event.h',
         'src/tracing/trace_event_common.h',
         'src/tracing/traced_value.h',
@@ -1108,12 +1128,19 @@
         'test/cctest/node_test_fixture.h',
         'test/cctest/test_aliased_buffer.cc',
         'test/cctest/test_base64.cc',
+        'test/cctest/test_dns_cache.cc',
         'test/cctest/test_node_postmortem_metadata.cc',
+        'test/cctest/test_node_trace_buffer.cc',
         'test/cctest/test_environment.cc',
+        'test/cctest/test_huge_page_pool.cc',
+        'test/cctest/test_size_class_pool.cc',
         'test/cctest/test_linked_binding.cc',
         'test/cctest/test_per_process.cc',
         'test/cctest/test_platform.cc',
+        'test/cctest/test_pprof.cc',
         'test/cctest/test_report_util.cc',
+        'test/cctest/test_simd_codecs.cc',
+        'test/cctest/test_timer_wheel.cc',
         'test/cctest/test_traced_value.cc',
         'test/cctest/test_util.cc',
         'test/cctest/test_url.cc',
@@ -1,6 +1,7 @@
 #include "node.h"
 #include "async_wrap-inl.h"
 #include "env-inl.h"
+#include "node_perf_loop.h"
 #include "v8.h"
 
 namespace node {
@@ -68,10 +69,21 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
   env->async_hooks()->push_async_ids(async_context_.async_id,
                                async_context_.trigger_async_id);
   pushed_ids_ = true;
+
+  // Only the outermost callbacks are measured, together with the ticks and
+  // microtasks that are run when they close.
+  if (env->async_callback_scope_depth() == 1 &&
+      performance::IsEventLoopObserved(env)) {
+    start_time_ = PERFORMANCE_NOW();
+    performance::ReportCallbackStart(env, start_time_);
+  }
 }
 
 InternalCallbackScope::~InternalCallbackScope() {
   Close();
+  if (start_time_ != 0) {
+    performance::ReportCallbackEnd(env_, start_time_, PERFORMANCE_NOW());
+  }
 }
 
 void InternalCallbackScope::Close() {
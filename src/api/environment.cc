@@ -81,13 +81,65 @@ static MaybeLocal<Value> PrepareStackTraceCallback(Local<Context> context,
   return result;
 }
 
+NodeArrayBufferAllocator::NodeArrayBufferAllocator() {
+  if (per_process::cli_options->huge_page_buffers &&
+      HugePagePool::IsSupported()) {
+    huge_pages_ = std::make_unique<HugePagePool>();
+  }
+  if (per_process::cli_options->arraybuffer_pool &&
+      SizeClassPool::IsSupported()) {
+    size_class_pool_ = std::make_unique<SizeClassPool>();
+  }
+}
+
 void* NodeArrayBufferAllocator::Allocate(size_t size) {
-  if (zero_fill_field_ || per_process::cli_options->zero_fill_all_buffers)
+  const bool zero_fill =
+      zero_fill_field_ || per_process::cli_options->zero_fill_all_buffers;
+  if (huge_pages_ && size >= HugePagePool::kMinSize)
+    return huge_pages_->Allocate(size, zero_fill);
+  if (size_class_pool_ && size <= SizeClassPool::kMaxSize)
+    return size_class_pool_->Allocate(size, zero_fill);
+  if (zero_fill)
     return UncheckedCalloc(size);
   else
     return UncheckedMalloc(size);
 }
 
+void* NodeArrayBufferAllocator::AllocateUninitialized(size_t size) {
+  if (huge_pages_ && size >= HugePagePool::kMinSize)
+    return huge_pages_->Allocate(size, false);
+  if (size_class_pool_ && size <= SizeClassPool::kMaxSize)
+    return size_class_pool_->Allocate(size, false);
+  return UncheckedMalloc(size);
+}
+
+void NodeArrayBufferAllocator::Free(void* data, size_t size) {
+  if (huge_pages_ && size >= HugePagePool::kMinSize &&
+      huge_pages_->Free(data)) {
+    return;
+  }
+  if (size_class_pool_ && size_class_pool_->Free(data, size))
+    return;
+  free(data);
+}
+
+void* NodeArrayBufferAllocator::Reallocate(void* data,
+                                           size_t old_size,
+                                           size_t size) {
+  // A reallocated block is an ordinary malloc() allocation.
+  if (huge_pages_ && old_size >= HugePagePool::kMinSize)
+    huge_pages_->Release(data);
+  return static_cast<void*>(
+      UncheckedRealloc<char>(static_cast<char*>(data), size));
+}
+
+void NodeArrayBufferAllocator::UnregisterPointer(void* data, size_t size) {
+  // The block leaves the pool, so that it is neither counted as in use nor
+  // mistaken for a pool block if malloc() returns its address again.
+  if (huge_pages_ && size >= HugePagePool::kMinSize)
+    huge_pages_->Release(data);
+}
+
 DebuggingArrayBufferAllocator::~DebuggingArrayBufferAllocator() {
   CHECK(allocations_.empty());
 }
@@ -141,6 +193,7 @@ void DebuggingArrayBufferAllocator::RegisterPointer(void* data, size_t size) {
 void DebuggingArrayBufferAllocator::UnregisterPointer(void* data, size_t size) {
   Mutex::ScopedLock lock(mutex_);
   UnregisterPointerInternal(data, size);
+  NodeArrayBufferAllocator::UnregisterPointer(data, size);
 }
 
 void DebuggingArrayBufferAllocator::UnregisterPointerInternal(void* data,
@@ -168,4 +168,13 @@ const char* signo_string(int signo) {
   }
 }
 
+int signo_number(const std::string& name) {
+  // Real-time signals have no names, so the numbers of the others are small.
+  for (int signo = 1; signo < 64; signo++) {
+    if (name == signo_string(signo))
+      return signo;
+  }
+  return 0;
+}
+
 }  // namespace node
@@ -46,6 +46,7 @@ using v8::Object;
 using v8::ObjectTemplate;
 using v8::Promise;
 using v8::PromiseHookType;
+using v8::Private;
 using v8::PropertyAttribute;
 using v8::PropertyCallbackInfo;
 using v8::ReadOnly;
@@ -226,12 +227,37 @@ static PromiseWrap* extractPromiseWrap(Local<Promise> promise) {
   return nullptr;
 }
 
+// Promise reactions run in the async context frame that was current when the
+// promise was created.
+static void PropagateContextFrame(Environment* env,
+                                  Local<Context> context,
+                                  PromiseHookType type,
+                                  Local<Promise> promise) {
+  AsyncHooks* async_hooks = env->async_hooks();
+  Local<Private> key = env->async_context_frame_private_symbol();
+  if (type == PromiseHookType::kInit) {
+    Local<Value> frame = async_hooks->context_frame();
+    if (!frame.IsEmpty())
+      USE(promise->SetPrivate(context, key, frame));
+  } else if (type == PromiseHookType::kBefore) {
+    Local<Value> frame;
+    if (!promise->GetPrivate(context, key).ToLocal(&frame))
+      frame = Local<Value>();
+    async_hooks->push_context_frame(frame);
+  } else if (type == PromiseHookType::kAfter) {
+    async_hooks->pop_context_frame();
+  }
+}
+
 static void PromiseHook(PromiseHookType type, Local<Promise> promise,
                         Local<Value> parent) {
   Local<Context> context = promise->CreationContext();
 
   Environment* env = Environment::GetCurrent(context);
   if (env == nullptr) return;
+  if (env->async_hooks()->context_frames_enabled())
+    PropagateContextFrame(env, context, type, promise);
+  if (!env->async_hooks()->promise_hook_enabled()) return;
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "EnvPromiseHook", env);
 
@@ -326,18 +352,52 @@ static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void UpdatePromiseHook(Environment* env) {
+  AsyncHooks* async_hooks = env->async_hooks();
+  // The per-Isolate API provides no way of knowing whether there are multiple
+  // users of the PromiseHook. That hopefully goes away when V8 introduces
+  // a per-context API.
+  if (async_hooks->promise_hook_enabled() ||
+      async_hooks->context_frames_enabled()) {
+    env->isolate()->SetPromiseHook(PromiseHook);
+  } else {
+    env->isolate()->SetPromiseHook(nullptr);
+  }
+}
+
+
 static void EnablePromiseHook(const FunctionCallbackInfo<Value>& args) {
-  args.GetIsolate()->SetPromiseHook(PromiseHook);
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_promise_hook_enabled(true);
+  UpdatePromiseHook(env);
 }
 
 
 static void DisablePromiseHook(const FunctionCallbackInfo<Value>& args) {
-  Isolate* isolate = args.GetIsolate();
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_promise_hook_enabled(false);
+  UpdatePromiseHook(env);
+}
 
-  // The per-Isolate API provides no way of knowing whether there are multiple
-  // users of the PromiseHook. That hopefully goes away when V8 introduces
-  // a per-context API.
-  isolate->SetPromiseHook(nullptr);
+
+static void EnableContextFrames(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_context_frames_enabled(true);
+  UpdatePromiseHook(env);
+}
+
+
+static void GetContextFrame(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Value> frame = env->async_hooks()->context_frame();
+  if (!frame.IsEmpty())
+    args.GetReturnValue().Set(frame);
+}
+
+
+static void SetContextFrame(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_context_frame(args[0]);
 }
 
 
@@ -470,6 +530,9 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "queueDestroyAsyncId", QueueDestroyAsyncId);
   env->SetMethod(target, "enablePromiseHook", EnablePromiseHook);
   env->SetMethod(target, "disablePromiseHook", DisablePromiseHook);
+  env->SetMethod(target, "enableContextFrames", EnableContextFrames);
+  env->SetMethod(target, "getContextFrame", GetContextFrame);
+  env->SetMethod(target, "setContextFrame", SetContextFrame);
   env->SetMethod(target, "registerDestroyHook", RegisterDestroyHook);
 
   PropertyAttribute ReadOnlyDontDelete =
@@ -648,6 +711,8 @@ void AsyncWrap::AsyncReset(Local<Object> resource, double execution_async_id,
   async_id_ = execution_async_id == kInvalidAsyncId ? env()->new_async_id()
                                                      : execution_async_id;
   trigger_async_id_ = env()->get_default_trigger_async_id();
+  context_frame_.Reset(env()->isolate(),
+                       env()->async_hooks()->context_frame());
 
   switch (provider_type()) {
 #define V(PROVIDER)                                                           \
@@ -715,8 +780,11 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
 
   ProviderType provider = provider_type();
   async_context context { get_async_id(), get_trigger_async_id() };
-  MaybeLocal<Value> ret = InternalMakeCallback(
-      env(), object(), cb, argc, argv, context);
+  MaybeLocal<Value> ret;
+  {
+    AsyncHooks::ContextFrameScope frame_scope(env(), context_frame_);
+    ret = InternalMakeCallback(env(), object(), cb, argc, argv, context);
+  }
 
   // This is a static call with cached values because the `this` object may
   // no longer be alive at this point.
@@ -3,6 +3,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "simd_codecs.h"
 #include "util.h"
 
 #include <cstddef>
@@ -85,6 +86,23 @@ bool base64_decode_group_slow(char* const dst, const size_t dstlen,
 }
 
 
+// Decodes the leading run of whole groups with the vectorized kernel. Only
+// one-byte input is handled there, two-byte strings always take the scalar
+// path.
+template <typename TypeName>
+inline size_t base64_decode_blocks(char* const dst, const size_t dstlen,
+                                   const TypeName* const src,
+                                   const size_t srclen) {
+  return 0;
+}
+
+template <>
+inline size_t base64_decode_blocks(char* const dst, const size_t dstlen,
+                                   const char* const src,
+                                   const size_t srclen) {
+  return simd::Base64Decode(src, srclen, dst, dstlen);
+}
+
 template <typename TypeName>
 size_t base64_decode_fast(char* const dst, const size_t dstlen,
                           const TypeName* const src, const size_t srclen,
@@ -95,6 +113,13 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
   size_t i = 0;
   size_t k = 0;
   while (i < max_i && k < max_k) {
+    const size_t n = base64_decode_blocks(dst + k, max_k - k,
+                                          src + i, max_i - i);
+    i += n;
+    k += n / 4 * 3;
+    if (i >= max_i || k >= max_k)
+      break;
+
     const uint32_t v =
         unbase64(src[i + 0]) << 24 |
         unbase64(src[i + 1]) << 16 |
@@ -148,9 +173,9 @@ static size_t base64_encode(const char* src,
                               "abcdefghijklmnopqrstuvwxyz"
                               "0123456789+/";
 
-  i = 0;
-  k = 0;
   n = slen / 3 * 3;
+  i = simd::Base64Encode(src, n, dst);
+  k = i / 3 * 4;
 
   while (i < n) {
     a = src[i + 0] & 0xff;
@@ -25,13 +25,18 @@
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
 #include "node.h"
+#include "node_dns_cache.h"
+#include "node_options.h"
 #include "req_wrap-inl.h"
 #include "util-inl.h"
 #include "uv.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <unordered_set>
 
@@ -59,6 +64,7 @@ namespace cares_wrap {
 using v8::Array;
 using v8::Context;
 using v8::EscapableHandleScope;
+using v8::Float64Array;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
@@ -121,7 +127,17 @@ inline const char* ToErrorCodeString(int status) {
   return "UNKNOWN_ARES_ERROR";
 }
 
+DnsCache* GetDnsCache() {
+  // The options do not change after startup. The cache is shared by all
+  // threads and is intentionally never destroyed.
+  static DnsCache* cache = new DnsCache(static_cast<uint32_t>(
+      std::min<uint64_t>(per_process::cli_options->dns_cache_max_ttl,
+                         UINT32_MAX)));
+  return cache;
+}
+
 class ChannelWrap;
+class QueryWrap;
 
 struct node_ares_task : public MemoryRetainer {
   ChannelWrap* channel;
@@ -171,6 +187,17 @@ class ChannelWrap : public AsyncWrap {
   inline int active_query_count() { return active_query_count_; }
   inline node_ares_task_list* task_list() { return &task_list_; }
 
+  // Returns the key under which the answers to a query are cached. It
+  // includes the servers of the channel, since they differ between Resolvers.
+  std::string QueryCacheKey(const char* name, int dnsclass, int type);
+  inline void ServersChanged() { servers_key_.clear(); }
+  // Identical queries that are in flight while the cache is enabled, keyed by
+  // their cache key. Only the first one of each was sent.
+  inline std::unordered_map<std::string, std::vector<QueryWrap*>>*
+      pending_queries() {
+    return &pending_queries_;
+  }
+
   void MemoryInfo(MemoryTracker* tracker) const override {
     if (timer_handle_ != nullptr)
       tracker->TrackField("timer_handle", *timer_handle_);
@@ -190,6 +217,8 @@ class ChannelWrap : public AsyncWrap {
   bool library_inited_;
   int active_query_count_;
   node_ares_task_list task_list_;
+  std::string servers_key_;
+  std::unordered_map<std::string, std::vector<QueryWrap*>> pending_queries_;
 };
 
 ChannelWrap::ChannelWrap(Environment* env,
@@ -220,16 +249,42 @@ class GetAddrInfoReqWrap : public ReqWrap<uv_getaddrinfo_t> {
                      Local<Object> req_wrap_obj,
                      bool verbatim);
 
+  ~GetAddrInfoReqWrap() override;
+
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(GetAddrInfoReqWrap)
   SET_SELF_SIZE(GetAddrInfoReqWrap)
 
   bool verbatim() const { return verbatim_; }
 
+  // Returns false if an identical lookup is already in flight. This one is
+  // then completed along with it instead of being dispatched.
+  bool AddPendingLookup(std::string&& cache_key);
+  // Caches the result of a dispatched lookup and returns the lookups that
+  // were waiting for it.
+  std::vector<GetAddrInfoReqWrap*> FinishPendingLookup(
+      int status, const std::vector<std::string>& addresses);
+  // Completes the lookup with a result from the cache, asynchronously.
+  void CompleteFromCache(DnsCache::Entry&& entry);
+  void Complete(int status, const std::vector<std::string>& addresses);
+
  private:
+  // Identical lookups are only coalesced within the same Environment.
+  std::string PendingKey() const;
+  void RemovePendingLookup();
+
   const bool verbatim_;
+  // Set while this lookup is in `pending_lookups`.
+  std::string cache_key_;
+  DnsCache::Entry cached_entry_;
 };
 
+// getaddrinfo() lookups that are in flight while the cache is enabled. Only
+// the first one of each key was dispatched.
+Mutex pending_lookups_mutex;
+std::unordered_map<std::string, std::vector<GetAddrInfoReqWrap*>>
+    pending_lookups;
+
 GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
                                        Local<Object> req_wrap_obj,
                                        bool verbatim)
@@ -237,6 +292,116 @@ GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
     , verbatim_(verbatim) {
 }
 
+GetAddrInfoReqWrap::~GetAddrInfoReqWrap() {
+  if (!cache_key_.empty())
+    RemovePendingLookup();
+}
+
+std::string GetAddrInfoReqWrap::PendingKey() const {
+  return std::to_string(reinterpret_cast<uintptr_t>(env())) + ' ' +
+         cache_key_;
+}
+
+bool GetAddrInfoReqWrap::AddPendingLookup(std::string&& cache_key) {
+  cache_key_ = std::move(cache_key);
+  Mutex::ScopedLock lock(pending_lookups_mutex);
+  std::vector<GetAddrInfoReqWrap*>& pending = pending_lookups[PendingKey()];
+  pending.push_back(this);
+  return pending.size() == 1;
+}
+
+std::vector<GetAddrInfoReqWrap*> GetAddrInfoReqWrap::FinishPendingLookup(
+    int status, const std::vector<std::string>& addresses) {
+  std::vector<GetAddrInfoReqWrap*> waiting;
+  if (cache_key_.empty())
+    return waiting;
+  {
+    Mutex::ScopedLock lock(pending_lookups_mutex);
+    auto it = pending_lookups.find(PendingKey());
+    if (it != pending_lookups.end()) {
+      waiting = std::move(it->second);
+      pending_lookups.erase(it);
+    }
+  }
+  waiting.erase(std::remove(waiting.begin(), waiting.end(), this),
+                waiting.end());
+  for (GetAddrInfoReqWrap* req_wrap : waiting)
+    req_wrap->cache_key_.clear();
+
+  const bool negative = status == UV_EAI_NONAME || status == UV_EAI_NODATA;
+  if (status == 0 || negative) {
+    DnsCache::Entry entry;
+    entry.status = status;
+    entry.addresses = addresses;
+    // getaddrinfo() does not report TTLs, so answers are kept for as long as
+    // the cache allows.
+    GetDnsCache()->Insert(cache_key_, std::move(entry), UINT32_MAX,
+                          uv_hrtime());
+  }
+  cache_key_.clear();
+  return waiting;
+}
+
+void GetAddrInfoReqWrap::RemovePendingLookup() {
+  Mutex::ScopedLock lock(pending_lookups_mutex);
+  auto it = pending_lookups.find(PendingKey());
+  if (it == pending_lookups.end())
+    return;
+  std::vector<GetAddrInfoReqWrap*>& pending = it->second;
+  if (pending[0] == this) {
+    // The identical lookups would never complete.
+    for (GetAddrInfoReqWrap* req_wrap : pending)
+      req_wrap->cache_key_.clear();
+    pending_lookups.erase(it);
+  } else {
+    pending.erase(std::remove(pending.begin(), pending.end(), this),
+                  pending.end());
+  }
+  cache_key_.clear();
+}
+
+void GetAddrInfoReqWrap::CompleteFromCache(DnsCache::Entry&& entry) {
+  cached_entry_ = std::move(entry);
+  env()->SetImmediate([](Environment*, void* data) {
+    std::unique_ptr<GetAddrInfoReqWrap> req_wrap {
+        static_cast<GetAddrInfoReqWrap*>(data)};
+    req_wrap->Complete(req_wrap->cached_entry_.status,
+                       req_wrap->cached_entry_.addresses);
+  }, this, object());
+}
+
+void GetAddrInfoReqWrap::Complete(int status,
+                                  const std::vector<std::string>& addresses) {
+  // Every lookup ends here, whether it was dispatched, coalesced with an
+  // identical one or answered from the cache.
+  TRACE_EVENT_NESTABLE_ASYNC_END2(
+      TRACING_CATEGORY_NODE2(dns, native), "lookup", this,
+      "count", addresses.size(), "verbatim", verbatim());
+
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+
+  Local<Value> argv[] = {
+    Integer::New(env()->isolate(), status),
+    Null(env()->isolate())
+  };
+
+  if (status == 0) {
+    Local<Array> results = Array::New(env()->isolate(), addresses.size());
+    for (size_t i = 0; i < addresses.size(); i++) {
+      results->Set(env()->context(),
+                   i,
+                   OneByteString(env()->isolate(),
+                                 addresses[i].data(),
+                                 addresses[i].size())).Check();
+    }
+    argv[1] = results;
+  }
+
+  // Make the callback into JavaScript
+  MakeCallback(env()->oncomplete_string(), arraysize(argv), argv);
+}
+
 
 class GetNameInfoReqWrap : public ReqWrap<uv_getnameinfo_t> {
  public:
@@ -452,8 +617,6 @@ void cares_wrap_hostent_cpy(struct hostent* dest, const struct hostent* src) {
   dest->h_addrtype = src->h_addrtype;
 }
 
-class QueryWrap;
-
 void ChannelWrap::Setup() {
   struct ares_options options;
   memset(&options, 0, sizeof(options));
@@ -483,6 +646,7 @@ void ChannelWrap::Setup() {
   }
 
   library_inited_ = true;
+  ServersChanged();
 }
 
 void ChannelWrap::StartTimer() {
@@ -568,6 +732,27 @@ void ChannelWrap::EnsureServers() {
   Setup();
 }
 
+std::string ChannelWrap::QueryCacheKey(const char* name,
+                                       int dnsclass,
+                                       int type) {
+  if (servers_key_.empty()) {
+    ares_addr_port_node* servers = nullptr;
+    ares_get_servers_ports(channel_, &servers);
+    for (ares_addr_port_node* cur = servers; cur != nullptr; cur = cur->next) {
+      char ip[INET6_ADDRSTRLEN];
+      if (uv_inet_ntop(cur->family, &cur->addr, ip, sizeof(ip)) != 0)
+        continue;
+      servers_key_ += ip;
+      servers_key_ += ':' + std::to_string(cur->udp_port) + ',';
+    }
+    ares_free_data(servers);
+    // Make sure that the key is not recomputed if there are no servers.
+    servers_key_ += ';';
+  }
+  return servers_key_ + std::to_string(dnsclass) + ' ' +
+         std::to_string(type) + ' ' + name;
+}
+
 
 class QueryWrap : public AsyncWrap {
  public:
@@ -587,6 +772,9 @@ class QueryWrap : public AsyncWrap {
     // Let Callback() know that this object no longer exists.
     if (callback_ptr_ != nullptr)
       *callback_ptr_ = nullptr;
+
+    if (!cache_key_.empty())
+      RemovePendingQuery();
   }
 
   // Subclasses should implement the appropriate Send method.
@@ -608,10 +796,89 @@ class QueryWrap : public AsyncWrap {
     TRACE_EVENT_NESTABLE_ASYNC_BEGIN1(
       TRACING_CATEGORY_NODE2(dns, native), trace_name_, this,
       "name", TRACE_STR_COPY(name));
+
+    DnsCache* cache = GetDnsCache();
+    if (cache->enabled()) {
+      std::string key = channel_->QueryCacheKey(name, dnsclass, type);
+      DnsCache::Entry entry;
+      if (cache->Lookup(key, uv_hrtime(), &entry)) {
+        SetResponse(entry.status,
+                    reinterpret_cast<const unsigned char*>(entry.answer.data()),
+                    entry.answer.size());
+        QueueResponseCallback(entry.status);
+        return;
+      }
+
+      std::vector<QueryWrap*>& pending =
+          (*channel_->pending_queries())[key];
+      pending.push_back(this);
+      cache_key_ = std::move(key);
+      if (pending.size() > 1) {
+        cache->RecordCoalesced();
+        return;
+      }
+    }
+
     ares_query(channel_->cares_channel(), name, dnsclass, type, Callback,
                MakeCallbackPointer());
   }
 
+  // Passes the response to the identical queries that were made while this
+  // one was in flight, and caches it if it is an answer or says that the
+  // name or record does not exist.
+  void ShareResponse(int status,
+                     const unsigned char* answer_buf,
+                     int answer_len) {
+    const std::string key = std::move(cache_key_);
+    cache_key_.clear();
+    std::vector<QueryWrap*> pending;
+    auto it = channel_->pending_queries()->find(key);
+    if (it != channel_->pending_queries()->end()) {
+      pending = std::move(it->second);
+      channel_->pending_queries()->erase(it);
+    }
+    for (QueryWrap* wrap : pending) {
+      if (wrap == this)
+        continue;
+      wrap->cache_key_.clear();
+      wrap->SetResponse(status, answer_buf, answer_len);
+      wrap->QueueResponseCallback(status);
+    }
+
+    if (answer_buf == nullptr ||
+        (status != ARES_SUCCESS &&
+         status != ARES_ENOTFOUND &&
+         status != ARES_ENODATA)) {
+      return;
+    }
+    DnsCache::Entry entry;
+    entry.status = status;
+    if (status == ARES_SUCCESS)
+      entry.answer.assign(reinterpret_cast<const char*>(answer_buf),
+                          answer_len);
+    GetDnsCache()->Insert(key,
+                          std::move(entry),
+                          DnsCache::ResponseTtl(answer_buf, answer_len),
+                          uv_hrtime());
+  }
+
+  void RemovePendingQuery() {
+    auto it = channel_->pending_queries()->find(cache_key_);
+    if (it == channel_->pending_queries()->end())
+      return;
+    std::vector<QueryWrap*>& pending = it->second;
+    if (pending[0] == this) {
+      // The identical queries would never get a response.
+      for (QueryWrap* wrap : pending)
+        wrap->cache_key_.clear();
+      channel_->pending_queries()->erase(it);
+    } else {
+      pending.erase(std::remove(pending.begin(), pending.end(), this),
+                    pending.end());
+    }
+    cache_key_.clear();
+  }
+
   struct ResponseData {
     int status;
     bool is_host;
@@ -654,19 +921,25 @@ class QueryWrap : public AsyncWrap {
     QueryWrap* wrap = FromCallbackPointer(arg);
     if (wrap == nullptr) return;
 
+    if (!wrap->cache_key_.empty())
+      wrap->ShareResponse(status, answer_buf, answer_len);
+    wrap->SetResponse(status, answer_buf, answer_len);
+    wrap->QueueResponseCallback(status);
+  }
+
+  void SetResponse(int status, const unsigned char* answer_buf,
+                   size_t answer_len) {
     unsigned char* buf_copy = nullptr;
     if (status == ARES_SUCCESS) {
       buf_copy = node::Malloc<unsigned char>(answer_len);
       memcpy(buf_copy, answer_buf, answer_len);
     }
 
-    wrap->response_data_ = std::make_unique<ResponseData>();
-    ResponseData* data = wrap->response_data_.get();
+    response_data_ = std::make_unique<ResponseData>();
+    ResponseData* data = response_data_.get();
     data->status = status;
     data->is_host = false;
     data->buf = MallocedBuffer<unsigned char>(buf_copy, answer_len);
-
-    wrap->QueueResponseCallback(status);
   }
 
   static void Callback(void* arg, int status, int timeouts,
@@ -740,6 +1013,8 @@ class QueryWrap : public AsyncWrap {
  private:
   std::unique_ptr<ResponseData> response_data_;
   const char* trace_name_;
+  // Set while this query is in the pending queries of the channel.
+  std::string cache_key_;
   // Pointer to pointer to 'this' that can be reset from the destructor,
   // in order to let Callback() know that 'this' no longer exists.
   QueryWrap** callback_ptr_ = nullptr;
@@ -1814,17 +2089,10 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
-  Local<Value> argv[] = {
-    Integer::New(env->isolate(), status),
-    Null(env->isolate())
-  };
-
-  uint64_t n = 0;
+  std::vector<std::string> addresses;
   const bool verbatim = req_wrap->verbatim();
 
   if (status == 0) {
-    Local<Array> results = Array::New(env->isolate());
-
     auto add = [&] (bool want_ipv4, bool want_ipv6) {
       for (auto p = res; p != nullptr; p = p->ai_next) {
         CHECK_EQ(p->ai_socktype, SOCK_STREAM);
@@ -1844,9 +2112,7 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
         if (uv_inet_ntop(p->ai_family, addr, ip, sizeof(ip)))
           continue;
 
-        Local<String> s = OneByteString(env->isolate(), ip);
-        results->Set(env->context(), n, s).Check();
-        n++;
+        addresses.emplace_back(ip);
       }
     };
 
@@ -1855,21 +2121,20 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
       add(false, true);
 
     // No responses were found to return
-    if (n == 0) {
-      argv[0] = Integer::New(env->isolate(), UV_EAI_NODATA);
+    if (addresses.empty()) {
+      status = UV_EAI_NODATA;
     }
-
-    argv[1] = results;
   }
 
   uv_freeaddrinfo(res);
 
-  TRACE_EVENT_NESTABLE_ASYNC_END2(
-      TRACING_CATEGORY_NODE2(dns, native), "lookup", req_wrap.get(),
-      "count", n, "verbatim", verbatim);
+  std::vector<GetAddrInfoReqWrap*> waiting =
+      req_wrap->FinishPendingLookup(status, addresses);
 
-  // Make the callback into JavaScript
-  req_wrap->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+  req_wrap->Complete(status, addresses);
+  for (GetAddrInfoReqWrap* waiting_req_wrap : waiting)
+    std::unique_ptr<GetAddrInfoReqWrap>(waiting_req_wrap)->Complete(
+        status, addresses);
 }
 
 
@@ -1981,6 +2246,23 @@ void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
       "family",
       family == AF_INET ? "ipv4" : family == AF_INET6 ? "ipv6" : "unspec");
 
+  DnsCache* cache = GetDnsCache();
+  if (cache->enabled()) {
+    std::string key = "lookup " + std::to_string(family) + ' ' +
+                      std::to_string(flags) + ' ' +
+                      (req_wrap->verbatim() ? "1 " : "0 ") + hostname.out();
+    DnsCache::Entry entry;
+    if (cache->Lookup(key, uv_hrtime(), &entry)) {
+      req_wrap.release()->CompleteFromCache(std::move(entry));
+      return args.GetReturnValue().Set(0);
+    }
+    if (!req_wrap->AddPendingLookup(std::move(key))) {
+      cache->RecordCoalesced();
+      USE(req_wrap.release());
+      return args.GetReturnValue().Set(0);
+    }
+  }
+
   int err = req_wrap->Dispatch(uv_getaddrinfo,
                                AfterGetAddrInfo,
                                *hostname,
@@ -2076,6 +2358,7 @@ void SetServers(const FunctionCallbackInfo<Value>& args) {
   Local<Array> arr = Local<Array>::Cast(args[0]);
 
   uint32_t len = arr->Length();
+  channel->ServersChanged();
 
   if (len == 0) {
     int rv = ares_set_servers(channel->cares_channel(), nullptr);
@@ -2154,6 +2437,20 @@ void Cancel(const FunctionCallbackInfo<Value>& args) {
   ares_cancel(channel->cares_channel());
 }
 
+void GetCacheStats(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), 4);
+  double* fields =
+      static_cast<double*>(array->Buffer()->GetContents().Data());
+
+  DnsCache::Stats stats = GetDnsCache()->stats();
+  fields[0] = stats.hits;
+  fields[1] = stats.misses;
+  fields[2] = stats.coalesced;
+  fields[3] = stats.entries;
+}
+
 const char EMSG_ESETSRVPENDING[] = "There are pending queries.";
 void StrError(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -2174,6 +2471,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "getaddrinfo", GetAddrInfo);
   env->SetMethod(target, "getnameinfo", GetNameInfo);
   env->SetMethodNoSideEffect(target, "canonicalizeIP", CanonicalizeIP);
+  env->SetMethodNoSideEffect(target, "getCacheStats", GetCacheStats);
 
   env->SetMethod(target, "strerror", StrError);
 
@@ -35,6 +35,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 
 #include <utility>
 
@@ -183,6 +184,64 @@ inline void AsyncHooks::clear_async_id_stack() {
   async_id_fields_[kExecutionAsyncId] = 0;
   async_id_fields_[kTriggerAsyncId] = 0;
   fields_[kStackLength] = 0;
+  context_frame_.Reset();
+  context_frame_stack_.clear();
+}
+
+inline v8::Local<v8::Value> AsyncHooks::context_frame() {
+  return context_frame_.Get(env()->isolate());
+}
+
+inline void AsyncHooks::set_context_frame(v8::Local<v8::Value> frame) {
+  if (frame.IsEmpty() || frame->IsUndefined())
+    context_frame_.Reset();
+  else
+    context_frame_.Reset(env()->isolate(), frame);
+}
+
+inline void AsyncHooks::push_context_frame(v8::Local<v8::Value> frame) {
+  context_frame_stack_.emplace_back(std::move(context_frame_));
+  set_context_frame(frame);
+}
+
+inline void AsyncHooks::pop_context_frame() {
+  // The stack is empty if the frames were enabled during a promise reaction.
+  if (context_frame_stack_.empty())
+    return;
+  context_frame_ = std::move(context_frame_stack_.back());
+  context_frame_stack_.pop_back();
+}
+
+inline bool AsyncHooks::promise_hook_enabled() const {
+  return promise_hook_enabled_;
+}
+
+inline void AsyncHooks::set_promise_hook_enabled(bool enabled) {
+  promise_hook_enabled_ = enabled;
+}
+
+inline bool AsyncHooks::context_frames_enabled() const {
+  return context_frames_enabled_;
+}
+
+inline void AsyncHooks::set_context_frames_enabled(bool enabled) {
+  context_frames_enabled_ = enabled;
+}
+
+inline AsyncHooks::ContextFrameScope::ContextFrameScope(
+    Environment* env, const v8::Global<v8::Value>& frame)
+    : async_hooks_(env->async_hooks()) {
+  // Nothing needs to be done unless AsyncLocalStorage is in use.
+  entered_ = !frame.IsEmpty() || !async_hooks_->context_frame_.IsEmpty();
+  if (!entered_)
+    return;
+  previous_frame_ = async_hooks_->context_frame();
+  async_hooks_->set_context_frame(frame.Get(env->isolate()));
+}
+
+inline AsyncHooks::ContextFrameScope::~ContextFrameScope() {
+  if (entered_)
+    async_hooks_->set_context_frame(previous_frame_);
 }
 
 // The DefaultTriggerAsyncIdScope(AsyncWrap*) constructor is defined in
@@ -281,6 +340,23 @@ inline bool TickInfo::has_rejection_to_warn() const {
   return fields_[kHasRejectionToWarn] == 1;
 }
 
+inline TimerInfo::TimerInfo(v8::Isolate* isolate)
+    : fields_(isolate, kFieldsCount + kMaxExpired + 2 * kMaxCommands) {
+  fields_[kNextExpiry] = std::numeric_limits<double>::infinity();
+}
+
+inline AliasedFloat64Array& TimerInfo::fields() {
+  return fields_;
+}
+
+inline TimerWheel* TimerInfo::wheel() {
+  return &wheel_;
+}
+
+inline void TimerInfo::set_next_expiry(double next_expiry) {
+  fields_[kNextExpiry] = next_expiry;
+}
+
 inline void Environment::AssignToContext(v8::Local<v8::Context> context,
                                          const ContextInfo& info) {
   context->SetAlignedPointerInEmbedderData(
@@ -444,6 +520,10 @@ inline TickInfo* Environment::tick_info() {
   return &tick_info_;
 }
 
+inline TimerInfo* Environment::timer_info() {
+  return &timer_info_;
+}
+
 inline uint64_t Environment::timer_base() const {
   return timer_base_;
 }
@@ -586,6 +666,10 @@ inline void Environment::set_http_parser_buffer_in_use(bool in_use) {
   http_parser_buffer_in_use_ = in_use;
 }
 
+inline ThreadPoolWorkQueue* Environment::threadpool_work_queue() const {
+  return threadpool_work_queue_.get();
+}
+
 inline http2::Http2State* Environment::http2_state() const {
   return http2_state_.get();
 }
@@ -735,6 +819,28 @@ inline uint64_t Environment::heap_prof_interval() const {
   return heap_prof_interval_;
 }
 
+inline void Environment::set_continuous_cpu_profiler(
+    std::unique_ptr<profiler::ContinuousCpuProfiler> profiler) {
+  CHECK_NULL(continuous_cpu_profiler_);
+  std::swap(continuous_cpu_profiler_, profiler);
+}
+
+inline profiler::ContinuousCpuProfiler*
+Environment::continuous_cpu_profiler() {
+  return continuous_cpu_profiler_.get();
+}
+
+inline void Environment::set_continuous_heap_profiler(
+    std::unique_ptr<profiler::ContinuousHeapProfiler> profiler) {
+  CHECK_NULL(continuous_heap_profiler_);
+  std::swap(continuous_heap_profiler_, profiler);
+}
+
+inline profiler::ContinuousHeapProfiler*
+Environment::continuous_heap_profiler() {
+  return continuous_heap_profiler_.get();
+}
+
 #endif  // HAVE_INSPECTOR
 
 inline std::shared_ptr<HostPort> Environment::inspector_host_port() {
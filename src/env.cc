@@ -9,6 +9,7 @@
 #include "node_internals.h"
 #include "node_native_module.h"
 #include "node_options-inl.h"
+#include "node_perf_loop.h"
 #include "node_process.h"
 #include "node_v8_platform-inl.h"
 #include "node_worker.h"
@@ -20,6 +21,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdio>
+#include <limits>
 #include <memory>
 
 namespace node {
@@ -190,6 +192,8 @@ void IsolateData::MemoryInfo(MemoryTracker* tracker) const {
   if (node_allocator_ != nullptr) {
     tracker->TrackFieldWithSize(
         "node_allocator", sizeof(*node_allocator_), "NodeArrayBufferAllocator");
+    tracker->TrackField("node_allocator_pool",
+                        node_allocator_->size_class_pool());
   } else {
     tracker->TrackFieldWithSize(
         "allocator", sizeof(*allocator_), "v8::ArrayBuffer::Allocator");
@@ -271,6 +275,7 @@ Environment::Environment(IsolateData* isolate_data,
       isolate_data_(isolate_data),
       immediate_info_(context->GetIsolate()),
       tick_info_(context->GetIsolate()),
+      timer_info_(context->GetIsolate()),
       timer_base_(uv_now(isolate_data->event_loop())),
       exec_argv_(exec_args),
       argv_(args),
@@ -293,6 +298,7 @@ Environment::Environment(IsolateData* isolate_data,
   // part of the per-process option set.
   options_.reset(new EnvironmentOptions(*isolate_data->options()->per_env));
   inspector_host_port_.reset(new HostPort(options_->debug_options().host_port));
+  threadpool_work_queue_ = std::make_unique<ThreadPoolWorkQueue>();
 
 #if HAVE_INSPECTOR
   // We can only create the inspector agent after having cloned the options.
@@ -674,10 +680,39 @@ void Environment::ToggleTimerRef(bool ref) {
   }
 }
 
+const size_t TimerInfo::kMaxExpired;
+const size_t TimerInfo::kMaxCommands;
+
+void TimerInfo::FlushCommands() {
+  const size_t count = static_cast<size_t>(fields_[kCommandCount]);
+  const size_t start = kFieldsCount + kMaxExpired;
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t id = static_cast<uint32_t>(fields_[start + 2 * i]);
+    const double expiry = fields_[start + 2 * i + 1];
+    if (expiry < 0)
+      wheel_.Cancel(id);
+    else
+      wheel_.Schedule(id, static_cast<uint64_t>(expiry));
+  }
+  fields_[kCommandCount] = 0;
+}
+
+size_t TimerInfo::SetExpired(const std::vector<uint32_t>& expired,
+                             size_t offset) {
+  const size_t count = std::min(expired.size() - offset, kMaxExpired);
+  for (size_t i = 0; i < count; i++)
+    fields_[kFieldsCount + i] = expired[offset + i];
+  fields_[kExpiredCount] = count;
+  fields_[kExpiredCursor] = 0;
+  return count;
+}
+
 void Environment::RunTimers(uv_timer_t* handle) {
   Environment* env = Environment::from_timer_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "RunTimers", env);
+  performance::EventLoopPhaseScope phase_scope(
+      env, performance::NODE_PERFORMANCE_LOOP_METRIC_TIMERS);
 
   if (!env->can_call_into_js())
     return;
@@ -688,51 +723,64 @@ void Environment::RunTimers(uv_timer_t* handle) {
   Local<Object> process = env->process_object();
   InternalCallbackScope scope(env, process, {0, 0});
 
+  TimerInfo* timer_info = env->timer_info();
+  TimerWheel* wheel = timer_info->wheel();
+  timer_info->FlushCommands();
+
   Local<Function> cb = env->timers_callback_function();
   MaybeLocal<Value> ret;
   Local<Value> arg = env->GetNow();
-  // This code will loop until all currently due timers will process. It is
-  // impossible for us to end up in an infinite loop due to how the JS-side
-  // is structured.
-  do {
-    TryCatchScope try_catch(env);
-    try_catch.SetVerbose(true);
-    ret = cb->Call(env->context(), process, 1, &arg);
-  } while (ret.IsEmpty() && env->can_call_into_js());
-
-  // NOTE(apapirovski): If it ever becomes possible that `call_into_js` above
-  // is reset back to `true` after being previously set to `false` then this
-  // code becomes invalid and needs to be rewritten. Otherwise catastrophic
-  // timers corruption will occur and all timers behaviour will become
-  // entirely unpredictable.
-  if (ret.IsEmpty())
-    return;
+  std::vector<uint32_t> expired;
+  wheel->Expire(static_cast<uint64_t>(arg.As<Number>()->Value()), &expired);
+
+  // The expired timer lists are passed to JS in batches. JS advances the
+  // cursor of the batch as it processes the lists, so that if a timer throws,
+  // calling back into JS continues with the list that threw. It is impossible
+  // for us to end up in an infinite loop due to how the JS-side is
+  // structured.
+  for (size_t offset = 0; offset < expired.size();) {
+    offset += timer_info->SetExpired(expired, offset);
+    do {
+      TryCatchScope try_catch(env);
+      try_catch.SetVerbose(true);
+      ret = cb->Call(env->context(), process, 1, &arg);
+    } while (ret.IsEmpty() && env->can_call_into_js());
+
+    // NOTE(apapirovski): If it ever becomes possible that `call_into_js`
+    // above is reset back to `true` after being previously set to `false`
+    // then this code becomes invalid and needs to be rewritten. Otherwise
+    // catastrophic timers corruption will occur and all timers behaviour will
+    // become entirely unpredictable.
+    if (ret.IsEmpty())
+      return;
+  }
 
-  // To allow for less JS-C++ boundary crossing, the value returned from JS
-  // serves a few purposes:
-  // 1. If it's 0, no more timers exist and the handle should be unrefed
-  // 2. If it's > 0, the value represents the next timer's expiry and there
-  //    is at least one timer remaining that is refed.
-  // 3. If it's < 0, the absolute value represents the next timer's expiry
-  //    and there are no timers that are refed.
-  int64_t expiry_ms =
-      ret.ToLocalChecked()->IntegerValue(env->context()).FromJust();
+  // The lists that JS scheduled or cancelled while it ran the timers are only
+  // now added to or removed from the wheel.
+  timer_info->FlushCommands();
 
   uv_handle_t* h = reinterpret_cast<uv_handle_t*>(handle);
+  const uint64_t next_expiry = wheel->NextExpiry();
+  if (next_expiry == TimerWheel::kNoExpiry) {
+    timer_info->set_next_expiry(std::numeric_limits<double>::infinity());
+    uv_unref(h);
+    return;
+  }
 
-  if (expiry_ms != 0) {
-    int64_t duration_ms =
-        llabs(expiry_ms) - (uv_now(env->event_loop()) - env->timer_base());
-
-    env->ScheduleTimer(duration_ms > 0 ? duration_ms : 1);
+  timer_info->set_next_expiry(next_expiry);
+  int64_t duration_ms = static_cast<int64_t>(next_expiry) -
+      static_cast<int64_t>(uv_now(env->event_loop()) - env->timer_base());
+  env->ScheduleTimer(duration_ms > 0 ? duration_ms : 1);
 
-    if (expiry_ms > 0)
-      uv_ref(h);
-    else
-      uv_unref(h);
-  } else {
+  // If JS ran, the value it returned is positive if at least one timer is
+  // refed, and negative otherwise. Otherwise the wheel only moved timers
+  // closer to expiry, and whether the handle is refed has not changed.
+  if (ret.IsEmpty())
+    return;
+  if (ret.ToLocalChecked()->IntegerValue(env->context()).FromJust() > 0)
+    uv_ref(h);
+  else
     uv_unref(h);
-  }
 }
 
 
@@ -740,6 +788,8 @@ void Environment::CheckImmediate(uv_check_t* handle) {
   Environment* env = Environment::from_immediate_check_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "CheckImmediate", env);
+  performance::EventLoopPhaseScope phase_scope(
+      env, performance::NODE_PERFORMANCE_LOOP_METRIC_CHECK);
 
   if (env->immediate_info()->count() == 0)
     return;
@@ -879,6 +929,10 @@ void TickInfo::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("fields", fields_);
 }
 
+void TimerInfo::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("fields", fields_);
+}
+
 void AsyncHooks::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("providers", providers_);
   tracker->TrackField("async_ids_stack", async_ids_stack_);
@@ -958,6 +1012,7 @@ inline size_t Environment::SelfSize() const {
   size -= sizeof(thread_stopper_);
   size -= sizeof(async_hooks_);
   size -= sizeof(tick_info_);
+  size -= sizeof(timer_info_);
   size -= sizeof(immediate_info_);
   return size;
 }
@@ -982,6 +1037,7 @@ void Environment::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("async_hooks", async_hooks_);
   tracker->TrackField("immediate_info", immediate_info_);
   tracker->TrackField("tick_info", tick_info_);
+  tracker->TrackField("timer_info", timer_info_);
 
 #define V(PropertyName, TypeName)                                              \
   tracker->TrackField(#PropertyName, PropertyName());
@@ -39,6 +39,7 @@
 #include "node_main_instance.h"
 #include "node_options.h"
 #include "req_wrap.h"
+#include "timer_wheel.h"
 #include "util.h"
 #include "uv.h"
 #include "v8.h"
@@ -68,6 +69,8 @@ namespace performance {
 class performance_state;
 }
 
+class ThreadPoolWorkQueue;
+
 namespace tracing {
 class AgentWriterHandle;
 }
@@ -77,6 +80,8 @@ namespace profiler {
 class V8CoverageConnection;
 class V8CpuProfilerConnection;
 class V8HeapProfilerConnection;
+class ContinuousCpuProfiler;
+class ContinuousHeapProfiler;
 }  // namespace profiler
 
 namespace inspector {
@@ -127,6 +132,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
 #define PER_ISOLATE_PRIVATE_SYMBOL_PROPERTIES(V)                              \
   V(alpn_buffer_private_symbol, "node:alpnBuffer")                            \
   V(arrow_message_private_symbol, "node:arrowMessage")                        \
+  V(async_context_frame_private_symbol, "node:asyncContextFrame")             \
   V(contextify_context_private_symbol, "node:contextify:context")             \
   V(contextify_global_private_symbol, "node:contextify:global")               \
   V(decorated_private_symbol, "node:decorated")                               \
@@ -442,6 +448,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
   V(quic_on_stream_ready_function, v8::Function)                               \
   V(quic_on_stream_reset_function, v8::Function)                               \
   V(script_data_constructor_function, v8::Function)                            \
+  V(startup_snapshot_state, v8::Object)                                        \
   V(tick_callback_function, v8::Function)                                      \
   V(timers_callback_function, v8::Function)                                    \
   V(tls_wrap_constructor_function, v8::Function)                               \
@@ -663,6 +670,22 @@ class AsyncHooks : public MemoryRetainer {
   inline bool pop_async_id(double async_id);
   inline void clear_async_id_stack();  // Used in fatal exceptions.
 
+  // The async context frame is the value in which AsyncLocalStorage keeps
+  // its stores. It is empty unless a store is in use. AsyncWrap instances
+  // capture it when they are created and restore it while they call into JS.
+  inline v8::Local<v8::Value> context_frame();
+  inline void set_context_frame(v8::Local<v8::Value> frame);
+  // Used around promise reactions, which do not nest in a C++ scope.
+  inline void push_context_frame(v8::Local<v8::Value> frame);
+  inline void pop_context_frame();
+
+  // Whether the PromiseHook runs the async hooks, and whether it propagates
+  // the async context frame.
+  inline bool promise_hook_enabled() const;
+  inline void set_promise_hook_enabled(bool enabled);
+  inline bool context_frames_enabled() const;
+  inline void set_context_frames_enabled(bool enabled);
+
   AsyncHooks(const AsyncHooks&) = delete;
   AsyncHooks& operator=(const AsyncHooks&) = delete;
 
@@ -685,6 +708,23 @@ class AsyncHooks : public MemoryRetainer {
     double old_default_trigger_async_id_;
   };
 
+  // Makes `frame` the current async context frame in a scope.
+  class ContextFrameScope {
+   public:
+    ContextFrameScope() = delete;
+    inline ContextFrameScope(Environment* env,
+                             const v8::Global<v8::Value>& frame);
+    inline ~ContextFrameScope();
+
+    ContextFrameScope(const ContextFrameScope&) = delete;
+    ContextFrameScope& operator=(const ContextFrameScope&) = delete;
+
+   private:
+    AsyncHooks* async_hooks_;
+    v8::Local<v8::Value> previous_frame_;
+    bool entered_;
+  };
+
  private:
   friend class Environment;  // So we can call the constructor.
   inline AsyncHooks();
@@ -697,6 +737,10 @@ class AsyncHooks : public MemoryRetainer {
   AliasedUint32Array fields_;
   // Attached to a Float64Array that tracks the state of async resources.
   AliasedFloat64Array async_id_fields_;
+  v8::Global<v8::Value> context_frame_;
+  std::vector<v8::Global<v8::Value>> context_frame_stack_;
+  bool promise_hook_enabled_ = false;
+  bool context_frames_enabled_ = false;
 
   void grow_async_ids_stack();
 };
@@ -762,6 +806,50 @@ class TickInfo : public MemoryRetainer {
   AliasedUint8Array fields_;
 };
 
+// The timer lists of lib/internal/timers.js are kept in a TimerWheel. JS does
+// not call into C++ to schedule or cancel them, but writes commands to
+// fields(), which are applied before the timers are run. The ids of the lists
+// that expire are written back to fields() in batches.
+class TimerInfo : public MemoryRetainer {
+ public:
+  inline AliasedFloat64Array& fields();
+  inline TimerWheel* wheel();
+  inline void set_next_expiry(double next_expiry);
+
+  // Applies the commands that JS has written, and clears them.
+  void FlushCommands();
+  // Writes the ids of `expired`, starting at `offset`, for JS to process.
+  // Returns how many of them fit.
+  size_t SetExpired(const std::vector<uint32_t>& expired, size_t offset);
+
+  TimerInfo(const TimerInfo&) = delete;
+  TimerInfo& operator=(const TimerInfo&) = delete;
+
+  SET_MEMORY_INFO_NAME(TimerInfo)
+  SET_SELF_SIZE(TimerInfo)
+  void MemoryInfo(MemoryTracker* tracker) const override;
+
+ private:
+  friend class Environment;  // So we can call the constructor.
+  inline explicit TimerInfo(v8::Isolate* isolate);
+
+  // The expired ids follow the fields, and the commands, which are pairs of
+  // an id and an expiry, follow the expired ids. A negative expiry cancels
+  // the timer.
+  enum Fields {
+    kNextExpiry,
+    kExpiredCount,
+    kExpiredCursor,
+    kCommandCount,
+    kFieldsCount
+  };
+  static const size_t kMaxExpired = 1024;
+  static const size_t kMaxCommands = 1024;
+
+  AliasedFloat64Array fields_;
+  TimerWheel wheel_;
+};
+
 class TrackingTraceStateObserver :
     public v8::TracingController::TraceStateObserver {
  public:
@@ -931,6 +1019,7 @@ class Environment : public MemoryRetainer {
   inline AsyncHooks* async_hooks();
   inline ImmediateInfo* immediate_info();
   inline TickInfo* tick_info();
+  inline TimerInfo* timer_info();
   inline uint64_t timer_base() const;
   inline std::shared_ptr<KVStore> env_vars();
   inline void set_env_vars(std::shared_ptr<KVStore> env_vars);
@@ -1000,6 +1089,8 @@ class Environment : public MemoryRetainer {
   inline bool http_parser_buffer_in_use() const;
   inline void set_http_parser_buffer_in_use(bool in_use);
 
+  inline ThreadPoolWorkQueue* threadpool_work_queue() const;
+
   inline http2::Http2State* http2_state() const;
   inline void set_http2_state(std::unique_ptr<http2::Http2State> state);
 
@@ -1219,6 +1310,13 @@ class Environment : public MemoryRetainer {
   inline void set_heap_prof_interval(uint64_t interval);
   inline uint64_t heap_prof_interval() const;
 
+  inline void set_continuous_cpu_profiler(
+      std::unique_ptr<profiler::ContinuousCpuProfiler> profiler);
+  inline profiler::ContinuousCpuProfiler* continuous_cpu_profiler();
+  inline void set_continuous_heap_profiler(
+      std::unique_ptr<profiler::ContinuousHeapProfiler> profiler);
+  inline profiler::ContinuousHeapProfiler* continuous_heap_profiler();
+
 #endif  // HAVE_INSPECTOR
 
  private:
@@ -1243,6 +1341,7 @@ class Environment : public MemoryRetainer {
   AsyncHooks async_hooks_;
   ImmediateInfo immediate_info_;
   TickInfo tick_info_;
+  TimerInfo timer_info_;
   const uint64_t timer_base_;
   std::shared_ptr<KVStore> env_vars_;
   bool printed_error_ = false;
@@ -1262,6 +1361,8 @@ class Environment : public MemoryRetainer {
   std::string heap_prof_dir_;
   std::string heap_prof_name_;
   uint64_t heap_prof_interval_;
+  std::unique_ptr<profiler::ContinuousCpuProfiler> continuous_cpu_profiler_;
+  std::unique_ptr<profiler::ContinuousHeapProfiler> continuous_heap_profiler_;
 #endif  // HAVE_INSPECTOR
 
   std::shared_ptr<EnvironmentOptions> options_;
@@ -1324,6 +1425,7 @@ class Environment : public MemoryRetainer {
 
   char* http_parser_buffer_ = nullptr;
   bool http_parser_buffer_in_use_ = false;
+  std::unique_ptr<ThreadPoolWorkQueue> threadpool_work_queue_;
   std::unique_ptr<http2::Http2State> http2_state_;
 #if HAVE_OPENSSL
   std::unique_ptr<QuicState> quic_state_;
@@ -12,10 +12,15 @@
 namespace node {
 namespace profiler {
 
+using v8::AllocationProfile;
 using v8::Context;
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::CpuProfiler;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
+using v8::HeapProfiler;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
@@ -296,6 +301,167 @@ void V8HeapProfilerConnection::End() {
   DispatchMessage("HeapProfiler.stopSampling");
 }
 
+ContinuousCpuProfiler::ContinuousCpuProfiler(Environment* env,
+                                             const std::string& directory,
+                                             uint64_t interval,
+                                             uint64_t period,
+                                             uint64_t max_files,
+                                             int signal)
+    : PeriodicProfiler(env, "CPU", directory, period, max_files, signal),
+      interval_(interval) {}
+
+ContinuousCpuProfiler::~ContinuousCpuProfiler() {
+  StopProfiling();
+}
+
+Local<String> ContinuousCpuProfiler::Title(uint32_t index) const {
+  std::string title = "node-continuous-" + std::to_string(index);
+  return OneByteString(env()->isolate(), title.c_str(), title.size());
+}
+
+void ContinuousCpuProfiler::StartProfiling() {
+  HandleScope handle_scope(env()->isolate());
+  cpu_profiler_ = CpuProfiler::New(env()->isolate());
+  cpu_profiler_->SetSamplingInterval(static_cast<int>(interval_));
+  cpu_profiler_->StartProfiling(Title(index_));
+}
+
+void ContinuousCpuProfiler::StopProfiling() {
+  if (cpu_profiler_ == nullptr)
+    return;
+  cpu_profiler_->Dispose();
+  cpu_profiler_ = nullptr;
+}
+
+// Adds a sample for each function that was on the top of the stack, with the
+// stack that led to it, innermost frame first.
+static void AddCpuProfileSamples(pprof::ProfileBuilder* builder,
+                                 const CpuProfileNode* node,
+                                 int64_t period,
+                                 std::vector<uint64_t>* stack) {
+  const bool is_root = stack->empty() && node->GetParent() == nullptr;
+  if (!is_root) {
+    std::string name = node->GetFunctionNameStr();
+    if (name.empty())
+      name = "(anonymous)";
+    stack->push_back(builder->AddLocation(name,
+                                          node->GetScriptResourceNameStr(),
+                                          node->GetLineNumber()));
+    const int64_t hits = node->GetHitCount();
+    if (hits > 0) {
+      builder->AddSample(
+          std::vector<uint64_t>(stack->rbegin(), stack->rend()),
+          { hits, hits * period });
+    }
+  }
+  for (int i = 0; i < node->GetChildrenCount(); i++)
+    AddCpuProfileSamples(builder, node->GetChild(i), period, stack);
+  if (!is_root)
+    stack->pop_back();
+}
+
+bool ContinuousCpuProfiler::CollectProfile(pprof::ProfileBuilder* builder,
+                                           bool last) {
+  HandleScope handle_scope(env()->isolate());
+  if (!last)
+    cpu_profiler_->StartProfiling(Title(index_ + 1));
+  CpuProfile* profile = cpu_profiler_->StopProfiling(Title(index_));
+  index_++;
+  if (profile == nullptr)
+    return false;
+
+  // The profile times are in microseconds, from an arbitrary point.
+  const int64_t duration = profile->GetEndTime() - profile->GetStartTime();
+  const int64_t period = interval_ * 1000;
+  builder->AddSampleType("samples", "count");
+  builder->AddSampleType("cpu", "nanoseconds");
+  builder->SetPeriod("cpu", "nanoseconds", period);
+  builder->set_time_nanos(
+      (static_cast<int64_t>(GetCurrentTimeInMicroseconds()) - duration) *
+      1000);
+  builder->set_duration_nanos(duration * 1000);
+
+  std::vector<uint64_t> stack;
+  AddCpuProfileSamples(builder, profile->GetTopDownRoot(), period, &stack);
+  profile->Delete();
+  return true;
+}
+
+ContinuousHeapProfiler::ContinuousHeapProfiler(Environment* env,
+                                               const std::string& directory,
+                                               uint64_t interval,
+                                               uint64_t period,
+                                               uint64_t max_files,
+                                               int signal)
+    : PeriodicProfiler(env, "Heap", directory, period, max_files, signal),
+      interval_(interval) {}
+
+ContinuousHeapProfiler::~ContinuousHeapProfiler() {
+  StopProfiling();
+}
+
+void ContinuousHeapProfiler::StartProfiling() {
+  sampling_ = env()->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+      interval_);
+  if (!sampling_)
+    fprintf(stderr, "Failed to start the sampling heap profiler\n");
+}
+
+void ContinuousHeapProfiler::StopProfiling() {
+  if (!sampling_)
+    return;
+  env()->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+  sampling_ = false;
+}
+
+// Adds a sample for each size of the objects allocated by a function, with
+// the stack that led to it, innermost frame first.
+static void AddAllocationSamples(Isolate* isolate,
+                                 pprof::ProfileBuilder* builder,
+                                 const AllocationProfile::Node* node,
+                                 std::vector<uint64_t>* stack) {
+  std::string name = *node::Utf8Value(isolate, node->name);
+  if (name.empty())
+    name = "(anonymous)";
+  stack->push_back(builder->AddLocation(
+      name, *node::Utf8Value(isolate, node->script_name), node->line_number));
+  for (const AllocationProfile::Allocation& allocation : node->allocations) {
+    // V8 scales the counts to estimate all the allocations, and not only the
+    // sampled ones.
+    const int64_t count = allocation.count;
+    builder->AddSample(
+        std::vector<uint64_t>(stack->rbegin(), stack->rend()),
+        { count, count * static_cast<int64_t>(allocation.size) });
+  }
+  for (const AllocationProfile::Node* child : node->children)
+    AddAllocationSamples(isolate, builder, child, stack);
+  stack->pop_back();
+}
+
+bool ContinuousHeapProfiler::CollectProfile(pprof::ProfileBuilder* builder,
+                                            bool last) {
+  if (!sampling_)
+    return false;
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  std::unique_ptr<AllocationProfile> profile(
+      isolate->GetHeapProfiler()->GetAllocationProfile());
+  if (!profile)
+    return false;
+
+  builder->AddSampleType("inuse_objects", "count");
+  builder->AddSampleType("inuse_space", "bytes");
+  builder->SetPeriod("space", "bytes", interval_);
+  builder->set_time_nanos(
+      static_cast<int64_t>(GetCurrentTimeInMicroseconds()) * 1000);
+
+  // The root node has no allocations of its own.
+  std::vector<uint64_t> stack;
+  for (const AllocationProfile::Node* node : profile->GetRootNode()->children)
+    AddAllocationSamples(isolate, builder, node, &stack);
+  return true;
+}
+
 // For now, we only support coverage profiling, but we may add more
 // in the future.
 void EndStartedProfilers(Environment* env) {
@@ -320,6 +486,21 @@ void EndStartedProfilers(Environment* env) {
   }
 }
 
+// Unlike the profilers above, continuous profilers are not ended by
+// process.kill(), which may send them the signal that writes a profile.
+void EndContinuousProfilers(Environment* env) {
+  if (env->continuous_cpu_profiler() != nullptr) {
+    Debug(env, DebugCategory::INSPECTOR_PROFILER,
+          "Ending continuous cpu profiling\n");
+    env->continuous_cpu_profiler()->Stop();
+  }
+  if (env->continuous_heap_profiler() != nullptr) {
+    Debug(env, DebugCategory::INSPECTOR_PROFILER,
+          "Ending continuous heap profiling\n");
+    env->continuous_heap_profiler()->Stop();
+  }
+}
+
 std::string GetCwd() {
   char cwd[PATH_MAX_BYTES];
   size_t size = PATH_MAX_BYTES;
@@ -371,6 +552,32 @@ void StartProfilers(Environment* env) {
         std::make_unique<profiler::V8HeapProfilerConnection>(env));
     env->heap_profiler_connection()->Start();
   }
+  if (env->options()->cpu_prof_continuous) {
+    const std::string& dir = env->options()->cpu_prof_dir;
+    const std::string& signal = env->options()->cpu_prof_continuous_signal;
+    auto profiler = std::make_unique<ContinuousCpuProfiler>(
+        env,
+        dir.empty() ? GetCwd() : dir,
+        env->options()->cpu_prof_continuous_interval,
+        env->options()->cpu_prof_continuous_period * 1000,
+        env->options()->cpu_prof_continuous_max_files,
+        signal.empty() ? 0 : signo_number(signal));
+    profiler->Start();
+    env->set_continuous_cpu_profiler(std::move(profiler));
+  }
+  if (env->options()->heap_prof_continuous) {
+    const std::string& dir = env->options()->heap_prof_dir;
+    const std::string& signal = env->options()->heap_prof_continuous_signal;
+    auto profiler = std::make_unique<ContinuousHeapProfiler>(
+        env,
+        dir.empty() ? GetCwd() : dir,
+        env->options()->heap_prof_continuous_interval,
+        env->options()->heap_prof_continuous_period * 1000,
+        env->options()->heap_prof_continuous_max_files,
+        signal.empty() ? 0 : signo_number(signal));
+    profiler->Start();
+    env->set_continuous_heap_profiler(std::move(profiler));
+  }
 }
 
 static void SetCoverageDirectory(const FunctionCallbackInfo<Value>& args) {
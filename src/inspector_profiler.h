@@ -9,6 +9,8 @@
 
 #include "env.h"
 #include "inspector_agent.h"
+#include "node_pprof.h"
+#include "v8-profiler.h"
 
 namespace node {
 // Forward declaration to break recursive dependency chain with src/env.h.
@@ -127,6 +129,58 @@ class V8HeapProfilerConnection : public V8ProfilerConnection {
   bool ending_ = false;
 };
 
+// Samples the JavaScript stacks with V8's CPU profiler, without an inspector
+// session, for as long as the Environment runs. Enabled with
+// --cpu-prof-continuous.
+class ContinuousCpuProfiler : public pprof::PeriodicProfiler {
+ public:
+  ContinuousCpuProfiler(Environment* env,
+                        const std::string& directory,
+                        uint64_t interval,
+                        uint64_t period,
+                        uint64_t max_files,
+                        int signal);
+  ~ContinuousCpuProfiler() override;
+
+ protected:
+  void StartProfiling() override;
+  void StopProfiling() override;
+  bool CollectProfile(pprof::ProfileBuilder* builder, bool last) override;
+
+ private:
+  // V8 can run several profiles at once. Each one is named after its index,
+  // and the next one is started before the current one is stopped so that
+  // no samples are lost in between.
+  v8::Local<v8::String> Title(uint32_t index) const;
+
+  const uint64_t interval_;
+  v8::CpuProfiler* cpu_profiler_ = nullptr;
+  uint32_t index_ = 0;
+};
+
+// Samples the allocations of the Environment with V8's sampling heap profiler,
+// for as long as it runs. Each profile has the sampled allocations that are
+// still live. Enabled with --heap-prof-continuous.
+class ContinuousHeapProfiler : public pprof::PeriodicProfiler {
+ public:
+  ContinuousHeapProfiler(Environment* env,
+                         const std::string& directory,
+                         uint64_t interval,
+                         uint64_t period,
+                         uint64_t max_files,
+                         int signal);
+  ~ContinuousHeapProfiler() override;
+
+ protected:
+  void StartProfiling() override;
+  void StopProfiling() override;
+  bool CollectProfile(pprof::ProfileBuilder* builder, bool last) override;
+
+ private:
+  const uint64_t interval_;
+  bool sampling_ = false;
+};
+
 }  // namespace profiler
 }  // namespace node
 
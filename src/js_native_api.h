@@ -494,6 +494,39 @@ NAPI_EXTERN napi_status napi_add_finalizer(napi_env env,
                                            napi_finalize finalize_cb,
                                            void* finalize_hint,
                                            napi_ref* result);
+
+// Property keys and object templates
+NAPI_EXTERN napi_status napi_create_property_key_utf8(
+    napi_env env,
+    const char* str,
+    size_t length,
+    napi_property_key* result);
+NAPI_EXTERN napi_status napi_delete_property_key(napi_env env,
+                                                 napi_property_key key);
+NAPI_EXTERN napi_status napi_get_property_key_value(napi_env env,
+                                                    napi_property_key key,
+                                                    napi_value* result);
+NAPI_EXTERN napi_status napi_set_keyed_property(napi_env env,
+                                                napi_value object,
+                                                napi_property_key key,
+                                                napi_value value);
+NAPI_EXTERN napi_status napi_get_keyed_property(napi_env env,
+                                                napi_value object,
+                                                napi_property_key key,
+                                                napi_value* result);
+NAPI_EXTERN napi_status napi_create_object_template(
+    napi_env env,
+    size_t key_count,
+    const napi_property_key* keys,
+    napi_object_template* result);
+NAPI_EXTERN napi_status napi_delete_object_template(
+    napi_env env,
+    napi_object_template tmpl);
+NAPI_EXTERN napi_status napi_create_object_from_template(
+    napi_env env,
+    napi_object_template tmpl,
+    const napi_value* values,
+    napi_value* result);
 #endif  // NAPI_EXPERIMENTAL
 
 EXTERN_C_END
@@ -20,6 +20,10 @@ typedef struct napi_handle_scope__* napi_handle_scope;
 typedef struct napi_escapable_handle_scope__* napi_escapable_handle_scope;
 typedef struct napi_callback_info__* napi_callback_info;
 typedef struct napi_deferred__* napi_deferred;
+#ifdef NAPI_EXPERIMENTAL
+typedef struct napi_property_key__* napi_property_key;
+typedef struct napi_object_template__* napi_object_template;
+#endif  // NAPI_EXPERIMENTAL
 
 typedef enum {
   napi_default = 0,
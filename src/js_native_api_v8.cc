@@ -1,6 +1,7 @@
 #include <climits>  // INT_MAX
 #include <cmath>
 #include <algorithm>
+#include <vector>
 #define NAPI_EXPERIMENTAL
 #include "env-inl.h"
 #include "js_native_api_v8.h"
@@ -669,6 +670,56 @@ inline napi_status Wrap(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+// A property name that is internalized once, rather than looked up in the
+// string table every time it is used.
+class PropertyKey {
+ public:
+  PropertyKey(napi_env env, v8::Local<v8::String> name)
+    : _name(env->isolate, name) {
+  }
+
+  v8::Local<v8::String> Get(napi_env env) const {
+    return _name.Get(env->isolate);
+  }
+
+ private:
+  v8impl::Persistent<v8::String> _name;
+};
+
+// Objects are created from a template by cloning a boilerplate object that
+// has all of the template's properties, so that they share its hidden class
+// and setting the properties does not change it.
+class ObjectTemplate {
+ public:
+  ObjectTemplate(napi_env env, v8::Local<v8::Object> boilerplate)
+    : _boilerplate(env->isolate, boilerplate) {
+  }
+
+  void AddKey(napi_env env, v8::Local<v8::String> name) {
+    _keys.emplace_back(env->isolate, name);
+  }
+
+  bool NewInstance(napi_env env,
+                   const napi_value* values,
+                   v8::Local<v8::Object>* result) const {
+    v8::Local<v8::Context> context = env->context();
+    v8::Local<v8::Object> obj = _boilerplate.Get(env->isolate)->Clone();
+    for (size_t i = 0; i < _keys.size(); i++) {
+      v8::Local<v8::Value> value = v8impl::V8LocalValueFromJsValue(values[i]);
+      if (!obj->CreateDataProperty(context, _keys[i].Get(env->isolate), value)
+              .FromMaybe(false)) {
+        return false;
+      }
+    }
+    *result = obj;
+    return true;
+  }
+
+ private:
+  v8impl::Persistent<v8::Object> _boilerplate;
+  std::vector<v8impl::Persistent<v8::String>> _keys;
+};
+
 }  // end of anonymous namespace
 
 }  // end of namespace v8impl
@@ -2951,3 +3002,155 @@ napi_status napi_adjust_external_memory(napi_env env,
 
   return napi_clear_last_error(env);
 }
+
+napi_status napi_create_property_key_utf8(napi_env env,
+                                          const char* str,
+                                          size_t length,
+                                          napi_property_key* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, str);
+  CHECK_ARG(env, result);
+
+  v8::Local<v8::String> name;
+  CHECK_NEW_FROM_UTF8_LEN(env, name, str, length);
+
+  *result = reinterpret_cast<napi_property_key>(
+      new v8impl::PropertyKey(env, name));
+  return napi_clear_last_error(env);
+}
+
+napi_status napi_delete_property_key(napi_env env, napi_property_key key) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, key);
+
+  delete reinterpret_cast<v8impl::PropertyKey*>(key);
+  return napi_clear_last_error(env);
+}
+
+napi_status napi_get_property_key_value(napi_env env,
+                                        napi_property_key key,
+                                        napi_value* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, key);
+  CHECK_ARG(env, result);
+
+  *result = v8impl::JsValueFromV8LocalValue(
+      reinterpret_cast<v8impl::PropertyKey*>(key)->Get(env));
+  return napi_clear_last_error(env);
+}
+
+napi_status napi_set_keyed_property(napi_env env,
+                                    napi_value object,
+                                    napi_property_key key,
+                                    napi_value value) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, key);
+  CHECK_ARG(env, value);
+
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Local<v8::String> name =
+      reinterpret_cast<v8impl::PropertyKey*>(key)->Get(env);
+  v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
+
+  v8::Maybe<bool> set_maybe = obj->Set(context, name, val);
+
+  RETURN_STATUS_IF_FALSE(env, set_maybe.FromMaybe(false), napi_generic_failure);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_get_keyed_property(napi_env env,
+                                    napi_value object,
+                                    napi_property_key key,
+                                    napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, key);
+  CHECK_ARG(env, result);
+
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Local<v8::String> name =
+      reinterpret_cast<v8impl::PropertyKey*>(key)->Get(env);
+
+  auto get_maybe = obj->Get(context, name);
+
+  CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+  v8::Local<v8::Value> val = get_maybe.ToLocalChecked();
+  *result = v8impl::JsValueFromV8LocalValue(val);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_create_object_template(napi_env env,
+                                        size_t key_count,
+                                        const napi_property_key* keys,
+                                        napi_object_template* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+  if (key_count > 0) {
+    CHECK_ARG(env, keys);
+  }
+
+  v8::Local<v8::Context> context = env->context();
+  v8::Local<v8::Object> boilerplate = v8::Object::New(env->isolate);
+  std::vector<v8::Local<v8::String>> names;
+  names.reserve(key_count);
+  for (size_t i = 0; i < key_count; i++) {
+    CHECK_ARG(env, keys[i]);
+    v8::Local<v8::String> name =
+        reinterpret_cast<v8impl::PropertyKey*>(keys[i])->Get(env);
+    // Every key must be distinct, so that each value has a property.
+    bool has_name;
+    RETURN_STATUS_IF_FALSE(env,
+        boilerplate->HasOwnProperty(context, name).To(&has_name) && !has_name,
+        napi_invalid_arg);
+    RETURN_STATUS_IF_FALSE(env,
+        boilerplate->CreateDataProperty(
+            context, name, v8::Undefined(env->isolate)).FromMaybe(false),
+        napi_generic_failure);
+    names.push_back(name);
+  }
+
+  v8impl::ObjectTemplate* tmpl = new v8impl::ObjectTemplate(env, boilerplate);
+  for (v8::Local<v8::String> name : names)
+    tmpl->AddKey(env, name);
+
+  *result = reinterpret_cast<napi_object_template>(tmpl);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_delete_object_template(napi_env env,
+                                        napi_object_template tmpl) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, tmpl);
+
+  delete reinterpret_cast<v8impl::ObjectTemplate*>(tmpl);
+  return napi_clear_last_error(env);
+}
+
+napi_status napi_create_object_from_template(napi_env env,
+                                             napi_object_template tmpl,
+                                             const napi_value* values,
+                                             napi_value* result) {
+  // Setting the properties of a new plain object does not call into JS, so
+  // this does not need the full NAPI_PREAMBLE.
+  CHECK_ENV(env);
+  CHECK_ARG(env, tmpl);
+  CHECK_ARG(env, values);
+  CHECK_ARG(env, result);
+
+  v8::Local<v8::Object> obj;
+  RETURN_STATUS_IF_FALSE(env,
+      reinterpret_cast<v8impl::ObjectTemplate*>(tmpl)->NewInstance(
+          env, values, &obj),
+      napi_generic_failure);
+
+  *result = v8impl::JsValueFromV8LocalValue(obj);
+  return napi_clear_last_error(env);
+}
@@ -173,6 +173,7 @@ static const unsigned kMaxSignal = 32;
 void WaitForInspectorDisconnect(Environment* env) {
 #if HAVE_INSPECTOR
   profiler::EndStartedProfilers(env);
+  profiler::EndContinuousProfilers(env);
 
   if (env->inspector_agent()->IsActive()) {
     // Restore signal dispositions, the app is done and is no longer
@@ -447,6 +448,12 @@ MaybeLocal<Value> StartMainThreadExecution(Environment* env) {
     return StartExecution(env, "internal/main/prof_process");
   }
 
+  // The snapshot file contains an application whose main function runs
+  // instead of a script.
+  if (!env->startup_snapshot_state().IsEmpty()) {
+    return StartExecution(env, "internal/main/run_snapshot_main");
+  }
+
   // -e/--eval without -i/--interactive
   if (env->options()->has_eval_string && !env->options()->force_repl) {
     return StartExecution(env, "internal/main/eval_string");
@@ -962,6 +969,31 @@ int Start(int argc, char** argv) {
     v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
     const std::vector<size_t>* indexes =
         NodeMainInstance::GetIsolateDataIndexes();
+
+    // A snapshot file replaces the embedded snapshot. Its contents have to
+    // stay alive for as long as the isolate, because the user context is
+    // deserialized after the isolate has been created.
+    std::string snapshot_file;
+    v8::StartupData file_blob;
+    std::vector<size_t> file_indexes;
+    bool has_user_context = false;
+    const std::string& snapshot_path = per_process::cli_options->snapshot_blob;
+    if (!snapshot_path.empty()) {
+      std::string error;
+      if (!NodeMainInstance::ReadSnapshotFile(snapshot_path,
+                                              &snapshot_file,
+                                              &file_blob,
+                                              &file_indexes,
+                                              &has_user_context,
+                                              &error)) {
+        fprintf(stderr, "%s: %s\n", result.args.at(0).c_str(), error.c_str());
+        TearDownOncePerProcess();
+        return 9;
+      }
+      blob = &file_blob;
+      indexes = &file_indexes;
+    }
+
     if (blob != nullptr) {
       params.external_references = external_references.data();
       params.snapshot_blob = blob;
@@ -972,7 +1004,8 @@ int Start(int argc, char** argv) {
                                    per_process::v8_platform.Platform(),
                                    result.args,
                                    result.exec_args,
-                                   indexes);
+                                   indexes,
+                                   has_user_context);
     result.exit_code = main_instance.Run();
   }
 
@@ -24,7 +24,10 @@
 #include "node_errors.h"
 #include "node_internals.h"
 
+#include "base_object-inl.h"
 #include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "simd_codecs.h"
 #include "string_bytes.h"
 #include "string_search.h"
 #include "util-inl.h"
@@ -33,6 +36,8 @@
 
 #include <cstring>
 #include <climits>
+#include <memory>
+#include <vector>
 
 #define THROW_AND_RETURN_UNLESS_BUFFER(env, obj)                            \
   THROW_AND_RETURN_IF_NOT_BUFFER(env, obj, "argument")                      \
@@ -62,6 +67,7 @@ using v8::ArrayBufferView;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::Global;
 using v8::Integer;
 using v8::Isolate;
@@ -71,6 +77,7 @@ using v8::Maybe;
 using v8::MaybeLocal;
 using v8::Nothing;
 using v8::Object;
+using v8::SharedArrayBuffer;
 using v8::String;
 using v8::Uint32;
 using v8::Uint32Array;
@@ -662,8 +669,34 @@ void ByteLengthUtf8(const FunctionCallbackInfo<Value> &args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK(args[0]->IsString());
 
+  Local<String> str = args[0].As<String>();
+  if (str->IsExternalOneByte()) {
+    auto ext = str->GetExternalOneByteStringResource();
+    size_t length = simd::Latin1Utf8Length(ext->data(), ext->length());
+    return args.GetReturnValue().Set(static_cast<double>(length));
+  }
+
   // Fast case: avoid StringBytes on UTF8 string. Jump to v8.
-  args.GetReturnValue().Set(args[0].As<String>()->Utf8Length(env->isolate()));
+  args.GetReturnValue().Set(str->Utf8Length(env->isolate()));
+}
+
+void IsUtf8(const FunctionCallbackInfo<Value>& args) {
+  bool result;
+  if (args[0]->IsArrayBuffer()) {
+    ArrayBuffer::Contents contents = args[0].As<ArrayBuffer>()->GetContents();
+    result = simd::ValidateUtf8(static_cast<const char*>(contents.Data()),
+                                contents.ByteLength());
+  } else if (args[0]->IsSharedArrayBuffer()) {
+    SharedArrayBuffer::Contents contents =
+        args[0].As<SharedArrayBuffer>()->GetContents();
+    result = simd::ValidateUtf8(static_cast<const char*>(contents.Data()),
+                                contents.ByteLength());
+  } else {
+    CHECK(args[0]->IsArrayBufferView());
+    ArrayBufferViewContents<char> buffer(args[0]);
+    result = simd::ValidateUtf8(buffer.data(), buffer.length());
+  }
+  args.GetReturnValue().Set(result);
 }
 
 // Normalize val to be an integer in the range of [1, -1] since
@@ -1003,6 +1036,141 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// A needle for Buffer#indexOf() and Buffer#lastIndexOf() that keeps its
+// search tables between calls, for code that searches for the same bytes
+// repeatedly, e.g. a multipart boundary.
+class BufferSearch : public BaseObject {
+ public:
+  BufferSearch(Environment* env,
+               Local<Object> object,
+               const char* needle,
+               size_t needle_length,
+               bool ucs2)
+      : BaseObject(env, object),
+        needle_(needle, needle + needle_length),
+        ucs2_(ucs2) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsArrayBufferView());
+    CHECK(args[1]->IsBoolean());
+    ArrayBufferViewContents<char> needle(args[0]);
+    new BufferSearch(env, args.This(), needle.data(), needle.length(),
+                     args[1]->IsTrue());
+  }
+
+  // Arguments and return value are the same as for IndexOfBuffer(), minus
+  // the needle and encoding.
+  static void IndexOf(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    BufferSearch* search;
+    ASSIGN_OR_RETURN_UNWRAP(&search, args.Holder());
+    CHECK(args[1]->IsNumber());
+    CHECK(args[2]->IsBoolean());
+
+    THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+    ArrayBufferViewContents<char> haystack_contents(args[0]);
+    int64_t offset_i64 = args[1].As<Integer>()->Value();
+    bool is_forward = args[2]->IsTrue();
+
+    const char* haystack = haystack_contents.data();
+    const size_t haystack_length = haystack_contents.length();
+    const size_t needle_length = search->needle_.size();
+
+    int64_t opt_offset = IndexOfOffset(haystack_length,
+                                       offset_i64,
+                                       needle_length,
+                                       is_forward);
+
+    if (needle_length == 0) {
+      // Match String#indexOf() and String#lastIndexOf() behavior.
+      args.GetReturnValue().Set(static_cast<double>(opt_offset));
+      return;
+    }
+
+    if (haystack_length == 0 || opt_offset <= -1) {
+      return args.GetReturnValue().Set(-1);
+    }
+    size_t offset = static_cast<size_t>(opt_offset);
+    CHECK_LT(offset, haystack_length);
+    if ((is_forward && needle_length + offset > haystack_length) ||
+        needle_length > haystack_length) {
+      return args.GetReturnValue().Set(-1);
+    }
+
+    size_t result = haystack_length;
+
+    if (search->ucs2_) {
+      if (haystack_length < 2 || needle_length < 2) {
+        return args.GetReturnValue().Set(-1);
+      }
+      result = SearchString(
+          search->GetSearch(search->search_ucs2_, is_forward),
+          reinterpret_cast<const uint16_t*>(haystack),
+          haystack_length / 2,
+          needle_length / 2,
+          offset / 2,
+          is_forward);
+      result *= 2;
+    } else {
+      result = SearchString(
+          search->GetSearch(search->search_, is_forward),
+          reinterpret_cast<const uint8_t*>(haystack),
+          haystack_length,
+          needle_length,
+          offset,
+          is_forward);
+    }
+
+    args.GetReturnValue().Set(
+        result == haystack_length ? -1 : static_cast<int>(result));
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("needle", needle_.size());
+    // The search tables are part of the StringSearch objects.
+    for (const SearchPtr<uint8_t>& search : search_) {
+      if (search)
+        tracker->TrackFieldWithSize("search", sizeof(*search));
+    }
+    for (const SearchPtr<uint16_t>& search : search_ucs2_) {
+      if (search)
+        tracker->TrackFieldWithSize("search_ucs2", sizeof(*search));
+    }
+  }
+
+  SET_MEMORY_INFO_NAME(BufferSearch)
+  SET_SELF_SIZE(BufferSearch)
+
+ private:
+  template <typename Char>
+  using SearchPtr = std::unique_ptr<stringsearch::StringSearch<Char>>;
+
+  // The search objects are created on first use, since each of them holds
+  // tables of a few kilobytes.
+  template <typename Char>
+  stringsearch::StringSearch<Char>* GetSearch(SearchPtr<Char> (&searches)[2],
+                                              bool is_forward) {
+    SearchPtr<Char>& search = searches[is_forward];
+    if (!search) {
+      stringsearch::Vector<const Char> pattern(
+          reinterpret_cast<const Char*>(needle_.data()),
+          needle_.size() / sizeof(Char),
+          is_forward);
+      search.reset(new stringsearch::StringSearch<Char>(pattern));
+    }
+    return search.get();
+  }
+
+  std::vector<char> needle_;
+  bool ucs2_;
+  SearchPtr<uint8_t> search_[2];
+  SearchPtr<uint16_t> search_ucs2_[2];
+};
+
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
@@ -1070,6 +1238,19 @@ void Initialize(Local<Object> target,
   env->SetMethodNoSideEffect(target, "createFromString", CreateFromString);
 
   env->SetMethodNoSideEffect(target, "byteLengthUtf8", ByteLengthUtf8);
+  env->SetMethodNoSideEffect(target, "isUtf8", IsUtf8);
+
+  Local<String> buffer_search_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "BufferSearch");
+  Local<FunctionTemplate> buffer_search =
+      env->NewFunctionTemplate(BufferSearch::New);
+  buffer_search->InstanceTemplate()->SetInternalFieldCount(1);
+  buffer_search->SetClassName(buffer_search_string);
+  env->SetProtoMethodNoSideEffect(buffer_search, "indexOf",
+                                  BufferSearch::IndexOf);
+  target->Set(env->context(), buffer_search_string,
+              buffer_search->GetFunction(env->context()).ToLocalChecked())
+      .Check();
   env->SetMethod(target, "copy", Copy);
   env->SetMethodNoSideEffect(target, "compare", Compare);
   env->SetMethodNoSideEffect(target, "compareOffset", CompareOffset);
@@ -30,6 +30,8 @@
 #include "module_wrap.h"
 #include "util-inl.h"
 
+#include <cinttypes>
+
 namespace node {
 namespace contextify {
 
@@ -1124,7 +1126,13 @@ void ContextifyContext::CompileFunction(
       WeakCallbackCompileFn,
       v8::WeakCallbackType::kParameter);
 
-  if (produce_cached_data) {
+  if (options == ScriptCompiler::kConsumeCodeCache) {
+    if (fn->Set(
+        parsing_context,
+        env->cached_data_rejected_string(),
+        Boolean::New(isolate, source.GetCachedData()->rejected)).IsNothing())
+      return;
+  } else if (produce_cached_data) {
     const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
         ScriptCompiler::CreateCodeCacheForFunction(fn));
     bool cached_data_produced = cached_data != nullptr;
@@ -1147,6 +1155,78 @@ void ContextifyContext::CompileFunction(
   args.GetReturnValue().Set(fn);
 }
 
+// createCodeCacheForFunction(fn): Returns a Buffer with the code cache of a
+// function returned by compileFunction(), which includes the inner functions
+// that have been compiled since, or undefined if V8 cannot produce it.
+static void CreateCodeCacheForFunction(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+      ScriptCompiler::CreateCodeCacheForFunction(args[0].As<Function>()));
+  if (cached_data == nullptr)
+    return;
+  Local<Object> buf;
+  if (Buffer::Copy(env,
+                   reinterpret_cast<const char*>(cached_data->data),
+                   cached_data->length).ToLocal(&buf)) {
+    args.GetReturnValue().Set(buf);
+  }
+}
+
+template <typename Char>
+static uint64_t HashCodeUnits(uint64_t hash, const Char* data, size_t length) {
+  for (size_t i = 0; i < length; i++)
+    hash = (hash ^ data[i]) * 0x100000001b3;
+  return hash;
+}
+
+// hashSource(source): Returns the 64-bit FNV-1a hash of the UTF-16 code
+// units of a string as a hexadecimal string. Every code unit is hashed as one
+// value, so the result does not depend on how V8 represents the string. The
+// contents of external strings are hashed in place; other strings are read
+// in chunks, without copying the whole source.
+static void HashSource(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  Local<String> source = args[0].As<String>();
+  uint64_t hash = 0xcbf29ce484222325;
+  if (source->IsExternalOneByte()) {
+    const String::ExternalOneByteStringResource* resource =
+        source->GetExternalOneByteStringResource();
+    hash = HashCodeUnits(hash,
+                         reinterpret_cast<const uint8_t*>(resource->data()),
+                         resource->length());
+  } else if (source->IsExternal()) {
+    const String::ExternalStringResource* resource =
+        source->GetExternalStringResource();
+    hash = HashCodeUnits(hash, resource->data(), resource->length());
+  } else {
+    const int length = source->Length();
+    const int kChunkSize = 1024;
+    if (source->IsOneByte()) {
+      uint8_t chunk[kChunkSize];
+      for (int start = 0; start < length; start += kChunkSize) {
+        const int written = source->WriteOneByte(
+            env->isolate(), chunk, start, kChunkSize,
+            String::NO_NULL_TERMINATION);
+        hash = HashCodeUnits(hash, chunk, written);
+      }
+    } else {
+      uint16_t chunk[kChunkSize];
+      for (int start = 0; start < length; start += kChunkSize) {
+        const int written = source->Write(
+            env->isolate(), chunk, start, kChunkSize,
+            String::NO_NULL_TERMINATION);
+        hash = HashCodeUnits(hash, chunk, written);
+      }
+    }
+  }
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016" PRIx64, hash);
+  args.GetReturnValue().Set(OneByteString(env->isolate(), hex));
+}
+
 static void StartSigintWatchdog(const FunctionCallbackInfo<Value>& args) {
   int ret = SigintWatchdogHelper::GetInstance()->Start();
   args.GetReturnValue().Set(ret == 0);
@@ -1170,6 +1250,10 @@ void Initialize(Local<Object> target,
   ContextifyContext::Init(env, target);
   ContextifyScript::Init(env, target);
 
+  env->SetMethod(target,
+                 "createCodeCacheForFunction",
+                 CreateCodeCacheForFunction);
+  env->SetMethodNoSideEffect(target, "hashSource", HashSource);
   env->SetMethod(target, "startSigintWatchdog", StartSigintWatchdog);
   env->SetMethod(target, "stopSigintWatchdog", StopSigintWatchdog);
   // Used in tests.
@@ -0,0 +1,203 @@
+#include "node_dns_cache.h"
+#include "util-inl.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace node {
+
+namespace {
+
+const size_t kHeaderSize = 12;
+const size_t kFixedRecordSize = 10;  // Type, class, TTL and data length.
+const uint16_t kTypeSoa = 6;
+// The EDNS pseudo-record, whose TTL field holds flags.
+const uint16_t kTypeOpt = 41;
+const uint64_t kNanosPerSecond = 1000 * 1000 * 1000;
+
+inline uint16_t ReadUint16(const unsigned char* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t ReadUint32(const unsigned char* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) |
+         static_cast<uint32_t>(p[3]);
+}
+
+inline void WriteUint32(unsigned char* p, uint32_t value) {
+  p[0] = static_cast<unsigned char>(value >> 24);
+  p[1] = static_cast<unsigned char>(value >> 16);
+  p[2] = static_cast<unsigned char>(value >> 8);
+  p[3] = static_cast<unsigned char>(value);
+}
+
+// Advances `*offset` past the (possibly compressed) domain name at it.
+bool SkipName(const unsigned char* buf, size_t len, size_t* offset) {
+  while (*offset < len) {
+    const unsigned char label = buf[*offset];
+    if ((label & 0xc0) == 0xc0) {
+      *offset += 2;
+      return *offset <= len;
+    }
+    *offset += 1 + label;
+    if (label == 0)
+      return true;
+  }
+  return false;
+}
+
+// Advances `*offset` past the question section of the response in `buf`.
+bool SkipQuestions(const unsigned char* buf, size_t len, size_t* offset) {
+  const uint16_t question_count = ReadUint16(buf + 4);
+  for (uint16_t i = 0; i < question_count; i++) {
+    if (!SkipName(buf, len, offset))
+      return false;
+    *offset += 4;  // Type and class.
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+const size_t DnsCache::kMaxEntries;
+const uint32_t DnsCache::kMaxNegativeTtl;
+
+bool DnsCache::Lookup(const std::string& key, uint64_t now, Entry* entry) {
+  Mutex::ScopedLock lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second.expiry->first <= now) {
+    if (it != entries_.end())
+      Erase(it);
+    stats_.misses++;
+    return false;
+  }
+  *entry = it->second.entry;
+  stats_.hits++;
+  const uint64_t age = (now - it->second.inserted_at) / kNanosPerSecond;
+  if (age > 0 && !entry->answer.empty()) {
+    AgeResponse(reinterpret_cast<unsigned char*>(&entry->answer[0]),
+                entry->answer.size(),
+                static_cast<uint32_t>(std::min<uint64_t>(age, UINT32_MAX)));
+  }
+  return true;
+}
+
+void DnsCache::Insert(const std::string& key,
+                      Entry&& entry,
+                      uint32_t ttl,
+                      uint64_t now) {
+  ttl = std::min(ttl, max_ttl_);
+  if (entry.status != 0)
+    ttl = std::min(ttl, kMaxNegativeTtl);
+  if (ttl == 0)
+    return;
+
+  Mutex::ScopedLock lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end())
+    Erase(it);
+  while (entries_.size() >= kMaxEntries)
+    Erase(entries_.find(expiries_.begin()->second));
+
+  ExpiryMap::iterator expiry =
+      expiries_.emplace(now + ttl * kNanosPerSecond, key);
+  entries_.emplace(key, Slot { std::move(entry), expiry, now });
+}
+
+void DnsCache::RecordCoalesced() {
+  Mutex::ScopedLock lock(mutex_);
+  stats_.coalesced++;
+}
+
+void DnsCache::Clear() {
+  Mutex::ScopedLock lock(mutex_);
+  entries_.clear();
+  expiries_.clear();
+}
+
+DnsCache::Stats DnsCache::stats() const {
+  Mutex::ScopedLock lock(mutex_);
+  Stats stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void DnsCache::Erase(std::unordered_map<std::string, Slot>::iterator it) {
+  expiries_.erase(it->second.expiry);
+  entries_.erase(it);
+}
+
+uint32_t DnsCache::ResponseTtl(const unsigned char* buf, size_t len) {
+  if (len < kHeaderSize)
+    return 0;
+  const uint16_t answer_count = ReadUint16(buf + 6);
+  const uint16_t authority_count = ReadUint16(buf + 8);
+
+  size_t offset = kHeaderSize;
+  if (!SkipQuestions(buf, len, &offset))
+    return 0;
+
+  const bool negative = answer_count == 0;
+  const uint16_t record_count = negative ? authority_count : answer_count;
+  bool found = false;
+  uint32_t ttl = 0;
+  for (uint16_t i = 0; i < record_count; i++) {
+    if (!SkipName(buf, len, &offset) || offset + kFixedRecordSize > len)
+      return 0;
+    const uint16_t type = ReadUint16(buf + offset);
+    uint32_t record_ttl = ReadUint32(buf + offset + 4);
+    const uint16_t data_length = ReadUint16(buf + offset + 8);
+    offset += kFixedRecordSize;
+    if (offset + data_length > len)
+      return 0;
+
+    if (negative) {
+      // The last field of the SOA record is the TTL for negative answers.
+      if (type != kTypeSoa || data_length < 22) {
+        offset += data_length;
+        continue;
+      }
+      record_ttl = std::min(record_ttl,
+                            ReadUint32(buf + offset + data_length - 4));
+    }
+    offset += data_length;
+    // TTLs are signed 32-bit numbers that are treated as 0 when negative.
+    if (record_ttl > INT32_MAX)
+      record_ttl = 0;
+    ttl = found ? std::min(ttl, record_ttl) : record_ttl;
+    found = true;
+  }
+  return ttl;
+}
+
+bool DnsCache::AgeResponse(unsigned char* buf, size_t len, uint32_t seconds) {
+  if (len < kHeaderSize)
+    return false;
+  // The answer, authority and additional sections.
+  const uint32_t record_count = static_cast<uint32_t>(ReadUint16(buf + 6)) +
+                                ReadUint16(buf + 8) + ReadUint16(buf + 10);
+
+  size_t offset = kHeaderSize;
+  if (!SkipQuestions(buf, len, &offset))
+    return false;
+  for (uint32_t i = 0; i < record_count; i++) {
+    if (!SkipName(buf, len, &offset) || offset + kFixedRecordSize > len)
+      return false;
+    const uint16_t type = ReadUint16(buf + offset);
+    const uint32_t ttl = ReadUint32(buf + offset + 4);
+    const uint16_t data_length = ReadUint16(buf + offset + 8);
+    if (type != kTypeOpt) {
+      const uint32_t remaining =
+          ttl > INT32_MAX || ttl <= seconds ? 0 : ttl - seconds;
+      WriteUint32(buf + offset + 4, remaining);
+    }
+    offset += kFixedRecordSize + data_length;
+    if (offset > len)
+      return false;
+  }
+  return true;
+}
+
+}  // namespace node
@@ -0,0 +1,99 @@
+#ifndef SRC_NODE_DNS_CACHE_H_
+#define SRC_NODE_DNS_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+
+// A process-wide cache of the results of dns.lookup() and of the queries
+// made by dns.Resolver, enabled with --dns-cache-max-ttl. Entries expire
+// after the TTL of the answer, capped at the configured maximum, and failed
+// lookups that say that a name or record does not exist are kept for at most
+// kMaxNegativeTtl seconds. The cache is bounded by kMaxEntries; the entries
+// that expire first are evicted first. The TTLs in cached responses are
+// reduced by the time that the response has spent in the cache, like a
+// caching resolver would do.
+//
+// The cache is shared by all threads. It only stores data; the callers
+// decide what the keys are and how long an answer may be used.
+class DnsCache {
+ public:
+  static const size_t kMaxEntries = 4096;
+  static const uint32_t kMaxNegativeTtl = 30;
+
+  struct Entry {
+    // 0 or ARES_SUCCESS for answers, the error code for negative entries.
+    int status = 0;
+    // The raw response of a c-ares query.
+    std::string answer;
+    // The addresses returned by getaddrinfo(), in the order they are
+    // reported to JavaScript.
+    std::vector<std::string> addresses;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Lookups that waited for an identical lookup that was in flight.
+    uint64_t coalesced = 0;
+    uint64_t entries = 0;
+  };
+
+  // `max_ttl` is in seconds. The cache is disabled if it is 0.
+  explicit DnsCache(uint32_t max_ttl) : max_ttl_(max_ttl) {}
+  DnsCache(const DnsCache&) = delete;
+  DnsCache& operator=(const DnsCache&) = delete;
+
+  inline bool enabled() const { return max_ttl_ > 0; }
+
+  // `now` is a timestamp in nanoseconds, as returned by uv_hrtime().
+  // The TTLs in `entry->answer` are those that remain at `now`.
+  bool Lookup(const std::string& key, uint64_t now, Entry* entry);
+  // Does nothing if `ttl`, in seconds, is 0.
+  void Insert(const std::string& key, Entry&& entry, uint32_t ttl,
+              uint64_t now);
+  void RecordCoalesced();
+  void Clear();
+  Stats stats() const;
+
+  // Returns the number of seconds for which the DNS response in `buf` may be
+  // cached: the smallest TTL of the records in the answer section, or, if
+  // there are none, the TTL of the SOA record in the authority section as
+  // described in RFC 2308. Returns 0 if the response cannot be parsed or
+  // there are no such records.
+  static uint32_t ResponseTtl(const unsigned char* buf, size_t len);
+  // Subtracts `seconds` from the TTLs of the records in the DNS response in
+  // `buf`, stopping at 0. Returns false if the response cannot be parsed, in
+  // which case the records before the error have been updated.
+  static bool AgeResponse(unsigned char* buf, size_t len, uint32_t seconds);
+
+ private:
+  using ExpiryMap = std::multimap<uint64_t, std::string>;
+
+  struct Slot {
+    Entry entry;
+    ExpiryMap::iterator expiry;
+    uint64_t inserted_at;
+  };
+
+  void Erase(std::unordered_map<std::string, Slot>::iterator it);
+
+  const uint32_t max_ttl_;
+  mutable Mutex mutex_;
+  std::unordered_map<std::string, Slot> entries_;
+  ExpiryMap expiries_;
+  Stats stats_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_DNS_CACHE_H_
@@ -33,10 +33,17 @@
 #include "stream_base-inl.h"
 #include "string_bytes.h"
 #include "string_search.h"
+#include "threadpoolwork-inl.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#if defined(__linux__)
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <linux/fs.h>
+# include <unistd.h>
+#endif
 #include <cstring>
 #include <cerrno>
 #include <climits>
@@ -82,6 +89,10 @@ using v8::Value;
 # define S_ISDIR(mode)  (((mode) & S_IFMT) == S_IFDIR)
 #endif
 
+#ifndef S_ISREG
+# define S_ISREG(mode)  (((mode) & S_IFMT) == S_IFREG)
+#endif
+
 #ifdef __POSIX__
 constexpr char kPathSeparator = '/';
 #else
@@ -1646,6 +1657,426 @@ static void CopyFile(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+CopyTreeJob::CopyTreeJob(Environment* env,
+                         Local<Object> obj,
+                         std::string&& src,
+                         std::string&& dest,
+                         int flags,
+                         uint32_t concurrency)
+    : AsyncWrap(env, obj, AsyncWrap::PROVIDER_COPYTREEJOB),
+      flags_(flags),
+      concurrency_(concurrency),
+      progress_(env->isolate(), kCopyTreeFieldsCount) {
+  MakeWeak();
+  queue_.push_back(Entry { std::move(src), std::move(dest) });
+  obj->Set(env->context(),
+           FIXED_ONE_BYTE_STRING(env->isolate(), "progress"),
+           progress_.GetJSArray()).Check();
+}
+
+void CopyTreeJob::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("progress", progress_);
+  tracker->TrackFieldWithSize("queue", queue_.size() * sizeof(Entry));
+}
+
+// new CopyTreeJob(src, dest, flags, concurrency)
+void CopyTreeJob::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK_EQ(args.Length(), 4);
+
+  BufferValue src(env->isolate(), args[0]);
+  CHECK_NOT_NULL(*src);
+  BufferValue dest(env->isolate(), args[1]);
+  CHECK_NOT_NULL(*dest);
+  CHECK(args[2]->IsInt32());
+  CHECK(args[3]->IsUint32());
+  const uint32_t concurrency = args[3].As<Uint32>()->Value();
+  CHECK_GT(concurrency, 0);
+
+  new CopyTreeJob(env,
+                  args.This(),
+                  std::string(*src, src.length()),
+                  std::string(*dest, dest.length()),
+                  args[2].As<Int32>()->Value(),
+                  concurrency);
+}
+
+void CopyTreeJob::Start(const FunctionCallbackInfo<Value>& args) {
+  CopyTreeJob* job;
+  ASSIGN_OR_RETURN_UNWRAP(&job, args.Holder());
+  CHECK(job->workers_.empty());
+
+  // Keep the JS object alive until the oncomplete callback has run.
+  job->ClearWeak();
+  job->ScheduleWorkers();
+}
+
+void CopyTreeJob::ReadProgress(const FunctionCallbackInfo<Value>& args) {
+  CopyTreeJob* job;
+  ASSIGN_OR_RETURN_UNWRAP(&job, args.Holder());
+  job->progress_[kCopyTreeFiles] = job->files_.load();
+  job->progress_[kCopyTreeDirectories] = job->directories_.load();
+  job->progress_[kCopyTreeSymlinks] = job->symlinks_.load();
+  job->progress_[kCopyTreeBytes] = job->bytes_.load();
+}
+
+void CopyTreeJob::Worker::DoThreadPoolWork() {
+  job_->Run();
+}
+
+void CopyTreeJob::Worker::AfterThreadPoolWork(int status) {
+  job_->OnWorkerDone(this, status);
+}
+
+// Workers never wait for entries that other workers may still add to the
+// queue, so that they do not keep threadpool threads away from unrelated
+// work. A worker returns once the queue is empty, after kEntriesPerRun
+// entries, or as soon as it has added entries that idle workers could take
+// on; the event loop thread then schedules as many workers as there are
+// entries to work on, up to `concurrency`.
+void CopyTreeJob::Run() {
+  Entry entry;
+  for (size_t i = 0; i < kEntriesPerRun && PopEntry(&entry); i++) {
+    const char* syscall = nullptr;
+    int err = CopyEntry(entry, &syscall);
+    if (!FinishEntry(err, syscall, entry))
+      break;
+  }
+
+  Mutex::ScopedLock lock(mutex_);
+  CHECK_GT(running_, 0);
+  // No new worker is scheduled once the queue is empty, so the last worker
+  // to return is the one that gives read-only directories their final mode.
+  if (--running_ == 0 && queue_.empty() && error_ == 0) {
+    for (const auto& dir : readonly_dirs_) {
+      uv_fs_t req;
+      int err = uv_fs_chmod(nullptr, &req, dir.first.c_str(), dir.second,
+                            nullptr);
+      uv_fs_req_cleanup(&req);
+      if (err < 0) {
+        error_ = err;
+        error_syscall_ = "chmod";
+        error_path_ = dir.first;
+        error_dest_.clear();
+        break;
+      }
+    }
+  }
+}
+
+bool CopyTreeJob::PopEntry(Entry* entry) {
+  Mutex::ScopedLock lock(mutex_);
+  if (queue_.empty() || error_ != 0)
+    return false;
+  *entry = std::move(queue_.front());
+  queue_.pop_front();
+  return true;
+}
+
+void CopyTreeJob::PushEntry(Entry&& entry) {
+  Mutex::ScopedLock lock(mutex_);
+  queue_.push_back(std::move(entry));
+}
+
+// Returns whether the worker should go on with the next entry.
+bool CopyTreeJob::FinishEntry(int err,
+                              const char* syscall,
+                              const Entry& entry) {
+  Mutex::ScopedLock lock(mutex_);
+  if (err < 0 && error_ == 0) {
+    error_ = err;
+    error_syscall_ = syscall;
+    error_path_ = entry.src;
+    error_dest_ = entry.dest;
+  }
+  return error_ == 0 &&
+         (running_ >= concurrency_ || queue_.size() <= running_);
+}
+
+// Called on the event loop thread. Returns whether any worker is running.
+bool CopyTreeJob::ScheduleWorkers() {
+  Mutex::ScopedLock lock(mutex_);
+  while (error_ == 0 &&
+         running_ < concurrency_ &&
+         running_ < queue_.size()) {
+    Worker* worker;
+    if (idle_workers_.empty()) {
+      workers_.emplace_back(new Worker(this));
+      worker = workers_.back().get();
+    } else {
+      worker = idle_workers_.back();
+      idle_workers_.pop_back();
+    }
+    running_++;
+    active_workers_++;
+    worker->ScheduleWork();
+  }
+  return active_workers_ > 0;
+}
+
+int CopyTreeJob::CopyEntry(const Entry& entry, const char** syscall) {
+  uv_fs_t req;
+  int err = uv_fs_lstat(nullptr, &req, entry.src.c_str(), nullptr);
+  const uv_stat_t st = req.statbuf;
+  uv_fs_req_cleanup(&req);
+  if (err < 0) {
+    *syscall = "lstat";
+    return err;
+  }
+
+  if (S_ISDIR(st.st_mode))
+    return CopyDirectory(entry, st.st_mode & 0777, syscall);
+#ifdef S_ISLNK
+  if (S_ISLNK(st.st_mode))
+    return CopySymlink(entry, syscall);
+#endif
+  // Opening a FIFO would block until it has a writer, and devices and
+  // sockets cannot be copied like files either.
+  if (!S_ISREG(st.st_mode)) {
+    *syscall = "copyfile";
+    return UV_EINVAL;
+  }
+  return CopyRegularFile(entry, st, syscall);
+}
+
+int CopyTreeJob::CopyDirectory(const Entry& entry,
+                               int mode,
+                               const char** syscall) {
+  uv_fs_t req;
+  int err = uv_fs_mkdir(nullptr, &req, entry.dest.c_str(), mode, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err == UV_EEXIST && !(flags_ & UV_FS_COPYFILE_EXCL)) {
+    err = uv_fs_stat(nullptr, &req, entry.dest.c_str(), nullptr);
+    if (err == 0 && !S_ISDIR(req.statbuf.st_mode))
+      err = UV_ENOTDIR;
+    uv_fs_req_cleanup(&req);
+  }
+  if (err < 0) {
+    *syscall = "mkdir";
+    return err;
+  }
+
+  // Set the mode explicitly, because mkdir() applies the umask and does not
+  // change directories that already exist. Directories that the owner cannot
+  // write to get their mode only after everything has been copied into them.
+  const int owner = 0700;
+  err = uv_fs_chmod(nullptr, &req, entry.dest.c_str(), mode | owner, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err < 0) {
+    *syscall = "chmod";
+    return err;
+  }
+  if ((mode & owner) != owner) {
+    Mutex::ScopedLock lock(mutex_);
+    readonly_dirs_.emplace_back(entry.dest, mode);
+  }
+
+  err = uv_fs_scandir(nullptr, &req, entry.src.c_str(), 0, nullptr);
+  if (err < 0) {
+    uv_fs_req_cleanup(&req);
+    *syscall = "scandir";
+    return err;
+  }
+
+#ifdef _WIN32
+  const char separator = '\\';
+#else
+  const char separator = '/';
+#endif
+  uv_dirent_t ent;
+  while ((err = uv_fs_scandir_next(&req, &ent)) != UV_EOF) {
+    if (err < 0) break;
+    PushEntry(Entry { entry.src + separator + ent.name,
+                      entry.dest + separator + ent.name });
+  }
+  uv_fs_req_cleanup(&req);
+  if (err < 0 && err != UV_EOF) {
+    *syscall = "scandir";
+    return err;
+  }
+
+  directories_++;
+  return 0;
+}
+
+int CopyTreeJob::CopySymlink(const Entry& entry, const char** syscall) {
+  uv_fs_t req;
+  int err = uv_fs_readlink(nullptr, &req, entry.src.c_str(), nullptr);
+  if (err < 0) {
+    uv_fs_req_cleanup(&req);
+    *syscall = "readlink";
+    return err;
+  }
+  const std::string target(static_cast<const char*>(req.ptr));
+  uv_fs_req_cleanup(&req);
+
+  err = uv_fs_symlink(nullptr, &req, target.c_str(), entry.dest.c_str(), 0,
+                      nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err == UV_EEXIST && !(flags_ & UV_FS_COPYFILE_EXCL)) {
+    err = uv_fs_unlink(nullptr, &req, entry.dest.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err == 0) {
+      err = uv_fs_symlink(nullptr, &req, target.c_str(), entry.dest.c_str(),
+                          0, nullptr);
+      uv_fs_req_cleanup(&req);
+    }
+  }
+  if (err < 0) {
+    *syscall = "symlink";
+    return err;
+  }
+
+  symlinks_++;
+  return 0;
+}
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+// Copies the file contents inside the kernel, cloning the extents when the
+// filesystem supports reflinks. If copy_file_range() is not available for
+// this pair of files, falls back to sendfile() like uv_fs_copyfile() does.
+static int CopyFileRange(const char* src,
+                         const char* dest,
+                         int flags,
+                         const uv_stat_t& st,
+                         const char** failed_syscall) {
+  int in_fd = open(src, O_RDONLY | O_CLOEXEC);
+  if (in_fd == -1) {
+    *failed_syscall = "open";
+    return -errno;
+  }
+
+  int out_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  if (flags & UV_FS_COPYFILE_EXCL)
+    out_flags |= O_EXCL;
+  int out_fd = open(dest, out_flags, st.st_mode & 07777);
+  if (out_fd == -1) {
+    *failed_syscall = "open";
+    int err = -errno;
+    close(in_fd);
+    return err;
+  }
+
+  int err = 0;
+  if (fchmod(out_fd, st.st_mode & 07777) == -1) {
+    *failed_syscall = "fchmod";
+    err = -errno;
+    goto out;
+  }
+
+#ifdef FICLONE
+  if (flags & (UV_FS_COPYFILE_FICLONE | UV_FS_COPYFILE_FICLONE_FORCE)) {
+    if (ioctl(out_fd, FICLONE, in_fd) == 0)
+      goto out;
+    if (flags & UV_FS_COPYFILE_FICLONE_FORCE) {
+      *failed_syscall = "copyfile";
+      err = (errno == ENOTTY || errno == EOPNOTSUPP || errno == EXDEV) ?
+          UV_ENOTSUP : -errno;
+      goto out;
+    }
+  }
+#endif
+
+  {
+    uint64_t remaining = st.st_size;
+    int64_t offset = 0;
+    bool use_sendfile = false;
+    while (remaining > 0) {
+      ssize_t n;
+      if (use_sendfile) {
+        uv_fs_t req;
+        n = uv_fs_sendfile(nullptr, &req, out_fd, in_fd, offset, remaining,
+                           nullptr);
+        uv_fs_req_cleanup(&req);
+        if (n < 0) {
+          *failed_syscall = "sendfile";
+          err = n;
+          break;
+        }
+      } else {
+        n = syscall(__NR_copy_file_range,
+                    in_fd, nullptr, out_fd, nullptr, remaining, 0);
+        if (n == -1) {
+          if (errno == EINTR) continue;
+          // Cross-filesystem copies fail with EXDEV on older kernels, and
+          // some filesystems do not implement the call at all.
+          if (offset == 0 && (errno == ENOSYS || errno == EXDEV ||
+                              errno == EINVAL || errno == EOPNOTSUPP)) {
+            use_sendfile = true;
+            continue;
+          }
+          *failed_syscall = "copy_file_range";
+          err = -errno;
+          break;
+        }
+      }
+      if (n == 0) break;  // The source file was truncated.
+      remaining -= n;
+      offset += n;
+    }
+  }
+
+ out:
+  close(in_fd);
+  if (close(out_fd) == -1 && err == 0) {
+    *failed_syscall = "close";
+    err = -errno;
+  }
+  if (err < 0)
+    unlink(dest);
+  return err;
+}
+#endif
+
+int CopyTreeJob::CopyRegularFile(const Entry& entry,
+                                 const uv_stat_t& st,
+                                 const char** syscall) {
+#if defined(__linux__) && defined(__NR_copy_file_range)
+  int err = CopyFileRange(entry.src.c_str(), entry.dest.c_str(), flags_, st,
+                          syscall);
+#else
+  uv_fs_t req;
+  int err = uv_fs_copyfile(nullptr, &req, entry.src.c_str(),
+                           entry.dest.c_str(), flags_, nullptr);
+  uv_fs_req_cleanup(&req);
+  *syscall = "copyfile";
+#endif
+  if (err < 0)
+    return err;
+
+  files_++;
+  bytes_ += st.st_size;
+  return 0;
+}
+
+void CopyTreeJob::OnWorkerDone(Worker* worker, int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  CHECK_GT(active_workers_, 0);
+  active_workers_--;
+  idle_workers_.push_back(worker);
+  if (!ScheduleWorkers())
+    Done();
+}
+
+void CopyTreeJob::Done() {
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  MakeWeak();
+
+  Local<Value> arg = Undefined(env()->isolate());
+  if (error_ != 0) {
+    arg = UVException(env()->isolate(),
+                      error_,
+                      error_syscall_,
+                      nullptr,
+                      error_path_.c_str(),
+                      error_dest_.c_str());
+  }
+  MakeCallback(env()->oncomplete_string(), 1, &arg);
+}
+
+
 // Wrapper for write(2).
 //
 // bytesWritten = write(fd, buffer, offset, length, position, callback)
@@ -2210,8 +2641,27 @@ void Initialize(Local<Object> target,
               FIXED_ONE_BYTE_STRING(isolate, "bigintStatValues"),
               env->fs_stats_field_bigint_array()->GetJSArray()).Check();
 
+  NODE_DEFINE_CONSTANT(target, kCopyTreeFiles);
+  NODE_DEFINE_CONSTANT(target, kCopyTreeDirectories);
+  NODE_DEFINE_CONSTANT(target, kCopyTreeSymlinks);
+  NODE_DEFINE_CONSTANT(target, kCopyTreeBytes);
+
   StatWatcher::Initialize(env, target);
 
+  // Create FunctionTemplate for CopyTreeJob
+  Local<FunctionTemplate> ctj = env->NewFunctionTemplate(CopyTreeJob::New);
+  ctj->InstanceTemplate()->SetInternalFieldCount(1);
+  ctj->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(ctj, "start", CopyTreeJob::Start);
+  env->SetProtoMethod(ctj, "readProgress", CopyTreeJob::ReadProgress);
+  Local<String> copyTreeJobString =
+      FIXED_ONE_BYTE_STRING(isolate, "CopyTreeJob");
+  ctj->SetClassName(copyTreeJobString);
+  target
+      ->Set(context, copyTreeJobString,
+            ctj->GetFunction(env->context()).ToLocalChecked())
+      .Check();
+
   // Create FunctionTemplate for FSReqCallback
   Local<FunctionTemplate> fst = env->NewFunctionTemplate(NewFSReqCallback);
   fst->InstanceTemplate()->SetInternalFieldCount(1);
@@ -4,9 +4,16 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "node.h"
+#include "node_internals.h"
+#include "node_mutex.h"
 #include "stream_base.h"
 #include "req_wrap-inl.h"
 
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace node {
 
 using v8::Context;
@@ -468,6 +475,107 @@ class FileHandle : public AsyncWrap, public StreamBase {
   std::unique_ptr<FileHandleReadWrap> current_read_ = nullptr;
 };
 
+// Indices into the progress array of a CopyTreeJob.
+enum CopyTreeProgressFields {
+  kCopyTreeFiles,
+  kCopyTreeDirectories,
+  kCopyTreeSymlinks,
+  kCopyTreeBytes,
+  kCopyTreeFieldsCount
+};
+
+// Recursively copies a directory tree on the threadpool. Directories are
+// expanded into a shared work queue that is drained by up to `concurrency`
+// threadpool workers, so that a tree with many small files is bound by I/O
+// rather than by one JS round trip per file. Workers never block waiting for
+// entries; they are scheduled again from the event loop thread instead.
+// Progress counters are kept in atomics on the worker side and copied into
+// an aliased Float64Array on request from JS.
+class CopyTreeJob : public AsyncWrap {
+ public:
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Start(const FunctionCallbackInfo<Value>& args);
+  static void ReadProgress(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(CopyTreeJob)
+  SET_SELF_SIZE(CopyTreeJob)
+
+  CopyTreeJob(const CopyTreeJob&) = delete;
+  CopyTreeJob& operator=(const CopyTreeJob&) = delete;
+  CopyTreeJob(const CopyTreeJob&&) = delete;
+  CopyTreeJob& operator=(const CopyTreeJob&&) = delete;
+
+ private:
+  struct Entry {
+    std::string src;
+    std::string dest;
+  };
+
+  class Worker : public ThreadPoolWork {
+   public:
+    explicit Worker(CopyTreeJob* job)
+        : ThreadPoolWork(job->env(), kFileSystem), job_(job) {}
+
+    void DoThreadPoolWork() override;
+    void AfterThreadPoolWork(int status) override;
+
+   private:
+    CopyTreeJob* job_;
+  };
+
+  CopyTreeJob(Environment* env,
+              Local<Object> obj,
+              std::string&& src,
+              std::string&& dest,
+              int flags,
+              uint32_t concurrency);
+
+  // The number of entries a worker copies before it returns its thread to
+  // the threadpool.
+  static const size_t kEntriesPerRun = 64;
+
+  // Called on the threadpool.
+  void Run();
+  bool PopEntry(Entry* entry);
+  void PushEntry(Entry&& entry);
+  bool FinishEntry(int err, const char* syscall, const Entry& entry);
+  int CopyEntry(const Entry& entry, const char** syscall);
+  int CopyDirectory(const Entry& entry, int mode, const char** syscall);
+  int CopySymlink(const Entry& entry, const char** syscall);
+  int CopyRegularFile(const Entry& entry,
+                      const uv_stat_t& st,
+                      const char** syscall);
+
+  // Called on the event loop thread.
+  bool ScheduleWorkers();
+  void OnWorkerDone(Worker* worker, int status);
+  void Done();
+
+  const int flags_;
+  const uint32_t concurrency_;
+  uint32_t active_workers_ = 0;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<Worker*> idle_workers_;
+
+  Mutex mutex_;
+  std::deque<Entry> queue_;
+  // Workers that are scheduled and have not yet returned from Run().
+  size_t running_ = 0;
+  // Destination directories and the modes they get once the copy is done.
+  std::vector<std::pair<std::string, int>> readonly_dirs_;
+  int error_ = 0;
+  const char* error_syscall_ = nullptr;
+  std::string error_path_;
+  std::string error_dest_;
+
+  std::atomic<uint64_t> files_{0};
+  std::atomic<uint64_t> directories_{0};
+  std::atomic<uint64_t> symlinks_{0};
+  std::atomic<uint64_t> bytes_{0};
+  AliasedFloat64Array progress_;
+};
+
 int MKDirpSync(uv_loop_t* loop,
                uv_fs_t* req,
                const std::string& path,
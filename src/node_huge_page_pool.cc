@@ -0,0 +1,107 @@
+#include "node_huge_page_pool.h"
+#include "util.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <sys/mman.h>
+#endif
+
+namespace node {
+
+HugePagePool::~HugePagePool() {
+  for (const auto& free_list : free_lists_) {
+    for (void* block : free_list.second)
+      free(block);
+  }
+}
+
+bool HugePagePool::IsSupported() {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t HugePagePool::Capacity(size_t size) {
+  return RoundUp(size, kHugePageSize);
+}
+
+void* HugePagePool::Allocate(size_t size, bool zero_fill) {
+  CHECK_GE(size, kMinSize);
+  const size_t capacity = Capacity(size);
+  void* block = nullptr;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = free_lists_.find(capacity);
+    if (it != free_lists_.end()) {
+      block = it->second.back();
+      it->second.pop_back();
+      if (it->second.empty())
+        free_lists_.erase(it);
+      cached_bytes_ -= capacity;
+    }
+  }
+
+  if (block == nullptr) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (posix_memalign(&block, kHugePageSize, capacity) != 0)
+      return nullptr;
+    // Failure only means that the block is backed by normal pages.
+    madvise(block, capacity, MADV_HUGEPAGE);
+#else
+    UNREACHABLE();
+#endif
+  }
+  if (zero_fill)
+    memset(block, 0, size);
+
+  Mutex::ScopedLock lock(mutex_);
+  in_use_[block] = capacity;
+  in_use_bytes_ += capacity;
+  return block;
+}
+
+bool HugePagePool::Free(void* data) {
+  Mutex::ScopedLock lock(mutex_);
+  auto it = in_use_.find(data);
+  if (it == in_use_.end())
+    return false;
+  const size_t capacity = it->second;
+  in_use_.erase(it);
+  in_use_bytes_ -= capacity;
+
+  // If the block was released with free() by someone else, its address may
+  // have been reused for an unrelated allocation, which must not be handed
+  // out with the capacity of the old block.
+  bool reusable = cached_bytes_ + capacity <= kMaxCachedBytes;
+#if defined(__linux__)
+  reusable = reusable && malloc_usable_size(data) >= capacity;
+#endif
+  if (!reusable) {
+    free(data);
+    return true;
+  }
+  free_lists_[capacity].push_back(data);
+  cached_bytes_ += capacity;
+  return true;
+}
+
+void HugePagePool::Release(void* data) {
+  Mutex::ScopedLock lock(mutex_);
+  auto it = in_use_.find(data);
+  if (it == in_use_.end())
+    return;
+  in_use_bytes_ -= it->second;
+  in_use_.erase(it);
+}
+
+size_t HugePagePool::total_bytes() const {
+  Mutex::ScopedLock lock(mutex_);
+  return in_use_bytes_ + cached_bytes_;
+}
+
+}  // namespace node
@@ -0,0 +1,65 @@
+#ifndef SRC_NODE_HUGE_PAGE_POOL_H_
+#define SRC_NODE_HUGE_PAGE_POOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+
+// Serves large ArrayBuffer allocations from blocks that are aligned to huge
+// page boundaries and advised with MADV_HUGEPAGE, so that the kernel backs
+// them with transparent huge pages, and keeps freed blocks for reuse.
+//
+// The blocks are ordinary malloc() allocations, because some code takes over
+// the contents of ArrayBuffers and releases them with free(). Such blocks are
+// simply lost to the pool.
+class HugePagePool {
+ public:
+  static const size_t kHugePageSize = 2 * 1024 * 1024;
+  // Smaller allocations would waste too much of their last huge page.
+  static const size_t kMinSize = kHugePageSize;
+  // The most memory that is kept in free lists.
+  static const size_t kMaxCachedBytes = 64 * 1024 * 1024;
+
+  HugePagePool() = default;
+  ~HugePagePool();
+  HugePagePool(const HugePagePool&) = delete;
+  HugePagePool& operator=(const HugePagePool&) = delete;
+
+  // Returns false on platforms without transparent huge pages.
+  static bool IsSupported();
+
+  // Returns nullptr if the memory could not be allocated.
+  void* Allocate(size_t size, bool zero_fill);
+  // Returns false if `data` does not come from this pool, in which case the
+  // caller has to free() it.
+  bool Free(void* data);
+  // Stops tracking `data`, e.g. because it is about to be realloc()ed. Does
+  // nothing if it does not come from this pool.
+  void Release(void* data);
+
+  // The number of bytes in blocks that are in use or kept for reuse.
+  size_t total_bytes() const;
+
+ private:
+  static size_t Capacity(size_t size);
+
+  mutable Mutex mutex_;
+  // Blocks that have been handed out, by address, with their capacity.
+  std::unordered_map<void*, size_t> in_use_;
+  // Freed blocks by capacity.
+  std::map<size_t, std::vector<void*>> free_lists_;
+  size_t in_use_bytes_ = 0;
+  size_t cached_bytes_ = 0;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_HUGE_PAGE_POOL_H_
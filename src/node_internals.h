@@ -27,7 +27,9 @@
 #include "env.h"
 #include "node.h"
 #include "node_binding.h"
+#include "node_huge_page_pool.h"
 #include "node_mutex.h"
+#include "node_size_class_pool.h"
 #include "tracing/trace_event.h"
 #include "util.h"
 #include "uv.h"
@@ -61,6 +63,10 @@ extern bool v8_is_profiling;
 // Forward declaration
 class Environment;
 
+// Returns the number of the signal named `name`, such as "SIGUSR2", or 0 if
+// there is no such signal. The opposite of signo_string().
+int signo_number(const std::string& name);
+
 // Convert a struct sockaddr to a { address: '1.2.3.4', port: 1234 } JS object.
 // Sets address and port properties on the info object and returns it.
 // If |info| is omitted, a new object is returned.
@@ -104,23 +110,34 @@ void PromiseRejectCallback(v8::PromiseRejectMessage message);
 
 class NodeArrayBufferAllocator : public ArrayBufferAllocator {
  public:
+  NodeArrayBufferAllocator();  // Defined in src/api/environment.cc
+
   inline uint32_t* zero_fill_field() { return &zero_fill_field_; }
 
-  void* Allocate(size_t size) override;  // Defined in src/node.cc
-  void* AllocateUninitialized(size_t size) override
-    { return node::UncheckedMalloc(size); }
-  void Free(void* data, size_t) override { free(data); }
-  virtual void* Reallocate(void* data, size_t old_size, size_t size) {
-    return static_cast<void*>(
-        UncheckedRealloc<char>(static_cast<char*>(data), size));
-  }
+  void* Allocate(size_t size) override;
+  void* AllocateUninitialized(size_t size) override;
+  void Free(void* data, size_t) override;
+  virtual void* Reallocate(void* data, size_t old_size, size_t size);
   virtual void RegisterPointer(void* data, size_t size) {}
-  virtual void UnregisterPointer(void* data, size_t size) {}
+  // Called when the memory is handed to someone who will free() it, such as
+  // the receiving end of a transferred ArrayBuffer.
+  virtual void UnregisterPointer(void* data, size_t size);
 
   NodeArrayBufferAllocator* GetImpl() final { return this; }
 
+  // The memory in blocks of the --huge-page-buffers pool.
+  size_t huge_page_bytes() const {
+    return huge_pages_ ? huge_pages_->total_bytes() : 0;
+  }
+  // The --arraybuffer-pool free lists, or nullptr.
+  const SizeClassPool* size_class_pool() const {
+    return size_class_pool_.get();
+  }
+
  private:
   uint32_t zero_fill_field_ = 1;  // Boolean but exposed as uint32 to JS land.
+  std::unique_ptr<HugePagePool> huge_pages_;
+  std::unique_ptr<SizeClassPool> size_class_pool_;
 };
 
 class DebuggingArrayBufferAllocator final : public NodeArrayBufferAllocator {
@@ -218,6 +235,8 @@ class InternalCallbackScope {
   bool failed_ = false;
   bool pushed_ids_ = false;
   bool closed_ = false;
+  // Set when the callback is measured by an EventLoopMonitor.
+  uint64_t start_time_ = 0;
 };
 
 class DebugSealHandleScope {
@@ -236,8 +255,21 @@ class DebugSealHandleScope {
 
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env) : env_(env) {
+  // Work is admitted to the libuv threadpool separately for each class, so
+  // that a burst of one kind of work cannot occupy every thread and delay
+  // unrelated requests. See ThreadPoolWorkQueue below.
+  enum WorkClass {
+    kFileSystem,
+    kCrypto,
+    kZlib,
+    kAddon,
+    kWorkClassCount
+  };
+
+  inline ThreadPoolWork(Environment* env, WorkClass work_class)
+      : env_(env), work_class_(work_class) {
     CHECK_NOT_NULL(env);
+    CHECK_LT(work_class, kWorkClassCount);
   }
   inline virtual ~ThreadPoolWork() = default;
 
@@ -247,11 +279,77 @@ class ThreadPoolWork {
   virtual void DoThreadPoolWork() = 0;
   virtual void AfterThreadPoolWork(int status) = 0;
 
+  static const char* WorkClassName(WorkClass work_class);
+
  private:
+  friend class ThreadPoolWorkQueue;
+
   Environment* env_;
+  const WorkClass work_class_;
+  uint64_t scheduled_at_ = 0;
+  uint64_t started_at_ = 0;
+  uint64_t finished_at_ = 0;
+  ListNode<ThreadPoolWork> queue_node_;
   uv_work_t work_req_;
 };
 
+// Per-Environment admission control for ThreadPoolWork, enabled with
+// --threadpool-limits. At most limit(c) work items of class c are handed to
+// the libuv threadpool at a time; the rest wait here in FIFO order until one
+// of them completes. Classes that the option does not list may use all but
+// one of the threadpool's threads, which leaves room for fs and DNS requests
+// that go to libuv directly.
+class ThreadPoolWorkQueue {
+ public:
+  struct ClassStats {
+    // 0 if the class is not limited.
+    size_t limit = 0;
+    size_t queued = 0;
+    size_t running = 0;
+    uint64_t completed = 0;
+    // Time from ScheduleWork() until a thread started running the work.
+    uint64_t total_wait_ns = 0;
+    uint64_t max_wait_ns = 0;
+    // Time spent in DoThreadPoolWork().
+    uint64_t total_run_ns = 0;
+  };
+
+  ThreadPoolWorkQueue();
+  ThreadPoolWorkQueue(const ThreadPoolWorkQueue&) = delete;
+  ThreadPoolWorkQueue& operator=(const ThreadPoolWorkQueue&) = delete;
+
+  inline void Schedule(ThreadPoolWork* work);
+  inline int Cancel(ThreadPoolWork* work);
+
+  // The size of the libuv threadpool, which is only fixed once the first
+  // work has been scheduled.
+  size_t threadpool_size() const;
+  inline const ClassStats& stats(ThreadPoolWork::WorkClass work_class) const {
+    return stats_[work_class];
+  }
+
+  // Parses the value of --threadpool-limits, a comma-separated list of
+  // `class=limit` pairs, into `limits`. Returns false and sets `error` if
+  // the list is malformed.
+  static bool ParseLimits(const std::string& text,
+                          size_t limits[ThreadPoolWork::kWorkClassCount],
+                          std::string* error);
+
+ private:
+  // Sets the limits that depend on the size of the threadpool, when the
+  // first work is scheduled.
+  void ResolveLimits();
+  inline void Submit(ThreadPoolWork* work);
+  inline void Done(ThreadPoolWork* work);
+  static void CompleteCancelled(Environment* env, void* data);
+
+  typedef ListHead<ThreadPoolWork, &ThreadPoolWork::queue_node_> WorkList;
+
+  bool limits_resolved_ = false;
+  WorkList queued_[ThreadPoolWork::kWorkClassCount];
+  ClassStats stats_[ThreadPoolWork::kWorkClassCount];
+};
+
 #define TRACING_CATEGORY_NODE "node"
 #define TRACING_CATEGORY_NODE1(one)                                           \
     TRACING_CATEGORY_NODE ","                                                 \
@@ -301,6 +399,7 @@ void SetIsolateCreateParamsForNode(v8::Isolate::CreateParams* params);
 namespace profiler {
 void StartProfilers(Environment* env);
 void EndStartedProfilers(Environment* env);
+void EndContinuousProfilers(Environment* env);
 }
 #endif  // HAVE_INSPECTOR
 
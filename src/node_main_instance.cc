@@ -1,6 +1,11 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
 #include "node_main_instance.h"
 #include "node_internals.h"
 #include "node_options-inl.h"
+#include "node_version.h"
 #include "node_v8_platform-inl.h"
 #include "util-inl.h"
 
@@ -11,7 +16,10 @@ using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
 using v8::Locker;
+using v8::Object;
 using v8::SealHandleScope;
+using v8::StartupData;
+using v8::V8;
 
 NodeMainInstance::NodeMainInstance(Isolate* isolate,
                                    uv_loop_t* event_loop,
@@ -45,14 +53,16 @@ NodeMainInstance::NodeMainInstance(
     MultiIsolatePlatform* platform,
     const std::vector<std::string>& args,
     const std::vector<std::string>& exec_args,
-    const std::vector<size_t>* per_isolate_data_indexes)
+    const std::vector<size_t>* per_isolate_data_indexes,
+    bool has_user_context)
     : args_(args),
       exec_args_(exec_args),
       array_buffer_allocator_(ArrayBufferAllocator::Create()),
       isolate_(nullptr),
       platform_(platform),
       isolate_data_(nullptr),
-      owns_isolate_(true) {
+      owns_isolate_(true),
+      has_user_context_(has_user_context) {
   params->array_buffer_allocator = array_buffer_allocator_.get();
   isolate_ = Isolate::Allocate();
   CHECK_NOT_NULL(isolate_);
@@ -63,6 +73,7 @@ NodeMainInstance::NodeMainInstance(
   Isolate::Initialize(isolate_, *params);
 
   deserialize_mode_ = per_isolate_data_indexes != nullptr;
+  CHECK_IMPLIES(has_user_context_, deserialize_mode_);
   // If the indexes are not nullptr, we are not deserializing
   CHECK_IMPLIES(deserialize_mode_, params->external_references != nullptr);
   isolate_data_.reset(new IsolateData(isolate_,
@@ -196,6 +207,18 @@ std::unique_ptr<Environment> NodeMainInstance::CreateMainEnvironment(
   env->InitializeLibuv(per_process::v8_is_profiling);
   env->InitializeDiagnostics();
 
+  if (has_user_context_) {
+    // The functions of the application live in a context of their own, and
+    // are handed the process object and require() of this one once the
+    // bootstrap is complete. See lib/internal/main/run_snapshot_main.js.
+    Local<Context> user_context =
+        Context::FromSnapshot(isolate_, kUserContextIndex).ToLocalChecked();
+    user_context->SetSecurityToken(context->GetSecurityToken());
+    env->set_startup_snapshot_state(
+        user_context->GetDataFromSnapshotOnce<Object>(kUserContextStateIndex)
+            .ToLocalChecked());
+  }
+
   // TODO(joyeecheung): when we snapshot the bootstrapped context,
   // the inspector and diagnostics setup should after after deserialization.
 #if HAVE_INSPECTOR && NODE_USE_V8_PLATFORM
@@ -212,4 +235,108 @@ std::unique_ptr<Environment> NodeMainInstance::CreateMainEnvironment(
   return env;
 }
 
+std::string NodeMainInstance::SnapshotFileVersion() {
+  return std::string(NODE_VERSION) + "/" + V8::GetVersion() + "/" +
+         NODE_ARCH;
+}
+
+namespace {
+
+class SnapshotFileReader {
+ public:
+  explicit SnapshotFileReader(const std::string& data) : data_(data) {}
+
+  bool ReadUint32(uint32_t* value) {
+    return Read(value, sizeof(*value));
+  }
+
+  bool ReadUint64(uint64_t* value) {
+    return Read(value, sizeof(*value));
+  }
+
+  // Returns a pointer to the next `length` bytes, or nullptr.
+  const char* Skip(size_t length) {
+    if (data_.size() - offset_ < length)
+      return nullptr;
+    const char* result = data_.data() + offset_;
+    offset_ += length;
+    return result;
+  }
+
+  bool at_end() const { return offset_ == data_.size(); }
+
+ private:
+  bool Read(void* value, size_t length) {
+    const char* data = Skip(length);
+    if (data == nullptr)
+      return false;
+    memcpy(value, data, length);
+    return true;
+  }
+
+  const std::string& data_;
+  size_t offset_ = 0;
+};
+
+}  // anonymous namespace
+
+// The layout of the file is described in tools/snapshot/snapshot_builder.cc.
+bool NodeMainInstance::ReadSnapshotFile(
+    const std::string& path,
+    std::string* contents,
+    StartupData* blob,
+    std::vector<size_t>* isolate_data_indexes,
+    bool* has_user_context,
+    std::string* error) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    *error = "Cannot open snapshot file " + path;
+    return false;
+  }
+  contents->assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    *error = "Cannot read snapshot file " + path;
+    return false;
+  }
+
+  SnapshotFileReader reader(*contents);
+  uint32_t magic;
+  uint32_t flags;
+  uint32_t version_length;
+  const char* version;
+  if (!reader.ReadUint32(&magic) || magic != kSnapshotFileMagic ||
+      !reader.ReadUint32(&flags) ||
+      !reader.ReadUint32(&version_length) ||
+      (version = reader.Skip(version_length)) == nullptr) {
+    *error = path + " is not a snapshot file";
+    return false;
+  }
+  if (std::string(version, version_length) != SnapshotFileVersion()) {
+    *error = path + " was created by a different build of Node.js (" +
+             std::string(version, version_length) + ")";
+    return false;
+  }
+
+  uint32_t index_count;
+  uint32_t blob_size;
+  bool valid = reader.ReadUint32(&index_count);
+  isolate_data_indexes->clear();
+  for (uint32_t i = 0; valid && i < index_count; i++) {
+    uint64_t index;
+    valid = reader.ReadUint64(&index);
+    isolate_data_indexes->push_back(index);
+  }
+  valid = valid && reader.ReadUint32(&blob_size) &&
+          (blob->data = reader.Skip(blob_size)) != nullptr &&
+          reader.at_end();
+  if (!valid) {
+    *error = "Snapshot file " + path + " is truncated";
+    return false;
+  }
+  blob->raw_size = blob_size;
+  *has_user_context = (flags & kSnapshotFileHasUserContext) != 0;
+  return true;
+}
+
 }  // namespace node
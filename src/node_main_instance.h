@@ -47,7 +47,8 @@ class NodeMainInstance {
       MultiIsolatePlatform* platform,
       const std::vector<std::string>& args,
       const std::vector<std::string>& exec_args,
-      const std::vector<size_t>* per_isolate_data_indexes = nullptr);
+      const std::vector<size_t>* per_isolate_data_indexes = nullptr,
+      bool has_user_context = false);
   ~NodeMainInstance();
 
   // Start running the Node.js instances, return the exit code when finished.
@@ -64,7 +65,27 @@ class NodeMainInstance {
   static const std::vector<size_t>* GetIsolateDataIndexes();
   static v8::StartupData* GetEmbeddedSnapshotBlob();
 
+  // Reads a snapshot written by `node_mksnapshot --blob`. `blob` points into
+  // `*contents`, which has to outlive the isolate created from it. Returns
+  // false and sets `*error` if the file cannot be used by this binary.
+  static bool ReadSnapshotFile(const std::string& path,
+                               std::string* contents,
+                               v8::StartupData* blob,
+                               std::vector<size_t>* isolate_data_indexes,
+                               bool* has_user_context,
+                               std::string* error);
+  // The identifier of the binary that wrote a snapshot file, which has to
+  // match the binary that reads it.
+  static std::string SnapshotFileVersion();
+
   static const size_t kNodeContextIndex = 0;
+  // The context in which the entry script of `node_mksnapshot --entry` ran.
+  static const size_t kUserContextIndex = 1;
+  // The index of the state object created by the `startupSnapshot` global
+  // in the data of the user context.
+  static const size_t kUserContextStateIndex = 0;
+  static const uint32_t kSnapshotFileMagic = 0x50414e53;  // "SNAP"
+  static const uint32_t kSnapshotFileHasUserContext = 1 << 0;
   NodeMainInstance(const NodeMainInstance&) = delete;
   NodeMainInstance& operator=(const NodeMainInstance&) = delete;
   NodeMainInstance(NodeMainInstance&&) = delete;
@@ -85,6 +106,7 @@ class NodeMainInstance {
   std::unique_ptr<IsolateData> isolate_data_;
   bool owns_isolate_ = false;
   bool deserialize_mode_ = false;
+  bool has_user_context_ = false;
 };
 
 }  // namespace node
@@ -25,11 +25,13 @@ using v8::Just;
 using v8::Local;
 using v8::Maybe;
 using v8::MaybeLocal;
+using v8::NewStringType;
 using v8::Nothing;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::SharedArrayBuffer;
 using v8::String;
+using v8::Uint8Array;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -42,11 +44,51 @@ Message::Message(MallocedBuffer<char>&& buffer)
     : main_message_buf_(std::move(buffer)) {}
 
 bool Message::IsCloseMessage() const {
-  return main_message_buf_.data == nullptr;
+  return payload_type_ == kSerialized && main_message_buf_.data == nullptr;
 }
 
 namespace {
 
+// Whether the memory of `ab` can be taken over instead of being copied.
+bool CanTransferArrayBuffer(Environment* env, Local<ArrayBuffer> ab) {
+  return ab->IsDetachable() && !ab->IsExternal() &&
+         env->isolate_data()->uses_node_allocator();
+}
+
+// Takes ownership of the memory of `ab` and renders `ab` inaccessible.
+MallocedBuffer<char> DetachArrayBuffer(Environment* env,
+                                       Local<ArrayBuffer> ab) {
+  ArrayBuffer::Contents contents = ab->Externalize();
+  ab->Detach();
+
+  CHECK(env->isolate_data()->uses_node_allocator());
+  env->isolate_data()->node_allocator()->UnregisterPointer(
+      contents.Data(), contents.ByteLength());
+
+  return MallocedBuffer<char>{
+      static_cast<char*>(contents.Data()), contents.ByteLength()};
+}
+
+// Creates an ArrayBuffer in `env` that takes ownership of `contents`.
+Local<ArrayBuffer> AdoptArrayBuffer(Environment* env,
+                                    MallocedBuffer<char>* contents) {
+  if (!env->isolate_data()->uses_node_allocator()) {
+    // We don't use Node's allocator on the receiving side, so we have
+    // to create the ArrayBuffer from a copy of the memory.
+    AllocatedBuffer buf = env->AllocateManaged(contents->size);
+    memcpy(buf.data(), contents->data, contents->size);
+    return buf.ToArrayBuffer();
+  }
+
+  env->isolate_data()->node_allocator()->RegisterPointer(
+      contents->data, contents->size);
+
+  return ArrayBuffer::New(env->isolate(),
+                          contents->release(),
+                          contents->size,
+                          ArrayBufferCreationMode::kInternalized);
+}
+
 // This is used to tell V8 how to read transferred host objects, like other
 // `MessagePort`s and `SharedArrayBuffer`s, and make new JS objects out of them.
 class DeserializerDelegate : public ValueDeserializer::Delegate {
@@ -101,6 +143,10 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
   EscapableHandleScope handle_scope(env->isolate());
   Context::Scope context_scope(context);
 
+  if (payload_type_ != kSerialized) {
+    return handle_scope.EscapeMaybe(DeserializeFast(env));
+  }
+
   // Create all necessary MessagePort handles.
   std::vector<MessagePort*> ports(message_ports_.size());
   for (uint32_t i = 0; i < message_ports_.size(); ++i) {
@@ -140,27 +186,8 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
 
   // Attach all transferred ArrayBuffers to their new Isolate.
   for (uint32_t i = 0; i < array_buffer_contents_.size(); ++i) {
-    if (!env->isolate_data()->uses_node_allocator()) {
-      // We don't use Node's allocator on the receiving side, so we have
-      // to create the ArrayBuffer from a copy of the memory.
-      AllocatedBuffer buf =
-          env->AllocateManaged(array_buffer_contents_[i].size);
-      memcpy(buf.data(),
-             array_buffer_contents_[i].data,
-             array_buffer_contents_[i].size);
-      deserializer.TransferArrayBuffer(i, buf.ToArrayBuffer());
-      continue;
-    }
-
-    env->isolate_data()->node_allocator()->RegisterPointer(
-        array_buffer_contents_[i].data, array_buffer_contents_[i].size);
-
-    Local<ArrayBuffer> ab =
-        ArrayBuffer::New(env->isolate(),
-                         array_buffer_contents_[i].release(),
-                         array_buffer_contents_[i].size,
-                         ArrayBufferCreationMode::kInternalized);
-    deserializer.TransferArrayBuffer(i, ab);
+    deserializer.TransferArrayBuffer(
+        i, AdoptArrayBuffer(env, &array_buffer_contents_[i]));
   }
   array_buffer_contents_.clear();
 
@@ -170,6 +197,36 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
       deserializer.ReadValue(context).FromMaybe(Local<Value>()));
 }
 
+MaybeLocal<Value> Message::DeserializeFast(Environment* env) {
+  Isolate* isolate = env->isolate();
+  switch (payload_type_) {
+    case kOneByteString:
+      return String::NewFromOneByte(
+          isolate,
+          reinterpret_cast<const uint8_t*>(main_message_buf_.data),
+          NewStringType::kNormal,
+          main_message_buf_.size).FromMaybe(Local<String>());
+    case kTwoByteString:
+      return String::NewFromTwoByte(
+          isolate,
+          reinterpret_cast<const uint16_t*>(main_message_buf_.data),
+          NewStringType::kNormal,
+          main_message_buf_.size / sizeof(uint16_t))
+              .FromMaybe(Local<String>());
+    case kArrayBuffer:
+    case kUint8Array: {
+      CHECK_EQ(array_buffer_contents_.size(), 1);
+      Local<ArrayBuffer> ab = AdoptArrayBuffer(env, &array_buffer_contents_[0]);
+      array_buffer_contents_.clear();
+      if (payload_type_ == kArrayBuffer)
+        return ab;
+      return Uint8Array::New(ab, view_offset_, view_length_);
+    }
+    default:
+      UNREACHABLE();
+  }
+}
+
 void Message::AddSharedArrayBuffer(
     const SharedArrayBufferMetadataReference& reference) {
   shared_array_buffers_.push_back(reference);
@@ -305,6 +362,10 @@ Maybe<bool> Message::Serialize(Environment* env,
   // Verify that we're not silently overwriting an existing message.
   CHECK(main_message_buf_.is_empty());
 
+  Maybe<bool> fast = SerializeFast(env, context, input, transfer_list_v);
+  if (fast.IsNothing() || fast.FromJust())
+    return fast;
+
   SerializerDelegate delegate(env, context, this);
   ValueSerializer serializer(env->isolate(), &delegate);
   delegate.serializer = &serializer;
@@ -322,10 +383,8 @@ Maybe<bool> Message::Serialize(Environment* env,
         Local<ArrayBuffer> ab = entry.As<ArrayBuffer>();
         // If we cannot render the ArrayBuffer unusable in this Isolate and
         // take ownership of its memory, copying the buffer will have to do.
-        if (!ab->IsDetachable() || ab->IsExternal() ||
-            !env->isolate_data()->uses_node_allocator()) {
+        if (!CanTransferArrayBuffer(env, ab))
           continue;
-        }
         if (std::find(array_buffers.begin(), array_buffers.end(), ab) !=
             array_buffers.end()) {
           ThrowDataCloneException(
@@ -387,15 +446,7 @@ Maybe<bool> Message::Serialize(Environment* env,
     // If serialization succeeded, we want to take ownership of
     // (a.k.a. externalize) the underlying memory region and render
     // it inaccessible in this Isolate.
-    ArrayBuffer::Contents contents = ab->Externalize();
-    ab->Detach();
-
-    CHECK(env->isolate_data()->uses_node_allocator());
-    env->isolate_data()->node_allocator()->UnregisterPointer(
-        contents.Data(), contents.ByteLength());
-
-    array_buffer_contents_.emplace_back(MallocedBuffer<char>{
-        static_cast<char*>(contents.Data()), contents.ByteLength()});
+    array_buffer_contents_.emplace_back(DetachArrayBuffer(env, ab));
   }
 
   delegate.Finish();
@@ -408,6 +459,84 @@ Maybe<bool> Message::Serialize(Environment* env,
   return Just(true);
 }
 
+Maybe<bool> Message::SerializeFast(Environment* env,
+                                   Local<Context> context,
+                                   Local<Value> input,
+                                   Local<Value> transfer_list_v) {
+  Isolate* isolate = env->isolate();
+
+  // The transfer list may at most contain the ArrayBuffer of `input`.
+  Local<Value> transfer;
+  if (transfer_list_v->IsArray()) {
+    Local<Array> transfer_list = transfer_list_v.As<Array>();
+    if (transfer_list->Length() > 1)
+      return Just(false);
+    if (transfer_list->Length() == 1 &&
+        !transfer_list->Get(context, 0).ToLocal(&transfer)) {
+      return Nothing<bool>();
+    }
+  }
+
+  if (input->IsString()) {
+    if (!transfer.IsEmpty())
+      return Just(false);
+    Local<String> string = input.As<String>();
+    const int length = string->Length();
+    if (string->IsOneByte()) {
+      main_message_buf_ = MallocedBuffer<char>(length);
+      string->WriteOneByte(isolate,
+                           reinterpret_cast<uint8_t*>(main_message_buf_.data),
+                           0,
+                           length,
+                           String::NO_NULL_TERMINATION);
+      payload_type_ = kOneByteString;
+    } else {
+      main_message_buf_ = MallocedBuffer<char>(length * sizeof(uint16_t));
+      string->Write(isolate,
+                    reinterpret_cast<uint16_t*>(main_message_buf_.data),
+                    0,
+                    length,
+                    String::NO_NULL_TERMINATION);
+      payload_type_ = kTwoByteString;
+    }
+    return Just(true);
+  }
+
+  PayloadType type;
+  Local<ArrayBuffer> ab;
+  if (input->IsArrayBuffer()) {
+    type = kArrayBuffer;
+    ab = input.As<ArrayBuffer>();
+  } else if (input->IsUint8Array()) {
+    type = kUint8Array;
+    ab = input.As<Uint8Array>()->Buffer();
+  } else {
+    return Just(false);
+  }
+  // Leave SharedArrayBuffers, as well as the error for detached
+  // ArrayBuffers, to the ValueSerializer.
+  if (ab->IsSharedArrayBuffer() || ab->ByteLength() == 0)
+    return Just(false);
+  if (!transfer.IsEmpty() && transfer != ab)
+    return Just(false);
+
+  if (type == kUint8Array) {
+    view_offset_ = input.As<Uint8Array>()->ByteOffset();
+    view_length_ = input.As<Uint8Array>()->Length();
+  }
+  if (!transfer.IsEmpty() && CanTransferArrayBuffer(env, ab)) {
+    array_buffer_contents_.emplace_back(DetachArrayBuffer(env, ab));
+  } else {
+    // Like the ValueSerializer, copy the whole ArrayBuffer of a Uint8Array.
+    ArrayBuffer::Contents contents = ab->GetContents();
+    MallocedBuffer<char> copy(contents.ByteLength());
+    memcpy(copy.data, contents.Data(), contents.ByteLength());
+    array_buffer_contents_.emplace_back(std::move(copy));
+  }
+  payload_type_ = type;
+  return Just(true);
+}
+
 void Message::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("array_buffer_contents", array_buffer_contents_);
   tracker->TrackFieldWithSize("shared_array_buffers",
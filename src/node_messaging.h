@@ -71,6 +71,29 @@ class Message : public MemoryRetainer {
   SET_SELF_SIZE(Message)
 
  private:
+  // Strings, and ArrayBuffers and Uint8Arrays whose ArrayBuffer is either
+  // copied or the only transferred object, are sent without running the
+  // ValueSerializer. Their contents are moved into main_message_buf_ or
+  // array_buffer_contents_ directly.
+  enum PayloadType : uint8_t {
+    kSerialized,
+    kOneByteString,
+    kTwoByteString,
+    kArrayBuffer,
+    kUint8Array
+  };
+
+  // Returns Just(false) if `input` needs to go through the ValueSerializer.
+  v8::Maybe<bool> SerializeFast(Environment* env,
+                                v8::Local<v8::Context> context,
+                                v8::Local<v8::Value> input,
+                                v8::Local<v8::Value> transfer_list);
+  v8::MaybeLocal<v8::Value> DeserializeFast(Environment* env);
+
+  PayloadType payload_type_ = kSerialized;
+  // The position of a Uint8Array within its ArrayBuffer.
+  size_t view_offset_ = 0;
+  size_t view_length_ = 0;
   MallocedBuffer<char> main_message_buf_;
   std::vector<MallocedBuffer<char>> array_buffer_contents_;
   std::vector<SharedArrayBufferMetadataReference> shared_array_buffers_;
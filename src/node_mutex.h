@@ -21,6 +21,7 @@ class MutexBase {
   inline MutexBase();
   inline ~MutexBase();
   inline void Lock();
+  inline bool TryLock();
   inline void Unlock();
 
   MutexBase(const MutexBase&) = delete;
@@ -116,6 +117,10 @@ struct LibuvMutexTraits {
     uv_mutex_lock(mutex);
   }
 
+  static inline int mutex_trylock(MutexT* mutex) {
+    return uv_mutex_trylock(mutex);
+  }
+
   static inline void mutex_unlock(MutexT* mutex) {
     uv_mutex_unlock(mutex);
   }
@@ -161,6 +166,11 @@ void MutexBase<Traits>::Lock() {
   Traits::mutex_lock(&mutex_);
 }
 
+template <typename Traits>
+bool MutexBase<Traits>::TryLock() {
+  return Traits::mutex_trylock(&mutex_) == 0;
+}
+
 template <typename Traits>
 void MutexBase<Traits>::Unlock() {
   Traits::mutex_unlock(&mutex_);
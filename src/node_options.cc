@@ -3,6 +3,7 @@
 
 #include "env-inl.h"
 #include "node_binding.h"
+#include "node_internals.h"
 
 #include <cstdlib>  // strtoul, errno
 
@@ -68,6 +69,14 @@ void PerProcessOptions::CheckOptions(std::vector<std::string>* errors) {
                       "used, not both");
   }
 #endif
+  size_t limits[ThreadPoolWork::kWorkClassCount] = {};
+  std::string error;
+  if (!ThreadPoolWorkQueue::ParseLimits(threadpool_limits, limits, &error))
+    errors->push_back("--threadpool-limits: " + error);
+  if (trace_event_format != "json" && trace_event_format != "perfetto") {
+    errors->push_back("--trace-event-format must be either "
+                      "'json' or 'perfetto'");
+  }
   per_isolate->CheckOptions(errors);
 }
 
@@ -173,8 +182,9 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     if (!cpu_prof_name.empty()) {
       errors->push_back("--cpu-prof-name must be used with --cpu-prof");
     }
-    if (!cpu_prof_dir.empty()) {
-      errors->push_back("--cpu-prof-dir must be used with --cpu-prof");
+    if (!cpu_prof_dir.empty() && !cpu_prof_continuous) {
+      errors->push_back("--cpu-prof-dir must be used with --cpu-prof or "
+                        "--cpu-prof-continuous");
     }
     // We can't catch the case where the value passed is the default value,
     // then the option just becomes a noop which is fine.
@@ -187,8 +197,9 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     if (!heap_prof_name.empty()) {
       errors->push_back("--heap-prof-name must be used with --heap-prof");
     }
-    if (!heap_prof_dir.empty()) {
-      errors->push_back("--heap-prof-dir must be used with --heap-prof");
+    if (!heap_prof_dir.empty() && !heap_prof_continuous) {
+      errors->push_back("--heap-prof-dir must be used with --heap-prof or "
+                        "--heap-prof-continuous");
     }
     // We can't catch the case where the value passed is the default value,
     // then the option just becomes a noop which is fine.
@@ -196,6 +207,26 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
       errors->push_back("--heap-prof-interval must be used with --heap-prof");
     }
   }
+  if (cpu_prof_continuous) {
+    if (cpu_prof_continuous_interval == 0) {
+      errors->push_back("--cpu-prof-continuous-interval must be greater "
+                        "than 0");
+    }
+    if (!cpu_prof_continuous_signal.empty() &&
+        signo_number(cpu_prof_continuous_signal) == 0) {
+      errors->push_back("invalid value for --cpu-prof-continuous-signal");
+    }
+  }
+  if (heap_prof_continuous) {
+    if (heap_prof_continuous_interval == 0) {
+      errors->push_back("--heap-prof-continuous-interval must be greater "
+                        "than 0");
+    }
+    if (!heap_prof_continuous_signal.empty() &&
+        signo_number(heap_prof_continuous_signal) == 0) {
+      errors->push_back("invalid value for --heap-prof-continuous-signal");
+    }
+  }
   debug_options_.CheckOptions(errors);
 #endif  // HAVE_INSPECTOR
 }
@@ -300,6 +331,16 @@ DebugOptionsParser::DebugOptionsParser() {
 }
 
 EnvironmentOptionsParser::EnvironmentOptionsParser() {
+  AddOption("--experimental-code-cache-dir",
+            "cache the compiled code of CommonJS modules in the specified "
+            "directory",
+            &EnvironmentOptions::experimental_code_cache_dir,
+            kAllowedInEnvironment);
+  AddOption("--experimental-code-cache-max-size",
+            "maximum size in bytes of the files in the code cache directory "
+            "(default: 256 MiB)",
+            &EnvironmentOptions::experimental_code_cache_max_size,
+            kAllowedInEnvironment);
   AddOption("--experimental-modules",
             "experimental ES Module support and caching modules",
             &EnvironmentOptions::experimental_modules,
@@ -400,9 +441,10 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "profile generated with --cpu-prof. (default: 1000)",
             &EnvironmentOptions::cpu_prof_interval);
   AddOption("--cpu-prof-dir",
-            "Directory where the V8 profiles generated by --cpu-prof will be "
-            "placed. Does not affect --prof.",
-            &EnvironmentOptions::cpu_prof_dir);
+            "Directory where the V8 profiles generated by --cpu-prof and "
+            "--cpu-prof-continuous will be placed. Does not affect --prof.",
+            &EnvironmentOptions::cpu_prof_dir,
+            kAllowedInEnvironment);
   AddOption(
       "--heap-prof",
       "Start the V8 heap profiler on start up, and write the heap profile "
@@ -415,12 +457,69 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             &EnvironmentOptions::heap_prof_name);
   AddOption("--heap-prof-dir",
             "Directory where the V8 heap profiles generated by --heap-prof "
-            "will be placed.",
-            &EnvironmentOptions::heap_prof_dir);
+            "and --heap-prof-continuous will be placed.",
+            &EnvironmentOptions::heap_prof_dir,
+            kAllowedInEnvironment);
   AddOption("--heap-prof-interval",
             "specified sampling interval in bytes for the V8 heap "
             "profile generated with --heap-prof. (default: 512 * 1024)",
             &EnvironmentOptions::heap_prof_interval);
+  AddOption("--cpu-prof-continuous",
+            "Sample the JavaScript stacks for as long as the process runs, "
+            "and periodically write the samples in pprof files to the "
+            "directory given by --cpu-prof-dir, or the current working "
+            "directory",
+            &EnvironmentOptions::cpu_prof_continuous,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-continuous-interval",
+            "sampling interval in microseconds of --cpu-prof-continuous "
+            "(default: 10000)",
+            &EnvironmentOptions::cpu_prof_continuous_interval,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-continuous-period",
+            "number of seconds between the profiles written by "
+            "--cpu-prof-continuous, or 0 to only write them on signal and "
+            "on exit (default: 60)",
+            &EnvironmentOptions::cpu_prof_continuous_period,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-continuous-max-files",
+            "maximum number of profiles written by --cpu-prof-continuous "
+            "that are kept in the directory, or 0 for no limit (default: 10)",
+            &EnvironmentOptions::cpu_prof_continuous_max_files,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-continuous-signal",
+            "signal on which --cpu-prof-continuous writes a profile right "
+            "away, such as SIGUSR2",
+            &EnvironmentOptions::cpu_prof_continuous_signal,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-continuous",
+            "Sample the allocations for as long as the process runs, and "
+            "periodically write the sampled live allocations in pprof files "
+            "to the directory given by --heap-prof-dir, or the current "
+            "working directory",
+            &EnvironmentOptions::heap_prof_continuous,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-continuous-interval",
+            "average sampling interval in bytes of --heap-prof-continuous "
+            "(default: 512 * 1024)",
+            &EnvironmentOptions::heap_prof_continuous_interval,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-continuous-period",
+            "number of seconds between the profiles written by "
+            "--heap-prof-continuous, or 0 to only write them on signal, on "
+            "process.report.writeHeapProfile() and on exit (default: 60)",
+            &EnvironmentOptions::heap_prof_continuous_period,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-continuous-max-files",
+            "maximum number of profiles written by --heap-prof-continuous "
+            "that are kept in the directory, or 0 for no limit (default: 10)",
+            &EnvironmentOptions::heap_prof_continuous_max_files,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-continuous-signal",
+            "signal on which --heap-prof-continuous writes a profile right "
+            "away, such as SIGUSR2",
+            &EnvironmentOptions::heap_prof_continuous_signal,
+            kAllowedInEnvironment);
 #endif  // HAVE_INSPECTOR
   AddOption("--redirect-warnings",
             "write warnings to file instead of stderr",
@@ -582,6 +681,9 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "the process title to use on startup",
             &PerProcessOptions::title,
             kAllowedInEnvironment);
+  AddOption("--snapshot-blob",
+            "start from a snapshot file written by node_mksnapshot --blob",
+            &PerProcessOptions::snapshot_blob);
   AddOption("--trace-event-categories",
             "comma separated list of trace event categories to record",
             &PerProcessOptions::trace_event_categories,
@@ -591,21 +693,51 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "data, it supports ${rotation} and ${pid}.",
             &PerProcessOptions::trace_event_file_pattern,
             kAllowedInEnvironment);
+  AddOption("--trace-event-format",
+            "format of the trace-events data, either json (default) or "
+            "perfetto",
+            &PerProcessOptions::trace_event_format,
+            kAllowedInEnvironment);
   AddAlias("--trace-events-enabled", {
     "--trace-event-categories", "v8,node,node.async_hooks" });
   AddOption("--max-http-header-size",
             "set the maximum size of HTTP headers (default: 8KB)",
             &PerProcessOptions::max_http_header_size,
             kAllowedInEnvironment);
+  AddOption("--dns-cache-max-ttl",
+            "cache DNS lookups and queries for up to this many seconds "
+            "(default: 0, disabled)",
+            &PerProcessOptions::dns_cache_max_ttl,
+            kAllowedInEnvironment);
+  AddOption("--threadpool-limits",
+            "limit the number of libuv threadpool threads each class of "
+            "work (fs, crypto, zlib, addon) may use at once, "
+            "e.g. crypto=1,zlib=2",
+            &PerProcessOptions::threadpool_limits,
+            kAllowedInEnvironment);
   AddOption("--v8-pool-size",
             "set V8's thread pool size",
             &PerProcessOptions::v8_thread_pool_size,
             kAllowedInEnvironment);
+  AddOption("--v8-pool-affinity",
+            "pin each thread of V8's thread pool to one CPU (Linux only)",
+            &PerProcessOptions::v8_pool_affinity,
+            kAllowedInEnvironment);
   AddOption("--zero-fill-buffers",
             "automatically zero-fill all newly allocated Buffer and "
             "SlowBuffer instances",
             &PerProcessOptions::zero_fill_all_buffers,
             kAllowedInEnvironment);
+  AddOption("--huge-page-buffers",
+            "back ArrayBuffers of 2 MB and more with transparent huge pages "
+            "(Linux only)",
+            &PerProcessOptions::huge_page_buffers,
+            kAllowedInEnvironment);
+  AddOption("--arraybuffer-pool",
+            "keep freed ArrayBuffer memory of up to 256 KB in "
+            "per-allocator size-class free lists for reuse",
+            &PerProcessOptions::arraybuffer_pool,
+            kAllowedInEnvironment);
   AddOption("--debug-arraybuffer-allocations",
             "", /* undocumented, only for debugging */
             &PerProcessOptions::debug_arraybuffer_allocations,
@@ -100,6 +100,8 @@ class DebugOptions : public Options {
 class EnvironmentOptions : public Options {
  public:
   bool abort_on_uncaught_exception = false;
+  std::string experimental_code_cache_dir;
+  uint64_t experimental_code_cache_max_size = 256 * 1024 * 1024;
   bool experimental_modules = false;
   std::string es_module_specifier_resolution;
   bool experimental_wasm_modules = false;
@@ -129,6 +131,16 @@ class EnvironmentOptions : public Options {
   static const uint64_t kDefaultHeapProfInterval = 512 * 1024;
   uint64_t heap_prof_interval = kDefaultHeapProfInterval;
   bool heap_prof = false;
+  bool cpu_prof_continuous = false;
+  uint64_t cpu_prof_continuous_interval = 10000;
+  uint64_t cpu_prof_continuous_period = 60;
+  uint64_t cpu_prof_continuous_max_files = 10;
+  std::string cpu_prof_continuous_signal;
+  bool heap_prof_continuous = false;
+  uint64_t heap_prof_continuous_interval = kDefaultHeapProfInterval;
+  uint64_t heap_prof_continuous_period = 60;
+  uint64_t heap_prof_continuous_max_files = 10;
+  std::string heap_prof_continuous_signal;
 #endif  // HAVE_INSPECTOR
   std::string redirect_warnings;
   bool throw_deprecation = false;
@@ -189,11 +201,18 @@ class PerProcessOptions : public Options {
   std::shared_ptr<PerIsolateOptions> per_isolate { new PerIsolateOptions() };
 
   std::string title;
+  std::string snapshot_blob;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
+  std::string trace_event_format = "json";
   uint64_t max_http_header_size = 8 * 1024;
+  uint64_t dns_cache_max_ttl = 0;
+  std::string threadpool_limits;
   int64_t v8_thread_pool_size = 4;
+  bool v8_pool_affinity = false;
   bool zero_fill_all_buffers = false;
+  bool huge_page_buffers = false;
+  bool arraybuffer_pool = false;
   bool debug_arraybuffer_allocations = false;
 
   std::vector<std::string> security_reverts;
@@ -6,6 +6,7 @@
 #include "node_process.h"
 #include "util-inl.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 namespace node {
@@ -14,6 +15,7 @@ namespace performance {
 using v8::Array;
 using v8::Context;
 using v8::DontDelete;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
@@ -368,22 +370,25 @@ void Timerify(const FunctionCallbackInfo<Value>& args) {
 
 // Event Loop Timing Histogram
 namespace {
-static void ELDHistogramMin(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+static void HistogramMin(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Min());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMax(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+static void HistogramMax(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Max());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMean(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+static void HistogramMean(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Mean());
 }
@@ -395,23 +400,26 @@ static void ELDHistogramExceeds(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramStddev(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+static void HistogramStddev(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Stddev());
 }
 
-static void ELDHistogramPercentile(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+static void HistogramPercentile(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsNumber());
   double percentile = args[0].As<Number>()->Value();
   args.GetReturnValue().Set(histogram->Percentile(percentile));
 }
 
-static void ELDHistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
+template <typename T>
+static void HistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  ELDHistogram* histogram;
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsMap());
   Local<Map> map = args[0].As<Map>();
@@ -447,6 +455,42 @@ static void ELDHistogramNew(const FunctionCallbackInfo<Value>& args) {
   CHECK_GT(resolution, 0);
   new ELDHistogram(env, args.This(), resolution);
 }
+
+static void EventLoopMonitorEnable(const FunctionCallbackInfo<Value>& args) {
+  EventLoopMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(monitor->Enable());
+}
+
+static void EventLoopMonitorDisable(const FunctionCallbackInfo<Value>& args) {
+  EventLoopMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  args.GetReturnValue().Set(monitor->Disable());
+}
+
+static void EventLoopMonitorReset(const FunctionCallbackInfo<Value>& args) {
+  EventLoopMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  monitor->ResetState();
+}
+
+static void EventLoopMonitorMetrics(const FunctionCallbackInfo<Value>& args) {
+  EventLoopMonitor* monitor;
+  ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), NODE_PERFORMANCE_LOOP_METRIC_INVALID);
+  double* metrics = reinterpret_cast<double*>(
+      static_cast<char*>(array->Buffer()->GetContents().Data()) +
+      array->ByteOffset());
+  monitor->GetMetrics(metrics);
+}
+
+static void EventLoopMonitorNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  new EventLoopMonitor(env, args.This());
+}
 }  // namespace
 
 ELDHistogram::ELDHistogram(
@@ -530,6 +574,141 @@ bool ELDHistogram::Disable() {
   return true;
 }
 
+EventLoopMonitor::EventLoopMonitor(Environment* env, Local<Object> wrap)
+    : BaseObject(env, wrap),
+      Histogram(1, 3.6e12) {
+  MakeWeak();
+  prepare_ = new uv_prepare_t();
+  uv_prepare_init(env->event_loop(), prepare_);
+  prepare_->data = this;
+}
+
+void EventLoopMonitor::ClosePrepare() {
+  if (prepare_ == nullptr)
+    return;
+
+  env()->CloseHandle(prepare_, [](uv_prepare_t* handle) { delete handle; });
+  prepare_ = nullptr;
+}
+
+EventLoopMonitor::~EventLoopMonitor() {
+  Disable();
+  ClosePrepare();
+}
+
+bool EventLoopMonitor::Enable() {
+  if (enabled_) return false;
+  enabled_ = true;
+  enabled_time_ = PERFORMANCE_NOW();
+  // The monitor is enabled from JavaScript, outside of the poll phase.
+  in_poll_ = false;
+  poll_end_ = 0;
+  phases_since_poll_ = 0;
+  uv_prepare_start(prepare_, OnPrepare);
+  uv_unref(reinterpret_cast<uv_handle_t*>(prepare_));
+  env()->performance_state()->event_loop_monitors.push_back(this);
+  return true;
+}
+
+bool EventLoopMonitor::Disable() {
+  if (!enabled_) return false;
+  enabled_ = false;
+  elapsed_ += PERFORMANCE_NOW() - enabled_time_;
+  uv_prepare_stop(prepare_);
+  std::vector<EventLoopMonitor*>* monitors =
+      &env()->performance_state()->event_loop_monitors;
+  monitors->erase(std::find(monitors->begin(), monitors->end(), this));
+  return true;
+}
+
+void EventLoopMonitor::ResetState() {
+  Reset();
+  for (uint64_t& metric : metrics_)
+    metric = 0;
+  elapsed_ = 0;
+  enabled_time_ = PERFORMANCE_NOW();
+  in_poll_ = false;
+  poll_end_ = 0;
+  phases_since_poll_ = 0;
+}
+
+void EventLoopMonitor::GetMetrics(double* metrics) const {
+  uint64_t elapsed = elapsed_;
+  if (enabled_)
+    elapsed += PERFORMANCE_NOW() - enabled_time_;
+  const uint64_t idle = metrics_[NODE_PERFORMANCE_LOOP_METRIC_IDLE];
+  for (size_t i = 0; i < NODE_PERFORMANCE_LOOP_METRIC_INVALID; i++)
+    metrics[i] = static_cast<double>(metrics_[i]);
+  metrics[NODE_PERFORMANCE_LOOP_METRIC_ACTIVE] =
+      static_cast<double>(elapsed > idle ? elapsed - idle : 0);
+}
+
+void EventLoopMonitor::OnPrepare(uv_prepare_t* handle) {
+  EventLoopMonitor* monitor = static_cast<EventLoopMonitor*>(handle->data);
+  const uint64_t now = PERFORMANCE_NOW();
+  if (monitor->poll_end_ != 0) {
+    uint64_t rest = now - monitor->poll_end_;
+    rest = rest > monitor->phases_since_poll_ ?
+        rest - monitor->phases_since_poll_ : 0;
+    monitor->metrics_[NODE_PERFORMANCE_LOOP_METRIC_CLOSE] += rest;
+  }
+  monitor->phases_since_poll_ = 0;
+  monitor->in_poll_ = true;
+  monitor->woken_ = false;
+  monitor->poll_start_ = now;
+}
+
+void EventLoopMonitor::EndPoll(uint64_t time) {
+  if (!in_poll_)
+    return;
+  in_poll_ = false;
+  metrics_[NODE_PERFORMANCE_LOOP_METRIC_POLL] += time - poll_start_;
+  if (!woken_)
+    metrics_[NODE_PERFORMANCE_LOOP_METRIC_IDLE] += time - poll_start_;
+  poll_end_ = time;
+}
+
+void ReportCallbackStart(Environment* env, uint64_t time) {
+  for (EventLoopMonitor* monitor : env->performance_state()->
+           event_loop_monitors) {
+    // The first callback of the poll phase is run once the loop has stopped
+    // waiting for I/O.
+    if (monitor->in_poll_ && !monitor->woken_) {
+      monitor->woken_ = true;
+      monitor->metrics_[NODE_PERFORMANCE_LOOP_METRIC_IDLE] +=
+          time - monitor->poll_start_;
+    }
+  }
+}
+
+void ReportCallbackEnd(Environment* env, uint64_t start, uint64_t end) {
+  for (EventLoopMonitor* monitor : env->performance_state()->
+           event_loop_monitors) {
+    monitor->Record(end > start ? end - start : 1);
+  }
+}
+
+void ReportPhaseStart(Environment* env, EventLoopMetric phase, uint64_t time) {
+  // The check phase follows the poll phase.
+  if (phase != NODE_PERFORMANCE_LOOP_METRIC_CHECK)
+    return;
+  for (EventLoopMonitor* monitor : env->performance_state()->
+           event_loop_monitors) {
+    monitor->EndPoll(time);
+  }
+}
+
+void ReportPhaseEnd(Environment* env,
+                    EventLoopMetric phase,
+                    uint64_t start,
+                    uint64_t end) {
+  for (EventLoopMonitor* monitor : env->performance_state()->
+           event_loop_monitors) {
+    monitor->metrics_[phase] += end - start;
+    monitor->phases_since_poll_ += end - start;
+  }
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -580,6 +759,12 @@ void Initialize(Local<Object> target,
   NODE_PERFORMANCE_MILESTONES(V)
 #undef V
 
+#define V(name)                                                               \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_PERFORMANCE_LOOP_METRIC_##name);
+  NODE_PERFORMANCE_LOOP_METRICS(V)
+#undef V
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_PERFORMANCE_LOOP_METRIC_INVALID);
+
   PropertyAttribute attr =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
 
@@ -605,17 +790,39 @@ void Initialize(Local<Object> target,
   eldh->SetClassName(eldh_classname);
   eldh->InstanceTemplate()->SetInternalFieldCount(1);
   env->SetProtoMethod(eldh, "exceeds", ELDHistogramExceeds);
-  env->SetProtoMethod(eldh, "min", ELDHistogramMin);
-  env->SetProtoMethod(eldh, "max", ELDHistogramMax);
-  env->SetProtoMethod(eldh, "mean", ELDHistogramMean);
-  env->SetProtoMethod(eldh, "stddev", ELDHistogramStddev);
-  env->SetProtoMethod(eldh, "percentile", ELDHistogramPercentile);
-  env->SetProtoMethod(eldh, "percentiles", ELDHistogramPercentiles);
+  env->SetProtoMethod(eldh, "min", HistogramMin<ELDHistogram>);
+  env->SetProtoMethod(eldh, "max", HistogramMax<ELDHistogram>);
+  env->SetProtoMethod(eldh, "mean", HistogramMean<ELDHistogram>);
+  env->SetProtoMethod(eldh, "stddev", HistogramStddev<ELDHistogram>);
+  env->SetProtoMethod(eldh, "percentile", HistogramPercentile<ELDHistogram>);
+  env->SetProtoMethod(eldh, "percentiles",
+                      HistogramPercentiles<ELDHistogram>);
   env->SetProtoMethod(eldh, "enable", ELDHistogramEnable);
   env->SetProtoMethod(eldh, "disable", ELDHistogramDisable);
   env->SetProtoMethod(eldh, "reset", ELDHistogramReset);
   target->Set(context, eldh_classname,
               eldh->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  Local<String> elm_classname =
+      FIXED_ONE_BYTE_STRING(isolate, "EventLoopMonitor");
+  Local<FunctionTemplate> elm =
+      env->NewFunctionTemplate(EventLoopMonitorNew);
+  elm->SetClassName(elm_classname);
+  elm->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(elm, "min", HistogramMin<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "max", HistogramMax<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "mean", HistogramMean<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "stddev", HistogramStddev<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "percentile",
+                      HistogramPercentile<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "percentiles",
+                      HistogramPercentiles<EventLoopMonitor>);
+  env->SetProtoMethod(elm, "metrics", EventLoopMonitorMetrics);
+  env->SetProtoMethod(elm, "enable", EventLoopMonitorEnable);
+  env->SetProtoMethod(elm, "disable", EventLoopMonitorDisable);
+  env->SetProtoMethod(elm, "reset", EventLoopMonitorReset);
+  target->Set(context, elm_classname,
+              elm->GetFunction(env->context()).ToLocalChecked()).Check();
 }
 
 }  // namespace performance
@@ -5,6 +5,7 @@
 
 #include "node.h"
 #include "node_perf_common.h"
+#include "node_perf_loop.h"
 #include "env.h"
 #include "base_object-inl.h"
 #include "histogram-inl.h"
@@ -158,6 +159,59 @@ class ELDHistogram : public BaseObject, public Histogram {
   uv_timer_t* timer_;
 };
 
+// Measures how the event loop spends its time: waiting for I/O in the poll
+// phase or not, in each phase, and in each callback into JavaScript, which is
+// recorded in the histogram. The check and timers phases, and the callbacks,
+// are reported by the Environment to the monitors that are enabled.
+class EventLoopMonitor : public BaseObject, public Histogram {
+ public:
+  EventLoopMonitor(Environment* env, Local<Object> wrap);
+
+  ~EventLoopMonitor() override;
+
+  bool Enable();
+  bool Disable();
+  void ResetState();
+  // Fills `metrics` with the EventLoopMetrics, in nanoseconds.
+  void GetMetrics(double* metrics) const;
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("histogram", GetMemorySize());
+  }
+
+  SET_MEMORY_INFO_NAME(EventLoopMonitor)
+  SET_SELF_SIZE(EventLoopMonitor)
+
+ private:
+  friend void ReportCallbackStart(Environment* env, uint64_t time);
+  friend void ReportCallbackEnd(Environment* env, uint64_t start,
+                                uint64_t end);
+  friend void ReportPhaseStart(Environment* env, EventLoopMetric phase,
+                               uint64_t time);
+  friend void ReportPhaseEnd(Environment* env, EventLoopMetric phase,
+                             uint64_t start, uint64_t end);
+
+  static void OnPrepare(uv_prepare_t* handle);
+  void EndPoll(uint64_t time);
+  void ClosePrepare();
+
+  bool enabled_ = false;
+  uint64_t enabled_time_ = 0;
+  uint64_t elapsed_ = 0;
+  uint64_t metrics_[NODE_PERFORMANCE_LOOP_METRIC_INVALID] = {};
+  // The poll phase is entered when the prepare handle runs, and left when the
+  // check phase starts. It is idle until the first callback into JavaScript.
+  bool in_poll_ = false;
+  bool woken_ = false;
+  uint64_t poll_start_ = 0;
+  uint64_t poll_end_ = 0;
+  // The time spent in the check and timers phases since the end of the poll
+  // phase. The rest of the time until the next poll phase is mostly spent in
+  // the close phase.
+  uint64_t phases_since_poll_ = 0;
+  uv_prepare_t* prepare_;
+};
+
 }  // namespace performance
 }  // namespace node
 
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace node {
 namespace performance {
@@ -37,6 +38,16 @@ extern uint64_t performance_v8_start;
   V(FUNCTION, "function")                                                     \
   V(HTTP2, "http2")
 
+// The times measured by the EventLoopMonitor. The timers, poll, check and
+// close values are also used as the indices of the event loop phases.
+#define NODE_PERFORMANCE_LOOP_METRICS(V)                                      \
+  V(IDLE)                                                                     \
+  V(ACTIVE)                                                                   \
+  V(TIMERS)                                                                   \
+  V(POLL)                                                                     \
+  V(CHECK)                                                                    \
+  V(CLOSE)
+
 enum PerformanceMilestone {
 #define V(name, _) NODE_PERFORMANCE_MILESTONE_##name,
   NODE_PERFORMANCE_MILESTONES(V)
@@ -51,6 +62,15 @@ enum PerformanceEntryType {
   NODE_PERFORMANCE_ENTRY_TYPE_INVALID
 };
 
+enum EventLoopMetric {
+#define V(name) NODE_PERFORMANCE_LOOP_METRIC_##name,
+  NODE_PERFORMANCE_LOOP_METRICS(V)
+#undef V
+  NODE_PERFORMANCE_LOOP_METRIC_INVALID
+};
+
+class EventLoopMonitor;
+
 class performance_state {
  public:
   explicit performance_state(v8::Isolate* isolate) :
@@ -77,6 +97,10 @@ class performance_state {
 
   uint64_t performance_last_gc_start_mark = 0;
 
+  // The monitors that are enabled, which the Environment reports the event
+  // loop phases and the callbacks into JavaScript to.
+  std::vector<EventLoopMonitor*> event_loop_monitors;
+
   void Mark(enum PerformanceMilestone milestone,
             uint64_t ts = PERFORMANCE_NOW());
 
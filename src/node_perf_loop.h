@@ -0,0 +1,59 @@
+#ifndef SRC_NODE_PERF_LOOP_H_
+#define SRC_NODE_PERF_LOOP_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "env-inl.h"
+#include "node_perf_common.h"
+
+namespace node {
+namespace performance {
+
+// Reports the event loop phases and the callbacks into JavaScript to the
+// EventLoopMonitors of an Environment. This is separate from node_perf.h so
+// that the Environment and InternalCallbackScope can report without
+// depending on the monitors themselves.
+
+inline bool IsEventLoopObserved(Environment* env) {
+  return !env->performance_state()->event_loop_monitors.empty();
+}
+
+void ReportCallbackStart(Environment* env, uint64_t time);
+void ReportCallbackEnd(Environment* env, uint64_t start, uint64_t end);
+void ReportPhaseStart(Environment* env, EventLoopMetric phase, uint64_t time);
+void ReportPhaseEnd(Environment* env,
+                    EventLoopMetric phase,
+                    uint64_t start,
+                    uint64_t end);
+
+// Reports the time spent in a phase of the event loop, if it is observed.
+class EventLoopPhaseScope {
+ public:
+  inline EventLoopPhaseScope(Environment* env, EventLoopMetric phase)
+      : env_(env), phase_(phase) {
+    if (!IsEventLoopObserved(env))
+      return;
+    start_ = PERFORMANCE_NOW();
+    ReportPhaseStart(env, phase, start_);
+  }
+
+  inline ~EventLoopPhaseScope() {
+    if (start_ != 0)
+      ReportPhaseEnd(env_, phase_, start_, PERFORMANCE_NOW());
+  }
+
+  EventLoopPhaseScope(const EventLoopPhaseScope&) = delete;
+  EventLoopPhaseScope& operator=(const EventLoopPhaseScope&) = delete;
+
+ private:
+  Environment* env_;
+  EventLoopMetric phase_;
+  uint64_t start_ = 0;
+};
+
+}  // namespace performance
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PERF_LOOP_H_
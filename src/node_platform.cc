@@ -5,8 +5,13 @@
 #include "debug_utils.h"
 #include <algorithm>
 #include <cmath>
+#include <deque>
 #include <memory>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace node {
 
 using v8::Isolate;
@@ -18,22 +23,113 @@ using node::tracing::TracingController;
 
 namespace {
 
-struct PlatformWorkerData {
-  TaskQueue<Task>* task_queue;
+// Set on platform worker threads, so that tasks posted from within a worker
+// task end up in the queue of the thread that posted them.
+thread_local WorkerThreadsTaskRunner* current_runner = nullptr;
+thread_local size_t current_queue_index = 0;
+
+}  // namespace
+
+// A queue owned by one worker thread. Other threads push into it when
+// distributing tasks, and steal from it when they run out of work.
+class WorkerThreadsTaskRunner::WorkerQueue {
+ public:
+  explicit WorkerQueue(std::atomic<size_t>* queued_tasks)
+      : queued_tasks_(queued_tasks) {}
+
+  void Push(std::unique_ptr<Task> task, Priority priority) {
+    Lock();
+    tasks_[priority].push_back(std::move(task));
+    sizes_[priority]++;
+    (*queued_tasks_)++;
+    mutex_.Unlock();
+    tasks_posted_++;
+  }
+
+  // Takes the oldest task of the given priority. Thieves take from the back
+  // so that they interfere less with the owner's order of execution.
+  std::unique_ptr<Task> Pop(Priority priority, bool steal) {
+    // Avoid taking the lock for queues that are obviously empty.
+    if (sizes_[priority].load(std::memory_order_relaxed) == 0)
+      return nullptr;
+    Lock();
+    std::unique_ptr<Task> task;
+    std::deque<std::unique_ptr<Task>>& tasks = tasks_[priority];
+    if (!tasks.empty()) {
+      if (steal) {
+        task = std::move(tasks.back());
+        tasks.pop_back();
+      } else {
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      sizes_[priority]--;
+      (*queued_tasks_)--;
+    }
+    mutex_.Unlock();
+    return task;
+  }
+
+  uint64_t tasks_posted() const { return tasks_posted_; }
+  uint64_t lock_contentions() const { return lock_contentions_; }
+
+ private:
+  void Lock() {
+    if (!mutex_.TryLock()) {
+      lock_contentions_++;
+      mutex_.Lock();
+    }
+  }
+
+  Mutex mutex_;
+  std::deque<std::unique_ptr<Task>> tasks_[kPriorityCount];
+  std::atomic<size_t> sizes_[kPriorityCount] = {};
+  std::atomic<size_t>* queued_tasks_;
+  std::atomic<uint64_t> tasks_posted_ {0};
+  std::atomic<uint64_t> lock_contentions_ {0};
+};
+
+struct WorkerThreadsTaskRunner::WorkerData {
+  WorkerThreadsTaskRunner* runner;
   Mutex* platform_workers_mutex;
   ConditionVariable* platform_workers_ready;
   int* pending_platform_workers;
-  int id;
+  size_t index;
+  bool pin_thread;
 };
 
-static void PlatformWorkerThread(void* data) {
-  std::unique_ptr<PlatformWorkerData>
-      worker_data(static_cast<PlatformWorkerData*>(data));
+void WorkerThreadsTaskRunner::WorkerThread(void* data) {
+  std::unique_ptr<WorkerData> worker_data(static_cast<WorkerData*>(data));
+  WorkerThreadsTaskRunner* runner = worker_data->runner;
+  const size_t index = worker_data->index;
 
-  TaskQueue<Task>* pending_worker_tasks = worker_data->task_queue;
   TRACE_EVENT_METADATA1("__metadata", "thread_name", "name",
                         "PlatformWorkerThread");
 
+#ifdef __linux__
+  if (worker_data->pin_thread) {
+    // Pick the index-th CPU this process may run on, so that restrictions
+    // set through taskset or cgroups are honoured. Affinity is only a hint;
+    // keep running unpinned if it cannot be set.
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0 &&
+        CPU_COUNT(&allowed) > 0) {
+      size_t nth = index % CPU_COUNT(&allowed);
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed) || nth-- != 0) continue;
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        break;
+      }
+    }
+  }
+#endif
+
+  current_runner = runner;
+  current_queue_index = index;
+
   // Notify the main thread that the platform worker is ready.
   {
     Mutex::ScopedLock lock(*worker_data->platform_workers_mutex);
@@ -41,18 +137,55 @@ static void PlatformWorkerThread(void* data) {
     worker_data->platform_workers_ready->Signal(lock);
   }
 
-  while (std::unique_ptr<Task> task = pending_worker_tasks->BlockingPop()) {
+  while (std::unique_ptr<Task> task = runner->NextTask(index)) {
     task->Run();
-    pending_worker_tasks->NotifyOfCompletion();
+    runner->NotifyOfCompletion();
   }
 }
 
-}  // namespace
+std::unique_ptr<Task> WorkerThreadsTaskRunner::NextTask(size_t index) {
+  const size_t queue_count = queues_.size();
+  while (!stopped_) {
+    // Higher priority tasks anywhere are preferred over lower priority
+    // tasks in the worker's own queue.
+    for (int priority = 0; priority < kPriorityCount; priority++) {
+      Priority p = static_cast<Priority>(priority);
+      if (std::unique_ptr<Task> task = queues_[index]->Pop(p, false))
+        return task;
+      for (size_t i = 1; i < queue_count; i++) {
+        WorkerQueue* victim = queues_[(index + i) % queue_count].get();
+        if (std::unique_ptr<Task> task = victim->Pop(p, true)) {
+          tasks_stolen_++;
+          return task;
+        }
+      }
+    }
+
+    // Sleep until a task is posted. Posting threads increment queued_tasks_
+    // before looking at idle_workers_, and we do the reverse, so at least
+    // one side sees the other's update.
+    Mutex::ScopedLock lock(idle_mutex_);
+    idle_workers_++;
+    if (queued_tasks_ == 0 && !stopped_) {
+      idle_waits_++;
+      tasks_available_.Wait(lock);
+    }
+    idle_workers_--;
+  }
+  return nullptr;
+}
+
+void WorkerThreadsTaskRunner::NotifyOfCompletion() {
+  if (--outstanding_tasks_ == 0) {
+    Mutex::ScopedLock lock(drain_mutex_);
+    tasks_drained_.Broadcast(lock);
+  }
+}
 
 class WorkerThreadsTaskRunner::DelayedTaskScheduler {
  public:
-  explicit DelayedTaskScheduler(TaskQueue<Task>* tasks)
-    : pending_worker_tasks_(tasks) {}
+  explicit DelayedTaskScheduler(WorkerThreadsTaskRunner* runner)
+    : runner_(runner) {}
 
   std::unique_ptr<uv_thread_t> Start() {
     auto start_thread = [](void* data) {
@@ -143,7 +276,7 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   static void RunTask(uv_timer_t* timer) {
     DelayedTaskScheduler* scheduler =
         ContainerOf(&DelayedTaskScheduler::loop_, timer->loop);
-    scheduler->pending_worker_tasks_->Push(scheduler->TakeTimerTask(timer));
+    scheduler->runner_->PostTask(scheduler->TakeTimerTask(timer));
   }
 
   std::unique_ptr<Task> TakeTimerTask(uv_timer_t* timer) {
@@ -157,7 +290,7 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   }
 
   uv_sem_t ready_;
-  TaskQueue<Task>* pending_worker_tasks_;
+  WorkerThreadsTaskRunner* runner_;
 
   TaskQueue<Task> tasks_;
   uv_loop_t loop_;
@@ -165,25 +298,30 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   std::unordered_set<uv_timer_t*> timers_;
 };
 
-WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size) {
+WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size,
+                                                 bool pin_threads) {
   Mutex platform_workers_mutex;
   ConditionVariable platform_workers_ready;
 
   Mutex::ScopedLock lock(platform_workers_mutex);
   int pending_platform_workers = thread_pool_size;
 
-  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(
-      &pending_worker_tasks_);
+  // The queues must exist before any task can be posted.
+  for (int i = 0; i < std::max(thread_pool_size, 1); i++)
+    queues_.emplace_back(new WorkerQueue(&queued_tasks_));
+
+  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(this);
   threads_.push_back(delayed_task_scheduler_->Start());
 
   for (int i = 0; i < thread_pool_size; i++) {
-    PlatformWorkerData* worker_data = new PlatformWorkerData{
-      &pending_worker_tasks_, &platform_workers_mutex,
-      &platform_workers_ready, &pending_platform_workers, i
+    WorkerData* worker_data = new WorkerData{
+      this, &platform_workers_mutex, &platform_workers_ready,
+      &pending_platform_workers, static_cast<size_t>(i), pin_threads
     };
     std::unique_ptr<uv_thread_t> t { new uv_thread_t() };
-    if (uv_thread_create(t.get(), PlatformWorkerThread,
-                         worker_data) != 0) {
+    if (uv_thread_create(t.get(), WorkerThread, worker_data) != 0) {
+      delete worker_data;
+      pending_platform_workers -= thread_pool_size - i;
       break;
     }
     threads_.push_back(std::move(t));
@@ -196,8 +334,24 @@ WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size) {
   }
 }
 
-void WorkerThreadsTaskRunner::PostTask(std::unique_ptr<Task> task) {
-  pending_worker_tasks_.Push(std::move(task));
+WorkerThreadsTaskRunner::~WorkerThreadsTaskRunner() = default;
+
+void WorkerThreadsTaskRunner::PostTask(std::unique_ptr<Task> task,
+                                       Priority priority) {
+  outstanding_tasks_++;
+  // Tasks posted by a worker thread stay local to it unless stolen; others
+  // are spread round-robin.
+  size_t index;
+  if (current_runner == this)
+    index = current_queue_index;
+  else
+    index = next_queue_++ % queues_.size();
+  queues_[index]->Push(std::move(task), priority);
+
+  if (idle_workers_ > 0) {
+    Mutex::ScopedLock lock(idle_mutex_);
+    tasks_available_.Signal(lock);
+  }
 }
 
 void WorkerThreadsTaskRunner::PostDelayedTask(std::unique_ptr<Task> task,
@@ -206,11 +360,18 @@ void WorkerThreadsTaskRunner::PostDelayedTask(std::unique_ptr<Task> task,
 }
 
 void WorkerThreadsTaskRunner::BlockingDrain() {
-  pending_worker_tasks_.BlockingDrain();
+  Mutex::ScopedLock lock(drain_mutex_);
+  while (outstanding_tasks_ > 0) {
+    tasks_drained_.Wait(lock);
+  }
 }
 
 void WorkerThreadsTaskRunner::Shutdown() {
-  pending_worker_tasks_.Stop();
+  {
+    Mutex::ScopedLock lock(idle_mutex_);
+    stopped_ = true;
+    tasks_available_.Broadcast(lock);
+  }
   delayed_task_scheduler_->Stop();
   for (size_t i = 0; i < threads_.size(); i++) {
     CHECK_EQ(0, uv_thread_join(threads_[i].get()));
@@ -221,6 +382,19 @@ int WorkerThreadsTaskRunner::NumberOfWorkerThreads() const {
   return threads_.size();
 }
 
+WorkerThreadsTaskRunner::Stats WorkerThreadsTaskRunner::GetStats() const {
+  Stats stats = {};
+  // The first thread is the one of the DelayedTaskScheduler.
+  stats.threads = threads_.size() - 1;
+  for (const auto& queue : queues_) {
+    stats.tasks_posted += queue->tasks_posted();
+    stats.lock_contentions += queue->lock_contentions();
+  }
+  stats.tasks_stolen = tasks_stolen_;
+  stats.idle_waits = idle_waits_;
+  return stats;
+}
+
 PerIsolatePlatformData::PerIsolatePlatformData(
     Isolate* isolate, uv_loop_t* loop)
   : loop_(loop) {
@@ -297,14 +471,16 @@ void PerIsolatePlatformData::Shutdown() {
 }
 
 NodePlatform::NodePlatform(int thread_pool_size,
-                           TracingController* tracing_controller) {
+                           TracingController* tracing_controller,
+                           bool pin_worker_threads) {
   if (tracing_controller) {
     tracing_controller_ = tracing_controller;
   } else {
     tracing_controller_ = new TracingController();
   }
   worker_thread_task_runner_ =
-      std::make_shared<WorkerThreadsTaskRunner>(thread_pool_size);
+      std::make_shared<WorkerThreadsTaskRunner>(thread_pool_size,
+                                                pin_worker_threads);
 }
 
 void NodePlatform::RegisterIsolate(Isolate* isolate, uv_loop_t* loop) {
@@ -430,6 +606,17 @@ void NodePlatform::CallOnWorkerThread(std::unique_ptr<Task> task) {
   worker_thread_task_runner_->PostTask(std::move(task));
 }
 
+void NodePlatform::CallBlockingTaskOnWorkerThread(std::unique_ptr<Task> task) {
+  worker_thread_task_runner_->PostTask(std::move(task),
+                                       WorkerThreadsTaskRunner::kUserBlocking);
+}
+
+void NodePlatform::CallLowPriorityTaskOnWorkerThread(
+    std::unique_ptr<Task> task) {
+  worker_thread_task_runner_->PostTask(std::move(task),
+                                       WorkerThreadsTaskRunner::kBestEffort);
+}
+
 void NodePlatform::CallDelayedOnWorkerThread(std::unique_ptr<Task> task,
                                              double delay_in_seconds) {
   worker_thread_task_runner_->PostDelayedTask(std::move(task),
@@ -460,6 +647,10 @@ NodePlatform::GetForegroundTaskRunner(Isolate* isolate) {
   return ForIsolate(isolate);
 }
 
+WorkerThreadsTaskRunner::Stats NodePlatform::GetWorkerThreadsStats() const {
+  return worker_thread_task_runner_->GetStats();
+}
+
 double NodePlatform::MonotonicallyIncreasingTime() {
   // Convert nanos to seconds.
   return uv_hrtime() / 1e9;
@@ -3,6 +3,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <atomic>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -108,11 +109,36 @@ class PerIsolatePlatformData :
 };
 
 // This acts as the single worker thread task runner for all Isolates.
+// Each worker thread owns a queue; tasks are spread over the queues and idle
+// workers steal from the queues of busy ones, so that threads posting tasks
+// concurrently do not all contend on one lock.
 class WorkerThreadsTaskRunner {
  public:
-  explicit WorkerThreadsTaskRunner(int thread_pool_size);
+  // Mirrors the kinds of worker tasks that V8 distinguishes through
+  // CallBlockingTaskOnWorkerThread() and CallLowPriorityTaskOnWorkerThread().
+  enum Priority {
+    kUserBlocking,
+    kUserVisible,
+    kBestEffort,
+    kPriorityCount
+  };
+
+  struct Stats {
+    // Threads that run tasks. Unlike NumberOfWorkerThreads(), this does not
+    // count the thread that schedules delayed tasks.
+    uint64_t threads;
+    uint64_t tasks_posted;
+    uint64_t tasks_stolen;
+    uint64_t lock_contentions;
+    uint64_t idle_waits;
+  };
 
-  void PostTask(std::unique_ptr<v8::Task> task);
+  explicit WorkerThreadsTaskRunner(int thread_pool_size,
+                                   bool pin_threads = false);
+  ~WorkerThreadsTaskRunner();
+
+  void PostTask(std::unique_ptr<v8::Task> task,
+                Priority priority = kUserVisible);
   void PostDelayedTask(std::unique_ptr<v8::Task> task,
                        double delay_in_seconds);
 
@@ -120,9 +146,31 @@ class WorkerThreadsTaskRunner {
   void Shutdown();
 
   int NumberOfWorkerThreads() const;
+  Stats GetStats() const;
 
  private:
-  TaskQueue<v8::Task> pending_worker_tasks_;
+  class WorkerQueue;
+  struct WorkerData;
+
+  static void WorkerThread(void* data);
+  std::unique_ptr<v8::Task> NextTask(size_t index);
+  void NotifyOfCompletion();
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::atomic<size_t> next_queue_ {0};
+  // Number of tasks sitting in any of the queues.
+  std::atomic<size_t> queued_tasks_ {0};
+  std::atomic<int> idle_workers_ {0};
+  std::atomic<bool> stopped_ {false};
+  std::atomic<uint64_t> tasks_stolen_ {0};
+  std::atomic<uint64_t> idle_waits_ {0};
+  Mutex idle_mutex_;
+  ConditionVariable tasks_available_;
+
+  // Number of tasks that have been posted but not finished running.
+  std::atomic<int> outstanding_tasks_ {0};
+  Mutex drain_mutex_;
+  ConditionVariable tasks_drained_;
 
   class DelayedTaskScheduler;
   std::unique_ptr<DelayedTaskScheduler> delayed_task_scheduler_;
@@ -133,7 +181,8 @@ class WorkerThreadsTaskRunner {
 class NodePlatform : public MultiIsolatePlatform {
  public:
   NodePlatform(int thread_pool_size,
-               node::tracing::TracingController* tracing_controller);
+               node::tracing::TracingController* tracing_controller,
+               bool pin_worker_threads = false);
   ~NodePlatform() override = default;
 
   void DrainTasks(v8::Isolate* isolate) override;
@@ -143,6 +192,9 @@ class NodePlatform : public MultiIsolatePlatform {
   // v8::Platform implementation.
   int NumberOfWorkerThreads() override;
   void CallOnWorkerThread(std::unique_ptr<v8::Task> task) override;
+  void CallBlockingTaskOnWorkerThread(std::unique_ptr<v8::Task> task) override;
+  void CallLowPriorityTaskOnWorkerThread(
+      std::unique_ptr<v8::Task> task) override;
   void CallDelayedOnWorkerThread(std::unique_ptr<v8::Task> task,
                                  double delay_in_seconds) override;
   void CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) override {
@@ -167,6 +219,8 @@ class NodePlatform : public MultiIsolatePlatform {
   std::shared_ptr<v8::TaskRunner> GetForegroundTaskRunner(
       v8::Isolate* isolate) override;
 
+  WorkerThreadsTaskRunner::Stats GetWorkerThreadsStats() const;
+
  private:
   std::shared_ptr<PerIsolatePlatformData> ForIsolate(v8::Isolate* isolate);
 
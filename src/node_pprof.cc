@@ -0,0 +1,379 @@
+#include "node_pprof.h"
+#include "diagnosticfilename-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_file.h"
+#include "node_internals.h"
+#include "util-inl.h"
+#include "zlib.h"
+
+#include <algorithm>
+
+namespace node {
+namespace pprof {
+
+namespace {
+
+// Field numbers of the messages of profile.proto.
+enum ProfileField {
+  kProfileSampleType = 1,
+  kProfileSample = 2,
+  kProfileLocation = 4,
+  kProfileFunction = 5,
+  kProfileStringTable = 6,
+  kProfileTimeNanos = 9,
+  kProfileDurationNanos = 10,
+  kProfilePeriodType = 11,
+  kProfilePeriod = 12
+};
+
+enum ValueTypeField { kValueTypeType = 1, kValueTypeUnit = 2 };
+enum SampleField { kSampleLocationId = 1, kSampleValue = 2 };
+enum LocationField { kLocationId = 1, kLocationLine = 4 };
+enum LineField { kLineFunctionId = 1, kLineLine = 2 };
+enum FunctionField {
+  kFunctionId = 1,
+  kFunctionName = 2,
+  kFunctionSystemName = 3,
+  kFunctionFilename = 4,
+  kFunctionStartLine = 5
+};
+
+enum WireType { kVarint = 0, kLengthDelimited = 2 };
+
+// A minimal protocol buffer encoder.
+class Encoder {
+ public:
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  void Key(int field, WireType type) {
+    Varint((static_cast<uint64_t>(field) << 3) | type);
+  }
+
+  // Fields that have their default value are not encoded.
+  void Int(int field, int64_t value) {
+    if (value == 0)
+      return;
+    Key(field, kVarint);
+    Varint(static_cast<uint64_t>(value));
+  }
+
+  void Bytes(int field, const std::string& value) {
+    Key(field, kLengthDelimited);
+    Varint(value.size());
+    out_ += value;
+  }
+
+  template <typename T>
+  void Packed(int field, const std::vector<T>& values) {
+    if (values.empty())
+      return;
+    Encoder packed;
+    for (T value : values)
+      packed.Varint(static_cast<uint64_t>(value));
+    Bytes(field, packed.out_);
+  }
+
+  void Message(int field, const Encoder& message) {
+    Bytes(field, message.out_);
+  }
+
+  const std::string& out() const { return out_; }
+
+ private:
+  std::string out_;
+};
+
+Encoder ValueType(const std::pair<int64_t, int64_t>& value_type) {
+  Encoder encoder;
+  encoder.Int(kValueTypeType, value_type.first);
+  encoder.Int(kValueTypeUnit, value_type.second);
+  return encoder;
+}
+
+}  // anonymous namespace
+
+ProfileBuilder::ProfileBuilder() {
+  // The first string of the table must be empty.
+  Intern("");
+}
+
+int64_t ProfileBuilder::Intern(const std::string& str) {
+  auto it = string_ids_.find(str);
+  if (it != string_ids_.end())
+    return it->second;
+  const int64_t id = strings_.size();
+  strings_.push_back(str);
+  string_ids_.emplace(str, id);
+  return id;
+}
+
+void ProfileBuilder::AddSampleType(const std::string& type,
+                                   const std::string& unit) {
+  sample_types_.push_back({ Intern(type), Intern(unit) });
+}
+
+void ProfileBuilder::SetPeriod(const std::string& type,
+                               const std::string& unit,
+                               int64_t period) {
+  period_type_ = { Intern(type), Intern(unit) };
+  period_ = period;
+}
+
+uint64_t ProfileBuilder::AddLocation(const std::string& name,
+                                     const std::string& filename,
+                                     int64_t line) {
+  FunctionKey key { Intern(name), Intern(filename), line };
+  auto it = function_ids_.find(key);
+  if (it != function_ids_.end())
+    return it->second;
+  const uint64_t id = function_ids_.size() + 1;
+  function_ids_.emplace(key, id);
+  return id;
+}
+
+void ProfileBuilder::AddSample(const std::vector<uint64_t>& location_ids,
+                               const std::vector<int64_t>& values) {
+  CHECK_EQ(values.size(), sample_types_.size());
+  samples_.push_back(Sample { location_ids, values });
+}
+
+std::string ProfileBuilder::Serialize() const {
+  Encoder profile;
+  for (const auto& sample_type : sample_types_)
+    profile.Message(kProfileSampleType, ValueType(sample_type));
+
+  for (const Sample& sample : samples_) {
+    Encoder encoder;
+    encoder.Packed(kSampleLocationId, sample.location_ids);
+    encoder.Packed(kSampleValue, sample.values);
+    profile.Message(kProfileSample, encoder);
+  }
+
+  // Each function has a location with the same id.
+  for (const auto& function : function_ids_) {
+    Encoder line;
+    line.Int(kLineFunctionId, function.second);
+    line.Int(kLineLine, std::get<2>(function.first));
+    Encoder location;
+    location.Int(kLocationId, function.second);
+    location.Message(kLocationLine, line);
+    profile.Message(kProfileLocation, location);
+  }
+
+  for (const auto& function : function_ids_) {
+    Encoder encoder;
+    encoder.Int(kFunctionId, function.second);
+    encoder.Int(kFunctionName, std::get<0>(function.first));
+    encoder.Int(kFunctionSystemName, std::get<0>(function.first));
+    encoder.Int(kFunctionFilename, std::get<1>(function.first));
+    encoder.Int(kFunctionStartLine, std::get<2>(function.first));
+    profile.Message(kProfileFunction, encoder);
+  }
+
+  for (const std::string& str : strings_)
+    profile.Bytes(kProfileStringTable, str);
+
+  profile.Int(kProfileTimeNanos, time_nanos_);
+  profile.Int(kProfileDurationNanos, duration_nanos_);
+  if (period_type_.first != 0)
+    profile.Message(kProfilePeriodType, ValueType(period_type_));
+  profile.Int(kProfilePeriod, period_);
+  return profile.out();
+}
+
+bool Gzip(const std::string& data, std::string* out) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // 16 + the default window bits selects the gzip format.
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS,
+                   8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  out->resize(deflateBound(&stream, data.size()));
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+  stream.avail_out = out->size();
+  const int err = deflate(&stream, Z_FINISH);
+  out->resize(stream.total_out);
+  deflateEnd(&stream);
+  return err == Z_STREAM_END;
+}
+
+void SortProfileNames(std::vector<std::string>* names) {
+  using Key = std::tuple<std::string, std::string, uint64_t, std::string>;
+  std::vector<Key> keys;
+  keys.reserve(names->size());
+  for (std::string& name : *names) {
+    const std::vector<std::string> fields = SplitString(name, '.');
+    if (fields.size() < 8) {
+      keys.emplace_back(std::string(), std::string(), 0, std::move(name));
+      continue;
+    }
+    const size_t n = fields.size();
+    keys.emplace_back(fields[n - 7],
+                      fields[n - 6],
+                      strtoull(fields[n - 3].c_str(), nullptr, 10),
+                      std::move(name));
+  }
+  std::sort(keys.begin(), keys.end());
+  for (size_t i = 0; i < keys.size(); i++)
+    (*names)[i] = std::move(std::get<3>(keys[i]));
+}
+
+PeriodicProfiler::PeriodicProfiler(Environment* env,
+                                   const char* type,
+                                   const std::string& directory,
+                                   uint64_t period,
+                                   uint64_t max_files,
+                                   int signal)
+    : env_(env),
+      type_(type),
+      directory_(directory),
+      period_(period),
+      max_files_(max_files),
+      signal_(signal) {}
+
+PeriodicProfiler::~PeriodicProfiler() {
+  if (started_)
+    env_->RemoveCleanupHook(CleanupHook, this);
+}
+
+void PeriodicProfiler::Start() {
+  CHECK(!started_);
+  started_ = true;
+  StartProfiling();
+
+  CHECK_EQ(0, uv_timer_init(env_->event_loop(), &timer_));
+  timer_.data = this;
+  if (period_ > 0)
+    CHECK_EQ(0, uv_timer_start(&timer_, OnTimer, period_, period_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&timer_));
+
+  CHECK_EQ(0, uv_signal_init(env_->event_loop(), &signal_handle_));
+  signal_handle_.data = this;
+  if (signal_ != 0) {
+    int err = uv_signal_start(&signal_handle_, OnSignal, signal_);
+    if (err != 0) {
+      fprintf(stderr, "%s: Cannot handle signal %d for %s profiles\n",
+              uv_err_name(err), signal_, type_);
+    }
+  }
+  uv_unref(reinterpret_cast<uv_handle_t*>(&signal_handle_));
+
+  env_->AddCleanupHook(CleanupHook, this);
+}
+
+void PeriodicProfiler::Stop() {
+  if (!running())
+    return;
+  uv_timer_stop(&timer_);
+  uv_signal_stop(&signal_handle_);
+  WriteProfile(true);
+  stopped_ = true;
+  StopProfiling();
+}
+
+void PeriodicProfiler::CleanupHook(void* data) {
+  PeriodicProfiler* profiler = static_cast<PeriodicProfiler*>(data);
+  profiler->Stop();
+  profiler->env_->CloseHandle(&profiler->timer_, [](uv_timer_t* handle) {});
+  profiler->env_->CloseHandle(&profiler->signal_handle_,
+                              [](uv_signal_t* handle) {});
+  profiler->started_ = false;
+}
+
+void PeriodicProfiler::OnTimer(uv_timer_t* handle) {
+  static_cast<PeriodicProfiler*>(handle->data)->WriteProfile();
+}
+
+void PeriodicProfiler::OnSignal(uv_signal_t* handle, int signal) {
+  static_cast<PeriodicProfiler*>(handle->data)->WriteProfile();
+}
+
+std::string PeriodicProfiler::WriteProfile() {
+  if (!running())
+    return std::string();
+  // Restart the period, so that profiles written on demand are not followed
+  // by a very short one.
+  if (period_ > 0)
+    uv_timer_again(&timer_);
+  return WriteProfile(false);
+}
+
+std::string PeriodicProfiler::WriteProfile(bool last) {
+  ProfileBuilder builder;
+  if (!CollectProfile(&builder, last) || builder.sample_count() == 0)
+    return std::string();
+
+  std::string data;
+  if (!Gzip(builder.Serialize(), &data)) {
+    fprintf(stderr, "Failed to compress %s profile\n", type_);
+    return std::string();
+  }
+
+  uv_fs_t req;
+  int err = fs::MKDirpSync(nullptr, &req, directory_, 0777, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err < 0 && err != UV_EEXIST) {
+    fprintf(stderr, "%s: Failed to create %s profile directory %s\n",
+            uv_err_name(err), type_, directory_.c_str());
+    return std::string();
+  }
+
+  const std::string filename = *DiagnosticFilename(env_, type_, "pb.gz");
+  const std::string path = directory_ + kPathSeparator + filename;
+  err = WriteFileSync(path.c_str(), uv_buf_init(&data[0], data.size()));
+  if (err != 0) {
+    fprintf(stderr, "%s: Failed to write file %s\n",
+            uv_err_name(err), path.c_str());
+    return std::string();
+  }
+  RemoveOldProfiles();
+  return path;
+}
+
+void PeriodicProfiler::RemoveOldProfiles() {
+  if (max_files_ == 0)
+    return;
+
+  uv_fs_t req;
+  if (uv_fs_scandir(nullptr, &req, directory_.c_str(), 0, nullptr) < 0) {
+    uv_fs_req_cleanup(&req);
+    return;
+  }
+  const std::string prefix = std::string(type_) + ".";
+  const std::string suffix = ".pb.gz";
+  std::vector<std::string> names;
+  uv_dirent_t ent;
+  while (uv_fs_scandir_next(&req, &ent) != UV_EOF) {
+    const std::string name = ent.name;
+    if ((ent.type == UV_DIRENT_FILE || ent.type == UV_DIRENT_UNKNOWN) &&
+        name.size() > prefix.size() + suffix.size() &&
+        name.compare(0, prefix.size(), prefix) == 0 &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      names.push_back(name);
+    }
+  }
+  uv_fs_req_cleanup(&req);
+  if (names.size() <= max_files_)
+    return;
+
+  SortProfileNames(&names);
+  for (size_t i = 0; i < names.size() - max_files_; i++) {
+    const std::string path = directory_ + kPathSeparator + names[i];
+    uv_fs_unlink(nullptr, &req, path.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+}
+
+}  // namespace pprof
+}  // namespace node
@@ -0,0 +1,148 @@
+#ifndef SRC_NODE_PPROF_H_
+#define SRC_NODE_PPROF_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+namespace pprof {
+
+// Builds a profile in the protocol buffer format read by pprof, as described
+// in https://github.com/google/pprof/blob/master/proto/profile.proto.
+// Only the fields that are needed for JavaScript stacks are supported.
+class ProfileBuilder {
+ public:
+  ProfileBuilder();
+  ProfileBuilder(const ProfileBuilder&) = delete;
+  ProfileBuilder& operator=(const ProfileBuilder&) = delete;
+
+  // Every sample has one value per sample type, in the same order.
+  void AddSampleType(const std::string& type, const std::string& unit);
+  void SetPeriod(const std::string& type, const std::string& unit,
+                 int64_t period);
+  inline void set_time_nanos(int64_t time) { time_nanos_ = time; }
+  inline void set_duration_nanos(int64_t duration) {
+    duration_nanos_ = duration;
+  }
+
+  // Returns the id of the location of the function `name`, which starts at
+  // `line` of `filename`. Locations and functions are deduplicated.
+  uint64_t AddLocation(const std::string& name,
+                       const std::string& filename,
+                       int64_t line);
+  // `location_ids` is the stack of the sample, starting with the innermost
+  // frame.
+  void AddSample(const std::vector<uint64_t>& location_ids,
+                 const std::vector<int64_t>& values);
+
+  inline size_t sample_count() const { return samples_.size(); }
+
+  // Returns the encoded profile, uncompressed.
+  std::string Serialize() const;
+
+ private:
+  struct Sample {
+    std::vector<uint64_t> location_ids;
+    std::vector<int64_t> values;
+  };
+  using FunctionKey = std::tuple<int64_t, int64_t, int64_t>;
+
+  int64_t Intern(const std::string& str);
+
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, int64_t> string_ids_;
+  std::vector<std::pair<int64_t, int64_t>> sample_types_;
+  std::pair<int64_t, int64_t> period_type_ = { 0, 0 };
+  int64_t period_ = 0;
+  int64_t time_nanos_ = 0;
+  int64_t duration_nanos_ = 0;
+  // Functions are numbered from 1 in the order in which they are added, and
+  // so are locations, which have a single line at the start of a function.
+  std::map<FunctionKey, uint64_t> function_ids_;
+  std::vector<Sample> samples_;
+};
+
+// Compresses `data` in the gzip format, which pprof expects files to use.
+bool Gzip(const std::string& data, std::string* out);
+
+// Sorts the names of the files that PeriodicProfiler writes, which look like
+// `type.date.time.pid.thread.seq.pb.gz`, from oldest to newest: by date and
+// time, and then by the sequence number, which is compared as a number
+// because it is only padded to three digits.
+void SortProfileNames(std::vector<std::string>* names);
+
+// Takes profiles while the process runs, and writes them to `directory` in
+// gzipped pprof files every `period` milliseconds, when `signal` is received
+// if it is not 0, and when profiling stops. The files are named like
+// diagnostic reports, with a `type` prefix and a `.pb.gz` extension. Only the
+// `max_files` most recent of them are kept in the directory, including those
+// written by other processes, unless `max_files` is 0.
+//
+// Subclasses take the profiles. Everything happens on the thread of the
+// Environment, and the profiles are written synchronously.
+class PeriodicProfiler {
+ public:
+  PeriodicProfiler(Environment* env,
+                   const char* type,
+                   const std::string& directory,
+                   uint64_t period,
+                   uint64_t max_files,
+                   int signal);
+  virtual ~PeriodicProfiler();
+  PeriodicProfiler(const PeriodicProfiler&) = delete;
+  PeriodicProfiler& operator=(const PeriodicProfiler&) = delete;
+
+  void Start();
+  // Writes the last profile. The handles are closed when the Environment is
+  // cleaned up.
+  void Stop();
+  // Writes the profile collected since the previous one was written, and
+  // returns its path, or an empty string if it could not be written.
+  std::string WriteProfile();
+
+  inline Environment* env() const { return env_; }
+  inline bool running() const { return started_ && !stopped_; }
+
+ protected:
+  virtual void StartProfiling() = 0;
+  virtual void StopProfiling() = 0;
+  // Adds what was collected since the previous call to `builder`. Unless
+  // `last` is true, collecting the next profile starts right away.
+  virtual bool CollectProfile(ProfileBuilder* builder, bool last) = 0;
+
+ private:
+  static void CleanupHook(void* data);
+  static void OnTimer(uv_timer_t* handle);
+  static void OnSignal(uv_signal_t* handle, int signal);
+  std::string WriteProfile(bool last);
+  void RemoveOldProfiles();
+
+  Environment* const env_;
+  const char* const type_;
+  const std::string directory_;
+  const uint64_t period_;
+  const uint64_t max_files_;
+  const int signal_;
+  uv_timer_t timer_;
+  uv_signal_t signal_handle_;
+  bool started_ = false;
+  bool stopped_ = false;
+};
+
+}  // namespace pprof
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PPROF_H_
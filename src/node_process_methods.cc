@@ -191,7 +191,7 @@ static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   // Get the double array pointer from the Float64Array argument.
   CHECK(args[0]->IsFloat64Array());
   Local<Float64Array> array = args[0].As<Float64Array>();
-  CHECK_EQ(array->Length(), 4);
+  CHECK_EQ(array->Length(), 5);
   Local<ArrayBuffer> ab = array->Buffer();
   double* fields = static_cast<double*>(ab->GetContents().Data());
 
@@ -199,6 +199,8 @@ static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   fields[1] = v8_heap_stats.total_heap_size();
   fields[2] = v8_heap_stats.used_heap_size();
   fields[3] = v8_heap_stats.external_memory();
+  NodeArrayBufferAllocator* allocator = env->isolate_data()->node_allocator();
+  fields[4] = allocator != nullptr ? allocator->huge_page_bytes() : 0;
 }
 
 void RawDebug(const FunctionCallbackInfo<Value>& args) {
@@ -4,6 +4,8 @@
 #include "diagnosticfilename-inl.h"
 #include "node_internals.h"
 #include "node_metadata.h"
+#include "node_platform.h"
+#include "node_v8_platform-inl.h"
 #include "util.h"
 
 #ifdef _WIN32
@@ -60,6 +62,8 @@ static void PrintJavaScriptStack(JSONWriter* writer,
                                  const char* trigger);
 static void PrintNativeStack(JSONWriter* writer);
 static void PrintResourceUsage(JSONWriter* writer);
+static void PrintV8ThreadPool(JSONWriter* writer);
+static void PrintThreadpoolWork(JSONWriter* writer, Environment* env);
 static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate);
 static void PrintSystemInformation(JSONWriter* writer);
 static void PrintLoadedLibraries(JSONWriter* writer);
@@ -247,6 +251,13 @@ static void WriteNodeReport(Isolate* isolate,
   // Report OS and current thread resource usage
   PrintResourceUsage(&writer);
 
+  // Report the activity of V8's thread pool
+  PrintV8ThreadPool(&writer);
+
+  // Report the per-class queues of libuv threadpool work
+  if (env != nullptr)
+    PrintThreadpoolWork(&writer, env);
+
   writer.json_arraystart("libuv");
   if (env != nullptr) {
     uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
@@ -472,6 +483,43 @@ static void PrintResourceUsage(JSONWriter* writer) {
 #endif
 }
 
+static void PrintV8ThreadPool(JSONWriter* writer) {
+  node::NodePlatform* platform = node::per_process::v8_platform.Platform();
+  if (platform == nullptr)
+    return;
+  node::WorkerThreadsTaskRunner::Stats stats =
+      platform->GetWorkerThreadsStats();
+  writer->json_objectstart("v8ThreadPool");
+  writer->json_keyvalue("threads", stats.threads);
+  writer->json_keyvalue("tasksPosted", stats.tasks_posted);
+  writer->json_keyvalue("tasksStolen", stats.tasks_stolen);
+  writer->json_keyvalue("lockContentions", stats.lock_contentions);
+  writer->json_keyvalue("idleWaits", stats.idle_waits);
+  writer->json_objectend();
+}
+
+static void PrintThreadpoolWork(JSONWriter* writer, Environment* env) {
+  const double kNsPerMs = 1e6;
+  node::ThreadPoolWorkQueue* queue = env->threadpool_work_queue();
+  writer->json_objectstart("threadpoolWork");
+  writer->json_keyvalue("threads", queue->threadpool_size());
+  for (int i = 0; i < node::ThreadPoolWork::kWorkClassCount; i++) {
+    const auto work_class = static_cast<node::ThreadPoolWork::WorkClass>(i);
+    const node::ThreadPoolWorkQueue::ClassStats& stats =
+        queue->stats(work_class);
+    writer->json_objectstart(node::ThreadPoolWork::WorkClassName(work_class));
+    writer->json_keyvalue("limit", stats.limit);
+    writer->json_keyvalue("queued", stats.queued);
+    writer->json_keyvalue("running", stats.running);
+    writer->json_keyvalue("completed", stats.completed);
+    writer->json_keyvalue("totalWaitMs", stats.total_wait_ns / kNsPerMs);
+    writer->json_keyvalue("maxWaitMs", stats.max_wait_ns / kNsPerMs);
+    writer->json_keyvalue("totalRunMs", stats.total_run_ns / kNsPerMs);
+    writer->json_objectend();
+  }
+  writer->json_objectend();
+}
+
 // Report operating system information.
 static void PrintSystemInformation(JSONWriter* writer) {
 #ifndef _WIN32
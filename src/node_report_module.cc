@@ -5,6 +5,10 @@
 #include "node_report.h"
 #include "util-inl.h"
 
+#if HAVE_INSPECTOR
+#include "inspector_profiler.h"
+#endif
+
 #include "handle_wrap.h"
 #include "node_buffer.h"
 #include "stream_base-inl.h"
@@ -68,6 +72,26 @@ void GetReport(const FunctionCallbackInfo<Value>& info) {
                                 .ToLocalChecked());
 }
 
+// External JavaScript API for writing the allocation profile collected by
+// --heap-prof-continuous right away
+void WriteHeapProfile(const FunctionCallbackInfo<Value>& info) {
+#if HAVE_INSPECTOR
+  Environment* env = Environment::GetCurrent(info);
+  node::profiler::ContinuousHeapProfiler* profiler =
+      env->continuous_heap_profiler();
+  if (profiler == nullptr)
+    return;
+  std::string filename = profiler->WriteProfile();
+  if (filename.empty())
+    return;
+  // Return value is the profile filename
+  info.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(),
+                          filename.c_str(),
+                          v8::NewStringType::kNormal).ToLocalChecked());
+#endif  // HAVE_INSPECTOR
+}
+
 static void GetDirectory(const FunctionCallbackInfo<Value>& info) {
   Environment* env = Environment::GetCurrent(info);
   std::string directory = env->isolate_data()->options()->report_directory;
@@ -161,6 +185,7 @@ static void Initialize(Local<Object> exports,
 
   env->SetMethod(exports, "writeReport", WriteReport);
   env->SetMethod(exports, "getReport", GetReport);
+  env->SetMethod(exports, "writeHeapProfile", WriteHeapProfile);
   env->SetMethod(exports, "getDirectory", GetDirectory);
   env->SetMethod(exports, "setDirectory", SetDirectory);
   env->SetMethod(exports, "getFilename", GetFilename);
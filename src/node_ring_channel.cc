@@ -0,0 +1,310 @@
+#include "env-inl.h"
+#include "node_binding.h"
+#include "node_buffer.h"
+#include "node_errors.h"
+#include "util-inl.h"
+
+#include <atomic>
+#include <cstring>
+
+// A ring buffer of length-prefixed records inside a SharedArrayBuffer, used
+// by worker_threads.RingChannel. Any number of threads may write to it and
+// one thread at a time may read from it. Writers reserve space by advancing
+// the head with a compare-and-swap, copy their record into the buffer and
+// then publish it by storing its type. The reader consumes published records
+// in order, zeroes them so that the space can be reused, and advances the
+// tail. Blocking and wakeups are implemented in JS with Atomics.wait() and
+// Atomics.notify() on the words that follow the head and the tail.
+
+namespace node {
+
+using v8::ArrayBufferView;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::Object;
+using v8::SharedArrayBuffer;
+using v8::String;
+using v8::Value;
+
+namespace ring_channel {
+
+// Byte offsets into the header that precedes the records. The head and the
+// tail live on cache lines of their own, so that writers and the reader do
+// not contend for them more than necessary.
+enum HeaderOffset : size_t {
+  kHeadOffset = 0,
+  kTailOffset = 64,
+  kReadersWaitingOffset = 128,
+  kReadSignalOffset = 132,
+  kWritersWaitingOffset = 192,
+  kWriteSignalOffset = 196,
+  kHeaderSize = 256
+};
+
+// A type of 0 means that the record has not been published yet.
+enum RecordType : uint32_t {
+  kNone = 0,
+  kBinary = 1,
+  kOneByteString = 2,
+  kTwoByteString = 3,
+  kPadding = 4
+};
+
+static const size_t kMinCapacity = 1024;
+static const size_t kMaxCapacity = 1u << 30;
+
+struct RecordHeader {
+  std::atomic<uint32_t> length;
+  std::atomic<uint32_t> type;
+};
+
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader must be 8 bytes");
+
+class Ring {
+ public:
+  explicit Ring(Local<Value> buffer) {
+    CHECK(buffer->IsSharedArrayBuffer());
+    SharedArrayBuffer::Contents contents =
+        buffer.As<SharedArrayBuffer>()->GetContents();
+    base_ = static_cast<char*>(contents.Data());
+    // The capacity has been validated by the RingChannel constructor.
+    CHECK_GE(contents.ByteLength(), kHeaderSize + kMinCapacity);
+    capacity_ = contents.ByteLength() - kHeaderSize;
+    CHECK_EQ(capacity_ & (capacity_ - 1), 0);
+    CHECK_LE(capacity_, kMaxCapacity);
+  }
+
+  // A record never has to be padded by more than its own size, so records
+  // of up to half the capacity can always be written once the ring is empty.
+  size_t max_length() const {
+    return capacity_ / 2 - sizeof(RecordHeader);
+  }
+
+  static uint32_t RecordSize(size_t length) {
+    return RoundUp(sizeof(RecordHeader) + length, alignof(uint64_t));
+  }
+
+  // Sets `*header` to the header of a record with room for `length` bytes
+  // of payload, or to nullptr if the ring is full. Returns false if the
+  // state of the ring is invalid.
+  bool Reserve(size_t length, RecordHeader** header) {
+    const uint32_t size = RecordSize(length);
+    uint32_t pos;
+    uint32_t padding;
+    for (;;) {
+      // The tail is loaded first, so that it cannot be ahead of the head.
+      const uint32_t tail = this->tail()->load();
+      pos = head()->load(std::memory_order_relaxed);
+      const uint32_t used = pos - tail;
+      if (used > capacity_ || pos % alignof(uint64_t) != 0)
+        return false;
+      const uint32_t offset = pos & (capacity_ - 1);
+      padding = capacity_ - offset < size ? capacity_ - offset : 0;
+      if (used + padding + size > capacity_) {
+        *header = nullptr;
+        return true;
+      }
+      if (head()->compare_exchange_weak(pos, pos + padding + size,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    if (padding != 0) {
+      RecordHeader* padding_header = At(pos);
+      padding_header->length.store(padding - sizeof(RecordHeader),
+                                   std::memory_order_relaxed);
+      padding_header->type.store(kPadding);
+      pos += padding;
+    }
+    *header = At(pos);
+    return true;
+  }
+
+  static void Publish(RecordHeader* header, RecordType type, size_t length) {
+    header->length.store(length, std::memory_order_relaxed);
+    header->type.store(type);
+  }
+
+  static char* Payload(RecordHeader* header) {
+    return reinterpret_cast<char*>(header + 1);
+  }
+
+  RecordHeader* At(uint32_t pos) const {
+    return reinterpret_cast<RecordHeader*>(
+        base_ + kHeaderSize + (pos & (capacity_ - 1)));
+  }
+
+  std::atomic<uint32_t>* head() const {
+    return reinterpret_cast<std::atomic<uint32_t>*>(base_ + kHeadOffset);
+  }
+
+  std::atomic<uint32_t>* tail() const {
+    return reinterpret_cast<std::atomic<uint32_t>*>(base_ + kTailOffset);
+  }
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  char* base_;
+  size_t capacity_;
+};
+
+// write(buffer, data): Returns false if the ring is full.
+static void Write(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Ring ring(args[0]);
+
+  RecordType type;
+  size_t length;
+  Local<String> string;
+  ArrayBufferViewContents<char> contents;
+  if (args[1]->IsString()) {
+    string = args[1].As<String>();
+    if (string->IsOneByte()) {
+      type = kOneByteString;
+      length = string->Length();
+    } else {
+      type = kTwoByteString;
+      length = string->Length() * sizeof(uint16_t);
+    }
+  } else {
+    CHECK(args[1]->IsArrayBufferView());
+    contents.Read(args[1].As<ArrayBufferView>());
+    type = kBinary;
+    length = contents.length();
+  }
+
+  if (length > ring.max_length()) {
+    THROW_ERR_OUT_OF_RANGE(
+        env, "The record exceeds half of the capacity of the RingChannel");
+    return;
+  }
+
+  RecordHeader* header;
+  if (!ring.Reserve(length, &header)) {
+    THROW_ERR_OUT_OF_RANGE(env, "The state of the RingChannel is invalid");
+    return;
+  }
+  if (header == nullptr)
+    return args.GetReturnValue().Set(false);
+
+  char* payload = Ring::Payload(header);
+  switch (type) {
+    case kOneByteString:
+      string->WriteOneByte(isolate,
+                           reinterpret_cast<uint8_t*>(payload),
+                           0,
+                           string->Length(),
+                           String::NO_NULL_TERMINATION);
+      break;
+    case kTwoByteString:
+      string->Write(isolate,
+                    reinterpret_cast<uint16_t*>(payload),
+                    0,
+                    string->Length(),
+                    String::NO_NULL_TERMINATION);
+      break;
+    default:
+      if (length > 0)
+        memcpy(payload, contents.data(), length);
+      break;
+  }
+  Ring::Publish(header, type, length);
+  args.GetReturnValue().Set(true);
+}
+
+// read(buffer): Returns the next record as a Buffer or a string, or
+// undefined if there is none.
+static void Read(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Ring ring(args[0]);
+
+  uint32_t pos = ring.tail()->load(std::memory_order_relaxed);
+  for (;;) {
+    if (pos % alignof(uint64_t) != 0) {
+      THROW_ERR_OUT_OF_RANGE(env, "The state of the RingChannel is invalid");
+      return;
+    }
+    RecordHeader* header = ring.At(pos);
+    const uint32_t type = header->type.load();
+    if (type == kNone)
+      return;
+    const uint32_t length = header->length.load(std::memory_order_relaxed);
+    const uint32_t offset = pos & (ring.capacity() - 1);
+    if (type > kPadding ||
+        length > ring.capacity() - offset - sizeof(RecordHeader) ||
+        (type != kPadding && length > ring.max_length()) ||
+        (type == kTwoByteString && length % sizeof(uint16_t) != 0)) {
+      THROW_ERR_OUT_OF_RANGE(env, "The state of the RingChannel is invalid");
+      return;
+    }
+    const uint32_t size = Ring::RecordSize(length);
+
+    const char* payload = Ring::Payload(header);
+    // Empty if creating the value failed with an exception.
+    Local<Value> value;
+    switch (type) {
+      case kBinary:
+        value = Buffer::Copy(isolate, payload, length)
+            .FromMaybe(Local<Object>());
+        break;
+      case kOneByteString:
+        value = String::NewFromOneByte(
+            isolate, reinterpret_cast<const uint8_t*>(payload),
+            NewStringType::kNormal, length).FromMaybe(Local<String>());
+        break;
+      case kTwoByteString:
+        value = String::NewFromTwoByte(
+            isolate, reinterpret_cast<const uint16_t*>(payload),
+            NewStringType::kNormal, length / sizeof(uint16_t))
+                .FromMaybe(Local<String>());
+        break;
+    }
+
+    // Writers rely on the space behind the tail being zeroed.
+    memset(Ring::Payload(header), 0, size - sizeof(RecordHeader));
+    header->length.store(0, std::memory_order_relaxed);
+    header->type.store(kNone, std::memory_order_relaxed);
+    pos += size;
+    ring.tail()->store(pos);
+
+    if (type != kPadding) {
+      if (!value.IsEmpty())
+        args.GetReturnValue().Set(value);
+      return;
+    }
+  }
+}
+
+static void Initialize(Local<Object> target,
+                       Local<Value> unused,
+                       Local<Context> context,
+                       void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "read", Read);
+  env->SetMethod(target, "write", Write);
+
+  NODE_DEFINE_CONSTANT(target, kHeaderSize);
+  NODE_DEFINE_CONSTANT(target, kMinCapacity);
+  NODE_DEFINE_CONSTANT(target, kMaxCapacity);
+  // Indices into an Int32Array over the header.
+  const int kReadersWaitingIndex = kReadersWaitingOffset / sizeof(int32_t);
+  const int kReadSignalIndex = kReadSignalOffset / sizeof(int32_t);
+  const int kWritersWaitingIndex = kWritersWaitingOffset / sizeof(int32_t);
+  const int kWriteSignalIndex = kWriteSignalOffset / sizeof(int32_t);
+  NODE_DEFINE_CONSTANT(target, kReadersWaitingIndex);
+  NODE_DEFINE_CONSTANT(target, kReadSignalIndex);
+  NODE_DEFINE_CONSTANT(target, kWritersWaitingIndex);
+  NODE_DEFINE_CONSTANT(target, kWriteSignalIndex);
+}
+
+}  // namespace ring_channel
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(ring_channel, node::ring_channel::Initialize)
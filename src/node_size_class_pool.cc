@@ -0,0 +1,124 @@
+#include "node_size_class_pool.h"
+#include "memory_tracker-inl.h"
+#include "util-inl.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <malloc.h>
+#define HAVE_USABLE_SIZE 1
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define HAVE_USABLE_SIZE 1
+#elif defined(_WIN32)
+#include <malloc.h>
+#define HAVE_USABLE_SIZE 1
+#endif
+
+namespace node {
+
+#ifdef HAVE_USABLE_SIZE
+static size_t UsableSize(void* data) {
+#if defined(__APPLE__)
+  return malloc_size(data);
+#elif defined(_WIN32)
+  return _msize(data);
+#else
+  return malloc_usable_size(data);
+#endif
+}
+#endif
+
+SizeClassPool::~SizeClassPool() {
+  for (const std::vector<void*>& free_list : free_lists_) {
+    for (void* block : free_list)
+      free(block);
+  }
+}
+
+bool SizeClassPool::IsSupported() {
+#ifdef HAVE_USABLE_SIZE
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t SizeClassPool::ClassIndex(size_t size, size_t* capacity) {
+  if (size <= kMinSize) {
+    *capacity = kMinSize;
+    return 0;
+  }
+  // 2^shift < size <= 2^(shift + 1)
+  size_t shift = 0;
+  while ((size_t{2} << shift) < size)
+    shift++;
+  const size_t base = size_t{1} << shift;
+  const size_t step = base / 4;
+  const size_t quarters = (size - base + step - 1) / step;
+  *capacity = base + quarters * step;
+  size_t index = 0;
+  for (size_t bits = kMinSize; bits < base; bits *= 2)
+    index += 4;
+  return index + quarters;
+}
+
+void* SizeClassPool::Allocate(size_t size, bool zero_fill) {
+  CHECK_LE(size, kMaxSize);
+  size_t capacity;
+  const size_t index = ClassIndex(size, &capacity);
+  DCHECK_LT(index, kClassCount);
+  void* block = nullptr;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    std::vector<void*>& free_list = free_lists_[index];
+    if (!free_list.empty()) {
+      block = free_list.back();
+      free_list.pop_back();
+      cached_bytes_ -= capacity;
+    }
+  }
+
+  if (block == nullptr)
+    return zero_fill ? UncheckedCalloc(capacity) : UncheckedMalloc(capacity);
+  if (zero_fill)
+    memset(block, 0, size);
+  return block;
+}
+
+bool SizeClassPool::Free(void* data, size_t size) {
+#ifdef HAVE_USABLE_SIZE
+  if (data == nullptr || size > kMaxSize)
+    return false;
+  size_t capacity;
+  const size_t index = ClassIndex(size, &capacity);
+  // The block may have been allocated by someone else, and then it may be
+  // too small to be reused for the other sizes of its class.
+  if (UsableSize(data) < capacity)
+    return false;
+  Mutex::ScopedLock lock(mutex_);
+  std::vector<void*>& free_list = free_lists_[index];
+  if ((free_list.size() + 1) * capacity > kMaxCachedBytesPerClass &&
+      !free_list.empty()) {
+    return false;
+  }
+  free_list.push_back(data);
+  cached_bytes_ += capacity;
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t SizeClassPool::cached_bytes() const {
+  Mutex::ScopedLock lock(mutex_);
+  return cached_bytes_;
+}
+
+void SizeClassPool::MemoryInfo(MemoryTracker* tracker) const {
+  Mutex::ScopedLock lock(mutex_);
+  tracker->TrackFieldWithSize("free_lists", cached_bytes_);
+}
+
+}  // namespace node
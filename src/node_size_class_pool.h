@@ -0,0 +1,70 @@
+#ifndef SRC_NODE_SIZE_CLASS_POOL_H_
+#define SRC_NODE_SIZE_CLASS_POOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "memory_tracker.h"
+#include "node_mutex.h"
+
+#include <array>
+#include <vector>
+
+namespace node {
+
+// Keeps freed ArrayBuffer backing stores of up to kMaxSize bytes in free
+// lists, one per size class, so that allocation-heavy code such as network
+// reads does not have to go through malloc() and free() for every chunk.
+// Each class covers a quarter of a power of two, so that no more than 25% of
+// a block is wasted.
+//
+// Like with HugePagePool, blocks are ordinary malloc() allocations that are
+// simply lost to the pool when someone else free()s them. Every allocator,
+// and so every isolate, has a pool of its own; its lock is only contended
+// when V8 frees ArrayBuffers on a background thread.
+class SizeClassPool : public MemoryRetainer {
+ public:
+  static const size_t kMinSize = 128;
+  static const size_t kMaxSize = 256 * 1024;
+  // The most memory that is kept in the free list of each class.
+  static const size_t kMaxCachedBytesPerClass = 128 * 1024;
+
+  SizeClassPool() = default;
+  ~SizeClassPool() override;
+  SizeClassPool(const SizeClassPool&) = delete;
+  SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+  // Returns false on platforms where the usable size of a malloc()
+  // allocation cannot be determined.
+  static bool IsSupported();
+
+  // `size` must not exceed kMaxSize. Returns nullptr if the memory could not
+  // be allocated.
+  void* Allocate(size_t size, bool zero_fill);
+  // Returns false if `data` was not kept, in which case the caller has to
+  // free() it.
+  bool Free(void* data, size_t size);
+
+  size_t cached_bytes() const;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(SizeClassPool)
+  SET_SELF_SIZE(SizeClassPool)
+
+ private:
+  // Four classes for every power of two between kMinSize and kMaxSize, and
+  // one for kMinSize itself.
+  static const size_t kClassCount = 45;
+
+  // Sets `*capacity` to the block size of the class of `size`.
+  static size_t ClassIndex(size_t size, size_t* capacity);
+
+  mutable Mutex mutex_;
+  std::array<std::vector<void*>, kClassCount> free_lists_;
+  size_t cached_bytes_ = 0;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SIZE_CLASS_POOL_H_
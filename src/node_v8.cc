@@ -143,6 +143,14 @@ void Initialize(Local<Object> target,
                                env->heap_statistics_buffer(),
                                heap_statistics_buffer_byte_length)).Check();
 
+  // Only set when starting from a snapshot file that contains an
+  // application, see node_mksnapshot --entry.
+  if (!env->startup_snapshot_state().IsEmpty()) {
+    target->Set(env->context(),
+                FIXED_ONE_BYTE_STRING(env->isolate(), "startupSnapshotState"),
+                env->startup_snapshot_state()).Check();
+  }
+
 #define V(i, _, name)                                                         \
   target->Set(env->context(),                                                 \
               FIXED_ONE_BYTE_STRING(env->isolate(), #name),                   \
@@ -94,7 +94,8 @@ struct V8Platform {
       StartTracingAgent();
     }
     // Tracing must be initialized before platform threads are created.
-    platform_ = new NodePlatform(thread_pool_size, controller);
+    platform_ = new NodePlatform(thread_pool_size, controller,
+                                 per_process::cli_options->v8_pool_affinity);
     v8::V8::InitializePlatform(platform_);
   }
 
@@ -129,7 +130,10 @@ struct V8Platform {
                                 std::make_move_iterator(categories.end())),
           std::unique_ptr<tracing::AsyncTraceWriter>(
               new tracing::NodeTraceWriter(
-                  per_process::cli_options->trace_event_file_pattern)),
+                  per_process::cli_options->trace_event_file_pattern,
+                  per_process::cli_options->trace_event_format == "perfetto" ?
+                      tracing::NodeTraceWriter::kPerfetto :
+                      tracing::NodeTraceWriter::kJSON)),
           tracing::Agent::kUseDefaultCategories);
     }
   }
@@ -321,6 +321,7 @@ void Worker::Run() {
 
 #if HAVE_INSPECTOR
       profiler::EndStartedProfilers(env_.get());
+      profiler::EndContinuousProfilers(env_.get());
 #endif
       Debug(this, "Exiting thread for worker %llu with exit code %d",
             thread_id_, exit_code_);
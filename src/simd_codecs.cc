@@ -0,0 +1,976 @@
+#include "simd_codecs.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NODE_SIMD_CODECS_X64 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define NODE_SIMD_CODECS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace node {
+namespace simd {
+
+namespace {
+
+struct Kernels {
+  size_t (*base64_encode)(const char* src, size_t slen, char* dst);
+  size_t (*base64_decode)(const char* src, size_t slen,
+                          char* dst, size_t dlen);
+  size_t (*hex_encode)(const char* src, size_t slen, char* dst);
+  size_t (*hex_decode)(const char* src, size_t slen, char* dst, size_t dlen);
+  bool (*validate_utf8)(const char* src, size_t len);
+};
+
+#if !defined(NODE_SIMD_CODECS_NEON)
+bool ValidateUtf8Scalar(const char* src, size_t len) {
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t c = s[i];
+    if (c < 0x80) {
+      i++;
+      continue;
+    }
+
+    size_t n;
+    uint32_t code_point;
+    if (c >= 0xc2 && c <= 0xdf) {
+      n = 1;
+      code_point = c & 0x1f;
+    } else if ((c & 0xf0) == 0xe0) {
+      n = 2;
+      code_point = c & 0x0f;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+      n = 3;
+      code_point = c & 0x07;
+    } else {
+      return false;
+    }
+    if (len - i - 1 < n)
+      return false;
+    for (size_t k = 1; k <= n; k++) {
+      if ((s[i + k] & 0xc0) != 0x80)
+        return false;
+      code_point = (code_point << 6) | (s[i + k] & 0x3f);
+    }
+    if (n == 2 && (code_point < 0x800 ||
+                   (code_point >= 0xd800 && code_point <= 0xdfff))) {
+      return false;
+    }
+    if (n == 3 && (code_point < 0x10000 || code_point > 0x10ffff))
+      return false;
+    i += n + 1;
+  }
+  return true;
+}
+#endif  // !defined(NODE_SIMD_CODECS_NEON)
+
+#if !defined(NODE_SIMD_CODECS_NEON)
+// Fallbacks for CPUs without usable vector instructions.
+size_t Base64EncodeNone(const char* src, size_t slen, char* dst) {
+  return 0;
+}
+
+size_t Base64DecodeNone(const char* src, size_t slen, char* dst,
+                        size_t dlen) {
+  return 0;
+}
+
+size_t HexEncodeNone(const char* src, size_t slen, char* dst) {
+  return 0;
+}
+
+#endif  // !defined(NODE_SIMD_CODECS_NEON)
+
+#if !defined(NODE_SIMD_CODECS_X64) && !defined(NODE_SIMD_CODECS_NEON)
+size_t HexDecodeNone(const char* src, size_t slen, char* dst, size_t dlen) {
+  return 0;
+}
+#endif
+
+#if defined(NODE_SIMD_CODECS_X64) || defined(NODE_SIMD_CODECS_NEON)
+// Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+// Byte". Every pair of adjacent bytes is classified through three nibble
+// lookups; the flags below mark the combinations that are errors.
+constexpr uint8_t kTooShort = 1 << 0;      // 11______ 0_______
+                                           // 11______ 11______
+constexpr uint8_t kTooLong = 1 << 1;       // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;     // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;      // 11110100 1001____
+                                           // 11110100 101_____
+                                           // 11110101+ 10______
+constexpr uint8_t kSurrogate = 1 << 4;     // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;     // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101+ 1000____
+constexpr uint8_t kOverlong4 = 1 << 6;     // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;      // 10______ 10______
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+#define UTF8_BYTE_1_HIGH                                                      \
+  kTooLong, kTooLong, kTooLong, kTooLong,                                     \
+  kTooLong, kTooLong, kTooLong, kTooLong,                                     \
+  kTwoConts, kTwoConts, kTwoConts, kTwoConts,                                 \
+  kTooShort | kOverlong2,                                                     \
+  kTooShort,                                                                  \
+  kTooShort | kOverlong3 | kSurrogate,                                        \
+  kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+
+#define UTF8_BYTE_1_LOW                                                       \
+  kCarry | kOverlong3 | kOverlong2 | kOverlong4,                              \
+  kCarry | kOverlong2,                                                        \
+  kCarry,                                                                     \
+  kCarry,                                                                     \
+  kCarry | kTooLarge,                                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000 | kSurrogate,                            \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000
+
+#define UTF8_BYTE_2_HIGH                                                      \
+  kTooShort, kTooShort, kTooShort, kTooShort,                                 \
+  kTooShort, kTooShort, kTooShort, kTooShort,                                 \
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 |          \
+      kOverlong4,                                                             \
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,                 \
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                 \
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                 \
+  kTooShort, kTooShort, kTooShort, kTooShort
+#endif
+
+#if defined(NODE_SIMD_CODECS_X64)
+
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+// Splits 12 input bytes into 16 sextets, one per byte, following
+// http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html.
+TARGET_SSSE3 inline __m128i Base64Unpack(__m128i in) {
+  in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                         4, 5, 3, 4, 1, 2, 0, 1));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+// Maps sextets to the standard base64 alphabet.
+TARGET_SSSE3 inline __m128i Base64Translate(__m128i indices) {
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12.
+  __m128i offset = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  offset = _mm_or_si128(offset, _mm_and_si128(less, _mm_set1_epi8(13)));
+  const __m128i shift = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(shift, offset));
+}
+
+TARGET_SSSE3 size_t Base64EncodeSSSE3(const char* src, size_t slen,
+                                      char* dst) {
+  size_t i = 0;
+  size_t k = 0;
+  // The loads are 16 bytes wide, but only 12 bytes are consumed.
+  for (; i + 16 <= slen; i += 12, k += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i out = Base64Translate(Base64Unpack(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+  }
+  return i;
+}
+
+// Maps characters from both the base64 and the base64url alphabets to their
+// sextet values. Sets *valid to a mask that has 0xff for every character
+// that is part of either alphabet. Only uses SSE2.
+inline __m128i Base64Values(__m128i c, __m128i* valid) {
+  const __m128i upper =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), c));
+  const __m128i lower =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+  const __m128i digit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+  const __m128i plus = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('+')),
+                                    _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+  const __m128i slash = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('/')),
+                                     _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+  *valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower),
+                                     _mm_or_si128(digit, plus)),
+                        slash);
+  const __m128i shift = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+  const __m128i letters_and_digits =
+      _mm_or_si128(upper, _mm_or_si128(lower, digit));
+  return _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(letters_and_digits, _mm_add_epi8(c, shift)),
+                   _mm_and_si128(plus, _mm_set1_epi8(62))),
+      _mm_and_si128(slash, _mm_set1_epi8(63)));
+}
+
+TARGET_AVX2 inline __m256i Base64Values(__m256i c, __m256i* valid) {
+  const __m256i upper =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+  const __m256i lower =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+  const __m256i digit =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+  const __m256i plus =
+      _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('+')),
+                      _mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')));
+  const __m256i slash =
+      _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('/')),
+                      _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')));
+  *valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower),
+                                           _mm256_or_si256(digit, plus)),
+                           slash);
+  const __m256i shift = _mm256_or_si256(
+      _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                      _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+      _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+  const __m256i letters_and_digits =
+      _mm256_or_si256(upper, _mm256_or_si256(lower, digit));
+  return _mm256_or_si256(
+      _mm256_or_si256(
+          _mm256_and_si256(letters_and_digits, _mm256_add_epi8(c, shift)),
+          _mm256_and_si256(plus, _mm256_set1_epi8(62))),
+      _mm256_and_si256(slash, _mm256_set1_epi8(63)));
+}
+
+// Packs 16 sextets into 12 bytes in the low 12 bytes of the result.
+TARGET_SSSE3 inline __m128i Base64Pack(__m128i values) {
+  const __m128i merged =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                14, 13, 12, -1, -1, -1, -1));
+}
+
+TARGET_SSSE3 size_t Base64DecodeSSSE3(const char* src, size_t slen,
+                                      char* dst, size_t dlen) {
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 16 <= slen && k + 12 <= dlen; i += 16, k += 12) {
+    const __m128i c =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i valid;
+    const __m128i values = Base64Values(c, &valid);
+    if (_mm_movemask_epi8(valid) != 0xffff)
+      break;
+    alignas(16) char out[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), Base64Pack(values));
+    memcpy(dst + k, out, 12);
+  }
+  return i;
+}
+
+TARGET_AVX2 size_t Base64EncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i shuffle = _mm256_set_epi8(
+      10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+      10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m256i shift = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  size_t k = 0;
+  // Each 128-bit lane encodes 12 bytes, loaded 16 bytes at a time.
+  for (; i + 28 <= slen; i += 24, k += 32) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, shuffle);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i offset = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    offset = _mm256_or_si256(offset,
+                             _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    const __m256i out =
+        _mm256_add_epi8(indices, _mm256_shuffle_epi8(shift, offset));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), out);
+  }
+  return i + Base64EncodeSSSE3(src + i, slen - i, dst + k);
+}
+
+TARGET_AVX2 size_t Base64DecodeAVX2(const char* src, size_t slen,
+                                    char* dst, size_t dlen) {
+  const __m256i pack = _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 32 <= slen && k + 24 <= dlen; i += 32, k += 24) {
+    const __m256i c =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i valid;
+    const __m256i values = Base64Values(c, &valid);
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+    __m256i packed =
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    packed = _mm256_madd_epi16(packed, _mm256_set1_epi32(0x00011000));
+    packed = _mm256_shuffle_epi8(packed, pack);
+    alignas(32) char out[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out), packed);
+    memcpy(dst + k, out, 12);
+    memcpy(dst + k + 12, out + 16, 12);
+  }
+  if (i + 32 <= slen && k + 24 <= dlen)
+    return i;  // Stopped at an invalid character.
+  return i + Base64DecodeSSSE3(src + i, slen - i, dst + k, dlen - k);
+}
+
+TARGET_SSSE3 size_t HexEncodeSSSE3(const char* src, size_t slen, char* dst) {
+  const __m128i table = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= slen; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+    const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(in, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+TARGET_AVX2 size_t HexEncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i table = _mm256_setr_epi8(
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= slen; i += 32) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i hi = _mm256_shuffle_epi8(
+        table, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+    const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(in, mask));
+    // unpack{lo,hi} work within 128-bit lanes, so put the lanes back in
+    // order before storing.
+    const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+    const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2),
+                        _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2 + 32),
+                        _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  return i + HexEncodeSSSE3(src + i, slen - i, dst + i * 2);
+}
+
+// Maps hex digits to their values. Sets *valid to a mask that has 0xff for
+// every character that is a hex digit.
+inline __m128i HexValues(__m128i c, __m128i* valid) {
+  const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  const __m128i is_digit =
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  const __m128i alpha =
+      _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  const __m128i is_alpha =
+      _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+  *valid = _mm_or_si128(is_digit, is_alpha);
+  return _mm_or_si128(
+      _mm_and_si128(is_digit, digit),
+      _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+// Combines the nibble pairs of 16 values into 8 bytes, one per 16-bit lane.
+inline __m128i HexCombine(__m128i values) {
+  const __m128i hi =
+      _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00ff)), 4);
+  return _mm_or_si128(hi, _mm_srli_epi16(values, 8));
+}
+
+// SSE2 is part of the x64 baseline, so this needs no target attribute.
+size_t HexDecodeSSE2(const char* src, size_t slen, char* dst, size_t dlen) {
+  size_t k = 0;
+  for (; k + 16 <= dlen && k * 2 + 32 <= slen; k += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + k * 2));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + k * 2 + 16));
+    __m128i valid_a;
+    __m128i valid_b;
+    const __m128i va = HexValues(a, &valid_a);
+    const __m128i vb = HexValues(b, &valid_b);
+    if (_mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) != 0xffff)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k),
+                     _mm_packus_epi16(HexCombine(va), HexCombine(vb)));
+  }
+  return k;
+}
+
+TARGET_AVX2 size_t HexDecodeAVX2(const char* src, size_t slen, char* dst,
+                                 size_t dlen) {
+  size_t k = 0;
+  for (; k + 32 <= dlen && k * 2 + 64 <= slen; k += 32) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + k * 2));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + k * 2 + 32));
+    __m256i values[2];
+    __m256i valid = _mm256_set1_epi8(-1);
+    const __m256i in[2] = { a, b };
+    for (int n = 0; n < 2; n++) {
+      const __m256i c = in[n];
+      const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+      const __m256i is_digit = _mm256_cmpeq_epi8(
+          _mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+      const __m256i alpha = _mm256_sub_epi8(
+          _mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+      const __m256i is_alpha = _mm256_cmpeq_epi8(
+          _mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+      valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_alpha));
+      const __m256i v = _mm256_or_si256(
+          _mm256_and_si256(is_digit, digit),
+          _mm256_and_si256(is_alpha,
+                           _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+      values[n] = _mm256_or_si256(
+          _mm256_slli_epi16(
+              _mm256_and_si256(v, _mm256_set1_epi16(0x00ff)), 4),
+          _mm256_srli_epi16(v, 8));
+    }
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+    // packus works within 128-bit lanes; restore the byte order afterwards.
+    const __m256i packed = _mm256_packus_epi16(values[0], values[1]);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k),
+                        _mm256_permute4x64_epi64(packed, 0xd8));
+  }
+  return k + HexDecodeSSE2(src + k * 2, slen - k * 2, dst + k, dlen - k);
+}
+
+
+struct Utf8CheckerSSSE3 {
+  __m128i error = _mm_setzero_si128();
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  TARGET_SSSE3 inline void Check(__m128i input) {
+    if (_mm_movemask_epi8(input) == 0) {
+      // ASCII only; the previous block must not have ended mid-character.
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = _mm_setzero_si128();
+      prev_input = input;
+      return;
+    }
+
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    const __m128i byte_1_high = _mm_shuffle_epi8(
+        _mm_setr_epi8(UTF8_BYTE_1_HIGH),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), mask));
+    const __m128i byte_1_low = _mm_shuffle_epi8(
+        _mm_setr_epi8(UTF8_BYTE_1_LOW), _mm_and_si128(prev1, mask));
+    const __m128i byte_2_high = _mm_shuffle_epi8(
+        _mm_setr_epi8(UTF8_BYTE_2_HIGH),
+        _mm_and_si128(_mm_srli_epi16(input, 4), mask));
+    const __m128i special_cases =
+        _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // Bytes that follow a 3- or 4-byte lead must be continuations; those
+    // are the only places where two continuations in a row are fine.
+    const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    const __m128i is_third_byte =
+        _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    const __m128i is_fourth_byte =
+        _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    const __m128i must_be_continuation = _mm_and_si128(
+        _mm_or_si128(is_third_byte, is_fourth_byte),
+        _mm_set1_epi8(static_cast<char>(0x80)));
+    error = _mm_or_si128(error,
+                         _mm_xor_si128(must_be_continuation, special_cases));
+
+    // A lead byte in the last three positions needs the next block.
+    prev_incomplete = _mm_subs_epu8(input, _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1),
+        static_cast<char>(0xc0 - 1)));
+    prev_input = input;
+  }
+};
+
+TARGET_SSSE3 bool ValidateUtf8SSSE3(const char* src, size_t len) {
+  Utf8CheckerSSSE3 checker;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    checker.Check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+  }
+  if (i < len) {
+    alignas(16) char tail[16] = {};
+    memcpy(tail, src + i, len - i);
+    checker.Check(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+  }
+  const __m128i error =
+      _mm_or_si128(checker.error, checker.prev_incomplete);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) ==
+         0xffff;
+}
+
+#undef TARGET_SSSE3
+#undef TARGET_AVX2
+
+Kernels DetectKernels() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return { Base64EncodeAVX2, Base64DecodeAVX2,
+             HexEncodeAVX2, HexDecodeAVX2, ValidateUtf8SSSE3 };
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return { Base64EncodeSSSE3, Base64DecodeSSSE3,
+             HexEncodeSSSE3, HexDecodeSSE2, ValidateUtf8SSSE3 };
+  }
+  return { Base64EncodeNone, Base64DecodeNone, HexEncodeNone, HexDecodeSSE2,
+           ValidateUtf8Scalar };
+}
+
+#elif defined(NODE_SIMD_CODECS_NEON)
+
+const uint8_t kBase64Table[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t Base64EncodeNEON(const char* src, size_t slen, char* dst) {
+  uint8x16x4_t table;
+  for (int n = 0; n < 4; n++)
+    table.val[n] = vld1q_u8(kBase64Table + n * 16);
+  const uint8x16_t mask = vdupq_n_u8(0x3f);
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 48 <= slen; i += 48, k += 64) {
+    const uint8x16x3_t in =
+        vld3q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    uint8x16x4_t out;
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[1], 4),
+                                   vshlq_n_u8(in.val[0], 4)), mask);
+    out.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(in.val[2], 6),
+                                   vshlq_n_u8(in.val[1], 2)), mask);
+    out.val[3] = vandq_u8(in.val[2], mask);
+    for (int n = 0; n < 4; n++)
+      out.val[n] = vqtbl4q_u8(table, out.val[n]);
+    vst4q_u8(reinterpret_cast<uint8_t*>(dst + k), out);
+  }
+  return i;
+}
+
+// Maps characters from both the base64 and the base64url alphabets to their
+// sextet values. Invalid characters map to 0xff.
+inline uint8x16_t Base64ValuesNEON(uint8x16_t c) {
+  const uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+  const uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+  const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+  uint8x16_t values = vdupq_n_u8(0xff);
+  values = vbslq_u8(vcltq_u8(upper, vdupq_n_u8(26)), upper, values);
+  values = vbslq_u8(vcltq_u8(lower, vdupq_n_u8(26)),
+                    vaddq_u8(lower, vdupq_n_u8(26)), values);
+  values = vbslq_u8(vcltq_u8(digit, vdupq_n_u8(10)),
+                    vaddq_u8(digit, vdupq_n_u8(52)), values);
+  values = vbslq_u8(vorrq_u8(vceqq_u8(c, vdupq_n_u8('+')),
+                             vceqq_u8(c, vdupq_n_u8('-'))),
+                    vdupq_n_u8(62), values);
+  values = vbslq_u8(vorrq_u8(vceqq_u8(c, vdupq_n_u8('/')),
+                             vceqq_u8(c, vdupq_n_u8('_'))),
+                    vdupq_n_u8(63), values);
+  return values;
+}
+
+size_t Base64DecodeNEON(const char* src, size_t slen, char* dst,
+                        size_t dlen) {
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 64 <= slen && k + 48 <= dlen; i += 64, k += 48) {
+    const uint8x16x4_t in =
+        vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    const uint8x16_t a = Base64ValuesNEON(in.val[0]);
+    const uint8x16_t b = Base64ValuesNEON(in.val[1]);
+    const uint8x16_t c = Base64ValuesNEON(in.val[2]);
+    const uint8x16_t d = Base64ValuesNEON(in.val[3]);
+    const uint8x16_t any =
+        vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d));
+    if (vmaxvq_u8(any) > 63)
+      break;
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+    vst3q_u8(reinterpret_cast<uint8_t*>(dst + k), out);
+  }
+  return i;
+}
+
+size_t HexEncodeNEON(const char* src, size_t slen, char* dst) {
+  const uint8x16_t table =
+      vld1q_u8(reinterpret_cast<const uint8_t*>("0123456789abcdef"));
+  size_t i = 0;
+  for (; i + 16 <= slen; i += 16) {
+    const uint8x16_t in = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    uint8x16x2_t out;
+    out.val[0] = vqtbl1q_u8(table, vshrq_n_u8(in, 4));
+    out.val[1] = vqtbl1q_u8(table, vandq_u8(in, vdupq_n_u8(0x0f)));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst + i * 2), out);
+  }
+  return i;
+}
+
+// Maps hex digits to their values. Invalid characters map to 0xff.
+inline uint8x16_t HexValuesNEON(uint8x16_t c) {
+  const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+  const uint8x16_t alpha =
+      vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  uint8x16_t values = vdupq_n_u8(0xff);
+  values = vbslq_u8(vcltq_u8(digit, vdupq_n_u8(10)), digit, values);
+  values = vbslq_u8(vcltq_u8(alpha, vdupq_n_u8(6)),
+                    vaddq_u8(alpha, vdupq_n_u8(10)), values);
+  return values;
+}
+
+size_t HexDecodeNEON(const char* src, size_t slen, char* dst, size_t dlen) {
+  size_t k = 0;
+  for (; k + 16 <= dlen && k * 2 + 32 <= slen; k += 16) {
+    const uint8x16x2_t in =
+        vld2q_u8(reinterpret_cast<const uint8_t*>(src + k * 2));
+    const uint8x16_t hi = HexValuesNEON(in.val[0]);
+    const uint8x16_t lo = HexValuesNEON(in.val[1]);
+    if (vmaxvq_u8(vorrq_u8(hi, lo)) > 15)
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + k),
+             vorrq_u8(vshlq_n_u8(hi, 4), lo));
+  }
+  return k;
+}
+
+struct Utf8CheckerNEON {
+  uint8x16_t error = vdupq_n_u8(0);
+  uint8x16_t prev_input = vdupq_n_u8(0);
+  uint8x16_t prev_incomplete = vdupq_n_u8(0);
+
+  inline void Check(uint8x16_t input) {
+    if (vmaxvq_u8(input) < 0x80) {
+      error = vorrq_u8(error, prev_incomplete);
+      prev_incomplete = vdupq_n_u8(0);
+      prev_input = input;
+      return;
+    }
+
+    static const uint8_t byte_1_high_table[16] = { UTF8_BYTE_1_HIGH };
+    static const uint8_t byte_1_low_table[16] = { UTF8_BYTE_1_LOW };
+    static const uint8_t byte_2_high_table[16] = { UTF8_BYTE_2_HIGH };
+    static const uint8_t incomplete_table[16] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+    };
+
+    const uint8x16_t prev1 = vextq_u8(prev_input, input, 15);
+    const uint8x16_t byte_1_high =
+        vqtbl1q_u8(vld1q_u8(byte_1_high_table), vshrq_n_u8(prev1, 4));
+    const uint8x16_t byte_1_low = vqtbl1q_u8(vld1q_u8(byte_1_low_table),
+                                             vandq_u8(prev1, vdupq_n_u8(0x0f)));
+    const uint8x16_t byte_2_high =
+        vqtbl1q_u8(vld1q_u8(byte_2_high_table), vshrq_n_u8(input, 4));
+    const uint8x16_t special_cases =
+        vandq_u8(vandq_u8(byte_1_high, byte_1_low), byte_2_high);
+
+    const uint8x16_t prev2 = vextq_u8(prev_input, input, 14);
+    const uint8x16_t prev3 = vextq_u8(prev_input, input, 13);
+    const uint8x16_t is_third_byte = vqsubq_u8(prev2, vdupq_n_u8(0xe0 - 0x80));
+    const uint8x16_t is_fourth_byte =
+        vqsubq_u8(prev3, vdupq_n_u8(0xf0 - 0x80));
+    const uint8x16_t must_be_continuation =
+        vandq_u8(vorrq_u8(is_third_byte, is_fourth_byte), vdupq_n_u8(0x80));
+    error = vorrq_u8(error, veorq_u8(must_be_continuation, special_cases));
+
+    prev_incomplete = vqsubq_u8(input, vld1q_u8(incomplete_table));
+    prev_input = input;
+  }
+};
+
+bool ValidateUtf8NEON(const char* src, size_t len) {
+  Utf8CheckerNEON checker;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16)
+    checker.Check(vld1q_u8(reinterpret_cast<const uint8_t*>(src + i)));
+  if (i < len) {
+    uint8_t tail[16] = {};
+    memcpy(tail, src + i, len - i);
+    checker.Check(vld1q_u8(tail));
+  }
+  return vmaxvq_u8(vorrq_u8(checker.error, checker.prev_incomplete)) == 0;
+}
+
+Kernels DetectKernels() {
+  return { Base64EncodeNEON, Base64DecodeNEON, HexEncodeNEON, HexDecodeNEON,
+           ValidateUtf8NEON };
+}
+
+#else
+
+Kernels DetectKernels() {
+  return { Base64EncodeNone, Base64DecodeNone, HexEncodeNone, HexDecodeNone,
+           ValidateUtf8Scalar };
+}
+
+#endif
+
+const Kernels& GetKernels() {
+  static const Kernels kernels = DetectKernels();
+  return kernels;
+}
+
+#if defined(NODE_SIMD_CODECS_NEON)
+// Equivalent of _mm_movemask_epi8() for lanes that are either 0 or 0xff.
+inline unsigned MoveMask(uint8x16_t lanes) {
+  static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                    1, 2, 4, 8, 16, 32, 64, 128 };
+  const uint8x16_t masked = vandq_u8(lanes, vld1q_u8(bits));
+  return vaddv_u8(vget_low_u8(masked)) |
+         (static_cast<unsigned>(vaddv_u8(vget_high_u8(masked))) << 8);
+}
+#endif
+
+// Returns the index of the lowest set bit of a non-zero mask.
+inline unsigned LowestBit(unsigned mask) {
+#if defined(__GNUC__)
+  return __builtin_ctz(mask);
+#else
+  unsigned bit = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+inline unsigned PopCount(unsigned mask) {
+#if defined(__GNUC__)
+  return __builtin_popcount(mask);
+#else
+  unsigned count = 0;
+  for (; mask != 0; mask &= mask - 1)
+    count++;
+  return count;
+#endif
+}
+
+// Returns a bit mask with bit n set if byte n of the 16-byte block at `src`
+// is >= 0x80.
+inline unsigned NonAsciiMask(const char* src) {
+#if defined(NODE_SIMD_CODECS_X64)
+  return _mm_movemask_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+#elif defined(NODE_SIMD_CODECS_NEON)
+  return MoveMask(vcltq_s8(vld1q_s8(reinterpret_cast<const int8_t*>(src)),
+                           vdupq_n_s8(0)));
+#else
+  unsigned mask = 0;
+  for (unsigned i = 0; i < 16; i++)
+    mask |= static_cast<unsigned>(static_cast<uint8_t>(src[i]) >> 7) << i;
+  return mask;
+#endif
+}
+
+#if defined(NODE_SIMD_CODECS_X64) || defined(NODE_SIMD_CODECS_NEON)
+// Returns a bit mask with bit n set if first[n] == a and last[n] == b.
+inline unsigned PairMask(const char* first, const char* last,
+                         uint8_t a, uint8_t b) {
+#if defined(NODE_SIMD_CODECS_X64)
+  const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+  const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last));
+  return _mm_movemask_epi8(
+      _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(a)),
+                    _mm_cmpeq_epi8(y, _mm_set1_epi8(b))));
+#else
+  const uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(first));
+  const uint8x16_t y = vld1q_u8(reinterpret_cast<const uint8_t*>(last));
+  return MoveMask(vandq_u8(vceqq_u8(x, vdupq_n_u8(a)),
+                           vceqq_u8(y, vdupq_n_u8(b))));
+#endif
+}
+#endif
+
+}  // anonymous namespace
+
+
+size_t Base64Encode(const char* src, size_t slen, char* dst) {
+  return GetKernels().base64_encode(src, slen, dst);
+}
+
+size_t Base64Decode(const char* src, size_t slen, char* dst, size_t dlen) {
+  return GetKernels().base64_decode(src, slen, dst, dlen);
+}
+
+size_t HexEncode(const char* src, size_t slen, char* dst) {
+  return GetKernels().hex_encode(src, slen, dst);
+}
+
+size_t HexDecode(const char* src, size_t slen, char* dst, size_t dlen) {
+  return GetKernels().hex_decode(src, slen, dst, dlen);
+}
+
+size_t AsciiPrefixLength(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const unsigned mask = NonAsciiMask(src + i);
+    if (mask != 0)
+      return i + LowestBit(mask);
+  }
+  for (; i < len; i++) {
+    if (static_cast<uint8_t>(src[i]) >= 0x80)
+      return i;
+  }
+  return len;
+}
+
+bool ValidateUtf8(const char* src, size_t len) {
+  return GetKernels().validate_utf8(src, len);
+}
+
+size_t Latin1Utf8Length(const char* src, size_t len) {
+  size_t non_ascii = 0;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16)
+    non_ascii += PopCount(NonAsciiMask(src + i));
+  for (; i < len; i++)
+    non_ascii += static_cast<uint8_t>(src[i]) >> 7;
+  return len + non_ascii;
+}
+
+size_t Latin1ToUtf8(const char* src, size_t slen, char* dst, size_t dlen,
+                    size_t* read) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i < slen) {
+    if (i + 16 <= slen && k + 16 <= dlen && NonAsciiMask(src + i) == 0) {
+      memcpy(dst + k, src + i, 16);
+      i += 16;
+      k += 16;
+      continue;
+    }
+    const uint8_t c = static_cast<uint8_t>(src[i]);
+    if (c < 0x80) {
+      if (k + 1 > dlen) break;
+      dst[k++] = c;
+    } else {
+      if (k + 2 > dlen) break;
+      dst[k++] = 0xc0 | (c >> 6);
+      dst[k++] = 0x80 | (c & 0x3f);
+    }
+    i++;
+  }
+  *read = i;
+  return k;
+}
+
+bool Utf8ToLatin1(const char* src, size_t slen, char* dst, size_t* written) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i < slen) {
+    if (i + 16 <= slen && NonAsciiMask(src + i) == 0) {
+      memcpy(dst + k, src + i, 16);
+      i += 16;
+      k += 16;
+      continue;
+    }
+    const uint8_t c = static_cast<uint8_t>(src[i]);
+    if (c < 0x80) {
+      dst[k++] = c;
+      i++;
+    } else if ((c == 0xc2 || c == 0xc3) && i + 1 < slen &&
+               (static_cast<uint8_t>(src[i + 1]) & 0xc0) == 0x80) {
+      dst[k++] = ((c & 0x03) << 6) | (src[i + 1] & 0x3f);
+      i += 2;
+    } else {
+      return false;
+    }
+  }
+  *written = k;
+  return true;
+}
+
+size_t FindSubstring(const char* haystack, size_t haystack_length,
+                     const char* needle, size_t needle_length,
+                     size_t* index, size_t max_mismatches) {
+  const size_t last = needle_length - 1;
+  const uint8_t first_char = needle[0];
+  const uint8_t last_char = needle[last];
+  // Positions at or beyond `end` cannot start a match.
+  const size_t end = haystack_length - last;
+  size_t mismatches = 0;
+  size_t i = *index;
+
+#if defined(NODE_SIMD_CODECS_X64) || defined(NODE_SIMD_CODECS_NEON)
+  for (; i + 16 <= end; i += 16) {
+    unsigned mask = PairMask(haystack + i, haystack + i + last,
+                             first_char, last_char);
+    while (mask != 0) {
+      const size_t pos = i + LowestBit(mask);
+      if (memcmp(haystack + pos + 1, needle + 1, needle_length - 2) == 0) {
+        *index = pos;
+        return pos;
+      }
+      if (++mismatches > max_mismatches) {
+        *index = pos + 1;
+        return haystack_length;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; i < end; i++) {
+    if (static_cast<uint8_t>(haystack[i]) != first_char ||
+        static_cast<uint8_t>(haystack[i + last]) != last_char) {
+      continue;
+    }
+    if (memcmp(haystack + i + 1, needle + 1, needle_length - 2) == 0) {
+      *index = i;
+      return i;
+    }
+    if (++mismatches > max_mismatches) {
+      *index = i + 1;
+      return haystack_length;
+    }
+  }
+  *index = end;
+  return haystack_length;
+}
+
+}  // namespace simd
+}  // namespace node
@@ -0,0 +1,81 @@
+#ifndef SRC_SIMD_CODECS_H_
+#define SRC_SIMD_CODECS_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+
+namespace node {
+namespace simd {
+
+// Vectorized kernels for the base64, hex and UTF-8 codecs in base64.h,
+// string_bytes.cc and node_buffer.cc, and for the byte search in
+// string_search.h. The best implementation for the running CPU is picked on
+// first use (SSSE3/AVX2 on x64, NEON on arm64).
+//
+// Each kernel only handles the prefix of its input that can be processed in
+// whole vector blocks and returns how far it got. The callers finish the
+// remainder with their scalar loops, which therefore remain the reference
+// for edge cases such as padding, whitespace and invalid characters.
+
+// Encodes whole 3-byte groups of `src`. Returns the number of bytes of `src`
+// consumed, a multiple of 3; `dst` receives 4/3 as many characters.
+size_t Base64Encode(const char* src, size_t slen, char* dst);
+
+// Decodes whole 4-character groups of `src` until the first character that
+// is not part of the base64 or base64url alphabet, or until `dlen` would be
+// exceeded. Returns the number of characters of `src` consumed, a multiple
+// of 4; `dst` receives 3/4 as many bytes.
+size_t Base64Decode(const char* src, size_t slen, char* dst, size_t dlen);
+
+// Encodes bytes of `src` as lowercase hex. Returns the number of bytes of
+// `src` consumed; `dst` receives twice as many characters.
+size_t HexEncode(const char* src, size_t slen, char* dst);
+
+// Decodes pairs of hex digits until the first invalid character, or until
+// `dlen` bytes have been written. Returns the number of bytes written; twice
+// as many characters of `src` have been consumed.
+size_t HexDecode(const char* src, size_t slen, char* dst, size_t dlen);
+
+// The functions below process their whole input.
+
+// Returns the index of the first byte >= 0x80, or `len` if there is none.
+size_t AsciiPrefixLength(const char* src, size_t len);
+
+// Returns whether `src` is well-formed UTF-8, i.e. has no truncated or
+// overlong sequences, no surrogates and no code points above U+10FFFF.
+bool ValidateUtf8(const char* src, size_t len);
+
+// Returns the length of the UTF-8 representation of Latin-1 input.
+size_t Latin1Utf8Length(const char* src, size_t len);
+
+// Transcodes Latin-1 to UTF-8 without splitting characters across the end
+// of `dst`. Returns the number of bytes written and sets *read to the number
+// of characters consumed.
+size_t Latin1ToUtf8(const char* src, size_t slen, char* dst, size_t dlen,
+                    size_t* read);
+
+// Transcodes UTF-8 to Latin-1. `dst` must have room for `slen` bytes.
+// Returns false if `src` is not valid UTF-8 or contains code points above
+// U+00FF; otherwise sets *written to the number of bytes written.
+bool Utf8ToLatin1(const char* src, size_t slen, char* dst, size_t* written);
+
+// Searches `haystack` for `needle`, which must be at least two bytes long
+// and no longer than `haystack`, starting at position *index. Candidate
+// positions are found by comparing the first and last byte of `needle`
+// against a whole vector of positions at once, and then verified.
+//
+// Returns the position of the first match. Otherwise returns
+// `haystack_length` and sets *index to the first position that has not been
+// examined, which is less than `haystack_length - needle_length + 1` only if
+// more than `max_mismatches` candidates failed verification.
+size_t FindSubstring(const char* haystack, size_t haystack_length,
+                     const char* needle, size_t needle_length,
+                     size_t* index, size_t max_mismatches);
+
+}  // namespace simd
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_SIMD_CODECS_H_
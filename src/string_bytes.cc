@@ -25,6 +25,7 @@
 #include "env-inl.h"
 #include "node_buffer.h"
 #include "node_errors.h"
+#include "simd_codecs.h"
 #include "util.h"
 
 #include <climits>
@@ -244,13 +245,31 @@ static inline unsigned unhex(uint8_t x) {
   return unhex_table[x];
 }
 
+// Decodes the leading run of valid hex digits with the vectorized kernel.
+// Two-byte strings always take the scalar path.
+template <typename TypeName>
+static inline size_t hex_decode_blocks(char* buf,
+                                       size_t len,
+                                       const TypeName* src,
+                                       const size_t srcLen) {
+  return 0;
+}
+
+template <>
+inline size_t hex_decode_blocks(char* buf,
+                                size_t len,
+                                const char* src,
+                                const size_t srcLen) {
+  return simd::HexDecode(src, srcLen, buf, len);
+}
+
 template <typename TypeName>
 static size_t hex_decode(char* buf,
                          size_t len,
                          const TypeName* src,
                          const size_t srcLen) {
-  size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  size_t i = hex_decode_blocks(buf, len, src, srcLen);
+  for (; i < len && i * 2 + 1 < srcLen; ++i) {
     unsigned a = unhex(src[i * 2 + 0]);
     unsigned b = unhex(src[i * 2 + 1]);
     if (!~a || !~b)
@@ -306,6 +325,45 @@ size_t StringBytes::WriteUCS2(Isolate* isolate,
 }
 
 
+// Latin-1 strings are transcoded without going through V8's generic UTF-8
+// writer; the ASCII prefix is copied in vector blocks.
+static size_t WriteOneByteAsUtf8(Isolate* isolate,
+                                 char* buf,
+                                 size_t buflen,
+                                 Local<String> str,
+                                 int flags,
+                                 int* chars_written) {
+  size_t nchars;
+  size_t nbytes;
+
+  if (str->IsExternalOneByte()) {
+    auto ext = str->GetExternalOneByteStringResource();
+    nbytes = simd::Latin1ToUtf8(ext->data(), ext->length(), buf, buflen,
+                                &nchars);
+    *chars_written = nchars;
+    return nbytes;
+  }
+
+  // Every character takes at least one byte, so no more than `buflen` of
+  // them can be written.
+  const size_t len = std::min(buflen, static_cast<size_t>(str->Length()));
+  nchars = str->WriteOneByte(isolate, reinterpret_cast<uint8_t*>(buf), 0,
+                             len, flags);
+  const size_t ascii = simd::AsciiPrefixLength(buf, nchars);
+  if (ascii == nchars) {
+    *chars_written = nchars;
+    return nchars;
+  }
+
+  MaybeStackBuffer<char> rest(nchars - ascii);
+  memcpy(*rest, buf + ascii, nchars - ascii);
+  nbytes = simd::Latin1ToUtf8(*rest, nchars - ascii, buf + ascii,
+                              buflen - ascii, &nchars);
+  *chars_written = ascii + nchars;
+  return ascii + nbytes;
+}
+
+
 size_t StringBytes::Write(Isolate* isolate,
                           char* buf,
                           size_t buflen,
@@ -342,6 +400,11 @@ size_t StringBytes::Write(Isolate* isolate,
 
     case BUFFER:
     case UTF8:
+      if (str->IsOneByte()) {
+        nbytes = WriteOneByteAsUtf8(isolate, buf, buflen, str, flags,
+                                    chars_written);
+        break;
+      }
       nbytes = str->WriteUtf8(isolate, buf, buflen, chars_written, flags);
       break;
 
@@ -365,6 +428,13 @@ size_t StringBytes::Write(Isolate* isolate,
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = base64_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        // Only the `char` decoder uses the SIMD kernels, so one-byte strings
+        // are copied as such rather than widened by String::Value.
+        MaybeStackBuffer<char> value(str->Length());
+        const size_t len = str->WriteOneByte(
+            isolate, reinterpret_cast<uint8_t*>(*value), 0, -1, flags);
+        nbytes = base64_decode(buf, buflen, *value, len);
       } else {
         String::Value value(isolate, str);
         nbytes = base64_decode(buf, buflen, *value, value.length());
@@ -376,6 +446,15 @@ size_t StringBytes::Write(Isolate* isolate,
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = hex_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        // Like for base64, but only the characters that can be decoded into
+        // `buf` are needed.
+        const size_t max_len =
+            std::min(static_cast<size_t>(str->Length()), buflen * 2);
+        MaybeStackBuffer<char> value(max_len);
+        const size_t len = str->WriteOneByte(
+            isolate, reinterpret_cast<uint8_t*>(*value), 0, max_len, flags);
+        nbytes = hex_decode(buf, buflen, *value, len);
       } else {
         String::Value value(isolate, str);
         nbytes = hex_decode(buf, buflen, *value, value.length());
@@ -606,7 +685,8 @@ size_t StringBytes::hex_encode(
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+  const size_t done = simd::HexEncode(src, slen, dst);
+  for (size_t i = done, k = done * 2; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -667,7 +747,27 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
         return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
       }
 
-    case UTF8:
+    case UTF8: {
+      // Pure ASCII and Latin-1 input can be turned into a one-byte string
+      // directly. Only attempt the latter when the first non-ASCII byte
+      // starts a two-byte sequence for U+0080..U+00FF.
+      const size_t ascii = simd::AsciiPrefixLength(buf, buflen);
+      if (ascii == buflen)
+        return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
+      const uint8_t lead = static_cast<uint8_t>(buf[ascii]);
+      if (lead == 0xc2 || lead == 0xc3) {
+        char* out = node::UncheckedMalloc(buflen);
+        size_t written;
+        if (out != nullptr &&
+            simd::Utf8ToLatin1(buf + ascii, buflen - ascii, out + ascii,
+                               &written)) {
+          memcpy(out, buf, ascii);
+          return ExternOneByteString::New(isolate, out, ascii + written,
+                                          error);
+        }
+        free(out);
+      }
+
       val = String::NewFromUtf8(isolate,
                                 buf,
                                 v8::NewStringType::kNormal,
@@ -677,6 +777,7 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
         return MaybeLocal<Value>();
       }
       return val.ToLocalChecked();
+    }
 
     case LATIN1:
       return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
@@ -726,6 +827,15 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
       }
       if (reinterpret_cast<uintptr_t>(buf) % 2 != 0) {
         // Unaligned data still means we can't directly pass it to V8.
+        // Short strings are copied by V8 anyway, so align them in the
+        // stack storage of a MaybeStackBuffer when they fit there, rather
+        // than in a heap copy that is freed right away.
+        MaybeStackBuffer<uint16_t> aligned;
+        if (buflen / 2 <= aligned.capacity()) {
+          memcpy(*aligned, buf, buflen / 2 * 2);
+          return ExternTwoByteString::NewFromCopy(
+              isolate, *aligned, buflen / 2, error);
+        }
         char* dst = node::UncheckedMalloc(buflen);
         if (dst == nullptr) {
           *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
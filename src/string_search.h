@@ -7,6 +7,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "simd_codecs.h"
 #include "util.h"
 
 #include <cstring>
@@ -76,6 +77,11 @@ class StringSearchBase {
   // to compensate for the algorithmic overhead compared to simple brute force.
   static const int kBMMinPatternLength = 8;
 
+  // Forward searches for one-byte patterns up to this length compare the
+  // first and last pattern character against a whole vector of subject
+  // positions at a time; see FilterSearch().
+  static const int kFilterMaxPatternLength = 128;
+
   // Store for the BoyerMoore(Horspool) bad char shift table.
   int bad_char_shift_table_[kUC16AlphabetSize];
   // Store for the BoyerMoore good suffix shift table.
@@ -103,9 +109,17 @@ class StringSearch : private StringSearchBase {
         strategy_ = &StringSearch::SingleCharSearch;
         return;
       }
+      if (UseFilterSearch()) {
+        strategy_ = &StringSearch::FilterSearch;
+        return;
+      }
       strategy_ = &StringSearch::LinearSearch;
       return;
     }
+    if (UseFilterSearch() && pattern_length <= kFilterMaxPatternLength) {
+      strategy_ = &StringSearch::FilterSearch;
+      return;
+    }
     strategy_ = &StringSearch::InitialSearch;
   }
 
@@ -131,6 +145,7 @@ class StringSearch : private StringSearchBase {
   typedef size_t (StringSearch::*SearchFunction)(Vector, size_t);
   size_t SingleCharSearch(Vector subject, size_t start_index);
   size_t LinearSearch(Vector subject, size_t start_index);
+  size_t FilterSearch(Vector subject, size_t start_index);
   size_t InitialSearch(Vector subject, size_t start_index);
   size_t BoyerMooreHorspoolSearch(Vector subject, size_t start_index);
   size_t BoyerMooreSearch(Vector subject, size_t start_index);
@@ -139,6 +154,10 @@ class StringSearch : private StringSearchBase {
 
   void PopulateBoyerMooreTable();
 
+  bool UseFilterSearch() const {
+    return sizeof(Char) == 1 && pattern_.forward();
+  }
+
   static inline int CharOccurrence(int* bad_char_occurrence,
                                    Char char_code) {
     if (sizeof(Char) == 1) {
@@ -309,6 +328,39 @@ size_t StringSearch<Char>::LinearSearch(
   return subject.length();
 }
 
+//---------------------------------------------------------------------
+// Vectorized first/last character filter search
+//---------------------------------------------------------------------
+
+// Forward search for one-byte patterns. Long patterns upgrade to
+// BoyerMooreHorspool if too many candidates fail verification, which is
+// where the skip distance of the latter starts to pay off.
+template <typename Char>
+size_t StringSearch<Char>::FilterSearch(
+    Vector subject,
+    size_t index) {
+  CHECK_EQ(sizeof(Char), 1);
+  CHECK(subject.forward());
+  const size_t pattern_length = pattern_.length();
+  const size_t subject_length = subject.length();
+  CHECK_GT(pattern_length, 1);
+
+  size_t max_mismatches = SIZE_MAX;
+  if (pattern_length >= kBMMinPatternLength)
+    max_mismatches = 16 + (subject_length - index) / pattern_length;
+
+  const size_t pos = simd::FindSubstring(
+      reinterpret_cast<const char*>(subject.start()), subject_length,
+      reinterpret_cast<const char*>(pattern_.start()), pattern_length,
+      &index, max_mismatches);
+  if (pos != subject_length || index > subject_length - pattern_length)
+    return pos;
+
+  PopulateBoyerMooreHorspoolTable();
+  strategy_ = &StringSearch::BoyerMooreHorspoolSearch;
+  return BoyerMooreHorspoolSearch(subject, index);
+}
+
 //---------------------------------------------------------------------
 // Boyer-Moore string search
 //---------------------------------------------------------------------
@@ -571,19 +623,17 @@ size_t SearchString(Vector<const Char> subject,
 
 namespace node {
 
+// Searches with a prepared search object, which keeps its tables between
+// calls. `search` must have been created for a needle of `needle_length`
+// characters in the direction given by `is_forward`.
 template <typename Char>
-size_t SearchString(const Char* haystack,
+size_t SearchString(stringsearch::StringSearch<Char>* search,
+                    const Char* haystack,
                     size_t haystack_length,
-                    const Char* needle,
                     size_t needle_length,
                     size_t start_index,
                     bool is_forward) {
   if (haystack_length < needle_length) return haystack_length;
-  // To do a reverse search (lastIndexOf instead of indexOf) without redundant
-  // code, create two vectors that are reversed views into the input strings.
-  // For example, v_needle[0] would return the *last* character of the needle.
-  // So we're searching for the first instance of rev(needle) in rev(haystack)
-  stringsearch::Vector<const Char> v_needle(needle, needle_length, is_forward);
   stringsearch::Vector<const Char> v_haystack(
       haystack, haystack_length, is_forward);
   size_t diff = haystack_length - needle_length;
@@ -595,8 +645,7 @@ size_t SearchString(const Char* haystack,
   } else {
     relative_start_index = diff - start_index;
   }
-  size_t pos = node::stringsearch::SearchString(
-      v_haystack, v_needle, relative_start_index);
+  size_t pos = search->Search(v_haystack, relative_start_index);
   if (pos == haystack_length) {
     // not found
     return pos;
@@ -604,6 +653,24 @@ size_t SearchString(const Char* haystack,
   return is_forward ? pos : (haystack_length - needle_length - pos);
 }
 
+template <typename Char>
+size_t SearchString(const Char* haystack,
+                    size_t haystack_length,
+                    const Char* needle,
+                    size_t needle_length,
+                    size_t start_index,
+                    bool is_forward) {
+  if (haystack_length < needle_length) return haystack_length;
+  // To do a reverse search (lastIndexOf instead of indexOf) without redundant
+  // code, create two vectors that are reversed views into the input strings.
+  // For example, v_needle[0] would return the *last* character of the needle.
+  // So we're searching for the first instance of rev(needle) in rev(haystack)
+  stringsearch::Vector<const Char> v_needle(needle, needle_length, is_forward);
+  stringsearch::StringSearch<Char> search(v_needle);
+  return SearchString(&search, haystack, haystack_length, needle_length,
+                      start_index, is_forward);
+}
+
 template <size_t N>
 size_t SearchString(const char* haystack, size_t haystack_length,
                     const char (&needle)[N]) {
@@ -31,11 +31,24 @@
 #include "stream_wrap.h"
 #include "util-inl.h"
 
+#include <cerrno>
 #include <cstdlib>
 
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
 
 namespace node {
 
+using v8::Array;
 using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
@@ -91,6 +104,9 @@ void TCPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "open", Open);
   env->SetProtoMethod(t, "bind", Bind);
   env->SetProtoMethod(t, "listen", Listen);
+  env->SetProtoMethod(t, "setReusePortGroupSize", SetReusePortGroupSize);
+  env->SetProtoMethod(t, "setDeferAccept", SetDeferAccept);
+  env->SetProtoMethod(t, "setFastOpen", SetFastOpen);
   env->SetProtoMethod(t, "connect", Connect);
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
@@ -126,6 +142,7 @@ void TCPWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(constants, SOCKET);
   NODE_DEFINE_CONSTANT(constants, SERVER);
   NODE_DEFINE_CONSTANT(constants, UV_TCP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, REUSEPORT);
   target->Set(context,
               env->constants_string(),
               constants).Check();
@@ -222,6 +239,49 @@ void TCPWrap::Open(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+namespace {
+
+// Creates the socket of `handle` with SO_REUSEPORT set. libuv only creates
+// the socket when binding, which is too late to set the option.
+int OpenReusePortSocket(uv_tcp_t* handle, int family) {
+#ifdef SO_REUSEPORT
+  int type = SOCK_STREAM;
+#ifdef SOCK_CLOEXEC
+  type |= SOCK_CLOEXEC;
+#endif
+  int fd = socket(family, type, 0);
+  if (fd == -1)
+    return uv_translate_sys_error(errno);
+
+  int on = 1;
+  int err = 0;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == -1)
+    err = uv_translate_sys_error(errno);
+  if (err == 0)
+    err = uv_tcp_open(handle, fd);
+  if (err != 0)
+    close(fd);
+  return err;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+// Only used for the options below that are available on this platform.
+#if !defined(_WIN32) && (defined(TCP_DEFER_ACCEPT) || defined(TCP_FASTOPEN))
+int SetIntSocketOption(uv_tcp_t* handle, int level, int name, int value) {
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
+  if (err == 0 &&
+      setsockopt(fd, level, name, &value, sizeof(value)) == -1) {
+    err = uv_translate_sys_error(errno);
+  }
+  return err;
+}
+#endif
+
+}  // anonymous namespace
+
 template <typename T>
 void TCPWrap::Bind(
     const FunctionCallbackInfo<Value>& args,
@@ -236,14 +296,22 @@ void TCPWrap::Bind(
   int port;
   unsigned int flags = 0;
   if (!args[1]->Int32Value(env->context()).To(&port)) return;
-  if (family == AF_INET6 &&
+  if (!args[2]->IsUndefined() &&
       !args[2]->Uint32Value(env->context()).To(&flags)) {
     return;
   }
+  const bool reuse_port = flags & REUSEPORT;
+  flags &= ~REUSEPORT;
+  // UV_TCP_IPV6ONLY only applies to IPv6 sockets.
+  if (family != AF_INET6)
+    flags = 0;
 
   T addr;
   int err = uv_ip_addr(*ip_address, port, &addr);
 
+  if (err == 0 && reuse_port)
+    err = OpenReusePortSocket(&wrap->handle_, family);
+
   if (err == 0) {
     err = uv_tcp_bind(&wrap->handle_,
                       reinterpret_cast<const sockaddr*>(&addr),
@@ -270,13 +338,157 @@ void TCPWrap::Listen(const FunctionCallbackInfo<Value>& args) {
   Environment* env = wrap->env();
   int backlog;
   if (!args[0]->Int32Value(env->context()).To(&backlog)) return;
+  if (!args[1]->IsUndefined() &&
+      !args[1]->Uint32Value(env->context()).To(&wrap->accept_batch_size_)) {
+    return;
+  }
   int err = uv_listen(reinterpret_cast<uv_stream_t*>(&wrap->handle_),
                       backlog,
-                      OnConnection);
+                      wrap->accept_batch_size_ > 0 ? OnConnectionBatch
+                                                   : OnConnection);
   args.GetReturnValue().Set(err);
 }
 
 
+void TCPWrap::OnConnectionBatch(uv_stream_t* handle, int status) {
+  if (status != 0)
+    return OnConnection(handle, status);
+
+  TCPWrap* wrap_data = static_cast<TCPWrap*>(handle->data);
+  CHECK_NOT_NULL(wrap_data);
+  Environment* env = wrap_data->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  CHECK_EQ(wrap_data->persistent().IsEmpty(), false);
+
+  Local<Array> clients = Array::New(env->isolate());
+  uint32_t count = 0;
+  TCPWrap* wrap;
+
+  // The connection that libuv has already accepted.
+  Local<Object> client_obj;
+  if (!Instantiate(env, wrap_data, SOCKET).ToLocal(&client_obj))
+    return;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, client_obj);
+  if (uv_accept(handle, reinterpret_cast<uv_stream_t*>(&wrap->handle_)) == 0 &&
+      clients->Set(env->context(), count, client_obj).IsJust()) {
+    count++;
+  }
+
+#ifdef __linux__
+  // Drain the rest of the accept queue directly, so that a burst of
+  // connections crosses into JavaScript once. libuv keeps accepting after
+  // this callback returns, and takes care of errors such as EMFILE.
+  uv_os_fd_t listen_fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &listen_fd) != 0)
+    listen_fd = -1;
+  while (listen_fd != -1 && count < wrap_data->accept_batch_size_) {
+    int fd;
+    do {
+      fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    } while (fd == -1 && errno == EINTR);
+    if (fd == -1)
+      break;
+
+    if (!Instantiate(env, wrap_data, SOCKET).ToLocal(&client_obj)) {
+      close(fd);
+      return;
+    }
+    wrap = Unwrap<TCPWrap>(client_obj);
+    if (wrap == nullptr) {
+      close(fd);
+      return;
+    }
+    if (uv_tcp_open(&wrap->handle_, fd) != 0) {
+      close(fd);
+      continue;
+    }
+    if (clients->Set(env->context(), count, client_obj).IsNothing())
+      return;
+    count++;
+  }
+#endif
+
+  if (count == 0)
+    return;
+
+  Local<Value> argv[] = { Integer::New(env->isolate(), 0), clients };
+  wrap_data->MakeCallback(env->onconnection_string(), arraysize(argv), argv);
+}
+
+
+// The number of seconds for which accepted connections are only passed to
+// the application once they have data to read.
+void TCPWrap::SetDeferAccept(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsUint32());
+#if defined(TCP_DEFER_ACCEPT) && !defined(_WIN32)
+  int err = SetIntSocketOption(&wrap->handle_, IPPROTO_TCP, TCP_DEFER_ACCEPT,
+                               args[0].As<Uint32>()->Value());
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// The length of the queue of TCP Fast Open connections that have not been
+// accepted yet. 0 disables TCP Fast Open. Must be set before listening.
+void TCPWrap::SetFastOpen(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsUint32());
+#if defined(TCP_FASTOPEN) && !defined(_WIN32)
+  int err = SetIntSocketOption(&wrap->handle_, IPPROTO_TCP, TCP_FASTOPEN,
+                               args[0].As<Uint32>()->Value());
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// Makes the kernel pick the listener of a SO_REUSEPORT group by the CPU on
+// which a connection was received: listener `cpu % size`, in the order in
+// which the listeners were bound. The program is shared by the whole group,
+// so every listener may set it.
+void TCPWrap::SetReusePortGroupSize(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsUint32());
+  const uint32_t size = args[0].As<Uint32>()->Value();
+  CHECK_GT(size, 0);
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    sock_filter code[] = {
+      { BPF_LD | BPF_W | BPF_ABS, 0, 0,
+        static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU) },
+      { BPF_ALU | BPF_MOD | BPF_K, 0, 0, size },
+      { BPF_RET | BPF_A, 0, 0, 0 }
+    };
+    sock_fprog program = { arraysize(code), code };
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                   &program, sizeof(program)) == -1) {
+      err = uv_translate_sys_error(errno);
+    }
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
 void TCPWrap::Connect(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[2]->IsUint32());
   int port = args[2].As<Uint32>()->Value();
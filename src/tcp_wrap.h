@@ -37,6 +37,14 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
     SERVER
   };
 
+  // Flags for bind() and bind6() that are handled by Node.js rather than
+  // passed to uv_tcp_bind().
+  enum BindFlags {
+    // Set SO_REUSEPORT before binding, so that several listeners, e.g. one
+    // per worker thread, can be bound to the same address and port.
+    REUSEPORT = 1 << 16
+  };
+
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
                                                 AsyncWrap* parent,
                                                 SocketType type);
@@ -74,6 +82,13 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void Bind(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Listen(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetReusePortGroupSize(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetDeferAccept(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetFastOpen(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Like ConnectionWrap::OnConnection(), but accepts up to
+  // accept_batch_size_ connections and passes them to JavaScript as an array.
+  static void OnConnectionBatch(uv_stream_t* handle, int status);
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   template <typename T>
@@ -90,6 +105,11 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void SetSimultaneousAccepts(
       const v8::FunctionCallbackInfo<v8::Value>& args);
 #endif
+
+  // The maximum number of connections that are accepted per wakeup of a
+  // listening socket, set by listen(). 0 if connections are passed to
+  // JavaScript one at a time.
+  uint32_t accept_batch_size_ = 0;
 };
 
 
@@ -27,27 +27,89 @@
 #include "util-inl.h"
 #include "node_internals.h"
 
+#include <algorithm>
+
 namespace node {
 
 void ThreadPoolWork::ScheduleWork() {
   env_->IncreaseWaitingRequestCounter();
+  env_->threadpool_work_queue()->Schedule(this);
+}
+
+int ThreadPoolWork::CancelWork() {
+  return env_->threadpool_work_queue()->Cancel(this);
+}
+
+void ThreadPoolWorkQueue::Schedule(ThreadPoolWork* work) {
+  if (!limits_resolved_)
+    ResolveLimits();
+  ClassStats& stats = stats_[work->work_class_];
+  work->scheduled_at_ = uv_hrtime();
+  work->started_at_ = 0;
+  if (stats.limit == 0 || stats.running < stats.limit) {
+    Submit(work);
+  } else {
+    queued_[work->work_class_].PushBack(work);
+    stats.queued++;
+  }
+}
+
+int ThreadPoolWorkQueue::Cancel(ThreadPoolWork* work) {
+  if (work->queue_node_.IsEmpty())
+    return uv_cancel(reinterpret_cast<uv_req_t*>(&work->work_req_));
+
+  // The work has not been handed to libuv yet. It completes with UV_ECANCELED
+  // on the next iteration of the event loop, just like work cancelled
+  // through uv_cancel() does, without waiting for the threadpool.
+  work->queue_node_.Remove();
+  stats_[work->work_class_].queued--;
+  work->env_->SetImmediate(CompleteCancelled, work);
+  return 0;
+}
+
+void ThreadPoolWorkQueue::CompleteCancelled(Environment* env, void* data) {
+  ThreadPoolWork* work = static_cast<ThreadPoolWork*>(data);
+  env->DecreaseWaitingRequestCounter();
+  work->AfterThreadPoolWork(UV_ECANCELED);
+}
+
+void ThreadPoolWorkQueue::Submit(ThreadPoolWork* work) {
+  stats_[work->work_class_].running++;
   int status = uv_queue_work(
-      env_->event_loop(),
-      &work_req_,
+      work->env_->event_loop(),
+      &work->work_req_,
       [](uv_work_t* req) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        self->started_at_ = uv_hrtime();
         self->DoThreadPoolWork();
+        self->finished_at_ = uv_hrtime();
       },
       [](uv_work_t* req, int status) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
-        self->env_->DecreaseWaitingRequestCounter();
+        Environment* env = self->env_;
+        env->threadpool_work_queue()->Done(self);
+        env->DecreaseWaitingRequestCounter();
         self->AfterThreadPoolWork(status);
       });
   CHECK_EQ(status, 0);
 }
 
-int ThreadPoolWork::CancelWork() {
-  return uv_cancel(reinterpret_cast<uv_req_t*>(&work_req_));
+void ThreadPoolWorkQueue::Done(ThreadPoolWork* work) {
+  ClassStats& stats = stats_[work->work_class_];
+  stats.running--;
+  // Work cancelled through uv_cancel() never started running.
+  if (work->started_at_ != 0) {
+    const uint64_t wait = work->started_at_ - work->scheduled_at_;
+    stats.completed++;
+    stats.total_wait_ns += wait;
+    stats.max_wait_ns = std::max(stats.max_wait_ns, wait);
+    stats.total_run_ns += work->finished_at_ - work->started_at_;
+  }
+
+  if (ThreadPoolWork* next = queued_[work->work_class_].PopFront()) {
+    stats.queued--;
+    Submit(next);
+  }
 }
 
 }  // namespace node
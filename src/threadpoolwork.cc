@@ -0,0 +1,124 @@
+#include "node_internals.h"
+#include "node_options-inl.h"
+#include "util-inl.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>  // strtoul
+
+namespace node {
+
+// The same bounds that libuv applies to UV_THREADPOOL_SIZE.
+static const size_t kDefaultThreadpoolSize = 4;
+static const size_t kMaxThreadpoolSize = 128;
+
+static size_t ReadThreadpoolSize() {
+  std::string text;
+  if (!credentials::SafeGetenv("UV_THREADPOOL_SIZE", &text))
+    return kDefaultThreadpoolSize;
+  const size_t size = strtoul(text.c_str(), nullptr, 10);
+  if (size == 0)
+    return 1;
+  return std::min(size, kMaxThreadpoolSize);
+}
+
+// libuv reads UV_THREADPOOL_SIZE when the first work is queued, so that
+// scripts can still set it from JavaScript. The size is read here at the
+// same point, when the first ThreadPoolWork of the process is scheduled, and
+// is 0 until then.
+static std::atomic<size_t> resolved_threadpool_size { 0 };
+
+static size_t ResolveThreadpoolSize() {
+  static uv_once_t once = UV_ONCE_INIT;
+  uv_once(&once, []() { resolved_threadpool_size = ReadThreadpoolSize(); });
+  return resolved_threadpool_size;
+}
+
+const char* ThreadPoolWork::WorkClassName(WorkClass work_class) {
+  switch (work_class) {
+    case kFileSystem: return "fs";
+    case kCrypto: return "crypto";
+    case kZlib: return "zlib";
+    case kAddon: return "addon";
+    default: UNREACHABLE();
+  }
+}
+
+ThreadPoolWorkQueue::ThreadPoolWorkQueue() {
+  size_t limits[ThreadPoolWork::kWorkClassCount] = {};
+  std::string error;
+  // The option has been validated in PerProcessOptions::CheckOptions().
+  CHECK(ParseLimits(per_process::cli_options->threadpool_limits,
+                    limits,
+                    &error));
+  for (size_t i = 0; i < ThreadPoolWork::kWorkClassCount; i++)
+    stats_[i].limit = limits[i];
+}
+
+size_t ThreadPoolWorkQueue::threadpool_size() const {
+  const size_t size = resolved_threadpool_size;
+  return size != 0 ? size : ReadThreadpoolSize();
+}
+
+void ThreadPoolWorkQueue::ResolveLimits() {
+  limits_resolved_ = true;
+  const size_t threadpool_size = ResolveThreadpoolSize();
+  // Without --threadpool-limits, work is not limited at all.
+  if (per_process::cli_options->threadpool_limits.empty())
+    return;
+  const size_t default_limit = threadpool_size > 1 ? threadpool_size - 1 : 1;
+  for (size_t i = 0; i < ThreadPoolWork::kWorkClassCount; i++) {
+    if (stats_[i].limit == 0)
+      stats_[i].limit = default_limit;
+  }
+}
+
+bool ThreadPoolWorkQueue::ParseLimits(
+    const std::string& text,
+    size_t limits[ThreadPoolWork::kWorkClassCount],
+    std::string* error) {
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(',', start);
+    if (end == std::string::npos)
+      end = text.size();
+    const std::string entry = text.substr(start, end - start);
+    start = end + 1;
+
+    const size_t equals = entry.find('=');
+    if (equals == std::string::npos) {
+      *error = "invalid entry '" + entry + "', expected <class>=<limit>";
+      return false;
+    }
+    const std::string name = entry.substr(0, equals);
+    const std::string value = entry.substr(equals + 1);
+
+    int work_class = 0;
+    while (work_class < ThreadPoolWork::kWorkClassCount &&
+           name != ThreadPoolWork::WorkClassName(
+               static_cast<ThreadPoolWork::WorkClass>(work_class))) {
+      work_class++;
+    }
+    if (work_class == ThreadPoolWork::kWorkClassCount) {
+      *error = "unknown work class '" + name + "', expected one of "
+               "fs, crypto, zlib, addon";
+      return false;
+    }
+
+    char* value_end;
+    errno = 0;
+    const unsigned long limit =  // NOLINT(runtime/int)
+        strtoul(value.c_str(), &value_end, 10);
+    if (value.empty() || *value_end != '\0' || errno != 0 ||
+        value[0] == '-' || limit == 0 || limit > kMaxThreadpoolSize) {
+      *error = "invalid limit '" + value + "' for work class '" + name +
+               "', expected an integer between 1 and " +
+               std::to_string(kMaxThreadpoolSize);
+      return false;
+    }
+    limits[work_class] = limit;
+  }
+  return true;
+}
+
+}  // namespace node
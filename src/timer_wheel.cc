@@ -0,0 +1,169 @@
+#include "timer_wheel.h"
+#include "util.h"
+
+#include <algorithm>
+
+namespace node {
+
+const uint64_t TimerWheel::kNoExpiry;
+const unsigned TimerWheel::kBits;
+const unsigned TimerWheel::kSlots;
+const unsigned TimerWheel::kLevels;
+const unsigned TimerWheel::kWords;
+const uint32_t TimerWheel::kNone;
+
+namespace {
+
+inline unsigned LowestBit(uint64_t word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  unsigned bit = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+}  // anonymous namespace
+
+TimerWheel::TimerWheel() : heads_(kLevels * kSlots, kNone) {}
+
+// A timer goes to the lowest level at which its expiry and the current time
+// differ only in the bits that the level covers. Its slot at that level then
+// comes after the current one, so that the wheel reaches the slot before the
+// timer expires. Timers that are already due go to the current slot of the
+// lowest level.
+uint32_t TimerWheel::SlotFor(uint64_t expiry) const {
+  if (expiry <= now_)
+    return now_ & (kSlots - 1);
+  const uint64_t diff = expiry ^ now_;
+  unsigned level = kLevels - 1;
+  while (level > 0 && (diff >> (level * kBits)) == 0)
+    level--;
+  return level * kSlots + ((expiry >> (level * kBits)) & (kSlots - 1));
+}
+
+uint64_t TimerWheel::NextStop(uint32_t* slot) const {
+  for (unsigned level = 0; level < kLevels; level++) {
+    const unsigned shift = level * kBits;
+    const unsigned current = (now_ >> shift) & (kSlots - 1);
+    // Higher levels are only reached once the current slot has passed.
+    unsigned index = level == 0 ? current : current + 1;
+    while (index < kSlots) {
+      uint64_t word = occupied_[level][index / 64] >> (index % 64);
+      if (word != 0) {
+        index += LowestBit(word);
+        break;
+      }
+      index = (index / 64 + 1) * 64;
+    }
+    if (index >= kSlots)
+      continue;
+    *slot = level * kSlots + index;
+    const unsigned upper = shift + kBits;
+    const uint64_t base = upper < 64 ? (now_ >> upper) << upper : 0;
+    return base | (static_cast<uint64_t>(index) << shift);
+  }
+  return kNoExpiry;
+}
+
+void TimerWheel::Link(uint32_t id) {
+  Entry& entry = entries_[id];
+  entry.slot = SlotFor(entry.expiry);
+  entry.prev = kNone;
+  entry.next = heads_[entry.slot];
+  if (entry.next != kNone)
+    entries_[entry.next].prev = id;
+  heads_[entry.slot] = id;
+  const unsigned index = entry.slot % kSlots;
+  occupied_[entry.slot / kSlots][index / 64] |= uint64_t{1} << (index % 64);
+}
+
+void TimerWheel::Unlink(uint32_t id) {
+  Entry& entry = entries_[id];
+  if (entry.prev != kNone)
+    entries_[entry.prev].next = entry.next;
+  else
+    heads_[entry.slot] = entry.next;
+  if (entry.next != kNone)
+    entries_[entry.next].prev = entry.prev;
+  if (heads_[entry.slot] == kNone) {
+    const unsigned index = entry.slot % kSlots;
+    occupied_[entry.slot / kSlots][index / 64] &=
+        ~(uint64_t{1} << (index % 64));
+  }
+}
+
+void TimerWheel::Schedule(uint32_t id, uint64_t expiry) {
+  CHECK_NE(id, kNone);
+  if (id >= entries_.size())
+    entries_.resize(id + 1);
+  Entry& entry = entries_[id];
+  if (entry.scheduled)
+    Unlink(id);
+  else
+    size_++;
+  entry.expiry = expiry;
+  entry.seq = seq_++;
+  entry.scheduled = true;
+  Link(id);
+}
+
+void TimerWheel::Cancel(uint32_t id) {
+  if (!IsScheduled(id))
+    return;
+  Unlink(id);
+  entries_[id].scheduled = false;
+  size_--;
+}
+
+bool TimerWheel::IsScheduled(uint32_t id) const {
+  return id < entries_.size() && entries_[id].scheduled;
+}
+
+uint64_t TimerWheel::NextExpiry() const {
+  uint32_t slot;
+  return NextStop(&slot);
+}
+
+void TimerWheel::Expire(uint64_t now, std::vector<uint32_t>* expired) {
+  const size_t first = expired->size();
+  for (;;) {
+    uint32_t slot;
+    const uint64_t stop = NextStop(&slot);
+    if (stop == kNoExpiry || stop > now)
+      break;
+    // No other slot is due before `stop`, so the wheel can move straight to
+    // it.
+    now_ = stop;
+    uint32_t id = heads_[slot];
+    heads_[slot] = kNone;
+    const unsigned index = slot % kSlots;
+    occupied_[slot / kSlots][index / 64] &= ~(uint64_t{1} << (index % 64));
+    while (id != kNone) {
+      const uint32_t next = entries_[id].next;
+      if (slot < kSlots) {
+        entries_[id].scheduled = false;
+        size_--;
+        expired->push_back(id);
+      } else {
+        Link(id);
+      }
+      id = next;
+    }
+  }
+  if (now > now_)
+    now_ = now;
+
+  std::sort(expired->begin() + first, expired->end(),
+            [&](uint32_t a, uint32_t b) {
+    const Entry& x = entries_[a];
+    const Entry& y = entries_[b];
+    return x.expiry != y.expiry ? x.expiry < y.expiry : x.seq < y.seq;
+  });
+}
+
+}  // namespace node
@@ -0,0 +1,76 @@
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace node {
+
+// A hierarchical timing wheel of millisecond expiry times, keyed by small
+// integer ids. Each level has 256 slots and covers 8 more bits of the time
+// than the level below it, so that scheduling and cancelling are constant
+// time, and a timer is moved to a lower level at most once per level before
+// it expires.
+class TimerWheel {
+ public:
+  static const uint64_t kNoExpiry = UINT64_MAX;
+
+  TimerWheel();
+
+  // Schedules the timer `id` to expire at `expiry`, replacing its previous
+  // expiry if it was already scheduled.
+  void Schedule(uint32_t id, uint64_t expiry);
+  // Does nothing if the timer `id` is not scheduled.
+  void Cancel(uint32_t id);
+  // Advances the wheel to `now` and appends the ids of the timers that expire
+  // at or before it to `expired`, ordered by expiry and then by the order in
+  // which they were scheduled.
+  void Expire(uint64_t now, std::vector<uint32_t>* expired);
+  // Returns the time at which Expire() must be called next. That is either
+  // the expiry of the next timer, or an earlier time at which timers move to
+  // a lower level of the wheel. Returns kNoExpiry if no timer is scheduled.
+  uint64_t NextExpiry() const;
+
+  bool IsScheduled(uint32_t id) const;
+  uint64_t now() const { return now_; }
+  size_t size() const { return size_; }
+
+ private:
+  static const unsigned kBits = 8;
+  static const unsigned kSlots = 1 << kBits;
+  static const unsigned kLevels = 64 / kBits;
+  static const unsigned kWords = kSlots / 64;
+  static const uint32_t kNone = UINT32_MAX;
+
+  struct Entry {
+    uint64_t expiry = 0;
+    uint64_t seq = 0;
+    uint32_t prev = kNone;
+    uint32_t next = kNone;
+    uint32_t slot = 0;
+    bool scheduled = false;
+  };
+
+  uint32_t SlotFor(uint64_t expiry) const;
+  // Returns the time of the first occupied slot that is due at or after
+  // now_, and stores the slot in `slot`.
+  uint64_t NextStop(uint32_t* slot) const;
+  void Link(uint32_t id);
+  void Unlink(uint32_t id);
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> heads_;
+  uint64_t occupied_[kLevels][kWords] = {};
+  uint64_t now_ = 0;
+  uint64_t seq_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_TIMER_WHEEL_H_
@@ -35,6 +35,10 @@ void ScheduleTimer(const FunctionCallbackInfo<Value>& args) {
   env->ScheduleTimer(args[0]->IntegerValue(env->context()).FromJust());
 }
 
+void FlushTimerCommands(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args)->timer_info()->FlushCommands();
+}
+
 void ToggleTimerRef(const FunctionCallbackInfo<Value>& args) {
   Environment::GetCurrent(args)->ToggleTimerRef(args[0]->IsTrue());
 }
@@ -52,12 +56,16 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "getLibuvNow", GetLibuvNow);
   env->SetMethod(target, "setupTimers", SetupTimers);
   env->SetMethod(target, "scheduleTimer", ScheduleTimer);
+  env->SetMethod(target, "flushTimerCommands", FlushTimerCommands);
   env->SetMethod(target, "toggleTimerRef", ToggleTimerRef);
   env->SetMethod(target, "toggleImmediateRef", ToggleImmediateRef);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "immediateInfo"),
               env->immediate_info()->fields().GetJSArray()).Check();
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "timerInfo"),
+              env->timer_info()->fields().GetJSArray()).Check();
 }
 
 
@@ -223,6 +223,182 @@ void Agent::Flush(bool blocking) {
     id_writer.second->Flush(blocking);
 }
 
+namespace {
+
+// Announces whether a thread is using a trace buffer that it has loaded from
+// a TracingController. Only the owning thread writes to its epoch, so that
+// adding an event does not touch memory shared with other threads. Records
+// are never freed, but reused once their thread has exited, so that
+// TracingController::Initialize() can walk the list without locking.
+struct BufferUser {
+  // Odd while the thread is inside a BufferScope.
+  std::atomic<uint64_t> epoch { 0 };
+  // The number of nested BufferScopes on the thread.
+  size_t depth = 0;
+  std::atomic<bool> claimed { true };
+  BufferUser* next = nullptr;
+};
+
+std::atomic<BufferUser*> buffer_users { nullptr };
+// The number of TracingController::Initialize() calls that are waiting for
+// threads to leave their BufferScope, which then signal buffer_unused.
+std::atomic<size_t> replacing_buffer { 0 };
+Mutex replace_buffer_mutex;
+ConditionVariable buffer_unused;
+
+BufferUser* ClaimBufferUser() {
+  for (BufferUser* user = buffer_users.load(std::memory_order_acquire);
+       user != nullptr;
+       user = user->next) {
+    bool claimed = false;
+    if (user->claimed.compare_exchange_strong(claimed, true,
+                                              std::memory_order_acquire)) {
+      return user;
+    }
+  }
+  BufferUser* user = new BufferUser();
+  BufferUser* head = buffer_users.load(std::memory_order_relaxed);
+  do {
+    user->next = head;
+  } while (!buffer_users.compare_exchange_weak(head, user,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+  return user;
+}
+
+class ThreadBufferUser {
+ public:
+  ~ThreadBufferUser() {
+    if (user_ != nullptr)
+      user_->claimed.store(false, std::memory_order_release);
+  }
+
+  BufferUser* get() {
+    if (user_ == nullptr)
+      user_ = ClaimBufferUser();
+    return user_;
+  }
+
+ private:
+  BufferUser* user_ = nullptr;
+};
+
+thread_local ThreadBufferUser thread_buffer_user;
+
+}  // anonymous namespace
+
+class TracingController::BufferScope {
+ public:
+  explicit BufferScope(TracingController* controller)
+      : user_(thread_buffer_user.get()) {
+    // Announce the use before loading the buffer, so that Initialize()
+    // either sees the use or this thread sees the new buffer. Both accesses
+    // are sequentially consistent for that reason.
+    if (user_->depth++ == 0)
+      user_->epoch.store(user_->epoch.load(std::memory_order_relaxed) + 1);
+    buffer_ = controller->trace_buffer_.load();
+  }
+
+  ~BufferScope() {
+    if (--user_->depth != 0)
+      return;
+    user_->epoch.store(user_->epoch.load(std::memory_order_relaxed) + 1);
+    if (replacing_buffer.load() != 0) {
+      Mutex::ScopedLock lock(replace_buffer_mutex);
+      buffer_unused.Broadcast(lock);
+    }
+  }
+
+  NodeTraceBuffer* buffer() const { return buffer_; }
+
+  BufferScope(const BufferScope&) = delete;
+  BufferScope& operator=(const BufferScope&) = delete;
+
+ private:
+  BufferUser* user_;
+  NodeTraceBuffer* buffer_;
+};
+
+void TracingController::Initialize(NodeTraceBuffer* trace_buffer) {
+  trace_buffer_.store(trace_buffer);
+  // The base class deletes the previous buffer, so wait until the threads
+  // that may have loaded it before the store above have left their
+  // BufferScope. Threads that enter one later see the new buffer.
+  {
+    Mutex::ScopedLock lock(replace_buffer_mutex);
+    replacing_buffer++;
+    for (BufferUser* user = buffer_users.load(std::memory_order_acquire);
+         user != nullptr;
+         user = user->next) {
+      const uint64_t epoch = user->epoch.load();
+      if (epoch % 2 == 0)
+        continue;
+      while (user->epoch.load() == epoch)
+        buffer_unused.Wait(lock);
+    }
+    replacing_buffer--;
+  }
+  v8::platform::tracing::TracingController::Initialize(trace_buffer);
+}
+
+void TracingController::StartTracing(TraceConfig* trace_config) {
+  recording_.store(true, std::memory_order_release);
+  v8::platform::tracing::TracingController::StartTracing(trace_config);
+}
+
+void TracingController::StopTracing() {
+  recording_.store(false, std::memory_order_release);
+  v8::platform::tracing::TracingController::StopTracing();
+}
+
+uint64_t TracingController::AddTraceEvent(
+    char phase, const uint8_t* category_enabled_flag, const char* name,
+    const char* scope, uint64_t id, uint64_t bind_id, int num_args,
+    const char** arg_names, const uint8_t* arg_types,
+    const uint64_t* arg_values,
+    std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+    unsigned int flags) {
+  return AddTraceEventWithTimestamp(
+      phase, category_enabled_flag, name, scope, id, bind_id, num_args,
+      arg_names, arg_types, arg_values, arg_convertables, flags,
+      CurrentTimestampMicroseconds());
+}
+
+uint64_t TracingController::AddTraceEventWithTimestamp(
+    char phase, const uint8_t* category_enabled_flag, const char* name,
+    const char* scope, uint64_t id, uint64_t bind_id, int num_args,
+    const char** arg_names, const uint8_t* arg_types,
+    const uint64_t* arg_values,
+    std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+    unsigned int flags, int64_t timestamp) {
+  uint64_t handle = 0;
+  if (!recording_.load(std::memory_order_acquire))
+    return handle;
+  BufferScope buffer_scope(this);
+  NodeTraceBuffer* trace_buffer = buffer_scope.buffer();
+  if (trace_buffer == nullptr)
+    return handle;
+  TraceObject* trace_object = trace_buffer->AddTraceEvent(&handle);
+  if (trace_object == nullptr)
+    return handle;
+  trace_object->Initialize(phase, category_enabled_flag, name, scope, id,
+                           bind_id, num_args, arg_names, arg_types,
+                           arg_values, arg_convertables, flags, timestamp,
+                           CurrentCpuTimestampMicroseconds());
+  trace_buffer->CommitTraceEvent(handle);
+  return handle;
+}
+
+void TracingController::UpdateTraceEventDuration(
+    const uint8_t* category_enabled_flag, const char* name, uint64_t handle) {
+  BufferScope buffer_scope(this);
+  NodeTraceBuffer* trace_buffer = buffer_scope.buffer();
+  if (trace_buffer == nullptr)
+    return;
+  trace_buffer->UpdateEventDuration(handle, CurrentTimestampMicroseconds(),
+                                    CurrentCpuTimestampMicroseconds());
+}
+
 void TracingController::AddMetadataEvent(
     const unsigned char* category_group_enabled,
     const char* name,
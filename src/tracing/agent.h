@@ -7,6 +7,7 @@
 #include "util.h"
 #include "node_mutex.h"
 
+#include <atomic>
 #include <list>
 #include <set>
 #include <string>
@@ -28,13 +29,44 @@ class AsyncTraceWriter {
   virtual void InitializeOnThread(uv_loop_t* loop) {}
 };
 
+class NodeTraceBuffer;
+
 class TracingController : public v8::platform::tracing::TracingController {
  public:
   TracingController() : v8::platform::tracing::TracingController() {}
 
+  // Takes ownership of `trace_buffer`. Unlike the base class, which takes a
+  // process-wide lock for every event, events are added to the buffer
+  // directly; NodeTraceBuffer can be used from any thread without locking.
+  // Each thread marks a record of its own while it uses the buffer, and the
+  // previous buffer is deleted once the threads that were using it have
+  // cleared their mark.
+  void Initialize(NodeTraceBuffer* trace_buffer);
+
+  // These hide the base class methods, which are not virtual, so that
+  // recording_ follows the private flag of the same name in the base class.
+  void StartTracing(TraceConfig* trace_config);
+  void StopTracing();
+
   int64_t CurrentTimestampMicroseconds() override {
     return uv_hrtime() / 1000;
   }
+  uint64_t AddTraceEvent(
+      char phase, const uint8_t* category_enabled_flag, const char* name,
+      const char* scope, uint64_t id, uint64_t bind_id, int num_args,
+      const char** arg_names, const uint8_t* arg_types,
+      const uint64_t* arg_values,
+      std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+      unsigned int flags) override;
+  uint64_t AddTraceEventWithTimestamp(
+      char phase, const uint8_t* category_enabled_flag, const char* name,
+      const char* scope, uint64_t id, uint64_t bind_id, int num_args,
+      const char** arg_names, const uint8_t* arg_types,
+      const uint64_t* arg_values,
+      std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+      unsigned int flags, int64_t timestamp) override;
+  void UpdateTraceEventDuration(const uint8_t* category_enabled_flag,
+                                const char* name, uint64_t handle) override;
   void AddMetadataEvent(
       const unsigned char* category_group_enabled,
       const char* name,
@@ -44,6 +76,13 @@ class TracingController : public v8::platform::tracing::TracingController {
       const uint64_t* arg_values,
       std::unique_ptr<v8::ConvertableToTraceFormat>* convertable_values,
       unsigned int flags);
+
+ private:
+  // Keeps the current trace buffer alive while the thread uses it.
+  class BufferScope;
+
+  std::atomic<NodeTraceBuffer*> trace_buffer_ { nullptr };
+  std::atomic<bool> recording_ { false };
 };
 
 class AgentWriterHandle {
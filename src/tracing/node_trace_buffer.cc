@@ -1,106 +1,56 @@
 #include "tracing/node_trace_buffer.h"
 
 #include <memory>
+#include <unordered_map>
 #include "util-inl.h"
 
 namespace node {
 namespace tracing {
 
-InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
-                                         Agent* agent)
-    : flushing_(false), max_chunks_(max_chunks),
-      agent_(agent), id_(id) {
-  chunks_.resize(max_chunks);
-}
+namespace {
 
-TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
-    if (chunk) {
-      chunk->Reset(current_chunk_seq_++);
-    } else {
-      chunk = std::make_unique<TraceBufferChunk>(current_chunk_seq_++);
-    }
-  }
-  auto& chunk = chunks_[total_chunks_ - 1];
-  size_t event_index;
-  TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
-  return trace_object;
-}
+// Buffers that threads may still hold a chunk of when they exit.
+Mutex live_buffers_mutex;
+std::unordered_map<NodeTraceBuffer*, uint64_t> live_buffers;
+std::atomic<uint64_t> next_buffer_id { 1 };
+// Chunk sequence numbers are unique across buffers, so that a handle from a
+// buffer that has been replaced is not mistaken for one from its successor.
+std::atomic<uint32_t> next_chunk_seq { 1 };
 
-TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  if (handle == 0) {
-    // A handle value of zero never has a trace event associated with it.
-    return nullptr;
-  }
-  size_t chunk_index, event_index;
-  uint32_t buffer_id, chunk_seq;
-  ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
-    // Either the chunk belongs to the other buffer, or is outside the current
-    // range of chunks loaded in memory (the latter being true suggests that
-    // the chunk has already been flushed and is no longer in memory.)
-    return nullptr;
-  }
-  auto& chunk = chunks_[chunk_index];
-  if (chunk->seq() != chunk_seq) {
-    // Chunk is no longer in memory.
-    return nullptr;
-  }
-  return chunk->GetEventAt(event_index);
-}
+}  // anonymous namespace
 
-void InternalTraceBuffer::Flush(bool blocking) {
-  {
-    Mutex::ScopedLock scoped_lock(mutex_);
-    if (total_chunks_ > 0) {
-      flushing_ = true;
-      for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
-        for (size_t j = 0; j < chunk->size(); ++j) {
-          TraceObject* trace_event = chunk->GetEventAt(j);
-          // Another thread may have added a trace that is yet to be
-          // initialized. Skip such traces.
-          // https://github.com/nodejs/node/issues/21038.
-          if (trace_event->name()) {
-            agent_->AppendTraceEvent(trace_event);
-          }
-        }
-      }
-      total_chunks_ = 0;
-      flushing_ = false;
-    }
+// The chunk that the current thread is filling. When the thread exits, the
+// chunk is handed to the tracing thread like a full one.
+class NodeTraceBuffer::ThreadChunk {
+ public:
+  ~ThreadChunk() {
+    if (slot_id == 0)
+      return;
+    Mutex::ScopedLock lock(live_buffers_mutex);
+    auto it = live_buffers.find(buffer);
+    if (it != live_buffers.end() && it->second == buffer_id)
+      buffer->ReleaseSlot(slot_id);
   }
-  agent_->Flush(blocking);
-}
 
-uint64_t InternalTraceBuffer::MakeHandle(
-    size_t chunk_index, uint32_t chunk_seq, size_t event_index) const {
-  return ((static_cast<uint64_t>(chunk_seq) * Capacity() +
-          chunk_index * TraceBufferChunk::kChunkSize + event_index) << 1) + id_;
-}
+  NodeTraceBuffer* buffer = nullptr;
+  uint64_t buffer_id = 0;
+  uint32_t slot_id = 0;
+};
 
-void InternalTraceBuffer::ExtractHandle(
-    uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-    uint32_t* chunk_seq, size_t* event_index) const {
-  *buffer_id = static_cast<uint32_t>(handle & 0x1);
-  handle >>= 1;
-  *chunk_seq = static_cast<uint32_t>(handle / Capacity());
-  size_t indices = handle % Capacity();
-  *chunk_index = indices / TraceBufferChunk::kChunkSize;
-  *event_index = indices % TraceBufferChunk::kChunkSize;
-}
+thread_local NodeTraceBuffer::ThreadChunk NodeTraceBuffer::thread_chunk_;
 
 NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
     Agent* agent, uv_loop_t* tracing_loop)
-    : tracing_loop_(tracing_loop),
-      buffer1_(max_chunks, 0, agent),
-      buffer2_(max_chunks, 1, agent) {
-  current_buf_.store(&buffer1_);
+    : id_(next_buffer_id++),
+      agent_(agent),
+      num_slots_(2 * max_chunks),
+      flush_threshold_(max_chunks),
+      slots_(new Slot[2 * max_chunks]),
+      tracing_loop_(tracing_loop) {
+  // Handles store the slot and event index in their lower 32 bits.
+  CHECK_LT(num_slots_, (uint64_t{1} << 32) / TraceBufferChunk::kChunkSize);
+  for (uint32_t slot_id = num_slots_; slot_id > 0; slot_id--)
+    PushFreeSlot(slot_id);
 
   flush_signal_.data = this;
   int err = uv_async_init(tracing_loop_, &flush_signal_,
@@ -110,9 +60,16 @@ NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
   exit_signal_.data = this;
   err = uv_async_init(tracing_loop_, &exit_signal_, ExitSignalCb);
   CHECK_EQ(err, 0);
+
+  Mutex::ScopedLock lock(live_buffers_mutex);
+  live_buffers[this] = id_;
 }
 
 NodeTraceBuffer::~NodeTraceBuffer() {
+  {
+    Mutex::ScopedLock lock(live_buffers_mutex);
+    live_buffers.erase(this);
+  }
   uv_async_send(&exit_signal_);
   Mutex::ScopedLock scoped_lock(exit_mutex_);
   while (!exited_) {
@@ -121,54 +78,239 @@ NodeTraceBuffer::~NodeTraceBuffer() {
 }
 
 TraceObject* NodeTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  // If the buffer is full, attempt to perform a flush.
-  if (!TryLoadAvailableBuffer()) {
-    // Assign a value of zero as the trace event handle.
-    // This is equivalent to calling InternalTraceBuffer::MakeHandle(0, 0, 0),
-    // and will cause GetEventByHandle to return NULL if passed as an argument.
-    *handle = 0;
-    return nullptr;
+  ThreadChunk* local = &thread_chunk_;
+  if (local->buffer != this || local->buffer_id != id_) {
+    // The chunk this thread filled last belongs to another buffer, which
+    // may no longer exist.
+    local->buffer = this;
+    local->buffer_id = id_;
+    local->slot_id = 0;
+  }
+
+  if (local->slot_id != 0 && slots_[local->slot_id - 1].chunk->IsFull()) {
+    ReleaseSlot(local->slot_id);
+    local->slot_id = 0;
   }
-  return current_buf_.load()->AddTraceEvent(handle);
+
+  if (local->slot_id == 0) {
+    const uint32_t slot_id = PopFreeSlot();
+    if (slot_id == 0) {
+      // Every chunk is either full or being filled by another thread.
+      uv_async_send(&flush_signal_);
+      // Assign a value of zero as the trace event handle. This will cause
+      // GetEventByHandle to return NULL if passed as an argument.
+      *handle = 0;
+      return nullptr;
+    }
+    Slot& slot = slots_[slot_id - 1];
+    uint32_t seq = next_chunk_seq++;
+    if (seq == 0)
+      seq = next_chunk_seq++;
+    if (slot.chunk) {
+      slot.chunk->Reset(seq);
+    } else {
+      slot.chunk = std::make_unique<TraceBufferChunk>(seq);
+    }
+    slot.committed.store(0, std::memory_order_relaxed);
+    slot.state.store(kFilling, std::memory_order_release);
+    slot.seq.store(seq, std::memory_order_release);
+    local->slot_id = slot_id;
+  }
+
+  Slot& slot = slots_[local->slot_id - 1];
+  // Events added earlier by this thread have been initialized by now.
+  slot.committed.store(slot.chunk->size(), std::memory_order_release);
+  size_t event_index;
+  TraceObject* trace_object = slot.chunk->AddTraceEvent(&event_index);
+  *handle = MakeHandle(local->slot_id, slot.chunk->seq(), event_index);
+  return trace_object;
+}
+
+void NodeTraceBuffer::CommitTraceEvent(uint64_t handle) {
+  ThreadChunk* local = &thread_chunk_;
+  if (handle == 0 || local->buffer != this || local->buffer_id != id_)
+    return;
+  uint32_t slot_id, seq;
+  size_t event_index;
+  ExtractHandle(handle, &slot_id, &seq, &event_index);
+  if (slot_id != local->slot_id)
+    return;
+  slots_[slot_id - 1].committed.store(event_index + 1,
+                                      std::memory_order_release);
 }
 
 TraceObject* NodeTraceBuffer::GetEventByHandle(uint64_t handle) {
-  return current_buf_.load()->GetEventByHandle(handle);
+  if (handle == 0) {
+    // A handle value of zero never has a trace event associated with it.
+    return nullptr;
+  }
+  uint32_t slot_id, seq;
+  size_t event_index;
+  ExtractHandle(handle, &slot_id, &seq, &event_index);
+  if (slot_id == 0 || slot_id > num_slots_)
+    return nullptr;
+  Slot& slot = slots_[slot_id - 1];
+  if (slot.seq.load(std::memory_order_acquire) != seq) {
+    // The chunk has already been flushed and is no longer in memory.
+    return nullptr;
+  }
+  return slot.chunk->GetEventAt(event_index);
+}
+
+void NodeTraceBuffer::UpdateEventDuration(uint64_t handle, int64_t timestamp,
+                                          int64_t cpu_timestamp) {
+  if (handle == 0)
+    return;
+  uint32_t slot_id, seq;
+  size_t event_index;
+  ExtractHandle(handle, &slot_id, &seq, &event_index);
+  if (slot_id == 0 || slot_id > num_slots_)
+    return;
+  Slot& slot = slots_[slot_id - 1];
+  // FlushSlots() waits for the update to finish before it writes the chunk
+  // out, and clears the slot's sequence number before it allows updates
+  // again, so the chunk cannot be reset underneath the update.
+  if ((slot.updaters.fetch_add(1, std::memory_order_acq_rel) & kFlushing) ==
+          0 &&
+      slot.seq.load(std::memory_order_acquire) == seq) {
+    slot.chunk->GetEventAt(event_index)->UpdateDuration(timestamp,
+                                                        cpu_timestamp);
+  }
+  slot.updaters.fetch_sub(1, std::memory_order_release);
 }
 
 bool NodeTraceBuffer::Flush() {
-  buffer1_.Flush(true);
-  buffer2_.Flush(true);
+  FlushSlots(true, true);
   return true;
 }
 
-// Attempts to set current_buf_ such that it references a buffer that can
-// write at least one trace event. If both buffers are unavailable this
-// method returns false; otherwise it returns true.
-bool NodeTraceBuffer::TryLoadAvailableBuffer() {
-  InternalTraceBuffer* prev_buf = current_buf_.load();
-  if (prev_buf->IsFull()) {
+uint32_t NodeTraceBuffer::PopFreeSlot() {
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  for (;;) {
+    const uint32_t slot_id = static_cast<uint32_t>(head);
+    if (slot_id == 0)
+      return 0;
+    const uint64_t next =
+        slots_[slot_id - 1].next.load(std::memory_order_relaxed);
+    const uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+    if (free_head_.compare_exchange_weak(head, new_head,
+                                         std::memory_order_acquire)) {
+      return slot_id;
+    }
+  }
+}
+
+void NodeTraceBuffer::PushFreeSlot(uint32_t slot_id) {
+  Slot& slot = slots_[slot_id - 1];
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  uint64_t new_head;
+  do {
+    slot.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    new_head = (head & ~uint64_t{0xffffffff}) | slot_id;
+  } while (!free_head_.compare_exchange_weak(head, new_head,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+void NodeTraceBuffer::PushFullSlot(uint32_t slot_id) {
+  Slot& slot = slots_[slot_id - 1];
+  uint32_t head = full_head_.load(std::memory_order_relaxed);
+  do {
+    slot.next.store(head, std::memory_order_relaxed);
+  } while (!full_head_.compare_exchange_weak(head, slot_id,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+  if (++full_count_ == flush_threshold_)
     uv_async_send(&flush_signal_);  // trigger flush on a separate thread
-    InternalTraceBuffer* other_buf = prev_buf == &buffer1_ ?
-      &buffer2_ : &buffer1_;
-    if (!other_buf->IsFull()) {
-      current_buf_.store(other_buf);
-    } else {
-      return false;
+}
+
+// Called by the thread that has been filling the chunk once it stops doing
+// so, either because the chunk is full or because the thread exits.
+void NodeTraceBuffer::ReleaseSlot(uint32_t slot_id) {
+  Slot& slot = slots_[slot_id - 1];
+  slot.committed.store(slot.chunk->size(), std::memory_order_release);
+  slot.state.store(kFull, std::memory_order_release);
+  PushFullSlot(slot_id);
+}
+
+void NodeTraceBuffer::FlushSlots(bool include_filling, bool blocking) {
+  {
+    Mutex::ScopedLock scoped_lock(flush_mutex_);
+    // Blocks UpdateEventDuration() for the slot and waits for the updates
+    // that are already running, which only take a few stores, so that events
+    // are not written out while their duration changes.
+    auto block_updates = [](Slot* slot) {
+      slot->updaters.fetch_or(kFlushing, std::memory_order_acq_rel);
+      while (slot->updaters.load(std::memory_order_acquire) != kFlushing) {}
+    };
+    auto write_events = [&](Slot* slot) {
+      const size_t committed = slot->committed.load(std::memory_order_acquire);
+      for (; slot->flushed < committed; slot->flushed++)
+        agent_->AppendTraceEvent(slot->chunk->GetEventAt(slot->flushed));
+    };
+
+    // Full chunks are pushed in LIFO order; reverse the list so that chunks
+    // are written in the order in which they filled up.
+    uint32_t slot_id = full_head_.exchange(0, std::memory_order_acquire);
+    uint32_t reversed = 0;
+    size_t count = 0;
+    while (slot_id != 0) {
+      Slot& slot = slots_[slot_id - 1];
+      const uint32_t next = slot.next.load(std::memory_order_relaxed);
+      slot.next.store(reversed, std::memory_order_relaxed);
+      reversed = slot_id;
+      slot_id = next;
+      count++;
+    }
+    for (slot_id = reversed; slot_id != 0;) {
+      Slot& slot = slots_[slot_id - 1];
+      const uint32_t next = slot.next.load(std::memory_order_relaxed);
+      block_updates(&slot);
+      write_events(&slot);
+      slot.flushed = 0;
+      slot.state.store(kFree, std::memory_order_relaxed);
+      slot.seq.store(0, std::memory_order_release);
+      slot.updaters.fetch_and(~kFlushing, std::memory_order_release);
+      PushFreeSlot(slot_id);
+      slot_id = next;
+    }
+    full_count_ -= count;
+
+    // Chunks that threads are still filling are written up to their last
+    // committed event. The rest is written once they are full.
+    if (include_filling) {
+      for (size_t i = 0; i < num_slots_; i++) {
+        Slot* slot = &slots_[i];
+        if (slot->state.load(std::memory_order_acquire) == kFilling) {
+          block_updates(slot);
+          write_events(slot);
+          slot->updaters.fetch_and(~kFlushing, std::memory_order_release);
+        }
+      }
     }
   }
-  return true;
+  agent_->Flush(blocking);
+}
+
+uint64_t NodeTraceBuffer::MakeHandle(
+    uint32_t slot_id, uint32_t seq, size_t event_index) const {
+  return (static_cast<uint64_t>(seq) << 32) |
+         (slot_id * TraceBufferChunk::kChunkSize + event_index);
+}
+
+void NodeTraceBuffer::ExtractHandle(
+    uint64_t handle, uint32_t* slot_id, uint32_t* seq,
+    size_t* event_index) const {
+  *seq = static_cast<uint32_t>(handle >> 32);
+  const uint32_t indices = static_cast<uint32_t>(handle);
+  *slot_id = indices / TraceBufferChunk::kChunkSize;
+  *event_index = indices % TraceBufferChunk::kChunkSize;
 }
 
 // static
 void NodeTraceBuffer::NonBlockingFlushSignalCb(uv_async_t* signal) {
   NodeTraceBuffer* buffer = static_cast<NodeTraceBuffer*>(signal->data);
-  if (buffer->buffer1_.IsFull() && !buffer->buffer1_.IsFlushing()) {
-    buffer->buffer1_.Flush(false);
-  }
-  if (buffer->buffer2_.IsFull() && !buffer->buffer2_.IsFlushing()) {
-    buffer->buffer2_.Flush(false);
-  }
+  buffer->FlushSlots(false, false);
 }
 
 // static
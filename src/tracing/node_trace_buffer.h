@@ -6,6 +6,7 @@
 #include "libplatform/v8-tracing.h"
 
 #include <atomic>
+#include <memory>
 
 namespace node {
 namespace tracing {
@@ -14,56 +15,91 @@ using v8::platform::tracing::TraceBuffer;
 using v8::platform::tracing::TraceBufferChunk;
 using v8::platform::tracing::TraceObject;
 
-// forward declaration
-class NodeTraceBuffer;
-
-class InternalTraceBuffer {
- public:
-  InternalTraceBuffer(size_t max_chunks, uint32_t id, Agent* agent);
-
-  TraceObject* AddTraceEvent(uint64_t* handle);
-  TraceObject* GetEventByHandle(uint64_t handle);
-  void Flush(bool blocking);
-  bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
-  }
-  bool IsFlushing() const {
-    return flushing_;
-  }
-
- private:
-  uint64_t MakeHandle(size_t chunk_index, uint32_t chunk_seq,
-                      size_t event_index) const;
-  void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-                     uint32_t* chunk_seq, size_t* event_index) const;
-  size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
-
-  Mutex mutex_;
-  bool flushing_;
-  size_t max_chunks_;
-  Agent* agent_;
-  std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
-  size_t total_chunks_ = 0;
-  uint32_t current_chunk_seq_ = 1;
-  uint32_t id_;
-};
-
+// Every thread that records trace events fills a chunk of its own, so adding
+// an event takes neither a lock nor an atomic read-modify-write operation.
+// When a chunk is full, its thread pushes it onto a lock-free list for the
+// tracing thread, which writes the events out and returns the chunk to a
+// lock-free free list.
 class NodeTraceBuffer : public TraceBuffer {
  public:
   NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop);
   ~NodeTraceBuffer() override;
 
   TraceObject* AddTraceEvent(uint64_t* handle) override;
+  // The event may be written out and its chunk reused while the caller
+  // holds the returned pointer; use UpdateEventDuration() instead where
+  // events are still being added.
   TraceObject* GetEventByHandle(uint64_t handle) override;
   bool Flush() override;
 
+  // Makes the event returned by the last AddTraceEvent() call on this thread
+  // visible to Flush(). Must be called once the event has been initialized;
+  // otherwise the event becomes visible when the thread adds its next event.
+  void CommitTraceEvent(uint64_t handle);
+
+  // Like GetEventByHandle(handle)->UpdateDuration(), but does nothing if the
+  // event is being written out or has been already.
+  void UpdateEventDuration(uint64_t handle, int64_t timestamp,
+                           int64_t cpu_timestamp);
+
   static const size_t kBufferChunks = 1024;
 
  private:
-  bool TryLoadAvailableBuffer();
+  class ThreadChunk;
+  static thread_local ThreadChunk thread_chunk_;
+
+  enum SlotState : uint8_t { kFree, kFilling, kFull };
+  static const uint32_t kFlushing = 1u << 31;
+
+  struct Slot {
+    std::unique_ptr<TraceBufferChunk> chunk;
+    std::atomic<SlotState> state { kFree };
+    // The sequence number of the chunk, so that handles to events in an
+    // earlier use of this slot are recognized as stale. 0 while free.
+    std::atomic<uint32_t> seq { 0 };
+    // The number of events that can be written out, i.e. that have been
+    // initialized by the thread that is filling the chunk.
+    std::atomic<size_t> committed { 0 };
+    // The number of events that have already been written out. Only
+    // accessed while holding flush_mutex_.
+    size_t flushed = 0;
+    // The number of threads updating the duration of an event in the chunk,
+    // plus kFlushing while the events are being written out.
+    std::atomic<uint32_t> updaters { 0 };
+    // Index of the next slot plus one in free_head_ or full_head_, or 0.
+    std::atomic<uint32_t> next { 0 };
+  };
+
+  // Slots are identified by their index plus one, so that 0 means none.
+  uint32_t PopFreeSlot();
+  void PushFreeSlot(uint32_t slot_id);
+  void PushFullSlot(uint32_t slot_id);
+  void ReleaseSlot(uint32_t slot_id);
+  void FlushSlots(bool include_filling, bool blocking);
+
+  uint64_t MakeHandle(uint32_t slot_id, uint32_t seq, size_t event_index) const;
+  void ExtractHandle(uint64_t handle, uint32_t* slot_id, uint32_t* seq,
+                     size_t* event_index) const;
+
   static void NonBlockingFlushSignalCb(uv_async_t* signal);
   static void ExitSignalCb(uv_async_t* signal);
 
+  // Unique among all NodeTraceBuffer instances of the process, so that
+  // threads can tell that the buffer they last used has been replaced.
+  const uint64_t id_;
+  Agent* agent_;
+  const size_t num_slots_;
+  // Full chunks after which the tracing thread is woken up to flush them.
+  const size_t flush_threshold_;
+  std::unique_ptr<Slot[]> slots_;
+  // Treiber stack of free slots. The upper 32 bits count pops to avoid the
+  // ABA problem.
+  std::atomic<uint64_t> free_head_ { 0 };
+  // Stack of full slots, which is emptied all at once by the flushing thread.
+  std::atomic<uint32_t> full_head_ { 0 };
+  std::atomic<size_t> full_count_ { 0 };
+  Mutex flush_mutex_;
+
   uv_loop_t* tracing_loop_;
   uv_async_t flush_signal_;
   uv_async_t exit_signal_;
@@ -72,9 +108,6 @@ class NodeTraceBuffer : public TraceBuffer {
   Mutex exit_mutex_;
   // Used to wait until async handles have been closed.
   ConditionVariable exit_cond_;
-  std::atomic<InternalTraceBuffer*> current_buf_;
-  InternalTraceBuffer buffer1_;
-  InternalTraceBuffer buffer2_;
 };
 
 }  // namespace tracing
@@ -0,0 +1,384 @@
+#include "tracing/perfetto_trace_writer.h"
+
+#include "tracing/trace_event_common.h"
+#include "util.h"
+
+#include <cstring>
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TracingController;
+
+namespace {
+
+// Field numbers from the .proto files in protos/perfetto/trace/ of the
+// Perfetto repository.
+namespace trace {
+const uint32_t kPacket = 1;
+}  // namespace trace
+
+namespace trace_packet {
+const uint32_t kTrustedPacketSequenceId = 10;
+const uint32_t kTrackEvent = 11;
+const uint32_t kInternedData = 12;
+const uint32_t kSequenceFlags = 13;
+const uint32_t kProcessDescriptor = 43;
+const uint32_t kThreadDescriptor = 44;
+
+const uint64_t kIncrementalStateCleared = 1;
+const uint64_t kNeedsIncrementalState = 2;
+}  // namespace trace_packet
+
+namespace process_descriptor {
+const uint32_t kPid = 1;
+const uint32_t kProcessName = 6;
+}  // namespace process_descriptor
+
+namespace thread_descriptor {
+const uint32_t kPid = 1;
+const uint32_t kTid = 2;
+const uint32_t kThreadName = 5;
+const uint32_t kReferenceTimestampUs = 6;
+const uint32_t kReferenceThreadTimeUs = 7;
+}  // namespace thread_descriptor
+
+namespace interned_data {
+const uint32_t kEventCategories = 1;
+const uint32_t kEventNames = 2;
+const uint32_t kDebugAnnotationNames = 3;
+}  // namespace interned_data
+
+// EventCategory, EventName and DebugAnnotationName share these fields.
+namespace interned_string {
+const uint32_t kIid = 1;
+const uint32_t kName = 2;
+}  // namespace interned_string
+
+namespace track_event {
+const uint32_t kTimestampDeltaUs = 1;
+const uint32_t kThreadTimeDeltaUs = 2;
+const uint32_t kCategoryIids = 3;
+const uint32_t kDebugAnnotations = 4;
+const uint32_t kLegacyEvent = 6;
+const uint32_t kNameIid = 10;
+}  // namespace track_event
+
+namespace debug_annotation {
+const uint32_t kNameIid = 1;
+const uint32_t kBoolValue = 2;
+const uint32_t kUintValue = 3;
+const uint32_t kIntValue = 4;
+const uint32_t kDoubleValue = 5;
+const uint32_t kStringValue = 6;
+const uint32_t kPointerValue = 7;
+const uint32_t kLegacyJsonValue = 9;
+}  // namespace debug_annotation
+
+namespace legacy_event {
+const uint32_t kPhase = 2;
+const uint32_t kDurationUs = 3;
+const uint32_t kThreadDurationUs = 4;
+const uint32_t kUnscopedId = 6;
+const uint32_t kIdScope = 7;
+const uint32_t kBindId = 8;
+const uint32_t kUseAsyncTts = 9;
+const uint32_t kLocalId = 10;
+const uint32_t kGlobalId = 11;
+const uint32_t kBindToEnclosing = 12;
+const uint32_t kFlowDirection = 13;
+const uint32_t kInstantEventScope = 14;
+}  // namespace legacy_event
+
+enum WireType { kVarint = 0, kFixed64 = 1, kLengthDelimited = 2 };
+
+void AppendVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendTag(std::string* out, uint32_t field, WireType wire_type) {
+  AppendVarint(out, (field << 3) | wire_type);
+}
+
+void AppendVarintField(std::string* out, uint32_t field, uint64_t value) {
+  AppendTag(out, field, kVarint);
+  AppendVarint(out, value);
+}
+
+void AppendDoubleField(std::string* out, uint32_t field, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  AppendTag(out, field, kFixed64);
+  for (int i = 0; i < 8; i++)
+    out->push_back(static_cast<char>(bits >> (8 * i)));
+}
+
+void AppendBytesField(std::string* out,
+                      uint32_t field,
+                      const char* data,
+                      size_t length) {
+  AppendTag(out, field, kLengthDelimited);
+  AppendVarint(out, length);
+  out->append(data, length);
+}
+
+void AppendBytesField(std::string* out,
+                      uint32_t field,
+                      const std::string& data) {
+  AppendBytesField(out, field, data.data(), data.size());
+}
+
+void AppendStringField(std::string* out, uint32_t field, const char* str) {
+  if (str == nullptr)
+    str = "";
+  AppendBytesField(out, field, str, strlen(str));
+}
+
+const char* StringArg(TraceObject* trace_event, int index) {
+  if (trace_event->num_args() <= index)
+    return nullptr;
+  const uint8_t type = trace_event->arg_types()[index];
+  if (type != TRACE_VALUE_TYPE_STRING && type != TRACE_VALUE_TYPE_COPY_STRING)
+    return nullptr;
+  return trace_event->arg_values()[index].as_string;
+}
+
+}  // anonymous namespace
+
+PerfettoTraceWriter::PerfettoTraceWriter(std::ostream& stream)
+    : stream_(stream) {}
+
+uint64_t PerfettoTraceWriter::Intern(InternTable* table,
+                                     uint32_t field,
+                                     const char* name) {
+  if (name == nullptr)
+    name = "";
+  auto it = table->find(name);
+  if (it != table->end())
+    return it->second;
+  // Interning ids start at 1, 0 means "not set".
+  const uint64_t iid = table->size() + 1;
+  table->emplace(name, iid);
+  message_.clear();
+  AppendVarintField(&message_, interned_string::kIid, iid);
+  AppendStringField(&message_, interned_string::kName, name);
+  AppendBytesField(&interned_data_, field, message_);
+  return iid;
+}
+
+void PerfettoTraceWriter::WritePacket() {
+  std::string header;
+  AppendTag(&header, trace::kPacket, kLengthDelimited);
+  AppendVarint(&header, packet_.size());
+  stream_.write(header.data(), header.size());
+  stream_.write(packet_.data(), packet_.size());
+}
+
+PerfettoTraceWriter::Sequence* PerfettoTraceWriter::StartSequence(
+    int pid, int tid, int64_t ts, int64_t tts) {
+  Sequence* sequence = &sequences_[tid];
+  sequence->id = next_sequence_id_++;
+  sequence->last_ts = ts;
+  sequence->last_tts = tts;
+  sequence->categories.clear();
+  sequence->event_names.clear();
+  sequence->annotation_names.clear();
+
+  message_.clear();
+  AppendVarintField(&message_, thread_descriptor::kPid, pid);
+  AppendVarintField(&message_, thread_descriptor::kTid, tid);
+  auto name = thread_names_.find(tid);
+  if (name != thread_names_.end())
+    AppendBytesField(&message_, thread_descriptor::kThreadName, name->second);
+  AppendVarintField(&message_, thread_descriptor::kReferenceTimestampUs, ts);
+  AppendVarintField(&message_, thread_descriptor::kReferenceThreadTimeUs, tts);
+
+  packet_.clear();
+  AppendVarintField(&packet_, trace_packet::kTrustedPacketSequenceId,
+                    sequence->id);
+  AppendVarintField(&packet_, trace_packet::kSequenceFlags,
+                    trace_packet::kIncrementalStateCleared);
+  AppendBytesField(&packet_, trace_packet::kThreadDescriptor, message_);
+  WritePacket();
+  return sequence;
+}
+
+void PerfettoTraceWriter::AppendProcessName(Sequence* sequence,
+                                            int pid,
+                                            const char* name) {
+  message_.clear();
+  AppendVarintField(&message_, process_descriptor::kPid, pid);
+  AppendStringField(&message_, process_descriptor::kProcessName, name);
+  packet_.clear();
+  AppendVarintField(&packet_, trace_packet::kTrustedPacketSequenceId,
+                    sequence->id);
+  AppendBytesField(&packet_, trace_packet::kProcessDescriptor, message_);
+  WritePacket();
+}
+
+void PerfettoTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  const int pid = trace_event->pid();
+  const int tid = trace_event->tid();
+  const char phase = trace_event->phase();
+  const int64_t ts = trace_event->ts();
+  const int64_t tts = trace_event->tts();
+
+  // Thread and process names are part of the descriptors in Perfetto.
+  // Agent::Flush() appends the metadata events again on every flush, so only
+  // names that are new or have changed are written; a thread descriptor
+  // starts a new sequence, which also resets the interned data.
+  if (phase == TRACE_EVENT_PHASE_METADATA) {
+    const char* value = StringArg(trace_event, 0);
+    if (value != nullptr && strcmp(trace_event->name(), "thread_name") == 0) {
+      auto name = thread_names_.find(tid);
+      if (name != thread_names_.end() && name->second == value)
+        return;
+      thread_names_[tid] = value;
+      StartSequence(pid, tid, ts, tts);
+      return;
+    }
+    if (value != nullptr && strcmp(trace_event->name(), "process_name") == 0) {
+      auto name = process_names_.find(pid);
+      if (name != process_names_.end() && name->second == value)
+        return;
+      process_names_[pid] = value;
+      auto it = sequences_.find(tid);
+      AppendProcessName(it != sequences_.end() ?
+                            &it->second : StartSequence(pid, tid, ts, tts),
+                        pid, value);
+      return;
+    }
+  }
+
+  auto it = sequences_.find(tid);
+  Sequence* sequence = it != sequences_.end() ?
+      &it->second : StartSequence(pid, tid, ts, tts);
+
+  interned_data_.clear();
+  track_event_.clear();
+  AppendVarintField(&track_event_, track_event::kTimestampDeltaUs,
+                    ts - sequence->last_ts);
+  AppendVarintField(&track_event_, track_event::kThreadTimeDeltaUs,
+                    tts - sequence->last_tts);
+  sequence->last_ts = ts;
+  sequence->last_tts = tts;
+  AppendVarintField(
+      &track_event_, track_event::kCategoryIids,
+      Intern(&sequence->categories, interned_data::kEventCategories,
+             TracingController::GetCategoryGroupName(
+                 trace_event->category_enabled_flag())));
+  AppendVarintField(
+      &track_event_, track_event::kNameIid,
+      Intern(&sequence->event_names, interned_data::kEventNames,
+             trace_event->name()));
+
+  const char** arg_names = trace_event->arg_names();
+  const uint8_t* arg_types = trace_event->arg_types();
+  TraceObject::ArgValue* arg_values = trace_event->arg_values();
+  for (int i = 0; i < trace_event->num_args(); ++i) {
+    std::string annotation;
+    AppendVarintField(
+        &annotation, debug_annotation::kNameIid,
+        Intern(&sequence->annotation_names,
+               interned_data::kDebugAnnotationNames, arg_names[i]));
+    const TraceObject::ArgValue& value = arg_values[i];
+    switch (arg_types[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        AppendVarintField(&annotation, debug_annotation::kBoolValue,
+                          value.as_bool);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        AppendVarintField(&annotation, debug_annotation::kUintValue,
+                          value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        AppendVarintField(&annotation, debug_annotation::kIntValue,
+                          value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        AppendDoubleField(&annotation, debug_annotation::kDoubleValue,
+                          value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        AppendVarintField(&annotation, debug_annotation::kPointerValue,
+                          reinterpret_cast<uintptr_t>(value.as_pointer));
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        AppendStringField(&annotation, debug_annotation::kStringValue,
+                          value.as_string);
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        trace_event->arg_convertables()[i]->AppendAsTraceFormat(&json);
+        AppendBytesField(&annotation, debug_annotation::kLegacyJsonValue,
+                         json);
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+    AppendBytesField(&track_event_, track_event::kDebugAnnotations,
+                     annotation);
+  }
+
+  const unsigned int flags = trace_event->flags();
+  message_.clear();
+  AppendVarintField(&message_, legacy_event::kPhase, phase);
+  if (phase == TRACE_EVENT_PHASE_COMPLETE) {
+    AppendVarintField(&message_, legacy_event::kDurationUs,
+                      trace_event->duration());
+    AppendVarintField(&message_, legacy_event::kThreadDurationUs,
+                      trace_event->cpu_duration());
+  }
+  if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    if (trace_event->scope() != nullptr) {
+      AppendStringField(&message_, legacy_event::kIdScope,
+                        trace_event->scope());
+    }
+    AppendVarintField(&message_, legacy_event::kUnscopedId, trace_event->id());
+  } else if (flags & TRACE_EVENT_FLAG_HAS_LOCAL_ID) {
+    AppendVarintField(&message_, legacy_event::kLocalId, trace_event->id());
+  } else if (flags & TRACE_EVENT_FLAG_HAS_GLOBAL_ID) {
+    AppendVarintField(&message_, legacy_event::kGlobalId, trace_event->id());
+  }
+  if (flags & (TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT)) {
+    AppendVarintField(&message_, legacy_event::kBindId,
+                      trace_event->bind_id());
+    // FLOW_IN = 1, FLOW_OUT = 2, FLOW_INOUT = 3.
+    AppendVarintField(&message_, legacy_event::kFlowDirection,
+                      ((flags & TRACE_EVENT_FLAG_FLOW_IN) ? 1 : 0) |
+                      ((flags & TRACE_EVENT_FLAG_FLOW_OUT) ? 2 : 0));
+  }
+  if (flags & TRACE_EVENT_FLAG_ASYNC_TTS)
+    AppendVarintField(&message_, legacy_event::kUseAsyncTts, 1);
+  if (flags & TRACE_EVENT_FLAG_BIND_TO_ENCLOSING)
+    AppendVarintField(&message_, legacy_event::kBindToEnclosing, 1);
+  if (phase == TRACE_EVENT_PHASE_INSTANT) {
+    // SCOPE_GLOBAL = 1, SCOPE_PROCESS = 2, SCOPE_THREAD = 3.
+    const unsigned int scope = flags & TRACE_EVENT_FLAG_SCOPE_MASK;
+    AppendVarintField(&message_, legacy_event::kInstantEventScope,
+                      scope == TRACE_EVENT_SCOPE_GLOBAL ? 1 :
+                      scope == TRACE_EVENT_SCOPE_PROCESS ? 2 : 3);
+  }
+  AppendBytesField(&track_event_, track_event::kLegacyEvent, message_);
+
+  packet_.clear();
+  AppendVarintField(&packet_, trace_packet::kTrustedPacketSequenceId,
+                    sequence->id);
+  AppendVarintField(&packet_, trace_packet::kSequenceFlags,
+                    trace_packet::kNeedsIncrementalState);
+  if (!interned_data_.empty())
+    AppendBytesField(&packet_, trace_packet::kInternedData, interned_data_);
+  AppendBytesField(&packet_, trace_packet::kTrackEvent, track_event_);
+  WritePacket();
+}
+
+void PerfettoTraceWriter::Flush() {}
+
+}  // namespace tracing
+}  // namespace node
@@ -0,0 +1,67 @@
+#ifndef SRC_TRACING_PERFETTO_TRACE_WRITER_H_
+#define SRC_TRACING_PERFETTO_TRACE_WRITER_H_
+
+#include "libplatform/v8-tracing.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Serializes trace events in the protobuf format of Perfetto and Chrome
+// (perfetto.protos.Trace), as an alternative to V8's JSONTraceWriter.
+//
+// Each thread is written as a packet sequence of its own. Categories, event
+// names and argument names are interned per sequence, and timestamps are
+// encoded as deltas from the previous event of the same thread. The trace
+// events keep their Chrome JSON semantics through TrackEvent.LegacyEvent,
+// which Perfetto and chrome://tracing both understand.
+class PerfettoTraceWriter : public TraceWriter {
+ public:
+  explicit PerfettoTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override;
+
+ private:
+  typedef std::unordered_map<std::string, uint64_t> InternTable;
+
+  struct Sequence {
+    uint32_t id = 0;
+    int64_t last_ts = 0;
+    int64_t last_tts = 0;
+    InternTable categories;
+    InternTable event_names;
+    InternTable annotation_names;
+  };
+
+  Sequence* StartSequence(int pid, int tid, int64_t ts, int64_t tts);
+  void AppendProcessName(Sequence* sequence, int pid, const char* name);
+  void WritePacket();
+
+  // Appends to `interned_data_` if `name` has not been seen on the sequence.
+  uint64_t Intern(InternTable* table, uint32_t field, const char* name);
+
+  std::ostream& stream_;
+  uint32_t next_sequence_id_ = 1;
+  std::unordered_map<int, Sequence> sequences_;
+  // The names that have been written, by thread and process id.
+  std::unordered_map<int, std::string> thread_names_;
+  std::unordered_map<int, std::string> process_names_;
+  // Scratch space for the message that is being built.
+  std::string packet_;
+  std::string interned_data_;
+  std::string track_event_;
+  std::string message_;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_PERFETTO_TRACE_WRITER_H_
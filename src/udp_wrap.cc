@@ -26,6 +26,13 @@
 #include "req_wrap-inl.h"
 #include "util-inl.h"
 
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <cerrno>
+#endif
+
 namespace node {
 
 using v8::Array;
@@ -119,6 +126,8 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendBatch", SendBatch);
+  env->SetProtoMethod(t, "sendBatch6", SendBatch6);
   env->SetProtoMethod(t, "disconnect", Disconnect);
   env->SetProtoMethod(t, "recvStart", RecvStart);
   env->SetProtoMethod(t, "recvStop", RecvStop);
@@ -488,11 +497,128 @@ void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// The number of datagrams that are passed to a single sendmmsg() call, which
+// is also the limit of the kernel.
+static const uint32_t kSendBatchSize = 1024;
+
+
+void UDPWrap::DoSendBatch(const FunctionCallbackInfo<Value>& args,
+                          int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  // sendBatch(list, list.length[, ports, ips])
+  CHECK(args.Length() == 2 || args.Length() == 4);
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsUint32());
+  const bool sendto = args.Length() == 4;
+  if (sendto) {
+    CHECK(args[2]->IsArray());
+    CHECK(args[3]->IsArray());
+  }
+
+  // Returns the number of datagrams that were sent right away. The caller
+  // sends the rest, if any, through send(), so that they are queued and
+  // errors are reported for them. Datagrams are only sent here if none are
+  // queued already, to keep them in order.
+  uint32_t sent = 0;
+#ifdef __linux__
+  const uint32_t count = args[1].As<Uint32>()->Value();
+  uv_os_fd_t fd;
+  if (count == 0 ||
+      wrap->handle_.send_queue_count != 0 ||
+      uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd) != 0) {
+    return args.GetReturnValue().Set(0);
+  }
+
+  Local<Array> chunks = args[0].As<Array>();
+  Local<Array> ports = sendto ? args[2].As<Array>() : Local<Array>();
+  Local<Array> ips = sendto ? args[3].As<Array>() : Local<Array>();
+  const uint32_t batch_size = std::min(count, kSendBatchSize);
+  MaybeStackBuffer<struct mmsghdr, 64> messages(batch_size);
+  MaybeStackBuffer<struct iovec, 64> iovs(batch_size);
+  MaybeStackBuffer<struct sockaddr_storage, 64> addrs(sendto ? batch_size : 0);
+  // Most batches go to a single destination, so the last address is reused
+  // as long as the IP and port do not change.
+  Local<Value> last_ip;
+  uint32_t last_port = 0;
+  struct sockaddr_storage last_addr;
+
+  while (sent < count) {
+    uint32_t n = 0;
+    for (; n < std::min(count - sent, batch_size); n++) {
+      Local<Value> chunk =
+          chunks->Get(env->context(), sent + n).ToLocalChecked();
+      iovs[n].iov_base = Buffer::Data(chunk);
+      iovs[n].iov_len = Buffer::Length(chunk);
+      memset(&messages[n], 0, sizeof(messages[n]));
+      messages[n].msg_hdr.msg_iov = &iovs[n];
+      messages[n].msg_hdr.msg_iovlen = 1;
+      if (!sendto)
+        continue;
+
+      Local<Value> ip = ips->Get(env->context(), sent + n).ToLocalChecked();
+      Local<Value> port_value =
+          ports->Get(env->context(), sent + n).ToLocalChecked();
+      CHECK(ip->IsString());
+      CHECK(port_value->IsUint32());
+      const uint32_t port = port_value.As<Uint32>()->Value();
+      if (last_ip.IsEmpty() ||
+          port != last_port ||
+          !ip->StrictEquals(last_ip)) {
+        node::Utf8Value address(env->isolate(), ip);
+        // Let send() report the error.
+        if (sockaddr_for_family(family, address.out(), port, &last_addr) != 0)
+          break;
+        last_ip = ip;
+        last_port = port;
+      }
+      addrs[n] = last_addr;
+      messages[n].msg_hdr.msg_name = &addrs[n];
+      messages[n].msg_hdr.msg_namelen = family == AF_INET6 ?
+          sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    }
+    if (n == 0)
+      break;
+
+    int r;
+    do {
+      r = sendmmsg(fd, *messages, n, 0);
+    } while (r == -1 && errno == EINTR);
+    // On errors, including a full socket buffer, the remaining datagrams are
+    // sent through send().
+    if (r <= 0)
+      break;
+    sent += r;
+    if (static_cast<uint32_t>(r) < n)
+      break;
+  }
+#endif  // __linux__
+
+  args.GetReturnValue().Set(sent);
+}
+
+
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET);
+}
+
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET6);
+}
+
+
 void UDPWrap::RecvStart(const FunctionCallbackInfo<Value>& args) {
   UDPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
                           args.Holder(),
                           args.GetReturnValue().Set(UV_EBADF));
+  wrap->recv_batch_ = args[0]->IsTrue();
   int err = uv_udp_recv_start(&wrap->handle_, OnAlloc, OnRecv);
   // UV_EALREADY means that the socket is already bound but that's okay
   if (err == UV_EALREADY)
@@ -565,9 +691,75 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   buf.Resize(nread);
   argv[2] = buf.ToBuffer().ToLocalChecked();
   argv[3] = AddressToJS(env, addr);
+
+  if (wrap->recv_batch_) {
+    Local<Array> buffers = Array::New(env->isolate());
+    Local<Array> addresses = Array::New(env->isolate());
+    buffers->Set(env->context(), 0, argv[2]).Check();
+    addresses->Set(env->context(), 0, argv[3]).Check();
+    wrap->ReadBatch(buffers, addresses, 1);
+    argv[2] = buffers;
+    argv[3] = addresses;
+  }
   wrap->MakeCallback(env->onmessage_string(), arraysize(argv), argv);
 }
 
+// The number of datagrams that are read with a single recvmmsg() call, and
+// the size of the buffer for each, which fits any datagram.
+static const size_t kRecvBatchSize = 32;
+static const size_t kRecvBatchSlotSize = 64 * 1024;
+
+void UDPWrap::ReadBatch(Local<Array> buffers,
+                        Local<Array> addresses,
+                        uint32_t index) {
+#ifdef __linux__
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd) != 0)
+    return;
+
+  // The storage is only touched as far as datagrams are written to it, so
+  // most of it never becomes resident.
+  if (recv_batch_storage_.is_empty()) {
+    recv_batch_storage_ = MallocedBuffer<char>(
+        kRecvBatchSize * kRecvBatchSlotSize);
+  }
+
+  struct mmsghdr messages[kRecvBatchSize];
+  struct iovec iovs[kRecvBatchSize];
+  struct sockaddr_storage addrs[kRecvBatchSize];
+  for (size_t i = 0; i < kRecvBatchSize; i++) {
+    iovs[i].iov_base = recv_batch_storage_.data + i * kRecvBatchSlotSize;
+    iovs[i].iov_len = kRecvBatchSlotSize;
+    memset(&messages[i], 0, sizeof(messages[i]));
+    messages[i].msg_hdr.msg_iov = &iovs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    messages[i].msg_hdr.msg_name = &addrs[i];
+    messages[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+  }
+
+  int r;
+  do {
+    r = recvmmsg(fd, messages, kRecvBatchSize, MSG_DONTWAIT, nullptr);
+  } while (r == -1 && errno == EINTR);
+  // Errors are left for libuv to report on its next read.
+  for (int i = 0; i < r; i++) {
+    Local<Object> buffer;
+    if (!Buffer::Copy(env(),
+                      static_cast<char*>(iovs[i].iov_base),
+                      messages[i].msg_len).ToLocal(&buffer)) {
+      return;
+    }
+    buffers->Set(env()->context(), index, buffer).Check();
+    addresses->Set(env()->context(),
+                   index,
+                   AddressToJS(env(),
+                               reinterpret_cast<sockaddr*>(&addrs[i])))
+        .Check();
+    index++;
+  }
+#endif  // __linux__
+}
+
 MaybeLocal<Object> UDPWrap::Instantiate(Environment* env,
                                         AsyncWrap* parent,
                                         UDPWrap::SocketType type) {
@@ -50,6 +50,8 @@ class UDPWrap: public HandleWrap {
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStart(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStop(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -86,6 +88,8 @@ class UDPWrap: public HandleWrap {
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
 
@@ -98,8 +102,17 @@ class UDPWrap: public HandleWrap {
                      const uv_buf_t* buf,
                      const struct sockaddr* addr,
                      unsigned int flags);
+  // Reads the datagrams that are waiting on the socket into `buffers` and
+  // `addresses`, starting at `index`, with as few system calls as possible.
+  void ReadBatch(v8::Local<v8::Array> buffers,
+                 v8::Local<v8::Array> addresses,
+                 uint32_t index);
 
   uv_udp_t handle_;
+  // Set by recvStart(true), in which case every call to onmessage receives an
+  // array of the datagrams that were read together.
+  bool recv_batch_ = false;
+  MallocedBuffer<char> recv_batch_storage_;
 };
 
 }  // namespace node
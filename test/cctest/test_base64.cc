@@ -1,7 +1,10 @@
 #include "base64.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -125,3 +128,40 @@ TEST(Base64Test, Decode) {
        "dCBjdXBpZGF0YXQgbm9uIHByb2lkZW50LCBzdW50IGluIGN1bHBhIHF1aSBvZmZpY2lh\n"
        "IGRlc2VydW50IG1vbGxpdCBhbmltIGlkIGVzdCBsYWJvcnVtLg", text);
 }
+
+TEST(Base64Test, RoundTrip) {
+  // Long enough to go through the vectorized kernels, with every possible
+  // tail length and a mix of both alphabets.
+  std::string data;
+  for (size_t i = 0; i < 300; i++)
+    data.push_back(static_cast<char>(i * 37 + 11));
+
+  for (size_t len = 0; len <= data.size(); len++) {
+    std::string encoded(node::base64_encoded_size(len), '\0');
+    base64_encode(data.data(), len, &encoded[0], encoded.size());
+
+    std::string decoded(len, '\0');
+    EXPECT_EQ(len, base64_decode(&decoded[0], len,
+                                 encoded.data(), encoded.size()));
+    EXPECT_EQ(data.substr(0, len), decoded);
+
+    std::string url = encoded;
+    std::replace(url.begin(), url.end(), '+', '-');
+    std::replace(url.begin(), url.end(), '/', '_');
+    std::fill(decoded.begin(), decoded.end(), '\0');
+    EXPECT_EQ(len, base64_decode(&decoded[0], len, url.data(), url.size()));
+    EXPECT_EQ(data.substr(0, len), decoded);
+
+    // Two-byte input takes the scalar path and must agree.
+    std::vector<uint16_t> wide(encoded.begin(), encoded.end());
+    std::fill(decoded.begin(), decoded.end(), '\0');
+    EXPECT_EQ(len, base64_decode(&decoded[0], len, wide.data(), wide.size()));
+    EXPECT_EQ(data.substr(0, len), decoded);
+
+    // Decoding stops at the same place with a short destination.
+    std::string partial(len / 2, '\0');
+    EXPECT_EQ(len / 2, base64_decode(&partial[0], partial.size(),
+                                     encoded.data(), encoded.size()));
+    EXPECT_EQ(data.substr(0, len / 2), partial);
+  }
+}
@@ -0,0 +1,152 @@
+#include "node_dns_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::DnsCache;
+
+namespace {
+
+const uint64_t kSecond = 1000 * 1000 * 1000;
+
+DnsCache::Entry MakeEntry(int status, const std::string& address) {
+  DnsCache::Entry entry;
+  entry.status = status;
+  if (status == 0)
+    entry.addresses.push_back(address);
+  return entry;
+}
+
+// A response to a query for a.io with the given answer and authority
+// records, which only consist of their fixed fields and data.
+std::vector<unsigned char> MakeResponse(
+    const std::vector<std::pair<uint16_t, uint32_t>>& answers,
+    const std::vector<std::pair<uint16_t, uint32_t>>& authorities,
+    uint32_t soa_minimum) {
+  std::vector<unsigned char> buf = {
+    0, 1, 0x81, 0x80, 0, 1, 0, static_cast<unsigned char>(answers.size()),
+    0, static_cast<unsigned char>(authorities.size()), 0, 0,
+    1, 'a', 2, 'i', 'o', 0, 0, 1, 0, 1
+  };
+  auto add = [&](uint16_t type, uint32_t ttl) {
+    // A pointer to the name in the question.
+    buf.insert(buf.end(), { 0xc0, 12, 0, static_cast<unsigned char>(type),
+                            0, 1 });
+    for (int shift = 24; shift >= 0; shift -= 8)
+      buf.push_back(static_cast<unsigned char>(ttl >> shift));
+    if (type != 6) {
+      buf.insert(buf.end(), { 0, 4, 127, 0, 0, 1 });
+      return;
+    }
+    // Root names for the primary server and the mailbox, followed by five
+    // 32-bit numbers of which the last one is the minimum TTL.
+    buf.insert(buf.end(), { 0, 22, 0, 0 });
+    buf.insert(buf.end(), 16, 0);
+    for (int shift = 24; shift >= 0; shift -= 8)
+      buf.push_back(static_cast<unsigned char>(soa_minimum >> shift));
+  };
+  for (const auto& record : answers)
+    add(record.first, record.second);
+  for (const auto& record : authorities)
+    add(record.first, record.second);
+  return buf;
+}
+
+}  // anonymous namespace
+
+TEST(DnsCacheTest, ExpiresEntries) {
+  DnsCache cache(60);
+  DnsCache::Entry entry;
+  EXPECT_FALSE(cache.Lookup("a", 0, &entry));
+
+  cache.Insert("a", MakeEntry(0, "127.0.0.1"), 10, 0);
+  ASSERT_TRUE(cache.Lookup("a", 9 * kSecond, &entry));
+  EXPECT_EQ(entry.addresses, std::vector<std::string> { "127.0.0.1" });
+  EXPECT_FALSE(cache.Lookup("a", 10 * kSecond, &entry));
+
+  // The TTL is capped at the maximum, and 0 means not to cache.
+  cache.Insert("a", MakeEntry(0, "127.0.0.1"), 3600, 0);
+  EXPECT_TRUE(cache.Lookup("a", 59 * kSecond, &entry));
+  EXPECT_FALSE(cache.Lookup("a", 60 * kSecond, &entry));
+  cache.Insert("b", MakeEntry(0, "127.0.0.1"), 0, 0);
+  EXPECT_FALSE(cache.Lookup("b", 0, &entry));
+
+  DnsCache::Stats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 4u);
+  EXPECT_EQ(stats.entries, 0u);
+}
+
+TEST(DnsCacheTest, LimitsNegativeEntries) {
+  DnsCache cache(3600);
+  DnsCache::Entry entry;
+  cache.Insert("a", MakeEntry(-3008, ""), 3600, 0);
+  ASSERT_TRUE(cache.Lookup("a", 0, &entry));
+  EXPECT_EQ(entry.status, -3008);
+  EXPECT_FALSE(cache.Lookup("a", DnsCache::kMaxNegativeTtl * kSecond, &entry));
+}
+
+TEST(DnsCacheTest, EvictsEntriesThatExpireFirst) {
+  DnsCache cache(3600);
+  for (size_t i = 0; i < DnsCache::kMaxEntries; i++)
+    cache.Insert(std::to_string(i), MakeEntry(0, "127.0.0.1"), 100 + i, 0);
+  cache.Insert("new", MakeEntry(0, "127.0.0.1"), 50, 0);
+
+  DnsCache::Entry entry;
+  EXPECT_EQ(cache.stats().entries, DnsCache::kMaxEntries);
+  EXPECT_FALSE(cache.Lookup("0", 0, &entry));
+  EXPECT_TRUE(cache.Lookup("1", 0, &entry));
+  EXPECT_TRUE(cache.Lookup("new", 0, &entry));
+
+  cache.Clear();
+  EXPECT_EQ(cache.stats().entries, 0u);
+}
+
+TEST(DnsCacheTest, ResponseTtl) {
+  std::vector<unsigned char> buf = MakeResponse({ {1, 300}, {1, 20} }, {}, 0);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size()), 20u);
+
+  // Negative answers use the smaller of the TTL and the minimum of the SOA.
+  buf = MakeResponse({}, { {6, 900}, {2, 10} }, 60);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size()), 60u);
+  buf = MakeResponse({}, { {6, 45} }, 60);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size()), 45u);
+  buf = MakeResponse({}, { {2, 10} }, 0);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size()), 0u);
+
+  // TTLs with the highest bit set count as 0.
+  buf = MakeResponse({ {1, 0x80000000} }, {}, 0);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size()), 0u);
+
+  buf = MakeResponse({ {1, 300} }, {}, 0);
+  EXPECT_EQ(DnsCache::ResponseTtl(buf.data(), buf.size() - 1), 0u);
+}
+
+TEST(DnsCacheTest, AgesCachedResponses) {
+  DnsCache cache(3600);
+  std::vector<unsigned char> buf = MakeResponse({ {1, 300}, {1, 20} }, {}, 0);
+  DnsCache::Entry entry;
+  entry.answer.assign(buf.begin(), buf.end());
+  cache.Insert("a", std::move(entry), 20, 5 * kSecond);
+
+  // The TTLs are those that remain when the response is taken from the
+  // cache, rounded up to whole seconds.
+  ASSERT_TRUE(cache.Lookup("a", 5 * kSecond, &entry));
+  EXPECT_EQ(entry.answer, std::string(buf.begin(), buf.end()));
+  ASSERT_TRUE(cache.Lookup("a", 20 * kSecond + kSecond / 2, &entry));
+  const unsigned char* answer =
+      reinterpret_cast<const unsigned char*>(entry.answer.data());
+  EXPECT_EQ(DnsCache::ResponseTtl(answer, entry.answer.size()), 5u);
+  std::vector<unsigned char> expected =
+      MakeResponse({ {1, 285}, {1, 5} }, {}, 0);
+  EXPECT_EQ(entry.answer, std::string(expected.begin(), expected.end()));
+
+  // TTLs do not go below 0.
+  buf = MakeResponse({ {1, 300}, {1, 20}, {1, 0x80000000} }, {}, 0);
+  EXPECT_TRUE(DnsCache::AgeResponse(buf.data(), buf.size(), 30));
+  expected = MakeResponse({ {1, 270}, {1, 0}, {1, 0} }, {}, 0);
+  EXPECT_EQ(buf, expected);
+  EXPECT_FALSE(DnsCache::AgeResponse(buf.data(), buf.size() - 1, 30));
+}
@@ -0,0 +1,78 @@
+#include "node_huge_page_pool.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using node::HugePagePool;
+
+class HugePagePoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!HugePagePool::IsSupported())
+      GTEST_SKIP();
+  }
+
+  HugePagePool pool;
+};
+
+TEST_F(HugePagePoolTest, AllocatesAlignedBlocks) {
+  const size_t size = HugePagePool::kHugePageSize + 1;
+  char* data = static_cast<char*>(pool.Allocate(size, true));
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % HugePagePool::kHugePageSize,
+            0u);
+  EXPECT_EQ(data[0], 0);
+  EXPECT_EQ(data[size - 1], 0);
+  EXPECT_EQ(pool.total_bytes(), 2 * HugePagePool::kHugePageSize);
+  EXPECT_TRUE(pool.Free(data));
+  EXPECT_EQ(pool.total_bytes(), 2 * HugePagePool::kHugePageSize);
+}
+
+TEST_F(HugePagePoolTest, ReusesBlocksOfTheSameCapacity) {
+  const size_t size = HugePagePool::kHugePageSize;
+  char* data = static_cast<char*>(pool.Allocate(size, false));
+  ASSERT_NE(data, nullptr);
+  memset(data, 'x', size);
+  EXPECT_TRUE(pool.Free(data));
+
+  // A block of a different capacity is not reused.
+  void* larger = pool.Allocate(3 * size, false);
+  EXPECT_NE(larger, data);
+  EXPECT_EQ(pool.total_bytes(), 4 * size);
+
+  char* reused = static_cast<char*>(pool.Allocate(size, true));
+  EXPECT_EQ(reused, data);
+  EXPECT_EQ(reused[0], 0);
+  EXPECT_EQ(reused[size - 1], 0);
+  EXPECT_EQ(pool.total_bytes(), 4 * size);
+
+  EXPECT_TRUE(pool.Free(reused));
+  EXPECT_TRUE(pool.Free(larger));
+}
+
+TEST_F(HugePagePoolTest, LimitsCachedMemory) {
+  const size_t size = HugePagePool::kMaxCachedBytes;
+  void* first = pool.Allocate(size, false);
+  void* second = pool.Allocate(size, false);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_TRUE(pool.Free(first));
+  EXPECT_TRUE(pool.Free(second));
+  EXPECT_EQ(pool.total_bytes(), size);
+}
+
+TEST_F(HugePagePoolTest, IgnoresForeignAndReleasedBlocks) {
+  void* foreign = malloc(HugePagePool::kHugePageSize);
+  EXPECT_FALSE(pool.Free(foreign));
+  free(foreign);
+
+  void* data = pool.Allocate(HugePagePool::kHugePageSize, false);
+  ASSERT_NE(data, nullptr);
+  pool.Release(data);
+  EXPECT_EQ(pool.total_bytes(), 0u);
+  EXPECT_FALSE(pool.Free(data));
+  free(data);
+}
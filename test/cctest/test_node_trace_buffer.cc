@@ -0,0 +1,354 @@
+#include "tracing/agent.h"
+#include "tracing/node_trace_buffer.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using node::Mutex;
+using node::tracing::Agent;
+using node::tracing::AgentWriterHandle;
+using node::tracing::AsyncTraceWriter;
+using node::tracing::NodeTraceBuffer;
+using node::tracing::TraceObject;
+using node::tracing::TracingController;
+using v8::platform::tracing::TraceBufferChunk;
+using v8::platform::tracing::TraceConfig;
+
+namespace {
+
+const uint8_t kCategoryEnabled = 1;
+
+// Collects the ids and durations of the events that are written out.
+class RecordingWriter : public AsyncTraceWriter {
+ public:
+  RecordingWriter(Mutex* mutex, std::multiset<uint64_t>* ids,
+                  std::multiset<int64_t>* durations)
+      : mutex_(mutex), ids_(ids), durations_(durations) {}
+
+  void AppendTraceEvent(TraceObject* trace_event) override {
+    Mutex::ScopedLock lock(*mutex_);
+    ids_->insert(trace_event->id());
+    durations_->insert(trace_event->duration());
+  }
+
+  void Flush(bool blocking) override {}
+
+ private:
+  Mutex* mutex_;
+  std::multiset<uint64_t>* ids_;
+  std::multiset<int64_t>* durations_;
+};
+
+void InitializeEvent(TraceObject* trace_object, uint64_t id) {
+  trace_object->Initialize('I', &kCategoryEnabled, "event", nullptr, id, 0,
+                           0, nullptr, nullptr, nullptr, nullptr, 0, 0, 0);
+}
+
+// Adds an event to `buffer` and returns its handle.
+uint64_t AddEvent(NodeTraceBuffer* buffer, uint64_t id) {
+  uint64_t handle;
+  TraceObject* trace_object = buffer->AddTraceEvent(&handle);
+  EXPECT_NE(trace_object, nullptr);
+  if (trace_object == nullptr)
+    return 0;
+  InitializeEvent(trace_object, id);
+  buffer->CommitTraceEvent(handle);
+  return handle;
+}
+
+struct AddEventsData {
+  NodeTraceBuffer* buffer;
+  uint64_t first_id;
+  size_t count;
+};
+
+void AddEvents(void* arg) {
+  AddEventsData* data = static_cast<AddEventsData*>(arg);
+  for (size_t i = 0; i < data->count; i++)
+    AddEvent(data->buffer, data->first_id + i);
+}
+
+}  // anonymous namespace
+
+class NodeTraceBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    agent_ = std::make_unique<Agent>();
+    writer_handle_ = agent_->AddClient(
+        { "test" },
+        std::make_unique<RecordingWriter>(&ids_mutex_, &ids_, &durations_),
+        Agent::kIgnoreDefaultCategories);
+    ASSERT_EQ(0, uv_loop_init(&loop_));
+  }
+
+  void TearDown() override {
+    // Deleting the buffers closes their handles, which ends the loop.
+    buffers_.clear();
+    if (loop_running_)
+      ASSERT_EQ(0, uv_thread_join(&loop_thread_));
+    ASSERT_EQ(0, uv_loop_close(&loop_));
+    writer_handle_.reset();
+    agent_.reset();
+  }
+
+  // Creates `count` buffers that flush on a thread of their own. Buffers
+  // initialize handles on the loop, so they are all created up front.
+  void CreateBuffers(size_t count, size_t max_chunks) {
+    for (size_t i = 0; i < count; i++) {
+      buffers_.emplace_back(
+          new NodeTraceBuffer(max_chunks, agent_.get(), &loop_));
+    }
+    ASSERT_EQ(0, uv_thread_create(&loop_thread_, [](void* arg) {
+      uv_run(static_cast<uv_loop_t*>(arg), UV_RUN_DEFAULT);
+    }, &loop_));
+    loop_running_ = true;
+  }
+
+  std::multiset<uint64_t> ids() {
+    Mutex::ScopedLock lock(ids_mutex_);
+    return ids_;
+  }
+
+  std::multiset<int64_t> durations() {
+    Mutex::ScopedLock lock(ids_mutex_);
+    return durations_;
+  }
+
+  std::unique_ptr<Agent> agent_;
+  AgentWriterHandle writer_handle_;
+  Mutex ids_mutex_;
+  std::multiset<uint64_t> ids_;
+  std::multiset<int64_t> durations_;
+  uv_loop_t loop_;
+  uv_thread_t loop_thread_;
+  bool loop_running_ = false;
+  std::vector<std::unique_ptr<NodeTraceBuffer>> buffers_;
+};
+
+TEST_F(NodeTraceBufferTest, ConcurrentAddAndFlush) {
+  CreateBuffers(1, NodeTraceBuffer::kBufferChunks);
+  NodeTraceBuffer* buffer = buffers_[0].get();
+  const size_t kThreads = 4;
+  const size_t kEventsPerThread = 10000;
+
+  AddEventsData data[kThreads];
+  uv_thread_t threads[kThreads];
+  for (size_t i = 0; i < kThreads; i++) {
+    data[i] = { buffer, i * kEventsPerThread, kEventsPerThread };
+    ASSERT_EQ(0, uv_thread_create(&threads[i], AddEvents, &data[i]));
+  }
+  for (int i = 0; i < 100; i++)
+    buffer->Flush();
+  for (size_t i = 0; i < kThreads; i++)
+    ASSERT_EQ(0, uv_thread_join(&threads[i]));
+  buffer->Flush();
+
+  // Every event is written exactly once, whether its chunk was full, still
+  // being filled, or held by a thread that has exited.
+  std::multiset<uint64_t> written = ids();
+  ASSERT_EQ(written.size(), kThreads * kEventsPerThread);
+  uint64_t expected = 0;
+  for (uint64_t id : written)
+    EXPECT_EQ(id, expected++);
+}
+
+TEST_F(NodeTraceBufferTest, ExitingThreadHandsOffChunk) {
+  CreateBuffers(1, NodeTraceBuffer::kBufferChunks);
+  NodeTraceBuffer* buffer = buffers_[0].get();
+
+  // A few events, so that the thread's chunk is not full when it exits.
+  AddEventsData data = { buffer, 100, TraceBufferChunk::kChunkSize / 2 };
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, AddEvents, &data));
+  ASSERT_EQ(0, uv_thread_join(&thread));
+
+  buffer->Flush();
+  std::multiset<uint64_t> written = ids();
+  ASSERT_EQ(written.size(), data.count);
+  EXPECT_EQ(*written.begin(), 100u);
+  EXPECT_EQ(*written.rbegin(), 100u + data.count - 1);
+
+  // The chunk has been returned to the buffer and can be used again.
+  for (size_t i = 0; i < 2 * NodeTraceBuffer::kBufferChunks; i++) {
+    data.first_id = 1000 + i;
+    data.count = 1;
+    ASSERT_EQ(0, uv_thread_create(&thread, AddEvents, &data));
+    ASSERT_EQ(0, uv_thread_join(&thread));
+    if (i % 100 == 0)
+      buffer->Flush();
+  }
+}
+
+TEST_F(NodeTraceBufferTest, GetEventByHandleAfterFlush) {
+  CreateBuffers(1, NodeTraceBuffer::kBufferChunks);
+  NodeTraceBuffer* buffer = buffers_[0].get();
+  EXPECT_EQ(buffer->GetEventByHandle(0), nullptr);
+
+  // Events of a chunk that is still being filled stay available after they
+  // have been written out.
+  const uint64_t handle = AddEvent(buffer, 1);
+  ASSERT_NE(handle, 0u);
+  TraceObject* trace_object = buffer->GetEventByHandle(handle);
+  ASSERT_NE(trace_object, nullptr);
+  EXPECT_EQ(trace_object->id(), 1u);
+  buffer->Flush();
+  EXPECT_EQ(buffer->GetEventByHandle(handle), trace_object);
+  EXPECT_EQ(ids().count(1), 1u);
+
+  // Once the chunk is full and has been flushed, handles to its events are
+  // stale.
+  for (size_t i = 1; i < TraceBufferChunk::kChunkSize; i++)
+    AddEvent(buffer, 1 + i);
+  const uint64_t next_handle = AddEvent(buffer, 1000);
+  buffer->Flush();
+  EXPECT_EQ(buffer->GetEventByHandle(handle), nullptr);
+  EXPECT_NE(buffer->GetEventByHandle(next_handle), nullptr);
+
+  // Each event is written once, even though the first chunk was flushed
+  // both while it was being filled and once it was full.
+  std::multiset<uint64_t> written = ids();
+  EXPECT_EQ(written.size(), TraceBufferChunk::kChunkSize + 1);
+  EXPECT_EQ(written.count(1), 1u);
+}
+
+TEST_F(NodeTraceBufferTest, UpdateEventDurationAfterFlush) {
+  CreateBuffers(1, NodeTraceBuffer::kBufferChunks);
+  NodeTraceBuffer* buffer = buffers_[0].get();
+
+  // Fill a chunk and start the next one, so that the first one is written
+  // out and its slot is reused for the chunk after that.
+  const uint64_t handle = AddEvent(buffer, 1);
+  buffer->UpdateEventDuration(handle, 10, 10);
+  for (size_t i = 1; i < 2 * TraceBufferChunk::kChunkSize; i++)
+    AddEvent(buffer, 1 + i);
+  buffer->Flush();
+  const uint64_t reused_handle = AddEvent(buffer, 1000);
+  ASSERT_EQ(static_cast<uint32_t>(reused_handle),
+            static_cast<uint32_t>(handle));
+
+  // The stale handle does not refer to the event in the reused slot.
+  buffer->UpdateEventDuration(handle, 20, 20);
+  EXPECT_EQ(buffer->GetEventByHandle(reused_handle)->duration(), 0);
+  buffer->UpdateEventDuration(reused_handle, 30, 30);
+  EXPECT_EQ(buffer->GetEventByHandle(reused_handle)->duration(), 30);
+  EXPECT_EQ(durations().count(10), 1u);
+  EXPECT_EQ(durations().count(20), 0u);
+}
+
+namespace {
+
+struct UpdateDurationsData {
+  NodeTraceBuffer* buffer;
+  std::atomic<uint64_t>* handle;
+  std::atomic<bool>* done;
+};
+
+void UpdateDurations(void* arg) {
+  UpdateDurationsData* data = static_cast<UpdateDurationsData*>(arg);
+  while (!*data->done)
+    data->buffer->UpdateEventDuration(*data->handle, 5, 5);
+}
+
+}  // anonymous namespace
+
+TEST_F(NodeTraceBufferTest, UpdateEventDurationWhileFlushing) {
+  CreateBuffers(1, 4);
+  NodeTraceBuffer* buffer = buffers_[0].get();
+
+  // Another thread updates the last event while chunks are written out,
+  // both once they are full and while they are being filled.
+  std::atomic<uint64_t> handle { 0 };
+  std::atomic<bool> done { false };
+  UpdateDurationsData data = { buffer, &handle, &done };
+  uv_thread_t thread;
+  ASSERT_EQ(0, uv_thread_create(&thread, UpdateDurations, &data));
+  const size_t kEvents = 20 * TraceBufferChunk::kChunkSize;
+  for (size_t i = 0; i < kEvents; i++) {
+    handle = AddEvent(buffer, i);
+    if (i % 50 == 0)
+      buffer->Flush();
+  }
+  done = true;
+  ASSERT_EQ(0, uv_thread_join(&thread));
+  buffer->Flush();
+
+  std::multiset<int64_t> written = durations();
+  ASSERT_EQ(written.size(), kEvents);
+  EXPECT_EQ(written.count(0) + written.count(5), kEvents);
+}
+
+namespace {
+
+struct ControllerData {
+  TracingController* controller;
+  std::atomic<bool>* done;
+  uint64_t id;
+};
+
+void AddControllerEvents(void* arg) {
+  ControllerData* data = static_cast<ControllerData*>(arg);
+  while (!*data->done) {
+    uint64_t handle = data->controller->AddTraceEvent(
+        'X', &kCategoryEnabled, "event", nullptr, data->id, 0, 0, nullptr,
+        nullptr, nullptr, nullptr, 0);
+    data->controller->UpdateTraceEventDuration(&kCategoryEnabled, "event",
+                                               handle);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_F(NodeTraceBufferTest, StopStartCycles) {
+  const size_t kBuffers = 8;
+  CreateBuffers(kBuffers, 16);
+  // The controller owns the buffers it is initialized with.
+  std::vector<NodeTraceBuffer*> buffers;
+  for (auto& buffer : buffers_)
+    buffers.push_back(buffer.release());
+  buffers_.clear();
+
+  TracingController controller;
+  controller.Initialize(buffers[0]);
+
+  // No events are recorded before tracing starts.
+  EXPECT_EQ(controller.AddTraceEvent('I', &kCategoryEnabled, "event",
+                                     nullptr, 1, 0, 0, nullptr, nullptr,
+                                     nullptr, nullptr, 0), 0u);
+  controller.StartTracing(new TraceConfig());
+
+  const size_t kThreads = 4;
+  std::atomic<bool> done { false };
+  ControllerData data[kThreads];
+  uv_thread_t threads[kThreads];
+  for (size_t i = 0; i < kThreads; i++) {
+    data[i] = { &controller, &done, 10 + i };
+    ASSERT_EQ(0, uv_thread_create(&threads[i], AddControllerEvents, &data[i]));
+  }
+
+  // Suspend and resume tracing like Agent does when clients change, and
+  // replace the buffer while threads are adding events to it.
+  for (size_t cycle = 0; cycle < 25 * (kBuffers - 1); cycle++) {
+    controller.StopTracing();
+    controller.StartTracing(new TraceConfig());
+    if (cycle % 25 == 24)
+      controller.Initialize(buffers[cycle / 25 + 1]);
+  }
+  done = true;
+  for (size_t i = 0; i < kThreads; i++)
+    ASSERT_EQ(0, uv_thread_join(&threads[i]));
+
+  // Events added while tracing is stopped are dropped.
+  controller.StopTracing();
+  const size_t written = ids().size();
+  EXPECT_EQ(controller.AddTraceEvent('I', &kCategoryEnabled, "event",
+                                     nullptr, 1, 0, 0, nullptr, nullptr,
+                                     nullptr, nullptr, 0), 0u);
+  buffers[kBuffers - 1]->Flush();
+  EXPECT_EQ(ids().size(), written);
+  EXPECT_EQ(ids().count(1), 0u);
+
+  controller.Initialize(nullptr);
+}
@@ -1,7 +1,10 @@
 #include "node_internals.h"
 #include "libplatform/libplatform.h"
 
+#include <atomic>
+#include <functional>
 #include <string>
+#include <utility>
 #include "gtest/gtest.h"
 #include "node_test_fixture.h"
 
@@ -57,3 +60,129 @@ TEST_F(PlatformTest, SkipNewTasksInFlushForegroundTasks) {
   EXPECT_EQ(3, run_count);
   EXPECT_FALSE(platform->FlushForegroundTasks(isolate_));
 }
+
+// Runs a callback on a worker thread.
+class CallbackTask : public v8::Task {
+ public:
+  explicit CallbackTask(std::function<void()> callback)
+      : callback_(std::move(callback)) {}
+
+  void Run() final { callback_(); }
+
+ private:
+  std::function<void()> callback_;
+};
+
+// Keeps the worker thread that runs it busy until Release() is called.
+class BlockingTask : public v8::Task {
+ public:
+  BlockingTask(uv_sem_t* started, uv_sem_t* release)
+      : started_(started), release_(release) {}
+
+  void Run() final {
+    uv_sem_post(started_);
+    uv_sem_wait(release_);
+  }
+
+ private:
+  uv_sem_t* started_;
+  uv_sem_t* release_;
+};
+
+TEST_F(PlatformTest, WorkerThreadsRunAllTasks) {
+  node::WorkerThreadsTaskRunner runner(4);
+  std::atomic<int> run_count {0};
+  // Tasks that are posted from worker threads go to their own queues.
+  for (int i = 0; i < 100; i++) {
+    runner.PostTask(std::make_unique<CallbackTask>([&]() {
+      run_count++;
+      for (int j = 0; j < 9; j++) {
+        runner.PostTask(std::make_unique<CallbackTask>([&]() {
+          run_count++;
+        }));
+      }
+    }));
+  }
+  runner.BlockingDrain();
+  EXPECT_EQ(run_count, 1000);
+
+  node::WorkerThreadsTaskRunner::Stats stats = runner.GetStats();
+  // The thread that schedules delayed tasks is not one of the workers.
+  EXPECT_EQ(stats.threads, 4u);
+  EXPECT_EQ(runner.NumberOfWorkerThreads(), 5);
+  EXPECT_EQ(stats.tasks_posted, 1000u);
+  runner.Shutdown();
+}
+
+TEST_F(PlatformTest, WorkerThreadsStealTasks) {
+  node::WorkerThreadsTaskRunner runner(4);
+  uv_sem_t started;
+  uv_sem_t release;
+  ASSERT_EQ(0, uv_sem_init(&started, 0));
+  ASSERT_EQ(0, uv_sem_init(&release, 0));
+  runner.PostTask(std::make_unique<BlockingTask>(&started, &release));
+  uv_sem_wait(&started);
+
+  // Tasks are spread over all queues, including that of the blocked thread,
+  // so they can only all run if the other threads steal them.
+  uv_sem_t done;
+  ASSERT_EQ(0, uv_sem_init(&done, 0));
+  for (int i = 0; i < 8; i++)
+    runner.PostTask(std::make_unique<CallbackTask>([&]() {
+      uv_sem_post(&done);
+    }));
+  for (int i = 0; i < 8; i++)
+    uv_sem_wait(&done);
+  EXPECT_GT(runner.GetStats().tasks_stolen, 0u);
+
+  uv_sem_post(&release);
+  runner.BlockingDrain();
+  runner.Shutdown();
+  uv_sem_destroy(&started);
+  uv_sem_destroy(&release);
+  uv_sem_destroy(&done);
+}
+
+TEST_F(PlatformTest, WorkerThreadsRunTasksByPriority) {
+  node::WorkerThreadsTaskRunner runner(1);
+  uv_sem_t started;
+  uv_sem_t release;
+  ASSERT_EQ(0, uv_sem_init(&started, 0));
+  ASSERT_EQ(0, uv_sem_init(&release, 0));
+  runner.PostTask(std::make_unique<BlockingTask>(&started, &release));
+  uv_sem_wait(&started);
+
+  // Only the single worker thread touches `order`.
+  std::string order;
+  using Runner = node::WorkerThreadsTaskRunner;
+  runner.PostTask(std::make_unique<CallbackTask>([&]() { order += "l"; }),
+                  Runner::kBestEffort);
+  runner.PostTask(std::make_unique<CallbackTask>([&]() { order += "v"; }),
+                  Runner::kUserVisible);
+  runner.PostTask(std::make_unique<CallbackTask>([&]() { order += "b"; }),
+                  Runner::kUserBlocking);
+  runner.PostTask(std::make_unique<CallbackTask>([&]() { order += "v"; }),
+                  Runner::kUserVisible);
+  uv_sem_post(&release);
+  runner.BlockingDrain();
+  EXPECT_EQ(order, "bvvl");
+
+  runner.Shutdown();
+  uv_sem_destroy(&started);
+  uv_sem_destroy(&release);
+}
+
+TEST_F(PlatformTest, WorkerThreadsRunDelayedTasks) {
+  node::WorkerThreadsTaskRunner runner(2);
+  uv_sem_t done;
+  ASSERT_EQ(0, uv_sem_init(&done, 0));
+  const uint64_t start = uv_hrtime();
+  runner.PostDelayedTask(std::make_unique<CallbackTask>([&]() {
+    uv_sem_post(&done);
+  }), 0.05);
+  uv_sem_wait(&done);
+  EXPECT_GE(uv_hrtime() - start, 40 * 1000 * 1000u);
+  runner.BlockingDrain();
+  runner.Shutdown();
+  uv_sem_destroy(&done);
+}
@@ -0,0 +1,157 @@
+#include "node_pprof.h"
+#include "gtest/gtest.h"
+#include "zlib.h"
+
+#include <string>
+#include <vector>
+
+using node::pprof::Gzip;
+using node::pprof::ProfileBuilder;
+using node::pprof::SortProfileNames;
+
+namespace {
+
+// Reads the varint at `*pos` of `data`, and moves `*pos` past it.
+uint64_t ReadVarint(const std::string& data, size_t* pos) {
+  uint64_t value = 0;
+  for (int shift = 0; *pos < data.size(); shift += 7) {
+    const uint8_t byte = data[(*pos)++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      break;
+  }
+  return value;
+}
+
+struct Field {
+  int number;
+  uint64_t value;     // For varints.
+  std::string bytes;  // For length-delimited fields.
+};
+
+std::vector<Field> ReadFields(const std::string& data) {
+  std::vector<Field> fields;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    const uint64_t key = ReadVarint(data, &pos);
+    Field field { static_cast<int>(key >> 3), 0, "" };
+    if ((key & 7) == 0) {
+      field.value = ReadVarint(data, &pos);
+    } else {
+      EXPECT_EQ(key & 7, 2u);
+      const size_t length = ReadVarint(data, &pos);
+      field.bytes = data.substr(pos, length);
+      pos += length;
+    }
+    fields.push_back(field);
+  }
+  EXPECT_EQ(pos, data.size());
+  return fields;
+}
+
+std::vector<Field> FieldsNumbered(const std::string& data, int number) {
+  std::vector<Field> result;
+  for (const Field& field : ReadFields(data)) {
+    if (field.number == number)
+      result.push_back(field);
+  }
+  return result;
+}
+
+}  // anonymous namespace
+
+TEST(PprofTest, EmptyProfile) {
+  ProfileBuilder builder;
+  // Only the empty string of the string table.
+  EXPECT_EQ(builder.Serialize(), std::string("\x32\x00", 2));
+}
+
+TEST(PprofTest, DeduplicatesLocations) {
+  ProfileBuilder builder;
+  const uint64_t main = builder.AddLocation("main", "/app.js", 1);
+  const uint64_t work = builder.AddLocation("work", "/app.js", 10);
+  EXPECT_EQ(main, 1u);
+  EXPECT_EQ(work, 2u);
+  EXPECT_EQ(builder.AddLocation("main", "/app.js", 1), main);
+  EXPECT_EQ(builder.AddLocation("main", "/lib.js", 1), 3u);
+}
+
+TEST(PprofTest, Serialize) {
+  ProfileBuilder builder;
+  builder.AddSampleType("samples", "count");
+  builder.AddSampleType("cpu", "nanoseconds");
+  builder.SetPeriod("cpu", "nanoseconds", 1000);
+  builder.set_duration_nanos(5000);
+  const uint64_t main = builder.AddLocation("main", "/app.js", 1);
+  const uint64_t work = builder.AddLocation("work", "/app.js", 10);
+  builder.AddSample({ work, main }, { 3, 3000 });
+  builder.AddSample({ main }, { 2, 2000 });
+  EXPECT_EQ(builder.sample_count(), 2u);
+
+  const std::string profile = builder.Serialize();
+  std::vector<std::string> strings;
+  for (const Field& field : FieldsNumbered(profile, 6))
+    strings.push_back(field.bytes);
+  EXPECT_EQ(strings, (std::vector<std::string> {
+    "", "samples", "count", "cpu", "nanoseconds", "main", "/app.js", "work"
+  }));
+
+  EXPECT_EQ(FieldsNumbered(profile, 1).size(), 2u);
+  const std::vector<Field> samples = FieldsNumbered(profile, 2);
+  ASSERT_EQ(samples.size(), 2u);
+  // Packed location ids 2, 1 and values 3, 3000.
+  const std::vector<Field> sample = ReadFields(samples[0].bytes);
+  ASSERT_EQ(sample.size(), 2u);
+  EXPECT_EQ(sample[0].bytes, std::string("\x02\x01", 2));
+  EXPECT_EQ(sample[1].bytes, std::string("\x03\xb8\x17", 3));
+
+  const std::vector<Field> functions = FieldsNumbered(profile, 5);
+  ASSERT_EQ(functions.size(), 2u);
+  const std::vector<Field> work_function = ReadFields(functions[1].bytes);
+  ASSERT_EQ(work_function.size(), 5u);
+  EXPECT_EQ(work_function[0].value, work);  // id
+  EXPECT_EQ(work_function[1].value, 7u);    // name
+  EXPECT_EQ(work_function[3].value, 6u);    // filename
+  EXPECT_EQ(work_function[4].value, 10u);   // start_line
+
+  EXPECT_EQ(FieldsNumbered(profile, 4).size(), 2u);
+  EXPECT_EQ(FieldsNumbered(profile, 10)[0].value, 5000u);
+  EXPECT_EQ(FieldsNumbered(profile, 12)[0].value, 1000u);
+}
+
+TEST(PprofTest, Gzip) {
+  const std::string data(10000, 'x');
+  std::string compressed;
+  ASSERT_TRUE(Gzip(data, &compressed));
+  EXPECT_LT(compressed.size(), data.size());
+  EXPECT_EQ(compressed.substr(0, 2), "\x1f\x8b");
+
+  std::string decompressed(data.size() + 1, '\0');
+  z_stream stream {};
+  ASSERT_EQ(inflateInit2(&stream, 16 + MAX_WBITS), Z_OK);
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  stream.avail_in = compressed.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&decompressed[0]);
+  stream.avail_out = decompressed.size();
+  EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+  decompressed.resize(stream.total_out);
+  inflateEnd(&stream);
+  EXPECT_EQ(decompressed, data);
+}
+
+TEST(PprofTest, SortProfileNames) {
+  std::vector<std::string> names = {
+    "cpu.20200102.000000.10.0.001.pb.gz",
+    "cpu.20200101.120000.10.0.1000.pb.gz",
+    "cpu.20200101.120000.10.0.999.pb.gz",
+    "cpu.20200101.115959.20.0.002.pb.gz",
+  };
+  SortProfileNames(&names);
+  EXPECT_EQ(names, (std::vector<std::string> {
+    "cpu.20200101.115959.20.0.002.pb.gz",
+    "cpu.20200101.120000.10.0.999.pb.gz",
+    "cpu.20200101.120000.10.0.1000.pb.gz",
+    "cpu.20200102.000000.10.0.001.pb.gz",
+  }));
+}
@@ -0,0 +1,94 @@
+#include "simd_codecs.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::simd::HexDecode;
+
+namespace {
+
+int Unhex(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// The scalar decoder of string_bytes.cc, starting at byte `start`.
+size_t ScalarHexDecode(const std::string& src, std::vector<char>* dst,
+                       size_t start) {
+  size_t i = start;
+  for (; i < dst->size() && i * 2 + 1 < src.size(); i++) {
+    const int a = Unhex(src[i * 2]);
+    const int b = Unhex(src[i * 2 + 1]);
+    if (a < 0 || b < 0)
+      break;
+    (*dst)[i] = static_cast<char>((a << 4) | b);
+  }
+  return i;
+}
+
+// Checks that the kernel decodes a prefix of what the scalar decoder does,
+// stops within one block of where the scalar decoder does, and leaves the
+// rest of the output alone.
+void CheckHexDecode(const std::string& src, size_t dlen) {
+  std::vector<char> expected(dlen, 0);
+  const size_t expected_len = ScalarHexDecode(src, &expected, 0);
+
+  // Bytes past `dlen` must not be written either.
+  std::vector<char> actual(dlen + 32, 0x55);
+  const size_t len = HexDecode(src.data(), src.size(), actual.data(), dlen);
+  ASSERT_LE(len, expected_len) << src << " " << dlen;
+  EXPECT_LT(expected_len - len, 32u) << src << " " << dlen;
+  for (size_t i = 0; i < len; i++)
+    ASSERT_EQ(actual[i], expected[i]) << src << " " << dlen << " " << i;
+  for (size_t i = len; i < actual.size(); i++)
+    ASSERT_EQ(actual[i], 0x55) << src << " " << dlen << " " << i;
+  actual.resize(dlen);
+
+  // Finishing with the scalar loop, like string_bytes.cc does, gives the
+  // same result as the scalar decoder alone.
+  std::fill(actual.begin() + len, actual.end(), 0);
+  EXPECT_EQ(ScalarHexDecode(src, &actual, len), expected_len);
+  EXPECT_EQ(actual, expected) << src << " " << dlen;
+}
+
+std::string HexString(size_t bytes) {
+  static const char kDigits[] = "0123456789abcdefABCDEF";
+  std::string src;
+  for (size_t i = 0; i < bytes * 2; i++)
+    src += kDigits[(i * 7 + i / 3) % (sizeof(kDigits) - 1)];
+  return src;
+}
+
+}  // anonymous namespace
+
+TEST(SimdCodecsTest, HexDecodeBlockEdges) {
+  for (size_t bytes = 0; bytes <= 100; bytes++) {
+    const std::string src = HexString(bytes);
+    CheckHexDecode(src, bytes);
+    // The output is the limit.
+    if (bytes > 0)
+      CheckHexDecode(src, bytes - 1);
+    // An odd number of characters.
+    CheckHexDecode(src + "a", bytes + 1);
+  }
+}
+
+TEST(SimdCodecsTest, HexDecodeInvalidCharacters) {
+  // Characters that are next to the digits and letters in ASCII, and one
+  // with the highest bit set.
+  const char kInvalid[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\0',
+                            static_cast<char>(0xb0) };
+  for (size_t bytes : { 16, 17, 31, 32, 33, 63, 64, 65, 100 }) {
+    for (size_t pos = 0; pos < bytes * 2; pos++) {
+      for (char c : kInvalid) {
+        std::string src = HexString(bytes);
+        src[pos] = c;
+        CheckHexDecode(src, bytes);
+      }
+    }
+  }
+}
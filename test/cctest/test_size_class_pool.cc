@@ -0,0 +1,82 @@
+#include "node_size_class_pool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using node::SizeClassPool;
+
+class SizeClassPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!SizeClassPool::IsSupported())
+      GTEST_SKIP();
+  }
+
+  SizeClassPool pool;
+};
+
+TEST_F(SizeClassPoolTest, ReusesBlocksWithinAClass) {
+  // 1000 and 1024 bytes are in the same class, 1025 bytes are not.
+  char* data = static_cast<char*>(pool.Allocate(1000, false));
+  ASSERT_NE(data, nullptr);
+  memset(data, 'x', 1000);
+  EXPECT_TRUE(pool.Free(data, 1000));
+  EXPECT_EQ(pool.cached_bytes(), 1024u);
+
+  void* other = pool.Allocate(1025, false);
+  EXPECT_NE(other, data);
+  EXPECT_TRUE(pool.Free(other, 1025));
+
+  char* reused = static_cast<char*>(pool.Allocate(1024, true));
+  EXPECT_EQ(reused, data);
+  for (size_t i = 0; i < 1024; i++)
+    ASSERT_EQ(reused[i], 0);
+  EXPECT_TRUE(pool.Free(reused, 1024));
+}
+
+TEST_F(SizeClassPoolTest, HandlesSmallAndLargeSizes) {
+  void* empty = pool.Allocate(0, true);
+  ASSERT_NE(empty, nullptr);
+  EXPECT_TRUE(pool.Free(empty, 0));
+  EXPECT_EQ(pool.Allocate(SizeClassPool::kMinSize, false), empty);
+  EXPECT_TRUE(pool.Free(empty, SizeClassPool::kMinSize));
+
+  void* largest = pool.Allocate(SizeClassPool::kMaxSize, false);
+  ASSERT_NE(largest, nullptr);
+  EXPECT_TRUE(pool.Free(largest, SizeClassPool::kMaxSize));
+
+  void* too_large = malloc(SizeClassPool::kMaxSize + 1);
+  EXPECT_FALSE(pool.Free(too_large, SizeClassPool::kMaxSize + 1));
+  free(too_large);
+}
+
+TEST_F(SizeClassPoolTest, LimitsCachedMemoryPerClass) {
+  const size_t size = 64 * 1024;
+  void* blocks[4];
+  for (void*& block : blocks) {
+    block = pool.Allocate(size, false);
+    ASSERT_NE(block, nullptr);
+  }
+  size_t kept = 0;
+  for (void* block : blocks) {
+    if (pool.Free(block, size))
+      kept++;
+    else
+      free(block);
+  }
+  const size_t max_cached = SizeClassPool::kMaxCachedBytesPerClass;
+  EXPECT_EQ(kept, max_cached / size);
+  EXPECT_EQ(pool.cached_bytes(), max_cached);
+}
+
+TEST_F(SizeClassPoolTest, RejectsBlocksThatAreTooSmallForTheirClass) {
+  // A 1025 byte block from malloc() cannot be reused for 1280 bytes.
+  void* foreign = malloc(1025);
+  if (!pool.Free(foreign, 1025))
+    free(foreign);
+  void* data = pool.Allocate(1280, true);
+  ASSERT_NE(data, nullptr);
+  EXPECT_TRUE(pool.Free(data, 1280));
+}
@@ -0,0 +1,139 @@
+#include "timer_wheel.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using node::TimerWheel;
+
+TEST(TimerWheelTest, Empty) {
+  TimerWheel wheel;
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_EQ(wheel.NextExpiry(), TimerWheel::kNoExpiry);
+  std::vector<uint32_t> expired;
+  wheel.Expire(1000, &expired);
+  EXPECT_TRUE(expired.empty());
+  EXPECT_EQ(wheel.now(), 1000u);
+}
+
+TEST(TimerWheelTest, ExpiresInOrder) {
+  TimerWheel wheel;
+  wheel.Schedule(3, 100);
+  wheel.Schedule(1, 50);
+  wheel.Schedule(2, 100);
+  wheel.Schedule(0, 70000);
+  EXPECT_EQ(wheel.size(), 4u);
+  EXPECT_EQ(wheel.NextExpiry(), 50u);
+
+  std::vector<uint32_t> expired;
+  wheel.Expire(49, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Expire(100, &expired);
+  EXPECT_EQ(expired, std::vector<uint32_t>({ 1, 3, 2 }));
+  EXPECT_EQ(wheel.size(), 1u);
+  EXPECT_FALSE(wheel.IsScheduled(1));
+  EXPECT_TRUE(wheel.IsScheduled(0));
+
+  // The next expiry may be earlier than 70000, when the timer moves to a
+  // lower level of the wheel, but never later.
+  EXPECT_LE(wheel.NextExpiry(), 70000u);
+  expired.clear();
+  wheel.Expire(69999, &expired);
+  EXPECT_TRUE(expired.empty());
+  EXPECT_EQ(wheel.NextExpiry(), 70000u);
+  wheel.Expire(1000000, &expired);
+  EXPECT_EQ(expired, std::vector<uint32_t>({ 0 }));
+  EXPECT_EQ(wheel.NextExpiry(), TimerWheel::kNoExpiry);
+}
+
+TEST(TimerWheelTest, RescheduleAndCancel) {
+  TimerWheel wheel;
+  wheel.Schedule(0, 10);
+  wheel.Schedule(1, 20);
+  wheel.Schedule(0, 30);
+  wheel.Cancel(1);
+  wheel.Cancel(1);
+  wheel.Cancel(42);
+  EXPECT_EQ(wheel.size(), 1u);
+
+  std::vector<uint32_t> expired;
+  wheel.Expire(25, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Expire(30, &expired);
+  EXPECT_EQ(expired, std::vector<uint32_t>({ 0 }));
+}
+
+TEST(TimerWheelTest, ScheduleInThePast) {
+  TimerWheel wheel;
+  std::vector<uint32_t> expired;
+  wheel.Expire(5000, &expired);
+  wheel.Schedule(0, 4000);
+  wheel.Schedule(1, 3000);
+  EXPECT_EQ(wheel.NextExpiry(), 5000u);
+  wheel.Expire(5000, &expired);
+  EXPECT_EQ(expired, std::vector<uint32_t>({ 1, 0 }));
+}
+
+TEST(TimerWheelTest, MatchesReference) {
+  std::mt19937 rng(42);
+  TimerWheel wheel;
+  // Maps ids to (expiry, order of scheduling).
+  std::map<uint32_t, std::pair<uint64_t, uint64_t>> reference;
+  uint64_t now = 0;
+  uint64_t seq = 0;
+  const uint64_t ranges[] = { 10, 300, 70000, 20000000, 1ull << 40 };
+
+  for (int round = 0; round < 20000; round++) {
+    const uint32_t id = rng() % 512;
+    switch (rng() % 4) {
+      case 0:
+      case 1: {
+        const uint64_t expiry = now + rng() % ranges[rng() % 5];
+        wheel.Schedule(id, expiry);
+        reference[id] = { expiry, seq++ };
+        break;
+      }
+      case 2:
+        wheel.Cancel(id);
+        reference.erase(id);
+        break;
+      case 3: {
+        const uint64_t next = wheel.NextExpiry();
+        if (reference.empty()) {
+          ASSERT_EQ(next, TimerWheel::kNoExpiry);
+        } else {
+          uint64_t earliest = TimerWheel::kNoExpiry;
+          for (const auto& it : reference)
+            earliest = std::min(earliest, it.second.first);
+          ASSERT_LE(next, std::max(earliest, now));
+        }
+        // Sometimes jump to the next stop, sometimes past it.
+        if (rng() % 2 == 0 && next != TimerWheel::kNoExpiry)
+          now = std::max(now, next);
+        else
+          now += rng() % ranges[rng() % 4];
+
+        std::vector<uint32_t> expired;
+        wheel.Expire(now, &expired);
+        std::vector<std::pair<std::pair<uint64_t, uint64_t>, uint32_t>> due;
+        for (auto it = reference.begin(); it != reference.end();) {
+          if (it->second.first <= now) {
+            due.push_back({ it->second, it->first });
+            it = reference.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        std::sort(due.begin(), due.end());
+        ASSERT_EQ(expired.size(), due.size());
+        for (size_t i = 0; i < due.size(); i++)
+          ASSERT_EQ(expired[i], due[i].second);
+        break;
+      }
+    }
+    ASSERT_EQ(wheel.size(), reference.size());
+  }
+}
@@ -49,6 +49,10 @@ function _validateContent(data) {
 
   if (report.uvthreadResourceUsage)
     sections.push('uvthreadResourceUsage');
+  if (report.v8ThreadPool)
+    sections.push('v8ThreadPool');
+  if (report.threadpoolWork)
+    sections.push('threadpoolWork');
 
   checkForUnknownFields(report, sections);
   sections.forEach((section) => {
@@ -164,6 +168,39 @@ function _validateContent(data) {
     assert(Number.isSafeInteger(usage.fsActivity.writes));
   }
 
+  // Verify the format of the v8ThreadPool section, if present.
+  if (report.v8ThreadPool) {
+    const pool = report.v8ThreadPool;
+    const poolFields = ['threads', 'tasksPosted', 'tasksStolen',
+                        'lockContentions', 'idleWaits'];
+    checkForUnknownFields(pool, poolFields);
+    poolFields.forEach((field) => {
+      assert(Number.isSafeInteger(pool[field]));
+    });
+    assert(pool.threads > 0);
+  }
+
+  // Verify the format of the threadpoolWork section, if present.
+  if (report.threadpoolWork) {
+    const work = report.threadpoolWork;
+    const workClasses = ['fs', 'crypto', 'zlib', 'addon'];
+    checkForUnknownFields(work, ['threads', ...workClasses]);
+    assert(Number.isSafeInteger(work.threads));
+    workClasses.forEach((workClass) => {
+      const stats = work[workClass];
+      checkForUnknownFields(stats, ['limit', 'queued', 'running', 'completed',
+                                    'totalWaitMs', 'maxWaitMs', 'totalRunMs']);
+      assert(Number.isSafeInteger(stats.limit));
+      assert(Number.isSafeInteger(stats.queued));
+      assert(Number.isSafeInteger(stats.running));
+      assert(Number.isSafeInteger(stats.completed));
+      assert(stats.limit === 0 || stats.running <= stats.limit);
+      assert.strictEqual(typeof stats.totalWaitMs, 'number');
+      assert.strictEqual(typeof stats.maxWaitMs, 'number');
+      assert.strictEqual(typeof stats.totalRunMs, 'number');
+    });
+  }
+
   // Verify the format of the libuv section.
   assert(Array.isArray(report.libuv));
   report.libuv.forEach((resource) => {
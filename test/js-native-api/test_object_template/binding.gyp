@@ -0,0 +1,11 @@
+{
+  "targets": [
+    {
+      "target_name": "test_object_template",
+      "sources": [
+        "../entry_point.c",
+        "test_object_template.c"
+      ]
+    }
+  ]
+}
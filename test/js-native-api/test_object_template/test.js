@@ -0,0 +1,68 @@
+// Flags: --allow-natives-syntax
+'use strict';
+
+const common = require('../../common');
+
+// This tests the n-api calls for property keys and object templates.
+
+const assert = require('assert');
+const test_object_template =
+  require(`./build/${common.buildType}/test_object_template`);
+
+assert.strictEqual(test_object_template.createTemplate(['id', 'name']), true);
+assert.strictEqual(test_object_template.getKey(1), 'name');
+
+const rows = [];
+for (let i = 0; i < 100; i++)
+  rows.push(test_object_template.createObject(i, `row ${i}`));
+for (let i = 0; i < 100; i++) {
+  assert.deepStrictEqual(rows[i], { id: i, name: `row ${i}` });
+  assert.deepStrictEqual(Object.keys(rows[i]), ['id', 'name']);
+}
+
+// The objects share their hidden class with each other and with objects
+// that are built one property at a time in the same order.
+assert(eval('%HaveSameMap(rows[0], rows[99])'));
+const built = test_object_template.createObjectWithProperties(100, 'row 100');
+assert.deepStrictEqual(built, { id: 100, name: 'row 100' });
+assert(eval('%HaveSameMap(rows[0], built)'));
+
+// The properties are ordinary data properties.
+const row = rows[0];
+assert.deepStrictEqual(Object.getOwnPropertyDescriptor(row, 'name'), {
+  value: 'row 0',
+  writable: true,
+  enumerable: true,
+  configurable: true
+});
+assert.strictEqual(Object.getPrototypeOf(row), Object.prototype);
+
+assert.strictEqual(test_object_template.getKeyed(row, 1), 'row 0');
+test_object_template.setKeyed(row, 1, 'renamed');
+assert.strictEqual(row.name, 'renamed');
+assert.strictEqual(test_object_template.getKeyed({}, 0), undefined);
+
+// Keyed access runs getters and setters.
+const accessors = {
+  get id() { return 42; },
+  set name(value) { this.set = value; }
+};
+assert.strictEqual(test_object_template.getKeyed(accessors, 0), 42);
+test_object_template.setKeyed(accessors, 1, 'value');
+assert.strictEqual(accessors.set, 'value');
+
+assert.throws(() => test_object_template.createObject(1), {
+  message: 'assertion (argc == key_count) failed: Wrong number of values'
+});
+
+test_object_template.deleteTemplate();
+
+// Templates must not repeat keys.
+assert.strictEqual(test_object_template.createTemplate(['a', 'b', 'a']),
+                   false);
+test_object_template.deleteTemplate();
+
+// Templates without keys create empty objects.
+assert.strictEqual(test_object_template.createTemplate([]), true);
+assert.deepStrictEqual(test_object_template.createObject(), {});
+test_object_template.deleteTemplate();
@@ -0,0 +1,140 @@
+#define NAPI_EXPERIMENTAL
+
+#include <js_native_api.h>
+#include "../common.h"
+
+#define MAX_KEYS 8
+
+static napi_property_key keys[MAX_KEYS];
+static char key_names[MAX_KEYS][64];
+static size_t key_count = 0;
+static napi_object_template tmpl = NULL;
+
+// Creates a key for each of the strings in the array that is passed in, and
+// a template of them.
+static napi_value CreateTemplate(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value names;
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, &names, NULL, NULL));
+
+  uint32_t length;
+  NAPI_CALL(env, napi_get_array_length(env, names, &length));
+  NAPI_ASSERT(env, length <= MAX_KEYS, "Too many keys");
+  NAPI_ASSERT(env, tmpl == NULL, "Template already created");
+
+  for (uint32_t i = 0; i < length; i++) {
+    napi_value name;
+    size_t copied;
+    NAPI_CALL(env, napi_get_element(env, names, i, &name));
+    NAPI_CALL(env, napi_get_value_string_utf8(
+        env, name, key_names[i], sizeof(key_names[i]), &copied));
+    NAPI_CALL(env, napi_create_property_key_utf8(
+        env, key_names[i], copied, &keys[i]));
+  }
+  key_count = length;
+
+  napi_status status = napi_create_object_template(env, key_count, keys, &tmpl);
+  napi_value result;
+  NAPI_CALL(env, napi_get_boolean(env, status == napi_ok, &result));
+  return result;
+}
+
+static napi_value CreateObject(napi_env env, napi_callback_info info) {
+  size_t argc = MAX_KEYS;
+  napi_value values[MAX_KEYS];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, values, NULL, NULL));
+  NAPI_ASSERT(env, argc == key_count, "Wrong number of values");
+
+  napi_value result;
+  NAPI_CALL(env, napi_create_object_from_template(env, tmpl, values, &result));
+  return result;
+}
+
+// Creates the same object as CreateObject, one property at a time.
+static napi_value CreateObjectWithProperties(napi_env env,
+                                             napi_callback_info info) {
+  size_t argc = MAX_KEYS;
+  napi_value values[MAX_KEYS];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, values, NULL, NULL));
+  NAPI_ASSERT(env, argc == key_count, "Wrong number of values");
+
+  napi_value result;
+  NAPI_CALL(env, napi_create_object(env, &result));
+  for (size_t i = 0; i < key_count; i++)
+    NAPI_CALL(env, napi_set_named_property(
+        env, result, key_names[i], values[i]));
+  return result;
+}
+
+static napi_value GetKey(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value arg;
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, &arg, NULL, NULL));
+
+  uint32_t index;
+  NAPI_CALL(env, napi_get_value_uint32(env, arg, &index));
+  NAPI_ASSERT(env, index < key_count, "Invalid key index");
+
+  napi_value result;
+  NAPI_CALL(env, napi_get_property_key_value(env, keys[index], &result));
+  return result;
+}
+
+static napi_value GetKeyed(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  uint32_t index;
+  NAPI_CALL(env, napi_get_value_uint32(env, args[1], &index));
+  NAPI_ASSERT(env, index < key_count, "Invalid key index");
+
+  napi_value result;
+  NAPI_CALL(env, napi_get_keyed_property(env, args[0], keys[index], &result));
+  return result;
+}
+
+static napi_value SetKeyed(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value args[3];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  uint32_t index;
+  NAPI_CALL(env, napi_get_value_uint32(env, args[1], &index));
+  NAPI_ASSERT(env, index < key_count, "Invalid key index");
+
+  NAPI_CALL(env, napi_set_keyed_property(env, args[0], keys[index], args[2]));
+  return NULL;
+}
+
+static napi_value DeleteTemplate(napi_env env, napi_callback_info info) {
+  // The template can be used without the keys it was created from.
+  for (size_t i = 0; i < key_count; i++)
+    NAPI_CALL(env, napi_delete_property_key(env, keys[i]));
+  key_count = 0;
+  if (tmpl != NULL) {
+    NAPI_CALL(env, napi_delete_object_template(env, tmpl));
+    tmpl = NULL;
+  }
+  return NULL;
+}
+
+EXTERN_C_START
+napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("createTemplate", CreateTemplate),
+    DECLARE_NAPI_PROPERTY("createObject", CreateObject),
+    DECLARE_NAPI_PROPERTY("createObjectWithProperties",
+                          CreateObjectWithProperties),
+    DECLARE_NAPI_PROPERTY("getKey", GetKey),
+    DECLARE_NAPI_PROPERTY("getKeyed", GetKeyed),
+    DECLARE_NAPI_PROPERTY("setKeyed", SetKeyed),
+    DECLARE_NAPI_PROPERTY("deleteTemplate", DeleteTemplate),
+  };
+
+  NAPI_CALL(env, napi_define_properties(
+      env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+
+  return exports;
+}
+EXTERN_C_END
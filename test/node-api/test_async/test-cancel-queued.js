@@ -0,0 +1,14 @@
+// Flags: --threadpool-limits=addon=1
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+const test_async = require(`./build/${common.buildType}/test_async`);
+
+// With a limit of one, the cancelled work is still waiting in the addon
+// queue of Node.js. It completes with napi_cancelled from the event loop,
+// without waiting for the busy work, which takes a second each, to finish.
+const start = process.hrtime.bigint();
+test_async.TestCancel(common.mustCall(() => {
+  const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  assert(elapsedMs < 1000, `${elapsedMs}`);
+}));
@@ -0,0 +1,28 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+// Memory that is reused from the free lists must still be zero-filled where
+// it is expected to be.
+const code = `
+  const assert = require('assert');
+  const sizes = [0, 1, 128, 1000, 8193, 65536, 100000, 256 * 1024];
+  for (let round = 0; round < 4; round++) {
+    for (const size of sizes) {
+      for (let i = 0; i < 16; i++) {
+        const zeroed = Buffer.alloc(size);
+        assert(zeroed.every((byte) => byte === 0));
+        zeroed.fill(0xff);
+        const view = new Uint8Array(new ArrayBuffer(size));
+        assert(view.every((byte) => byte === 0));
+        view.fill(0xff);
+        Buffer.allocUnsafeSlow(size).fill(0xff);
+      }
+    }
+    global.gc();
+  }
+`;
+const child = spawnSync(process.execPath,
+                        ['--arraybuffer-pool', '--expose-gc', '-e', code]);
+assert.strictEqual(child.status, 0, child.stderr.toString());
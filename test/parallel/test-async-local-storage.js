@@ -0,0 +1,86 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { AsyncLocalStorage, AsyncResource } = require('async_hooks');
+
+const storage = new AsyncLocalStorage();
+const other = new AsyncLocalStorage();
+
+assert.strictEqual(storage.getStore(), undefined);
+
+// The store is kept through timers, immediates, ticks, promises and
+// resources that are created in C++, such as the requests of `fs`.
+storage.run('a', common.mustCall(async (arg) => {
+  assert.strictEqual(arg, 1);
+  assert.strictEqual(storage.getStore(), 'a');
+  assert.strictEqual(other.getStore(), undefined);
+
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+  }), 1);
+  const interval = setInterval(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+    clearInterval(interval);
+  }), 1);
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+  }));
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+  }));
+  queueMicrotask(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+  }));
+  fs.stat(__filename, common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+  }));
+
+  const resource = new AsyncResource('test');
+  storage.run('b', common.mustCall(() => {
+    resource.runInAsyncScope(common.mustCall(() => {
+      assert.strictEqual(storage.getStore(), 'a');
+    }));
+    assert.strictEqual(storage.getStore(), 'b');
+  }));
+
+  // Stores of different instances are independent.
+  other.run('c', common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), 'a');
+    assert.strictEqual(other.getStore(), 'c');
+    storage.exit(common.mustCall(() => {
+      assert.strictEqual(storage.getStore(), undefined);
+      assert.strictEqual(other.getStore(), 'c');
+      setImmediate(common.mustCall(() => {
+        assert.strictEqual(storage.getStore(), undefined);
+        assert.strictEqual(other.getStore(), 'c');
+      }));
+    }));
+    assert.strictEqual(storage.getStore(), 'a');
+  }));
+
+  await fs.promises.stat(__filename);
+  assert.strictEqual(storage.getStore(), 'a');
+  await new Promise((resolve) => setTimeout(resolve, 1));
+  assert.strictEqual(storage.getStore(), 'a');
+}), 1);
+
+assert.strictEqual(storage.getStore(), undefined);
+
+// Callbacks of resources that were created outside of run() do not see the
+// store, even if they are started from it.
+const resource = new AsyncResource('test');
+storage.run('d', common.mustCall(() => {
+  resource.runInAsyncScope(common.mustCall(() => {
+    assert.strictEqual(storage.getStore(), undefined);
+  }));
+}));
+
+// The store is restored if the callback throws.
+assert.throws(() => {
+  storage.run('e', () => {
+    throw new Error('boom');
+  });
+}, /boom/);
+assert.strictEqual(storage.getStore(), undefined);
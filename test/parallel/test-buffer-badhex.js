@@ -46,3 +46,23 @@ const assert = require('assert');
   const badHex = `${hex.slice(0, 256)}xx${hex.slice(256, 510)}`;
   assert.deepStrictEqual(Buffer.from(badHex, 'hex'), buf.slice(0, 128));
 }
+
+// Long inputs are decoded in vector blocks; an invalid character anywhere
+// must still stop decoding at the preceding complete byte.
+{
+  const buf = Buffer.alloc(200);
+  for (let i = 0; i < buf.length; i++)
+    buf[i] = (i * 37 + 11) & 0xff;
+
+  const hex = buf.toString('hex');
+  assert.strictEqual(hex.length, 400);
+  assert.deepStrictEqual(Buffer.from(hex.toUpperCase(), 'hex'), buf);
+
+  for (let pos = 0; pos < hex.length; pos += 7) {
+    for (const bad of ['g', 'G', '/', ':', '@', '`', 'à', 'Ā']) {
+      const badHex = `${hex.slice(0, pos)}${bad}${hex.slice(pos + 1)}`;
+      assert.deepStrictEqual(Buffer.from(badHex, 'hex'),
+                             buf.slice(0, pos >> 1));
+    }
+  }
+}
@@ -0,0 +1,78 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const { isUtf8 } = require('buffer');
+
+const valid = [
+  '',
+  'hello world',
+  'été',
+  '€'.repeat(100),
+  '😀 emoji',
+  'x'.repeat(63) + 'ÿ' + 'y'.repeat(64),
+  '￿\u{10ffff}'
+];
+
+for (const str of valid) {
+  const buf = Buffer.from(str);
+  assert.strictEqual(isUtf8(buf), true);
+  assert.strictEqual(isUtf8(new Uint8Array(buf)), true);
+  assert.strictEqual(isUtf8(new Uint8Array(buf).buffer), true);
+}
+
+const invalid = [
+  [0x80],                    // Lone continuation byte.
+  [0xc3],                    // Truncated two-byte sequence.
+  [0xe2, 0x82],              // Truncated three-byte sequence.
+  [0xf0, 0x9f, 0x98],        // Truncated four-byte sequence.
+  [0xc0, 0x80],              // Overlong encoding of U+0000.
+  [0xe0, 0x80, 0x80],        // Overlong three-byte sequence.
+  [0xf0, 0x80, 0x80, 0x80],  // Overlong four-byte sequence.
+  [0xed, 0xa0, 0x80],        // Encoded surrogate.
+  [0xf4, 0x90, 0x80, 0x80],  // Above U+10FFFF.
+  [0xff]
+];
+
+// Errors must be detected at every position relative to the vector width.
+for (const bytes of invalid) {
+  for (let offset = 0; offset < 70; offset++) {
+    const buf = Buffer.alloc(offset + bytes.length + 5, 'a');
+    buf.set(bytes, offset);
+    assert.strictEqual(isUtf8(buf), false, `${bytes} at ${offset}`);
+    assert.strictEqual(isUtf8(buf.subarray(0, offset)), true);
+  }
+}
+
+// Multi-byte sequences spanning block boundaries.
+for (let offset = 0; offset < 40; offset++) {
+  const buf = Buffer.from('a'.repeat(offset) + '😀€é');
+  assert.strictEqual(isUtf8(buf), true);
+  assert.strictEqual(isUtf8(buf.subarray(0, buf.length - 1)), false);
+}
+
+assert.strictEqual(isUtf8(new DataView(Buffer.from('€').buffer)), true);
+assert.strictEqual(isUtf8(new SharedArrayBuffer(16)), true);
+
+[undefined, null, 'string', 1, {}, []].forEach((input) => {
+  assert.throws(() => isUtf8(input), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    name: 'TypeError'
+  });
+});
+
+// The UTF-8 fast paths in StringBytes must agree with the generic ones.
+for (const str of valid) {
+  const latin1 = Buffer.from(str, 'latin1').toString('latin1');
+  const buf = Buffer.from(latin1, 'utf8');
+  assert.strictEqual(buf.toString('utf8'), latin1);
+  assert.strictEqual(Buffer.byteLength(latin1, 'utf8'), buf.length);
+  for (let length = 0; length <= buf.length; length++) {
+    const target = Buffer.alloc(length);
+    const written = target.write(latin1, 'utf8');
+    assert.strictEqual(target.toString('utf8', 0, written),
+                       latin1.slice(0, target.toString('utf8', 0,
+                                                       written).length));
+  }
+}
+assert.strictEqual(Buffer.from([0x61, 0xc3]).toString(), 'a�');
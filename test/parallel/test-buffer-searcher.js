@@ -0,0 +1,87 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const { Searcher } = require('buffer');
+
+const haystack = Buffer.from('preamble\r\n--boundary\r\nfirst part' +
+                             '\r\n--boundary\r\nsecond\r\n--boundary--');
+
+// Results must match Buffer#indexOf() and Buffer#lastIndexOf() for all
+// offsets, including negative and out of range ones.
+const needles = [
+  '\r\n--boundary',
+  '--',
+  'p',
+  'not there',
+  '',
+  haystack.toString(),
+  Buffer.from('second'),
+  new Uint8Array([0x2d, 0x2d, 0x62])
+];
+
+for (const needle of needles) {
+  const searcher = new Searcher(needle);
+  assert.strictEqual(searcher.length, Buffer.from(needle).length);
+  for (let offset = -haystack.length - 2;
+    offset <= haystack.length + 2;
+    offset++) {
+    assert.strictEqual(searcher.indexOf(haystack, offset),
+                       haystack.indexOf(needle, offset));
+    assert.strictEqual(searcher.lastIndexOf(haystack, offset),
+                       haystack.lastIndexOf(needle, offset));
+    assert.strictEqual(searcher.includes(haystack, offset),
+                       haystack.includes(needle, offset));
+  }
+  assert.strictEqual(searcher.indexOf(haystack), haystack.indexOf(needle));
+  assert.strictEqual(searcher.lastIndexOf(haystack),
+                     haystack.lastIndexOf(needle));
+}
+
+// The same searcher can be used for many haystacks, including ones that make
+// it switch to a different algorithm.
+{
+  const needle = 'a'.repeat(30) + 'b';
+  const searcher = new Searcher(needle);
+  for (let i = 0; i < 50; i++) {
+    const buf = Buffer.from('a'.repeat(i * 20) + needle + 'a'.repeat(i));
+    assert.strictEqual(searcher.indexOf(buf), i * 20);
+    assert.strictEqual(searcher.lastIndexOf(buf), i * 20);
+    assert.strictEqual(searcher.indexOf(buf, i * 20 + 1), -1);
+  }
+}
+
+// The needle is copied.
+{
+  const needle = Buffer.from('abc');
+  const searcher = new Searcher(needle);
+  needle[0] = 0x78;
+  assert.strictEqual(searcher.indexOf(Buffer.from('xxabc')), 2);
+}
+
+// Encodings.
+{
+  const ucs2 = Buffer.from('aあbいc', 'ucs2');
+  const searcher = new Searcher('いc', 'ucs2');
+  assert.strictEqual(searcher.indexOf(ucs2), ucs2.indexOf('いc', 'ucs2'));
+  assert.strictEqual(searcher.lastIndexOf(ucs2), 6);
+  assert.strictEqual(new Searcher('6869', 'hex').indexOf(Buffer.from('ohhi')),
+                     2);
+  assert.strictEqual(new Searcher('aGk=', 'base64').indexOf(Buffer.from('hi')),
+                     0);
+  assert.strictEqual(new Searcher('é', 'latin1')
+                       .indexOf(Buffer.from([0x61, 0xe9])), 1);
+}
+
+assert.throws(() => new Searcher(1), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
+assert.throws(() => new Searcher('x', 'nope'), {
+  code: 'ERR_UNKNOWN_ENCODING',
+  name: 'TypeError'
+});
+assert.throws(() => new Searcher('x').indexOf('xyz'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
@@ -0,0 +1,39 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const kCount = 20;
+
+const receiver = dgram.createSocket({ type: 'udp4', recvBatch: true });
+const sender = dgram.createSocket('udp4');
+
+receiver.on('message', common.mustNotCall());
+
+const received = [];
+receiver.on('messages', common.mustCallAtLeast((msgs, rinfos) => {
+  assert(Array.isArray(msgs));
+  assert.strictEqual(msgs.length, rinfos.length);
+  assert(msgs.length > 0);
+  for (let i = 0; i < msgs.length; i++) {
+    assert.strictEqual(rinfos[i].address, '127.0.0.1');
+    assert.strictEqual(rinfos[i].port, sender.address().port);
+    assert.strictEqual(rinfos[i].size, msgs[i].length);
+    received.push(msgs[i].toString());
+  }
+  if (received.length < kCount)
+    return;
+
+  const expected = [];
+  for (let i = 0; i < kCount; i++)
+    expected.push(`message ${i}`);
+  assert.deepStrictEqual(received.sort(), expected.sort());
+  receiver.close();
+  sender.close();
+}));
+
+receiver.bind(0, common.mustCall(() => {
+  const { port } = receiver.address();
+  for (let i = 0; i < kCount; i++)
+    sender.send(`message ${i}`, port, '127.0.0.1');
+}));
@@ -0,0 +1,77 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const kCount = 20;
+const expected = [];
+for (let i = 0; i < kCount; i++)
+  expected.push(`message ${i}`);
+
+const receiver = dgram.createSocket('udp4');
+const sender = dgram.createSocket('udp4');
+
+[
+  null,
+  [null],
+  [{ msg: 42, port: 1234 }],
+].forEach((messages) => {
+  assert.throws(() => sender.sendBatch(messages), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+assert.throws(() => sender.sendBatch([{ msg: 'x', port: 0 }]), {
+  code: 'ERR_SOCKET_BAD_PORT'
+});
+assert.throws(() => sender.sendBatch([], 'not a function'), {
+  code: 'ERR_INVALID_CALLBACK'
+});
+
+const received = [];
+receiver.on('message', common.mustCall((msg, rinfo) => {
+  assert.strictEqual(rinfo.port, sender.address().port);
+  received.push(msg.toString());
+  if (received.length < kCount)
+    return;
+  assert.deepStrictEqual(received.sort(), expected.slice().sort());
+  receiver.close();
+  sendConnected();
+}, kCount));
+
+receiver.bind(0, common.mustCall(() => {
+  const { port } = receiver.address();
+  const messages = expected.map((msg, i) => ({
+    msg: i % 2 ? msg : Buffer.from(msg),
+    port,
+    address: i % 3 ? 'localhost' : undefined
+  }));
+  // The socket is bound implicitly, like with send().
+  sender.sendBatch(messages, common.mustCall((err) => {
+    assert.ifError(err);
+  }));
+}));
+
+// Connected sockets do not take addresses.
+function sendConnected() {
+  const peer = dgram.createSocket('udp4');
+  peer.bind(0, common.mustCall(() => {
+    const client = dgram.createSocket('udp4');
+    client.connect(peer.address().port, common.mustCall(() => {
+      assert.throws(() => client.sendBatch([{ msg: 'x', port: 1234 }]), {
+        code: 'ERR_SOCKET_DGRAM_IS_CONNECTED'
+      });
+      client.sendBatch([{ msg: 'a' }, { msg: 'b' }], common.mustCall((err) => {
+        assert.ifError(err);
+      }));
+    }));
+
+    let count = 0;
+    peer.on('message', common.mustCall(() => {
+      if (++count === 2) {
+        peer.close();
+        client.close();
+        sender.close();
+      }
+    }, 2));
+  }));
+}
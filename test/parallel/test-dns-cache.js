@@ -0,0 +1,65 @@
+// Flags: --dns-cache-max-ttl=60
+'use strict';
+const common = require('../common');
+const dnstools = require('../common/dns');
+const assert = require('assert');
+const dgram = require('dgram');
+const dns = require('dns');
+
+const server = dgram.createSocket('udp4');
+
+// Only the first of the identical queries reaches the server.
+server.on('message', common.mustCall((msg, { address, port }) => {
+  const parsed = dnstools.parseDNSPacket(msg);
+  const domain = parsed.questions[0].domain;
+  assert.strictEqual(domain, 'example.org');
+
+  server.send(dnstools.writeDNSPacket({
+    id: parsed.id,
+    questions: parsed.questions,
+    answers: [{ domain, type: 'A', address: '1.2.3.4', ttl: 300 }]
+  }), port, address);
+}));
+
+server.bind(0, common.mustCall(() => {
+  const resolver = new dns.Resolver();
+  resolver.setServers([`127.0.0.1:${server.address().port}`]);
+
+  const options = { ttl: true };
+  resolver.resolve4('example.org', options, common.mustCall((err, res) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(res, [{ address: '1.2.3.4', ttl: 300 }]);
+  }));
+
+  // This query waits for the one that is in flight.
+  resolver.resolve4('example.org', common.mustCall((err, res) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(res, ['1.2.3.4']);
+    assert.deepStrictEqual(dns.getCacheStats(),
+                           { hits: 0, misses: 2, coalesced: 1, entries: 1 });
+
+    // This one is answered from the cache, with the TTL that remains.
+    resolver.resolve4('example.org', options, common.mustCall((err, res) => {
+      assert.ifError(err);
+      assert.strictEqual(res.length, 1);
+      assert.strictEqual(res[0].address, '1.2.3.4');
+      assert(res[0].ttl <= 300 && res[0].ttl > 240, `${res[0].ttl}`);
+      assert.deepStrictEqual(dns.getCacheStats(),
+                             { hits: 1, misses: 2, coalesced: 1, entries: 1 });
+      server.close();
+      checkLookup();
+    }));
+  }));
+}));
+
+function checkLookup() {
+  dns.lookup('localhost', { all: true }, common.mustCall((err, first) => {
+    assert.ifError(err);
+    const { hits } = dns.getCacheStats();
+    dns.lookup('localhost', { all: true }, common.mustCall((err, second) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(second, first);
+      assert.strictEqual(dns.getCacheStats().hits, hits + 1);
+    }));
+  }));
+}
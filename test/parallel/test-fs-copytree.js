@@ -0,0 +1,155 @@
+'use strict';
+const common = require('../common');
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+tmpdir.refresh();
+
+const src = path.join(tmpdir.path, 'copytree-src');
+const nested = path.join(src, 'a', 'b', 'c');
+fs.mkdirSync(nested, { recursive: true });
+
+let expectedBytes = 0;
+const files = [];
+for (let i = 0; i < 20; i++) {
+  const dir = [src, path.join(src, 'a'), nested][i % 3];
+  const file = path.join(dir, `file-${i}.txt`);
+  const data = 'x'.repeat(i * 1000);
+  fs.writeFileSync(file, data);
+  files.push(path.relative(src, file));
+  expectedBytes += data.length;
+}
+fs.chmodSync(path.join(src, files[0]), 0o600);
+
+const canCreateSymLink = common.canCreateSymLink();
+if (canCreateSymLink)
+  fs.symlinkSync(files[1], path.join(src, 'link'));
+
+function verify(dest) {
+  for (const file of files) {
+    const srcFile = path.join(src, file);
+    const destFile = path.join(dest, file);
+    assert.strictEqual(fs.readFileSync(destFile, 'utf8'),
+                       fs.readFileSync(srcFile, 'utf8'));
+    assert.strictEqual(fs.statSync(destFile).mode,
+                       fs.statSync(srcFile).mode);
+  }
+  if (canCreateSymLink) {
+    assert.strictEqual(fs.readlinkSync(path.join(dest, 'link')), files[1]);
+  }
+}
+
+// Copy a tree into a new directory.
+{
+  const dest = path.join(tmpdir.path, 'copytree-dest');
+  const job = fs.copyTree(src, dest, common.mustCall((err) => {
+    assert.ifError(err);
+    verify(dest);
+    assert.deepStrictEqual(job.progress(), {
+      files: files.length,
+      directories: 4,
+      symlinks: canCreateSymLink ? 1 : 0,
+      bytes: expectedBytes
+    });
+
+    // Copying again overwrites the existing files by default, and gives
+    // existing directories the mode of the source directory.
+    if (!common.isWindows)
+      fs.chmodSync(path.join(dest, 'a'), 0o700);
+    fs.copyTree(src, dest, { concurrency: 1 }, common.mustCall((err) => {
+      assert.ifError(err);
+      verify(dest);
+      assert.strictEqual(fs.statSync(path.join(dest, 'a')).mode,
+                         fs.statSync(path.join(src, 'a')).mode);
+
+      // ...but not with COPYFILE_EXCL.
+      const { COPYFILE_EXCL } = fs.constants;
+      fs.copyTree(src, dest, { flags: COPYFILE_EXCL },
+                  common.mustCall((err) => {
+                    assert.strictEqual(err.code, 'EEXIST');
+                    assert.strictEqual(err.syscall, 'mkdir');
+                  }));
+    }));
+  }));
+  assert.strictEqual(typeof job.progress, 'function');
+}
+
+// A single file can be copied as well.
+{
+  const dest = path.join(tmpdir.path, 'copytree-file.txt');
+  fs.copyTree(path.join(src, files[5]), dest, common.mustCall((err) => {
+    assert.ifError(err);
+    assert.strictEqual(fs.readFileSync(dest, 'utf8'), 'x'.repeat(5000));
+  }));
+}
+
+// Errors carry the path of the entry that failed.
+{
+  const missing = path.join(tmpdir.path, 'does-not-exist');
+  fs.copyTree(missing, path.join(tmpdir.path, 'copytree-missing'),
+              common.mustCall((err) => {
+                assert.strictEqual(err.code, 'ENOENT');
+                assert.strictEqual(err.syscall, 'lstat');
+                assert.strictEqual(err.path, missing);
+              }));
+}
+
+// Directories that cannot be written to are copied with their contents.
+if (!common.isWindows) {
+  const readonlySrc = path.join(tmpdir.path, 'copytree-readonly');
+  const readonlyDest = path.join(tmpdir.path, 'copytree-readonly-dest');
+  fs.mkdirSync(path.join(readonlySrc, 'dir'), { recursive: true });
+  fs.writeFileSync(path.join(readonlySrc, 'dir', 'file.txt'), 'data');
+  fs.chmodSync(path.join(readonlySrc, 'dir'), 0o555);
+  fs.copyTree(readonlySrc, readonlyDest, common.mustCall((err) => {
+    assert.ifError(err);
+    const dir = path.join(readonlyDest, 'dir');
+    assert.strictEqual(fs.statSync(dir).mode & 0o777, 0o555);
+    assert.strictEqual(fs.readFileSync(path.join(dir, 'file.txt'), 'utf8'),
+                       'data');
+    fs.chmodSync(dir, 0o755);
+    fs.chmodSync(path.join(readonlySrc, 'dir'), 0o755);
+  }));
+}
+
+// FIFOs are not opened, which would block until they have a writer.
+if (!common.isWindows) {
+  const fifoSrc = path.join(tmpdir.path, 'copytree-fifo');
+  fs.mkdirSync(fifoSrc);
+  const fifo = path.join(fifoSrc, 'fifo');
+  const mkfifo = require('child_process').spawnSync('mkfifo', [fifo]);
+  if (!mkfifo.error) {
+    fs.copyTree(fifoSrc, path.join(tmpdir.path, 'copytree-fifo-dest'),
+                common.mustCall((err) => {
+                  assert.strictEqual(err.code, 'EINVAL');
+                  assert.strictEqual(err.path, fifo);
+                }));
+  }
+}
+
+// Argument validation.
+{
+  // A directory cannot be copied into itself.
+  for (const dest of [src, path.join(src, 'a', 'copy'), `${src}/a/../b`]) {
+    assert.throws(() => fs.copyTree(src, dest, common.mustNotCall()), {
+      code: 'ERR_INVALID_ARG_VALUE'
+    });
+  }
+  fs.copyTree(src, `${src}-sibling`, common.mustCall((err) => {
+    assert.ifError(err);
+  }));
+
+  assert.throws(() => fs.copyTree(src, 'dest'), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+  assert.throws(() => fs.copyTree(src, 'dest', { concurrency: 0 },
+                                  common.mustNotCall()), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+  assert.throws(() => fs.copyTree(src, 'dest', { flags: 'x' },
+                                  common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
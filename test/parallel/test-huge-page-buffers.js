@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+assert.strictEqual(process.memoryUsage().hugePageBuffers, 0);
+
+if (!common.isLinux)
+  common.skip('huge page buffers are only supported on Linux');
+
+const code = `
+  const assert = require('assert');
+  const kMB = 1024 * 1024;
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 0);
+
+  // Smaller buffers are not affected.
+  const small = Buffer.alloc(kMB);
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 0);
+
+  const large = Buffer.alloc(3 * kMB);
+  assert(large.every((byte) => byte === 0));
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 4 * kMB);
+  large.fill(1);
+
+  const unsafe = Buffer.allocUnsafe(2 * kMB);
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 6 * kMB);
+  unsafe.fill(2);
+  assert.strictEqual(small.length + large.length + unsafe.length, 6 * kMB);
+
+  // Transferred buffers leave the pool, because the receiving side frees
+  // them on its own.
+  const { MessageChannel } = require('worker_threads');
+  const { port1, port2 } = new MessageChannel();
+  const transferred = new ArrayBuffer(4 * kMB);
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 10 * kMB);
+  port1.postMessage(transferred, [transferred]);
+  assert.strictEqual(transferred.byteLength, 0);
+  assert.strictEqual(process.memoryUsage().hugePageBuffers, 6 * kMB);
+  port2.once('message', (received) => {
+    assert.strictEqual(received.byteLength, 4 * kMB);
+    assert.strictEqual(process.memoryUsage().hugePageBuffers, 6 * kMB);
+    port2.close();
+  });
+`;
+for (const args of [[], ['--debug-arraybuffer-allocations']]) {
+  const child = spawnSync(process.execPath,
+                          ['--huge-page-buffers', ...args, '-e', code]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
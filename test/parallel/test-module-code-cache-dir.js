@@ -0,0 +1,91 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+const cacheDir = path.join(tmpdir.path, 'cache');
+const entry = path.join(tmpdir.path, 'entry.js');
+const dep = path.join(tmpdir.path, 'dep.js');
+
+fs.writeFileSync(entry, `
+  const { square } = require('./dep');
+  process.stdout.write(String(square(7)));
+`);
+fs.writeFileSync(dep, 'exports.square = (x) => x * x;');
+
+function run(expected, dir = cacheDir, args = []) {
+  const child = spawnSync(process.execPath,
+                          [`--experimental-code-cache-dir=${dir}`,
+                           ...args, entry],
+                          { env: { ...process.env, NODE_DEBUG: 'codecache' } });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString(), expected);
+  return child.stderr.toString();
+}
+
+function cacheFiles() {
+  return fs.readdirSync(cacheDir).sort();
+}
+
+// The first run writes a cache file for each module.
+let debug = run('49');
+assert(/wrote cache for .*entry\.js/.test(debug), debug);
+assert(/wrote cache for .*dep\.js/.test(debug), debug);
+const files = cacheFiles();
+assert.strictEqual(files.length, 2);
+assert(files.every((file) => file.endsWith('.cache')));
+const read = (file) => fs.readFileSync(path.join(cacheDir, file));
+const contents = files.map(read);
+
+// The second run uses them and does not write anything.
+debug = run('49');
+assert(!/wrote cache|stale cache|cache rejected/.test(debug), debug);
+assert.deepStrictEqual(cacheFiles(), files);
+assert.deepStrictEqual(files.map(read), contents);
+
+// A changed module is compiled from scratch and its cache file is replaced.
+fs.writeFileSync(dep, 'exports.square = (x) => x * x + 1;');
+debug = run('50');
+assert(/stale cache for .*dep\.js/.test(debug), debug);
+assert(/wrote cache for .*dep\.js/.test(debug), debug);
+assert(!/entry\.js/.test(debug), debug);
+assert.deepStrictEqual(cacheFiles(), files);
+
+// Corrupted cache files are ignored.
+for (const file of files)
+  fs.writeFileSync(path.join(cacheDir, file), 'garbage');
+run('50');
+
+// Once the cache files take up more than the maximum size, the least recently
+// written ones are removed. Here, the cache of dep.js is written first and
+// removed when the cache of entry.js is written.
+{
+  const sizes =
+    files.map((file) => fs.statSync(path.join(cacheDir, file)).size);
+  const smallCacheDir = path.join(tmpdir.path, 'small-cache');
+  const maxSize = Math.max(...sizes) + 1;
+  debug = run('50', smallCacheDir,
+              [`--experimental-code-cache-max-size=${maxSize}`]);
+  assert(/evicted /.test(debug), debug);
+  const remaining = fs.readdirSync(smallCacheDir);
+  assert.strictEqual(remaining.length, 1);
+  const cache = fs.readFileSync(path.join(smallCacheDir, remaining[0]));
+  assert(cache.includes(entry), remaining[0]);
+
+  // Modules whose cache does not fit are not cached at all.
+  const emptyCacheDir = path.join(tmpdir.path, 'empty-cache');
+  run('50', emptyCacheDir, ['--experimental-code-cache-max-size=1']);
+  assert(!fs.existsSync(emptyCacheDir));
+}
+
+// Unusable cache directories are ignored as well.
+const notADir = path.join(tmpdir.path, 'file');
+fs.writeFileSync(notADir, '');
+const child = spawnSync(process.execPath,
+                        [`--experimental-code-cache-dir=${notADir}`, entry]);
+assert.strictEqual(child.status, 0, child.stderr.toString());
+assert.strictEqual(child.stdout.toString(), '50');
@@ -0,0 +1,60 @@
+'use strict';
+const common = require('../common');
+if (!common.isLinux)
+  common.skip('SO_REUSEPORT load balancing is only tested on Linux');
+
+const assert = require('assert');
+const net = require('net');
+
+assert.throws(() => net.createServer().listen({ port: 0,
+                                                reusePortGroupSize: 2 }), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => net.createServer().listen({ port: 0,
+                                                reusePort: true,
+                                                reusePortGroupSize: 0 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+
+const kConnections = 20;
+let accepted = 0;
+
+function onConnection(socket) {
+  accepted++;
+  socket.end();
+}
+
+const first = net.createServer(onConnection);
+const second = net.createServer(onConnection);
+const options = {
+  host: common.localhostIPv4,
+  port: 0,
+  reusePort: true,
+  reusePortGroupSize: 2
+};
+
+first.listen(options, common.mustCall(() => {
+  const { port } = first.address();
+
+  // Without reusePort, the port is taken.
+  net.createServer().listen({ host: common.localhostIPv4, port })
+    .on('error', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'EADDRINUSE');
+    }));
+
+  second.listen({ ...options, port }, common.mustCall(() => {
+    assert.strictEqual(second.address().port, port);
+
+    let closed = 0;
+    for (let i = 0; i < kConnections; i++) {
+      net.connect(port, common.localhostIPv4).resume()
+        .on('close', common.mustCall(() => {
+          if (++closed < kConnections)
+            return;
+          assert.strictEqual(accepted, kConnections);
+          first.close();
+          second.close();
+        }));
+    }
+  }));
+}));
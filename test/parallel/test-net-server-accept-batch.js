@@ -0,0 +1,43 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+['acceptBatch', 'deferAccept', 'fastOpen'].forEach((name) => {
+  assert.throws(() => net.createServer().listen({ port: 0, [name]: -1 }), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+  assert.throws(() => net.createServer().listen({ port: 0, [name]: 'x' }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+
+const kConnections = 50;
+const options = { port: 0, host: common.localhostIPv4, acceptBatch: 16 };
+if (common.isLinux) {
+  options.deferAccept = 1;
+  options.fastOpen = 16;
+}
+
+const server = net.createServer(common.mustCall((socket) => {
+  socket.once('data', common.mustCall((data) => {
+    assert.strictEqual(data.toString(), 'ping');
+    socket.end('pong');
+  }));
+}, kConnections));
+
+server.listen(options, common.mustCall(() => {
+  let done = 0;
+  for (let i = 0; i < kConnections; i++) {
+    const client = net.connect(server.address().port, common.localhostIPv4);
+    client.write('ping');
+    client.setEncoding('utf8');
+    client.on('data', common.mustCall((data) => {
+      assert.strictEqual(data, 'pong');
+    }));
+    client.on('end', common.mustCall(() => {
+      if (++done === kConnections)
+        server.close();
+    }));
+  }
+}));
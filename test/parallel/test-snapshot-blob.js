@@ -0,0 +1,81 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const mksnapshot = path.join(
+  path.dirname(process.execPath),
+  `node_mksnapshot${common.isWindows ? '.exe' : ''}`);
+if (!fs.existsSync(mksnapshot))
+  common.skip('node_mksnapshot is not available');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+const entry = path.join(tmpdir.path, 'entry.js');
+const blob = path.join(tmpdir.path, 'snapshot.blob');
+
+fs.writeFileSync(entry, `
+  const squares = [];
+  for (let i = 0; i < 10; i++)
+    squares.push(i * i);
+  let pid;
+  startupSnapshot.addDeserializeCallback(({ process }) => {
+    pid = process.pid;
+  });
+  startupSnapshot.setDeserializeMainFunction(({ process, require }) => {
+    const assert = require('assert');
+    assert.strictEqual(pid, process.pid);
+    process.stdout.write(squares[process.argv[1]] + ',' + process.argv[2]);
+  });
+`);
+
+{
+  const child = spawnSync(mksnapshot, ['--blob', '--entry', entry, blob]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--snapshot-blob', blob, '7', 'foo'],
+                          { cwd: tmpdir.path });
+  assert.strictEqual(child.stderr.toString(), '');
+  assert.strictEqual(child.stdout.toString(), '49,foo');
+  assert.strictEqual(child.status, 0);
+}
+
+{
+  // Without an entry script, the snapshot only replaces the built-in one.
+  const plain = path.join(tmpdir.path, 'plain.blob');
+  let child = spawnSync(mksnapshot, ['--blob', plain]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  child = spawnSync(process.execPath,
+                    ['--snapshot-blob', plain, '-p', '6 * 7']);
+  assert.strictEqual(child.stdout.toString().trim(), '42');
+  assert.strictEqual(child.status, 0);
+}
+
+{
+  // The entry script has to set the main function.
+  fs.writeFileSync(entry, 'const x = 1;');
+  const child = spawnSync(mksnapshot, ['--entry', entry, blob]);
+  assert.strictEqual(child.status, 1);
+  assert(/did not call startupSnapshot\.setDeserializeMainFunction\(\)/
+    .test(child.stderr.toString()));
+}
+
+{
+  // Errors thrown by the entry script are reported.
+  fs.writeFileSync(entry, 'throw new Error("entry failed");');
+  const child = spawnSync(mksnapshot, ['--entry', entry, blob]);
+  assert.strictEqual(child.status, 1);
+  assert(/entry failed/.test(child.stderr.toString()));
+}
+
+{
+  // Other files are rejected.
+  const child = spawnSync(process.execPath, ['--snapshot-blob', entry]);
+  assert.strictEqual(child.status, 9);
+  assert(/is not a snapshot file/.test(child.stderr.toString()));
+}
@@ -86,6 +86,30 @@ test('ucs2', Buffer.from('ababc', 'ucs2'), 'ababc');
 // UTF-16LE
 test('utf16le', Buffer.from('3DD84DDC', 'hex'), '\ud83d\udc4d'); // thumbs up
 
+// Long inputs that are ASCII-only, Latin-1 or mixed, with chunk boundaries
+// at every position relative to the vector width.
+for (const str of ['ascii only '.repeat(10),
+                   'héllo wörld '.repeat(10),
+                   'ascii, then € and 😀 '.repeat(5)]) {
+  const input = Buffer.from(str);
+  for (let i = 0; i <= 48; i++) {
+    decoder = new StringDecoder('utf8');
+    assert.strictEqual(decoder.write(input.slice(0, i)) +
+                       decoder.write(input.slice(i)) +
+                       decoder.end(), str);
+  }
+}
+
+// UTF-16LE data that is not 2-byte aligned in memory.
+{
+  const str = 'unaligned ✓ '.repeat(20);
+  const input = Buffer.concat([Buffer.from([0]), Buffer.from(str, 'utf16le')]);
+  decoder = new StringDecoder('utf16le');
+  assert.strictEqual(decoder.write(input.slice(1, 100)) +
+                     decoder.write(input.slice(100)) +
+                     decoder.end(), str);
+}
+
 // Additional UTF-8 tests
 decoder = new StringDecoder('utf8');
 assert.strictEqual(decoder.write(Buffer.from('E1', 'hex')), '');
@@ -0,0 +1,29 @@
+'use strict';
+
+// This tests that timers with many different durations expire in order, also
+// when more of their lists are created and expire at once than fit into a
+// single batch of the native timer wheel.
+
+const common = require('../common');
+const assert = require('assert');
+
+const N = 1500;
+const order = [];
+
+for (let i = 1; i <= N; i++) {
+  setTimeout(() => order.push(i), i);
+  // Timers that are cleared, and so their lists deleted, before they expire
+  // do not fire.
+  if (i % 2 === 0)
+    clearTimeout(setTimeout(common.mustNotCall(), N + i));
+}
+
+// Block the event loop until all of the timers above have expired, so that
+// they are all run in the same iteration of the loop.
+common.busyLoop(N + 100);
+
+setTimeout(common.mustCall(() => {
+  assert.strictEqual(order.length, N);
+  for (let i = 0; i < N; i++)
+    assert.strictEqual(order[i], i + 1);
+}), N + 1);
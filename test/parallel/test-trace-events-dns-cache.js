@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const path = require('path');
+const fs = require('fs');
+const tmpdir = require('../common/tmpdir');
+
+// Every lookup that is started ends, including the ones that wait for an
+// identical lookup in flight and the ones answered from the cache.
+
+if (process.argv[2] === 'child') {
+  const dns = require('dns');
+  const lookup = () => new Promise((resolve, reject) => {
+    dns.lookup('localhost', (err) => {
+      if (err) reject(err);
+      else resolve();
+    });
+  });
+  Promise.all([lookup(), lookup(), lookup()]).then(lookup)
+    .then(common.mustCall(() => {
+      assert.deepStrictEqual(dns.getCacheStats(),
+                             { hits: 1, misses: 3, coalesced: 2, entries: 1 });
+    }));
+} else {
+  tmpdir.refresh();
+
+  const proc = cp.fork(__filename,
+                       [ 'child' ], {
+                         cwd: tmpdir.path,
+                         execArgv: [
+                           '--dns-cache-max-ttl=60',
+                           '--trace-event-categories',
+                           'node.dns.native'
+                         ]
+                       });
+
+  proc.once('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+    const file = path.join(tmpdir.path, 'node_trace.1.log');
+    const traces = JSON.parse(fs.readFileSync(file)).traceEvents
+      .filter((trace) => trace.name === 'lookup');
+    const begins = traces.filter((trace) => trace.ph === 'b');
+    const ends = traces.filter((trace) => trace.ph === 'e');
+    assert.strictEqual(begins.length, 4);
+    assert.deepStrictEqual(ends.map((trace) => trace.id).sort(),
+                           begins.map((trace) => trace.id).sort());
+  }));
+}
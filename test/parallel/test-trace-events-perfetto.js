@@ -0,0 +1,134 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const CODE =
+  'setTimeout(() => { for (var i = 0; i < 100000; i++) { "test" + i } }, 1);' +
+  'const { performance } = require("perf_hooks");' +
+  'performance.mark("A"); performance.mark("B");' +
+  'performance.measure("A to B", "A", "B");';
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+const FILE_NAME = path.join(tmpdir.path, 'node_trace.1.log');
+
+// Decodes the fields of a protobuf message into a map from field number to
+// the list of values, where length-delimited values are Buffers.
+function decode(buffer) {
+  const fields = new Map();
+  let offset = 0;
+  function varint() {
+    let value = 0n;
+    let shift = 0n;
+    let byte;
+    do {
+      assert(offset < buffer.length);
+      byte = buffer[offset++];
+      value |= BigInt(byte & 0x7f) << shift;
+      shift += 7n;
+    } while (byte & 0x80);
+    return value;
+  }
+  while (offset < buffer.length) {
+    const tag = Number(varint());
+    let value;
+    switch (tag & 7) {
+      case 0:
+        value = varint();
+        break;
+      case 1:
+        value = buffer.readDoubleLE(offset);
+        offset += 8;
+        break;
+      case 2: {
+        const length = Number(varint());
+        value = buffer.slice(offset, offset + length);
+        assert.strictEqual(value.length, length);
+        offset += length;
+        break;
+      }
+      default:
+        assert.fail(`unexpected wire type in tag ${tag}`);
+    }
+    const field = tag >> 3;
+    if (!fields.has(field))
+      fields.set(field, []);
+    fields.get(field).push(value);
+  }
+  return fields;
+}
+
+function interned(packets, field) {
+  const names = [];
+  for (const packet of packets) {
+    for (const data of packet.get(12) || []) {
+      for (const entry of decode(data).get(field) || [])
+        names.push(decode(entry).get(2)[0].toString());
+    }
+  }
+  return names;
+}
+
+const proc = cp.spawn(process.execPath,
+                      [ '--trace-event-categories', 'node.perf.usertiming',
+                        '--trace-event-format=perfetto',
+                        '--title=bar',
+                        '-e', CODE ],
+                      { cwd: tmpdir.path });
+proc.once('exit', common.mustCall((code) => {
+  assert.strictEqual(code, 0);
+  assert(fs.existsSync(FILE_NAME));
+  fs.readFile(FILE_NAME, common.mustCall((err, data) => {
+    assert.ifError(err);
+    const trace = decode(data);
+    assert.deepStrictEqual([...trace.keys()], [1]);
+    const packets = trace.get(1).map(decode);
+
+    // Every packet belongs to a sequence.
+    assert(packets.every((packet) => packet.has(10)));
+
+    const threads = packets
+      .filter((packet) => packet.has(44))
+      .map((packet) => decode(packet.get(44)[0]))
+      .filter((descriptor) => descriptor.has(5));
+    const threadNames = threads
+      .map((descriptor) => descriptor.get(5)[0].toString());
+    assert(threadNames.includes('JavaScriptMainThread'));
+    assert(threadNames.includes('PlatformWorkerThread'));
+    // Metadata is flushed repeatedly, but each thread is only described once.
+    const tids = threads.map((descriptor) => descriptor.get(2)[0]);
+    assert.strictEqual(new Set(tids).size, tids.length);
+
+    if (!common.isSunOS) {
+      // Changing process.title is currently unsupported on SunOS/SmartOS
+      const processNames = packets
+        .filter((packet) => packet.has(43))
+        .map((packet) => decode(packet.get(43)[0]).get(6)[0].toString());
+      assert.strictEqual(
+        processNames.filter((name) => name === 'bar').length, 1);
+    }
+
+    const events = packets.filter((packet) => packet.has(11));
+    assert(events.length > 0);
+    assert(interned(packets, 1)
+      .includes('node,node.perf,node.perf.usertiming'));
+    const names = interned(packets, 2);
+    assert(names.includes('A'));
+    assert(names.includes('A to B'));
+    // Names are only interned once per sequence.
+    const sequences = new Set(packets.map((packet) => packet.get(10)[0]));
+    assert(names.filter((name) => name === 'A').length <= sequences.size);
+  }));
+}));
+
+proc.stderr.pipe(process.stderr);
+
+// Invalid formats are rejected.
+const child = cp.spawnSync(process.execPath,
+                           [ '--trace-event-format=xml', '-e', '' ]);
+assert.strictEqual(child.status, 9);
+assert(/--trace-event-format must be either 'json' or 'perfetto'/
+  .test(child.stderr.toString()));
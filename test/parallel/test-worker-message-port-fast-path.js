@@ -0,0 +1,95 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { MessageChannel, receiveMessageOnPort } = require('worker_threads');
+
+// Strings, ArrayBuffers and Uint8Arrays are sent without the ValueSerializer.
+// Make sure that they are received the same way as before.
+
+const { port1, port2 } = new MessageChannel();
+
+function roundTrip(value, transferList) {
+  port1.postMessage(value, transferList);
+  const { message } = receiveMessageOnPort(port2);
+  assert.strictEqual(receiveMessageOnPort(port2), undefined);
+  return message;
+}
+
+for (const string of ['', 'hello', 'café', '\u{1F600} two-byte',
+                      'x'.repeat(100000)]) {
+  assert.strictEqual(roundTrip(string), string);
+}
+
+{
+  // Copied ArrayBuffer.
+  const ab = new Uint8Array([1, 2, 3]).buffer;
+  const received = roundTrip(ab);
+  assert(received instanceof ArrayBuffer);
+  assert.notStrictEqual(received, ab);
+  assert.deepStrictEqual(new Uint8Array(received), new Uint8Array([1, 2, 3]));
+  assert.strictEqual(ab.byteLength, 3);
+}
+
+{
+  // Transferred ArrayBuffer.
+  const ab = new Uint8Array([1, 2, 3]).buffer;
+  const received = roundTrip(ab, [ab]);
+  assert.deepStrictEqual(new Uint8Array(received), new Uint8Array([1, 2, 3]));
+  assert.strictEqual(ab.byteLength, 0);
+}
+
+{
+  // Copied Uint8Array. Like with the ValueSerializer, the whole ArrayBuffer
+  // is copied and the offset of the view is kept.
+  const buf = Buffer.from('hello world');
+  const received = roundTrip(buf);
+  assert.strictEqual(Object.getPrototypeOf(received), Uint8Array.prototype);
+  assert.strictEqual(Buffer.from(received).toString(), 'hello world');
+  assert.strictEqual(received.byteOffset, buf.byteOffset);
+  assert.strictEqual(received.buffer.byteLength, buf.buffer.byteLength);
+  assert.strictEqual(buf.toString(), 'hello world');
+}
+
+{
+  // Transferred Uint8Array.
+  const ab = new ArrayBuffer(16);
+  const view = new Uint8Array(ab, 4, 8);
+  view.fill(7);
+  const received = roundTrip(view, [ab]);
+  assert.strictEqual(received.byteOffset, 4);
+  assert.strictEqual(received.length, 8);
+  assert.strictEqual(received.buffer.byteLength, 16);
+  assert.deepStrictEqual(received, new Uint8Array(8).fill(7));
+  assert.strictEqual(ab.byteLength, 0);
+  assert.strictEqual(view.length, 0);
+}
+
+{
+  // Transfer lists with other objects still work.
+  const other = new ArrayBuffer(4);
+  const received = roundTrip(new Uint8Array([5]), [other]);
+  assert.deepStrictEqual(received, new Uint8Array([5]));
+  assert.strictEqual(other.byteLength, 0);
+
+  const { port1: otherPort } = new MessageChannel();
+  assert.strictEqual(roundTrip('hello', [otherPort]), 'hello');
+}
+
+{
+  // Views on SharedArrayBuffers share their memory.
+  const view = new Uint8Array(new SharedArrayBuffer(4));
+  const received = roundTrip(view);
+  received[0] = 42;
+  assert.strictEqual(view[0], 42);
+}
+
+{
+  // Detached ArrayBuffers are still rejected.
+  const ab = new ArrayBuffer(8);
+  roundTrip(ab, [ab]);
+  assert.throws(() => port1.postMessage(ab), {
+    name: 'DataCloneError'
+  });
+}
+
+port1.close();
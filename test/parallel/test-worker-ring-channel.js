@@ -0,0 +1,105 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Worker, RingChannel } = require('worker_threads');
+
+{
+  const channel = new RingChannel(1024);
+  assert.strictEqual(channel.capacity, 1024);
+  assert(channel.buffer instanceof SharedArrayBuffer);
+  assert.strictEqual(channel.tryRead(), undefined);
+  assert.strictEqual(channel.read(0), undefined);
+
+  const values = [
+    'hello',
+    '',
+    'café',
+    '\u{1F600} two-byte',
+    Buffer.from([1, 2, 3]),
+    Buffer.alloc(0)
+  ];
+  for (const value of values)
+    assert.strictEqual(channel.tryWrite(value), true);
+  assert.strictEqual(channel.tryWrite(new Uint16Array([1, 256])), true);
+  assert.strictEqual(channel.tryWrite(new Uint8Array([4, 5]).buffer), true);
+
+  // A second instance for the same buffer sees the same messages.
+  const reader = new RingChannel(channel.buffer);
+  for (const value of values)
+    assert.deepStrictEqual(reader.read(), value);
+  assert.deepStrictEqual(reader.read(), Buffer.from([1, 0, 0, 1]));
+  assert.deepStrictEqual(reader.read(), Buffer.from([4, 5]));
+  assert.strictEqual(reader.tryRead(), undefined);
+}
+
+{
+  // Messages that wrap around the end of the ring are padded, and the
+  // space is reused once they have been read.
+  const channel = new RingChannel(1024);
+  const message = Buffer.alloc(300, 'x');
+  let written = 0;
+  while (channel.tryWrite(message))
+    written++;
+  assert.strictEqual(written, 3);
+  assert.strictEqual(channel.write(message, 10), false);
+  for (let i = 0; i < 100; i++) {
+    assert.deepStrictEqual(channel.read(), message);
+    assert.strictEqual(channel.tryWrite(message), true);
+  }
+
+  assert.throws(() => channel.tryWrite(Buffer.alloc(512)), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+  assert.throws(() => channel.tryWrite({}), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => channel.read(-1), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+}
+
+for (const capacity of [0, 1000, 1023, 2 ** 31, 1.5, NaN]) {
+  assert.throws(() => new RingChannel(capacity), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+}
+assert.throws(() => new RingChannel(new SharedArrayBuffer(1024)), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => new RingChannel(new ArrayBuffer(2048)), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+{
+  // Several writers and a blocking reader. The ring is small enough that
+  // the writers have to block as well.
+  const kWriters = 3;
+  const kMessages = 5000;
+  const channel = new RingChannel(4096);
+  const workers = [];
+  for (let i = 0; i < kWriters; i++) {
+    const worker = new Worker(`
+      const { RingChannel, workerData } = require('worker_threads');
+      const channel = new RingChannel(workerData.buffer);
+      for (let i = 0; i < ${kMessages}; i++) {
+        if (i % 2 === 0)
+          channel.write(\`\${workerData.id}:\${i}\`);
+        else
+          channel.write(Buffer.from(\`\${workerData.id}:\${i}\`));
+      }
+    `, { eval: true, workerData: { buffer: channel.buffer, id: i } });
+    worker.on('exit', common.mustCall((code) => {
+      assert.strictEqual(code, 0);
+    }));
+    workers.push(worker);
+  }
+
+  const next = new Array(kWriters).fill(0);
+  for (let received = 0; received < kWriters * kMessages; received++) {
+    const message = channel.read();
+    const [id, i] = `${message}`.split(':').map(Number);
+    assert.strictEqual(i, next[id]++);
+    assert.strictEqual(typeof message === 'string', i % 2 === 0);
+  }
+  assert.strictEqual(channel.read(10), undefined);
+}
@@ -0,0 +1,26 @@
+// Flags: --expose-internals
+'use strict';
+require('../common');
+const { validateSnapshotNodes } = require('../common/heap');
+const { Searcher } = require('buffer');
+
+validateSnapshotNodes('Node / BufferSearch', []);
+const searcher = new Searcher('needle');
+validateSnapshotNodes('Node / BufferSearch', [
+  {
+    children: [
+      { node_name: 'Node / needle', edge_name: 'needle' }
+    ]
+  }
+]);
+
+// The search tables are created on first use.
+searcher.indexOf(Buffer.from('haystack with a needle'));
+validateSnapshotNodes('Node / BufferSearch', [
+  {
+    children: [
+      { node_name: 'Node / needle', edge_name: 'needle' },
+      { node_name: 'Node / search', edge_name: 'search' }
+    ]
+  }
+]);
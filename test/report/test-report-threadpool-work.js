@@ -0,0 +1,80 @@
+// Flags: --experimental-report --threadpool-limits=crypto=1
+'use strict';
+const common = require('../common');
+common.skipIfReportDisabled();
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const crypto = require('crypto');
+const helper = require('../common/report');
+
+common.expectWarning('ExperimentalWarning',
+                     'report is an experimental feature. This feature could ' +
+                     'change at any time');
+
+const kJobs = 4;
+
+{
+  // Only one crypto job is handed to the threadpool at a time; the others
+  // wait in the crypto queue.
+  const onDone = common.mustCall((err) => {
+    assert.ifError(err);
+  }, kJobs);
+  for (let i = 0; i < kJobs; i++)
+    crypto.pbkdf2('password', 'salt', 1000, 64, 'sha512', onDone);
+
+  const report = process.report.getReport();
+  helper.validateContent(report);
+  const { threads, crypto: stats, fs } = report.threadpoolWork;
+  assert(threads >= 1);
+  assert.strictEqual(stats.limit, 1);
+  assert.strictEqual(stats.running, 1);
+  assert.strictEqual(stats.queued, kJobs - 1);
+  assert.strictEqual(fs.limit, Math.max(threads - 1, 1));
+}
+
+process.on('exit', () => {
+  const { crypto: stats } = process.report.getReport().threadpoolWork;
+  assert.strictEqual(stats.running, 0);
+  assert.strictEqual(stats.queued, 0);
+  assert.strictEqual(stats.completed, kJobs);
+  assert(stats.totalWaitMs >= stats.maxWaitMs);
+});
+
+// Work is not limited without --threadpool-limits.
+{
+  const child = spawnSync(process.execPath, [
+    '--experimental-report',
+    '-p', 'JSON.stringify(process.report.getReport().threadpoolWork.zlib)'
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(JSON.parse(child.stdout).limit, 0);
+}
+
+// The threadpool size is read when work is first scheduled, like libuv does,
+// so it can still be set from JavaScript.
+{
+  const script = `
+    process.env.UV_THREADPOOL_SIZE = '64';
+    require('crypto').randomBytes(16, () => {});
+    const { threads, fs } = process.report.getReport().threadpoolWork;
+    console.log(JSON.stringify({ threads, limit: fs.limit }));
+  `;
+  const env = { ...process.env };
+  delete env.UV_THREADPOOL_SIZE;
+  const child = spawnSync(process.execPath, [
+    '--experimental-report', '--threadpool-limits=crypto=1', '-e', script
+  ], { env });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.deepStrictEqual(JSON.parse(child.stdout), { threads: 64, limit: 63 });
+}
+
+// Invalid limits are rejected at startup.
+for (const limits of ['crypto', 'gpu=1', 'zlib=0', 'addon=-1', 'fs=1x']) {
+  const child = spawnSync(process.execPath,
+                          [`--threadpool-limits=${limits}`, '-e', '0']);
+  assert.strictEqual(child.status, 9);
+  assert(child.stderr.toString().includes('--threadpool-limits: '),
+         child.stderr.toString());
+}
@@ -152,6 +152,9 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
 
   const StatWatcher = binding.StatWatcher;
   testInitialized(new StatWatcher(), 'StatWatcher');
+
+  const CopyTreeJob = binding.CopyTreeJob;
+  testInitialized(new CopyTreeJob('src', 'dest', 0, 1), 'CopyTreeJob');
 }
 
 
@@ -0,0 +1,71 @@
+'use strict';
+
+// This tests that --cpu-prof-continuous writes pprof profiles on signal and
+// on exit, and only keeps --cpu-prof-continuous-max-files of them.
+
+const common = require('../common');
+common.skipIfInspectorDisabled();
+if (common.isWindows)
+  common.skip('no SIGUSR2 on Windows');
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const { spawnSync } = require('child_process');
+
+const tmpdir = require('../common/tmpdir');
+
+function getPprofProfiles(dir) {
+  return fs.readdirSync(dir)
+    .filter((file) => file.startsWith('CPU.') && file.endsWith('.pb.gz'))
+    .map((file) => path.join(dir, file));
+}
+
+// Writes a profile on each signal, and one more on exit.
+const script = `
+  function fib(n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+  }
+  for (let i = 0; i < 3; i++) {
+    fib(25);
+    process.kill(process.pid, 'SIGUSR2');
+  }
+  setTimeout(() => fib(25), 100);
+`;
+
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'profiles');
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-continuous',
+    '--cpu-prof-continuous-interval', '100',
+    '--cpu-prof-continuous-signal', 'SIGUSR2',
+    '--cpu-prof-continuous-max-files', '2',
+    '--cpu-prof-dir', dir,
+    '-e', script
+  ], { cwd: tmpdir.path });
+  if (output.status !== 0)
+    console.log(output.stderr.toString());
+  assert.strictEqual(output.status, 0);
+
+  const profiles = getPprofProfiles(dir);
+  assert.strictEqual(profiles.length, 2);
+  for (const file of profiles) {
+    const profile = zlib.gunzipSync(fs.readFileSync(file));
+    // The string table includes the names of the sampled functions.
+    assert(profile.includes('(program)') || profile.includes('fib'));
+  }
+}
+
+// Invalid options.
+{
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-continuous',
+    '--cpu-prof-continuous-signal', 'SIGNOPE',
+    '-e', '0'
+  ]);
+  assert.strictEqual(output.status, 9);
+  assert(output.stderr.toString().includes(
+    'invalid value for --cpu-prof-continuous-signal'));
+}
@@ -205,7 +205,30 @@ const env = {
   assert.strictEqual(output.status, 9);
   assert.strictEqual(
     stderr,
-    `${process.execPath}: --cpu-prof-dir must be used with --cpu-prof`);
+    `${process.execPath}: --cpu-prof-dir must be used with --cpu-prof ` +
+    'or --cpu-prof-continuous');
+}
+
+// --cpu-prof-dir with --cpu-prof-continuous
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'prof');
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-continuous',
+    '--cpu-prof-dir',
+    dir,
+    fixtures.path('workload', 'fibonacci.js'),
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  if (output.status !== 0) {
+    console.log(output.stderr.toString());
+  }
+  assert.strictEqual(output.status, 0);
+  const profiles = fs.readdirSync(dir)
+    .filter((file) => file.startsWith('CPU.') && file.endsWith('.pb.gz'));
+  assert.strictEqual(profiles.length, 1);
 }
 
 // --cpu-prof-interval without --cpu-prof
@@ -0,0 +1,115 @@
+'use strict';
+
+// This tests that --heap-prof-continuous writes pprof profiles of the live
+// allocations on process.report.writeHeapProfile(), on signal and on exit,
+// and only keeps the --heap-prof-continuous-max-files most recent of them.
+
+const common = require('../common');
+common.skipIfInspectorDisabled();
+common.skipIfReportDisabled();
+if (common.isWindows)
+  common.skip('no SIGUSR2 on Windows');
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const { spawnSync } = require('child_process');
+
+const tmpdir = require('../common/tmpdir');
+
+function isProfile(file) {
+  return file.startsWith('Heap.') && file.endsWith('.pb.gz');
+}
+
+function getPprofProfiles(dir) {
+  return fs.readdirSync(dir)
+    .filter(isProfile)
+    .map((file) => path.join(dir, file));
+}
+
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'profiles');
+  // Writes a profile on demand and one on signal, then one more on exit.
+  // The timer keeps the event loop alive until the signal has been handled,
+  // and prints the profiles that have been written by then.
+  const script = `
+    const fs = require('fs');
+    const retained = [];
+    function allocate() {
+      for (let i = 0; i < 1000; i++)
+        retained.push(new Array(100).fill(i));
+    }
+    allocate();
+    console.log(process.report.writeHeapProfile());
+    allocate();
+    process.kill(process.pid, 'SIGUSR2');
+    setTimeout(() => {
+      allocate();
+      const files = fs.readdirSync(${JSON.stringify(dir)})
+        .filter((file) => file.endsWith('.pb.gz'));
+      console.log(JSON.stringify(files));
+    }, 100);
+  `;
+  const output = spawnSync(process.execPath, [
+    '--experimental-report',
+    '--heap-prof-continuous',
+    '--heap-prof-continuous-interval', '1024',
+    '--heap-prof-continuous-signal', 'SIGUSR2',
+    '--heap-prof-continuous-max-files', '2',
+    '--heap-prof-dir', dir,
+    '-e', script
+  ], { cwd: tmpdir.path });
+  if (output.status !== 0)
+    console.log(output.stderr.toString());
+  assert.strictEqual(output.status, 0);
+
+  const lines = output.stdout.toString().trim().split('\n');
+  assert.strictEqual(lines.length, 2);
+  const written = path.basename(lines[0]);
+  assert(isProfile(written), written);
+  assert.strictEqual(path.dirname(lines[0]), dir);
+  // The profile written on signal follows the one written on demand.
+  const beforeExit = JSON.parse(lines[1]);
+  assert.strictEqual(beforeExit.length, 2);
+  assert(beforeExit.includes(written), `${written} not in ${beforeExit}`);
+  const onSignal = beforeExit.find((file) => file !== written);
+
+  // Only the two most recent profiles are kept: the one written on signal and
+  // the one written on exit.
+  const profiles = getPprofProfiles(dir);
+  assert.strictEqual(profiles.length, 2);
+  const kept = profiles.map((file) => path.basename(file));
+  assert(!kept.includes(written), `${written} in ${kept}`);
+  assert(kept.includes(onSignal), `${onSignal} not in ${kept}`);
+  for (const file of profiles) {
+    const profile = zlib.gunzipSync(fs.readFileSync(file));
+    // The string table includes the sample types and the allocating function.
+    assert(profile.includes('inuse_space'));
+    assert(profile.includes('allocate'));
+  }
+}
+
+// process.report.writeHeapProfile() does nothing without
+// --heap-prof-continuous.
+{
+  const output = spawnSync(process.execPath, [
+    '--experimental-report',
+    '-p', 'process.report.writeHeapProfile()'
+  ]);
+  assert.strictEqual(output.status, 0);
+  assert.strictEqual(output.stdout.toString().trim(), 'undefined');
+}
+
+// Invalid options.
+{
+  const output = spawnSync(process.execPath, [
+    '--heap-prof-continuous',
+    '--heap-prof-continuous-signal', 'SIGNOPE',
+    '-e', '0'
+  ]);
+  assert.strictEqual(output.status, 9);
+  assert(output.stderr.toString().includes(
+    'invalid value for --heap-prof-continuous-signal'));
+}
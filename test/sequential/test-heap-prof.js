@@ -213,7 +213,32 @@ const env = {
   assert.strictEqual(output.status, 9);
   assert.strictEqual(
     stderr,
-    `${process.execPath}: --heap-prof-dir must be used with --heap-prof`);
+    `${process.execPath}: --heap-prof-dir must be used with --heap-prof ` +
+    'or --heap-prof-continuous');
+}
+
+// --heap-prof-dir with --heap-prof-continuous
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'prof');
+  const output = spawnSync(process.execPath, [
+    '--heap-prof-continuous',
+    '--heap-prof-continuous-interval',
+    kHeapProfInterval,
+    '--heap-prof-dir',
+    dir,
+    fixtures.path('workload', 'allocation.js'),
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  if (output.status !== 0) {
+    console.log(output.stderr.toString());
+  }
+  assert.strictEqual(output.status, 0);
+  const profiles = fs.readdirSync(dir)
+    .filter((file) => file.startsWith('Heap.') && file.endsWith('.pb.gz'));
+  assert.strictEqual(profiles.length, 1);
 }
 
 // --heap-prof-interval without --heap-prof
@@ -0,0 +1,83 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const {
+  monitorEventLoopUtilization
+} = require('perf_hooks');
+
+{
+  const monitor = monitorEventLoopUtilization();
+  assert(monitor.enable());
+  assert(!monitor.enable());
+  monitor.reset();
+  assert(monitor.disable());
+  assert(!monitor.disable());
+}
+
+{
+  const monitor = monitorEventLoopUtilization();
+  assert.strictEqual(monitor.idle, 0);
+  assert.strictEqual(monitor.active, 0);
+  assert.strictEqual(monitor.utilization, 0);
+  assert.deepStrictEqual(monitor.phases,
+                         { timers: 0, poll: 0, check: 0, close: 0 });
+}
+
+{
+  const busy = 100;
+  const monitor = monitorEventLoopUtilization();
+  monitor.enable();
+
+  // The loop is busy in a timer and in an immediate, and idle while it waits
+  // for the next timer.
+  let m = 3;
+  function spinAWhile() {
+    common.busyLoop(busy);
+    setImmediate(() => common.busyLoop(busy));
+    if (--m > 0) {
+      setTimeout(spinAWhile, common.platformTimeout(200));
+    } else {
+      setTimeout(check, common.platformTimeout(200));
+    }
+  }
+  setTimeout(spinAWhile, common.platformTimeout(200));
+
+  function check() {
+    monitor.disable();
+    const { idle, active, utilization, phases, callbacks } = monitor;
+    // The values are non-deterministic, so we only check that they are
+    // consistent with the time the loop was known to be busy and idle.
+    assert(active >= 6 * busy, `active: ${active}`);
+    assert(idle >= 200, `idle: ${idle}`);
+    assert(utilization > 0 && utilization < 1, `utilization: ${utilization}`);
+    assert(phases.timers >= 3 * busy, `timers: ${phases.timers}`);
+    assert(phases.check >= 3 * busy, `check: ${phases.check}`);
+    assert(phases.poll >= idle, `poll: ${phases.poll}`);
+    assert(phases.close >= 0, `close: ${phases.close}`);
+    assert(callbacks.max >= busy * 1e6, `callbacks.max: ${callbacks.max}`);
+    assert(callbacks.min > 0);
+    assert(callbacks.percentiles.size > 0);
+    assert(callbacks.percentile(50) > 0);
+
+    // Nothing is measured while the monitor is disabled.
+    setTimeout(common.mustCall(() => {
+      assert.strictEqual(monitor.idle, idle);
+      assert.strictEqual(monitor.active, active);
+
+      monitor.reset();
+      assert.strictEqual(monitor.idle, 0);
+      assert.strictEqual(monitor.active, 0);
+      assert.strictEqual(monitor.phases.timers, 0);
+      assert.strictEqual(monitor.callbacks.max, 0);
+
+      common.expectsError(
+        () => monitor.callbacks.percentile('a'),
+        {
+          type: TypeError,
+          code: 'ERR_INVALID_ARG_TYPE'
+        }
+      );
+    }), common.platformTimeout(100));
+  }
+}
@@ -105,6 +105,8 @@ const customTypesMap = {
 
   'os.constants.dlopen': 'os.html#os_dlopen_constants',
 
+  'EventLoopUtilizationMonitor':
+    'perf_hooks.html#perf_hooks_class_eventlooputilizationmonitor',
   'Histogram': 'perf_hooks.html#perf_hooks_class_histogram',
   'PerformanceEntry': 'perf_hooks.html#perf_hooks_class_performanceentry',
   'PerformanceNodeTiming':
@@ -14,20 +14,70 @@
 #ifdef _WIN32
 #include <windows.h>
 
+static std::string ToUtf8(const wchar_t* arg) {
+  int size =
+      WideCharToMultiByte(CP_UTF8, 0, arg, -1, nullptr, 0, nullptr, nullptr);
+  std::string result(size, '\0');
+  WideCharToMultiByte(CP_UTF8, 0, arg, -1, &result[0], size, nullptr, nullptr);
+  result.resize(size - 1);
+  return result;
+}
+
 int wmain(int argc, wchar_t* argv[]) {
 #else   // UNIX
+static std::string ToUtf8(const char* arg) {
+  return arg;
+}
+
 int main(int argc, char* argv[]) {
 #endif  // _WIN32
 
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <path/to/output.cc>\n";
+  // node_mksnapshot [--blob] [--entry <path/to/entry.js>] <path/to/output>
+  //
+  // Without --blob, the output is C++ source that embeds the snapshot into
+  // the binary. With --blob, it is a file for `node --snapshot-blob`.
+  // --entry implies --blob.
+  bool blob = false;
+  std::string entry_filename;
+  int i = 1;
+  for (; i < argc - 1; i++) {
+    const std::string arg = ToUtf8(argv[i]);
+    if (arg == "--blob") {
+      blob = true;
+    } else if (arg == "--entry" && i + 1 < argc - 1) {
+      blob = true;
+      entry_filename = ToUtf8(argv[++i]);
+    } else {
+      break;
+    }
+  }
+  if (i != argc - 1) {
+    std::cerr << "Usage: " << argv[0] << " <path/to/output.cc>\n"
+              << "       " << argv[0]
+              << " --blob [--entry <path/to/entry.js>] <path/to/output>\n";
     return 1;
   }
 
+  std::string entry_source;
+  if (!entry_filename.empty()) {
+    std::ifstream entry(entry_filename, std::ios::in | std::ios::binary);
+    if (!entry.is_open()) {
+      std::cerr << "Cannot open " << entry_filename << "\n";
+      return 1;
+    }
+    std::stringstream ss;
+    ss << entry.rdbuf();
+    entry_source = ss.str();
+    if (entry_source.empty()) {
+      std::cerr << entry_filename << " is empty\n";
+      return 1;
+    }
+  }
+
   std::ofstream out;
-  out.open(argv[1], std::ios::out | std::ios::binary);
+  out.open(argv[i], std::ios::out | std::ios::binary);
   if (!out.is_open()) {
-    std::cerr << "Cannot open " << argv[1] << "\n";
+    std::cerr << "Cannot open " << argv[i] << "\n";
     return 1;
   }
 
@@ -40,7 +90,23 @@ int main(int argc, char* argv[]) {
   CHECK(!result.early_return);
   CHECK_EQ(result.exit_code, 0);
 
-  {
+  int exit_code = 0;
+  if (blob) {
+    std::string snapshot;
+    std::string error;
+    if (node::SnapshotBuilder::GenerateFile(result.args,
+                                            result.exec_args,
+                                            entry_filename,
+                                            entry_source,
+                                            &snapshot,
+                                            &error)) {
+      out << snapshot;
+    } else {
+      std::cerr << error << "\n";
+      exit_code = 1;
+    }
+    out.close();
+  } else {
     std::string snapshot =
         node::SnapshotBuilder::Generate(result.args, result.exec_args);
     out << snapshot;
@@ -48,5 +114,5 @@ int main(int argc, char* argv[]) {
   }
 
   node::TearDownOncePerProcess();
-  return 0;
+  return exit_code;
 }
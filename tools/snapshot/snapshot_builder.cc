@@ -4,16 +4,27 @@
 #include "node_internals.h"
 #include "node_main_instance.h"
 #include "node_v8_platform-inl.h"
+#include "util-inl.h"
 
 namespace node {
 
 using v8::Context;
+using v8::Function;
 using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
 using v8::Locker;
+using v8::MaybeLocal;
+using v8::NewStringType;
+using v8::Object;
+using v8::Script;
+using v8::ScriptOrigin;
 using v8::SnapshotCreator;
 using v8::StartupData;
+using v8::String;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::Value;
 
 template <typename T>
 void WriteVector(std::stringstream* ss, const T* vec, size_t size) {
@@ -62,9 +73,104 @@ const std::vector<size_t>* NodeMainInstance::GetIsolateDataIndexes() {
   return ss.str();
 }
 
-std::string SnapshotBuilder::Generate(
-    const std::vector<std::string> args,
-    const std::vector<std::string> exec_args) {
+// Defines the `startupSnapshot` global of the user context. The returned
+// state object is added to the snapshot and read by
+// lib/internal/main/run_snapshot_main.js after deserialization.
+static const char kUserContextPrelude[] = R"((function(filename) {
+  'use strict';
+  const state = { filename, callbacks: [], main: undefined };
+  function validateFunction(value, name) {
+    if (typeof value !== 'function')
+      throw new TypeError(`The "${name}" argument must be of type function`);
+  }
+  Object.defineProperty(globalThis, 'startupSnapshot', {
+    configurable: true,
+    writable: true,
+    value: Object.freeze({
+      addDeserializeCallback(callback) {
+        validateFunction(callback, 'callback');
+        state.callbacks.push(callback);
+      },
+      setDeserializeMainFunction(main) {
+        validateFunction(main, 'main');
+        if (state.main !== undefined)
+          throw new Error('The deserialize main function is already set');
+        state.main = main;
+      }
+    })
+  });
+  return state;
+}))";
+
+static std::string FormatException(Local<Context> context,
+                                   const TryCatch& try_catch) {
+  Isolate* isolate = context->GetIsolate();
+  Local<Value> value;
+  if (!try_catch.StackTrace(context).ToLocal(&value) || !value->IsString())
+    value = try_catch.Exception();
+  return *String::Utf8Value(isolate, value);
+}
+
+// Runs the entry script in a new context and returns the state object that
+// its calls to the `startupSnapshot` global have filled in.
+static MaybeLocal<Object> RunEntryScript(Local<Context> context,
+                                         const std::string& filename,
+                                         const std::string& source,
+                                         std::string* error) {
+  Isolate* isolate = context->GetIsolate();
+  Context::Scope context_scope(context);
+  TryCatch try_catch(isolate);
+
+  Local<Value> filename_string;
+  Local<Value> prelude;
+  Local<Value> state;
+  Local<String> entry;
+  Local<Script> script;
+  if (!ToV8Value(context, filename).ToLocal(&filename_string) ||
+      !Script::Compile(context, OneByteString(isolate, kUserContextPrelude))
+           .ToLocalChecked()->Run(context).ToLocal(&prelude) ||
+      !prelude.As<Function>()
+           ->Call(context, Undefined(isolate), 1, &filename_string)
+           .ToLocal(&state) ||
+      !String::NewFromUtf8(isolate, source.data(), NewStringType::kNormal,
+                           source.size()).ToLocal(&entry)) {
+    *error = FormatException(context, try_catch);
+    return MaybeLocal<Object>();
+  }
+
+  ScriptOrigin origin(filename_string);
+  if (!Script::Compile(context, entry, &origin).ToLocal(&script) ||
+      script->Run(context).IsEmpty()) {
+    *error = FormatException(context, try_catch);
+    return MaybeLocal<Object>();
+  }
+  isolate->RunMicrotasks();
+  if (try_catch.HasCaught()) {
+    *error = FormatException(context, try_catch);
+    return MaybeLocal<Object>();
+  }
+  Local<Value> main;
+  if (!state.As<Object>()
+           ->Get(context, OneByteString(isolate, "main"))
+           .ToLocal(&main) ||
+      !main->IsFunction()) {
+    *error = filename + " did not call "
+             "startupSnapshot.setDeserializeMainFunction()";
+    return MaybeLocal<Object>();
+  }
+  return state.As<Object>();
+}
+
+// Creates the snapshot and copies the blob into `*blob_data`. If
+// `entry_source` is not empty, the entry script is run in the context at
+// NodeMainInstance::kUserContextIndex.
+static bool CreateSnapshot(const std::vector<std::string>& args,
+                           const std::vector<std::string>& exec_args,
+                           const std::string& entry_filename,
+                           const std::string& entry_source,
+                           std::vector<size_t>* isolate_data_indexes,
+                           std::string* blob_data,
+                           std::string* error) {
   // TODO(joyeecheung): collect external references and set it in
   // params.external_references.
   std::vector<intptr_t> external_references = {
@@ -73,10 +179,9 @@ std::string SnapshotBuilder::Generate(
   per_process::v8_platform.Platform()->RegisterIsolate(isolate,
                                                        uv_default_loop());
   NodeMainInstance* main_instance = nullptr;
-  std::string result;
+  bool success = true;
 
   {
-    std::vector<size_t> isolate_data_indexes;
     SnapshotCreator creator(isolate, external_references.data());
     {
       main_instance =
@@ -87,10 +192,25 @@ std::string SnapshotBuilder::Generate(
                                    exec_args);
       HandleScope scope(isolate);
       creator.SetDefaultContext(Context::New(isolate));
-      isolate_data_indexes = main_instance->isolate_data()->Serialize(&creator);
+      *isolate_data_indexes =
+          main_instance->isolate_data()->Serialize(&creator);
 
       size_t index = creator.AddContext(NewContext(isolate));
       CHECK_EQ(index, NodeMainInstance::kNodeContextIndex);
+
+      if (!entry_source.empty()) {
+        Local<Context> user_context = NewContext(isolate);
+        Local<Object> state;
+        if (RunEntryScript(user_context, entry_filename, entry_source, error)
+                .ToLocal(&state)) {
+          index = creator.AddData(user_context, state);
+          CHECK_EQ(index, NodeMainInstance::kUserContextStateIndex);
+          index = creator.AddContext(user_context);
+          CHECK_EQ(index, NodeMainInstance::kUserContextIndex);
+        } else {
+          success = false;
+        }
+      }
     }
 
     // Must be out of HandleScope
@@ -99,11 +219,74 @@ std::string SnapshotBuilder::Generate(
     // Must be done while the snapshot creator isolate is entered i.e. the
     // creator is still alive.
     main_instance->Dispose();
-    result = FormatBlob(&blob, isolate_data_indexes);
-    delete blob.data;
+    blob_data->assign(blob.data, blob.raw_size);
+    delete[] blob.data;
   }
 
   per_process::v8_platform.Platform()->UnregisterIsolate(isolate);
-  return result;
+  return success;
+}
+
+std::string SnapshotBuilder::Generate(
+    const std::vector<std::string> args,
+    const std::vector<std::string> exec_args) {
+  std::vector<size_t> isolate_data_indexes;
+  std::string blob_data;
+  std::string error;
+  CHECK(CreateSnapshot(
+      args, exec_args, "", "", &isolate_data_indexes, &blob_data, &error));
+  StartupData blob = { blob_data.data(), static_cast<int>(blob_data.size()) };
+  return FormatBlob(&blob, isolate_data_indexes);
+}
+
+template <typename T>
+static void Append(std::string* contents, T value) {
+  contents->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// A snapshot file consists of, in the byte order of the host:
+//
+//   uint32_t magic                      NodeMainInstance::kSnapshotFileMagic
+//   uint32_t flags                      kSnapshotFileHasUserContext
+//   uint32_t version_length
+//   char     version[version_length]    NodeMainInstance::SnapshotFileVersion()
+//   uint32_t index_count
+//   uint64_t isolate_data_indexes[index_count]
+//   uint32_t blob_size
+//   char     blob[blob_size]
+bool SnapshotBuilder::GenerateFile(
+    const std::vector<std::string> args,
+    const std::vector<std::string> exec_args,
+    const std::string& entry_filename,
+    const std::string& entry_source,
+    std::string* contents,
+    std::string* error) {
+  std::vector<size_t> isolate_data_indexes;
+  std::string blob_data;
+  if (!CreateSnapshot(args,
+                      exec_args,
+                      entry_filename,
+                      entry_source,
+                      &isolate_data_indexes,
+                      &blob_data,
+                      error)) {
+    return false;
+  }
+
+  const std::string version = NodeMainInstance::SnapshotFileVersion();
+  uint32_t flags = 0;
+  if (!entry_source.empty())
+    flags |= NodeMainInstance::kSnapshotFileHasUserContext;
+  contents->clear();
+  Append<uint32_t>(contents, NodeMainInstance::kSnapshotFileMagic);
+  Append<uint32_t>(contents, flags);
+  Append<uint32_t>(contents, version.size());
+  contents->append(version);
+  Append<uint32_t>(contents, isolate_data_indexes.size());
+  for (size_t index : isolate_data_indexes)
+    Append<uint64_t>(contents, index);
+  Append<uint32_t>(contents, blob_data.size());
+  contents->append(blob_data);
+  return true;
 }
 }  // namespace node
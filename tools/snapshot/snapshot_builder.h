@@ -7,8 +7,20 @@
 namespace node {
 class SnapshotBuilder {
  public:
+  // Returns C++ source code that embeds the snapshot into the binary.
   static std::string Generate(const std::vector<std::string> args,
                               const std::vector<std::string> exec_args);
+
+  // Sets `*contents` to a snapshot file that can be passed to
+  // --snapshot-blob. If `entry_source` is not empty, it is run in a context
+  // of its own that is added to the snapshot. Returns false and sets
+  // `*error` if running it fails.
+  static bool GenerateFile(const std::vector<std::string> args,
+                           const std::vector<std::string> exec_args,
+                           const std::string& entry_filename,
+                           const std::string& entry_source,
+                           std::string* contents,
+                           std::string* error);
 };
 }  // namespace node
 